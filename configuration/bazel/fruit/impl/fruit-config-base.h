@@ -53,6 +53,9 @@
 
 #define FRUIT_USES_BOOST 1
 
+// Whether the components expanded during binding normalization are allocated in the normalization's memory pool.
+#define FRUIT_ALLOCATE_COMPONENTS_IN_MEMORY_POOL 0
+
 #define FRUIT_HAS_ALWAYS_INLINE_ATTRIBUTE 1
 
 #define FRUIT_HAS_FORCEINLINE 0
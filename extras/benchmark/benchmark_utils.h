@@ -0,0 +1,73 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_BENCHMARK_UTILS_H
+#define FRUIT_BENCHMARK_UTILS_H
+
+// Helpers shared by the benchmarks with MULTIPLIER bindings.
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// REPEAT(X) expands to X(N) for MULTIPLIER different values of N, while REPEAT_GROUPS(X) expands to X(G) for
+// MULTIPLIER/10 different values of G. The bindings are usually split in groups of 10 (see REPEAT_IN_GROUP), each in a
+// separate component: a single component with all the bindings would take too long to compile.
+#if MULTIPLIER == 10
+#define REPEAT(X) REPEAT_10(X, _)
+#define REPEAT_GROUPS(X) REPEAT_1(X, _)
+
+#elif MULTIPLIER == 100
+#define REPEAT(X) REPEAT_100(X, _)
+#define REPEAT_GROUPS(X) REPEAT_10(X, _)
+
+#elif MULTIPLIER == 1000
+#define REPEAT(X) REPEAT_1000(X, _)
+#define REPEAT_GROUPS(X) REPEAT_100(X, _)
+
+#else
+#error Multiplier not supported.
+#endif
+
+#define PLACEHOLDER
+
+#define EVAL0(...) __VA_ARGS__
+#define EVAL1(...) EVAL0(EVAL0(EVAL0(EVAL0(__VA_ARGS__))))
+#define EVAL2(...) EVAL1(EVAL1(EVAL1(EVAL1(__VA_ARGS__))))
+#define EVAL(...) EVAL2(EVAL2(EVAL2(EVAL2(__VA_ARGS__))))
+
+#define META_REPEAT_10(R, X, I)                                                                                        \
+  R PLACEHOLDER(X, I##0) R PLACEHOLDER(X, I##1) R PLACEHOLDER(X, I##2) R PLACEHOLDER(X, I##3) R PLACEHOLDER(X, I##4)   \
+      R PLACEHOLDER(X, I##5) R PLACEHOLDER(X, I##6) R PLACEHOLDER(X, I##7) R PLACEHOLDER(X, I##8)                      \
+          R PLACEHOLDER(X, I##9)
+
+#define REPEAT_1(X, I) X(I)
+
+#define REPEAT_10(X, I) META_REPEAT_10(REPEAT_1, X, I)
+
+#define REPEAT_100(X, I) META_REPEAT_10(REPEAT_10, X, I)
+
+#define REPEAT_1000(X, I) META_REPEAT_10(REPEAT_100, X, I)
+
+// This is separate from REPEAT_10 because it's used within REPEAT_GROUPS, and macros can't be expanded recursively.
+#define REPEAT_IN_GROUP(X, G) X(G##0) X(G##1) X(G##2) X(G##3) X(G##4) X(G##5) X(G##6) X(G##7) X(G##8) X(G##9)
+
+// Prints a metric in the format expected by run_benchmarks.py.
+inline void printMetric(const std::string& name, double value) {
+  std::cout << std::left << std::setw(50) << name << " = " << value << std::endl;
+}
+
+#endif // FRUIT_BENCHMARK_UTILS_H
@@ -0,0 +1,220 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures the throughput and latency of the lookups in an injector with MULTIPLIER bindings, shared by <num_threads>
+// threads. This covers both the case where the objects are already constructed ("warm") and the one where the threads
+// construct them concurrently ("cold").
+//
+// Usage: concurrency_benchmark <num_threads> <num_loops>
+//
+// The output is in the format expected by run_benchmarks.py (one "Metric name = value" line per metric). Throughputs
+// are in operations per second (over all threads), latencies in seconds.
+
+#include "exposed_component.h"
+
+#include <fruit/fruit.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+#define PROVIDER_FIELD(N) fruit::Provider<I##N> provider##N{injector.get<fruit::Provider<I##N>>()};
+
+#define GET_FUNCTION(N) [](ExposedInjector& injector) -> void* { return injector.get<I##N*>(); },
+
+#define PROVIDER_GET_FUNCTION(N) [](Providers& providers) -> void* { return providers.provider##N.get(); },
+
+// The providers for all the types, each thread has its own.
+struct Providers {
+  explicit Providers(ExposedInjector& injector) : injector(injector) {}
+
+  ExposedInjector& injector;
+  EVAL(REPEAT(PROVIDER_FIELD))
+};
+
+namespace {
+
+constexpr std::size_t num_bindings = MULTIPLIER;
+
+// These allow to look up the i-th type (chosen at run-time) in an injector.
+using GetFunction = void* (*)(ExposedInjector&);
+using ProviderGetFunction = void* (*)(Providers&);
+const GetFunction get_functions[] = {EVAL(REPEAT(GET_FUNCTION))};
+const ProviderGetFunction provider_get_functions[] = {EVAL(REPEAT(PROVIDER_GET_FUNCTION))};
+
+// This is printed at the end, so that the compiler can't optimize out the operations under benchmark.
+std::atomic<std::uintptr_t> checksum{0};
+
+struct Results {
+  std::size_t num_operations = 0;
+  double total_time = 0;
+  std::vector<double> latencies;
+
+  void printMetrics(const std::string& name) {
+    std::sort(latencies.begin(), latencies.end());
+    printMetric(name + " throughput", num_operations / total_time);
+    printMetric(name + " p50 latency", latencies[latencies.size() / 2]);
+    printMetric(name + " p99 latency", latencies[latencies.size() * 99 / 100]);
+  }
+};
+
+// Runs `thread_body' in `num_threads' threads, all started at the same time. `thread_body' gets the index of the thread
+// and must add the latency of each operation to the vector it's passed.
+void runInThreads(std::size_t num_threads, const std::function<void(std::size_t, std::vector<double>&)>& thread_body,
+                  Results& results) {
+  std::vector<std::vector<double>> latencies_by_thread(num_threads);
+  std::vector<Clock::time_point> end_times(num_threads);
+  std::atomic<std::size_t> num_ready_threads{0};
+  std::atomic<bool> started{false};
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&, i]() {
+      ++num_ready_threads;
+      while (!started) {
+        std::this_thread::yield();
+      }
+      thread_body(i, latencies_by_thread[i]);
+      end_times[i] = Clock::now();
+    });
+  }
+  while (num_ready_threads != num_threads) {
+    std::this_thread::yield();
+  }
+  Clock::time_point start_time = Clock::now();
+  started = true;
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  Clock::time_point end_time = *std::max_element(end_times.begin(), end_times.end());
+  results.total_time += std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time).count();
+  for (const std::vector<double>& latencies : latencies_by_thread) {
+    results.num_operations += latencies.size();
+    results.latencies.insert(results.latencies.end(), latencies.begin(), latencies.end());
+  }
+}
+
+// Times a single call to `operation' and adds its latency to `latencies'.
+template <typename F>
+void timeOperation(F operation, std::vector<double>& latencies) {
+  Clock::time_point start_time = Clock::now();
+  std::uintptr_t result = reinterpret_cast<std::uintptr_t>(operation());
+  latencies.push_back(std::chrono::duration_cast<std::chrono::duration<double>>(Clock::now() - start_time).count());
+  checksum.fetch_add(result, std::memory_order_relaxed);
+}
+
+} // namespace
+
+int main(int argc, const char* argv[]) {
+  if (argc != 3) {
+    std::cout << "Error: you need to specify the number of threads and the number of loops as arguments." << std::endl;
+    return 1;
+  }
+  std::size_t num_threads = std::atoi(argv[1]);
+  std::size_t num_loops = std::atoi(argv[2]);
+
+  std::cout << std::fixed;
+  std::cout << std::setprecision(15);
+
+  ExposedNormalizedComponent normalized_component(getComponent);
+
+  {
+    // The threads construct the objects concurrently, each one starting from a different type.
+    Results results;
+    for (std::size_t loop = 0; loop < num_loops; ++loop) {
+      ExposedInjector injector(normalized_component, getEmptyComponent);
+      runInThreads(num_threads,
+                   [&](std::size_t thread_index, std::vector<double>& latencies) {
+                     latencies.reserve(num_bindings);
+                     std::size_t first_type_index = thread_index * num_bindings / num_threads;
+                     for (std::size_t i = 0; i < num_bindings; ++i) {
+                       GetFunction get = get_functions[(first_type_index + i) % num_bindings];
+                       timeOperation([&]() { return get(injector); }, latencies);
+                     }
+                   },
+                   results);
+    }
+    results.printMetrics("Cold get()");
+  }
+
+  ExposedInjector injector(normalized_component, getEmptyComponent);
+  for (GetFunction get : get_functions) {
+    checksum += reinterpret_cast<std::uintptr_t>(get(injector));
+  }
+  checksum += injector.getMultibindings<Listener>().size();
+
+  {
+    Results results;
+    runInThreads(num_threads,
+                 [&](std::size_t, std::vector<double>& latencies) {
+                   latencies.reserve(num_loops * num_bindings);
+                   for (std::size_t loop = 0; loop < num_loops; ++loop) {
+                     for (GetFunction get : get_functions) {
+                       timeOperation([&]() { return get(injector); }, latencies);
+                     }
+                   }
+                 },
+                 results);
+    results.printMetrics("Warm get()");
+  }
+
+  {
+    Results results;
+    runInThreads(num_threads,
+                 [&](std::size_t, std::vector<double>& latencies) {
+                   Providers providers(injector);
+                   latencies.reserve(num_loops * num_bindings);
+                   for (std::size_t loop = 0; loop < num_loops; ++loop) {
+                     for (ProviderGetFunction provider_get : provider_get_functions) {
+                       timeOperation([&]() { return provider_get(providers); }, latencies);
+                     }
+                   }
+                 },
+                 results);
+    results.printMetrics("Warm Provider::get()");
+  }
+
+  {
+    Results results;
+    runInThreads(num_threads,
+                 [&](std::size_t, std::vector<double>& latencies) {
+                   latencies.reserve(num_loops);
+                   for (std::size_t loop = 0; loop < num_loops; ++loop) {
+                     timeOperation(
+                         [&]() {
+                           return reinterpret_cast<void*>(injector.getMultibindings<Listener>().size());
+                         },
+                         latencies);
+                   }
+                 },
+                 results);
+    results.printMetrics("Warm getMultibindings()");
+  }
+
+  // This goes to stderr, so run_benchmarks.py ignores it.
+  std::cerr << "Checksum: " << checksum << std::endl;
+
+  return 0;
+}
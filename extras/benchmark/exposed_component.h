@@ -0,0 +1,76 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_BENCHMARK_EXPOSED_COMPONENT_H
+#define FRUIT_BENCHMARK_EXPOSED_COMPONENT_H
+
+// A component with MULTIPLIER bindings I##N -> C##N, each also multibound as a Listener, shared by the benchmarks that
+// measure the lookups in an injector.
+
+#include "benchmark_utils.h"
+
+#include <fruit/fruit.h>
+
+struct Listener {
+  virtual ~Listener() = default;
+};
+
+struct Root {
+  INJECT(Root()) = default;
+};
+
+#define DEFINITIONS(N)                                                                                                 \
+  struct I##N {                                                                                                        \
+    virtual ~I##N() = default;                                                                                         \
+  };                                                                                                                   \
+                                                                                                                       \
+  struct C##N : public I##N, public Listener {                                                                         \
+    INJECT(C##N()) = default;                                                                                          \
+  };
+
+#define EXPOSED_TYPE(N) I##N,
+
+#define BINDINGS(N) .bind<I##N, C##N>().addMultibinding<Listener, C##N>()
+
+// GroupRoot##G is just used to terminate the list of types.
+#define GROUP_COMPONENT(G)                                                                                             \
+  struct GroupRoot##G {                                                                                                \
+    INJECT(GroupRoot##G()) = default;                                                                                  \
+  };                                                                                                                   \
+                                                                                                                       \
+  inline fruit::Component<REPEAT_IN_GROUP(EXPOSED_TYPE, G) GroupRoot##G> getComponent##G() {                           \
+    return fruit::createComponent() REPEAT_IN_GROUP(BINDINGS, G);                                                      \
+  }
+
+#define INSTALL_GROUP_COMPONENT(G) .install(getComponent##G)
+
+EVAL(REPEAT(DEFINITIONS))
+
+using ExposedComponent = fruit::Component<EVAL(REPEAT(EXPOSED_TYPE)) Root>;
+using ExposedNormalizedComponent = fruit::NormalizedComponent<EVAL(REPEAT(EXPOSED_TYPE)) Root>;
+using ExposedInjector = fruit::Injector<EVAL(REPEAT(EXPOSED_TYPE)) Root>;
+
+EVAL(REPEAT_GROUPS(GROUP_COMPONENT))
+
+inline ExposedComponent getComponent() {
+  return fruit::createComponent() EVAL(REPEAT_GROUPS(INSTALL_GROUP_COMPONENT));
+}
+
+inline fruit::Component<> getEmptyComponent() {
+  return fruit::createComponent();
+}
+
+#endif // FRUIT_BENCHMARK_EXPOSED_COMPONENT_H
@@ -226,8 +226,9 @@ def time_interval_pretty_printer(time_interval, min_in_table, max_in_table):
     sec = 1
     milli = 0.001
     micro = milli * milli
-    units = [micro, milli, sec]
-    unit_name_by_unit = {micro: 'μs', milli: 'ms', sec: 's'}
+    nano = micro * milli
+    units = [nano, micro, milli, sec]
+    unit_name_by_unit = {nano: 'ns', micro: 'μs', milli: 'ms', sec: 's'}
 
     unit = find_best_unit(units, min_in_table, max_in_table)
     unit_name = unit_name_by_unit[unit]
@@ -248,6 +249,23 @@ def file_size_interval_pretty_printer(file_size_interval, min_in_table, max_in_t
     return interval_pretty_printer(file_size_interval, unit=unit_name, multiplier=1 / unit)
 
 
+def throughput_interval_pretty_printer(throughput_interval, min_in_table, max_in_table):
+    ops = 1
+    kops = 1000
+    mops = kops * kops
+    units = [ops, kops, mops]
+    unit_name_by_unit = {ops: 'ops/s', kops: 'K ops/s', mops: 'M ops/s'}
+
+    unit = find_best_unit(units, min_in_table, max_in_table)
+    unit_name = unit_name_by_unit[unit]
+
+    return interval_pretty_printer(throughput_interval, unit=unit_name, multiplier=1 / unit)
+
+
+def count_interval_pretty_printer(count_interval, min_in_table, max_in_table):
+    return interval_pretty_printer(count_interval, unit='', multiplier=1).strip()
+
+
 def make_immutable(x):
     if isinstance(x, list):
         return tuple(make_immutable(elem) for elem in x)
@@ -286,6 +304,10 @@ def determine_value_pretty_printer(unit):
         return time_interval_pretty_printer
     if unit == "bytes":
         return file_size_interval_pretty_printer
+    if unit == "count":
+        return count_interval_pretty_printer
+    if unit == "operations per second":
+        return throughput_interval_pretty_printer
     raise Exception("Unrecognized unit: %s" % unit)
 
 
@@ -13,89 +13,252 @@
 # limitations under the License.
 
 
-def generate_files(injection_graph, generate_runtime_bench_code, use_normalized_component=False):
+# The ways in which the generated components can bind their types:
+#  * 'interface': each component binds an interface to its implementation class, with bind<InterfaceN, XN>().
+#  * 'multibinding': like 'interface', but each class is also added as a multibinding for a common Listener type,
+#                    that the main function retrieves with getMultibindings().
+#  * 'annotated': like 'interface', but the interfaces are bound and injected as annotated types.
+#  * 'factory': each component registers a factory (with an assisted parameter) with registerFactory(), and the classes
+#               get the factories of their dependencies injected.
+#  * 'provider': each class is constructed by a provider lambda registered with registerProvider().
+#  * 'component_args': like 'interface', but the component functions take an argument (so that they're installed as
+#                      components with arguments).
+#  * 'replace': like 'interface', but each component is replaced with a replacement component (with a different
+#               implementation class) everywhere it's installed, using replace(...).with(...).
+BINDING_STYLES = ['interface', 'multibinding', 'annotated', 'factory', 'provider', 'component_args', 'replace']
+
+def generate_files(injection_graph, generate_runtime_bench_code, use_normalized_component=False, binding_style='interface'):
     if use_normalized_component:
         assert not generate_runtime_bench_code
+    if binding_style not in BINDING_STYLES:
+        raise Exception('Unrecognized binding_style: %s. Allowed values are %s' % (binding_style, BINDING_STYLES))
 
     file_content_by_name = dict()
 
     for node_id in injection_graph.nodes_iter():
-        file_content_by_name['component%s.h' % node_id] = _generate_component_header(node_id)
-        file_content_by_name['component%s.cpp' % node_id] = _generate_component_source(node_id, injection_graph.successors(node_id))
+        file_content_by_name['component%s.h' % node_id] = _generate_component_header(node_id, binding_style)
+        file_content_by_name['component%s.cpp' % node_id] = _generate_component_source(node_id, injection_graph.successors(node_id), binding_style)
+
+    if binding_style == 'multibinding':
+        file_content_by_name['listener.h'] = _generate_listener_header()
 
     [toplevel_node] = [node_id
                        for node_id in injection_graph.nodes_iter()
                        if not injection_graph.predecessors(node_id)]
-    file_content_by_name['main.cpp'] = _generate_main(toplevel_node, generate_runtime_bench_code)
+    file_content_by_name['main.cpp'] = _generate_main(toplevel_node, generate_runtime_bench_code, binding_style)
 
     return file_content_by_name
 
-def _get_component_type(component_index):
-    return 'fruit::Component<Interface{component_index}>'.format(**locals())
+def _get_injected_type(component_index, binding_style):
+    if binding_style == 'annotated':
+        return 'fruit::Annotated<Annotation{component_index}, Interface{component_index}>'.format(**locals())
+    if binding_style == 'factory':
+        return 'Interface{component_index}Factory'.format(**locals())
+    return 'Interface{component_index}'.format(**locals())
+
+def _get_component_type(component_index, binding_style):
+    injected_type = _get_injected_type(component_index, binding_style)
+    return 'fruit::Component<{injected_type}>'.format(**locals())
+
+def _get_component_params(binding_style):
+    if binding_style == 'component_args':
+        return 'std::string name'
+    return ''
+
+def _get_component_args(component_index, binding_style):
+    if binding_style == 'component_args':
+        return ', std::string("component{component_index}")'.format(**locals())
+    return ''
+
+def _generate_listener_header():
+    return """
+#ifndef LISTENER_H
+#define LISTENER_H
+
+struct Listener {
+  virtual ~Listener() = default;
+};
+
+#endif // LISTENER_H
+"""
+
+def _generate_component_header(component_index, binding_style):
+    component_type = _get_component_type(component_index, binding_style)
+    component_params = _get_component_params(binding_style)
+
+    extra_includes = ''
+    extra_declarations = ''
+    if binding_style == 'multibinding':
+        extra_includes = '#include "listener.h"\n'
+    elif binding_style == 'annotated':
+        extra_declarations = 'struct Annotation{component_index} {{}};\n'.format(**locals())
+    elif binding_style == 'factory':
+        extra_includes = '#include <functional>\n#include <memory>\n'
+        extra_declarations = 'using Interface{component_index}Factory = std::function<std::unique_ptr<Interface{component_index}>(int)>;\n'.format(**locals())
+    elif binding_style == 'component_args':
+        extra_includes = '#include <string>\n'
+    elif binding_style == 'replace':
+        extra_declarations = '{component_type} getReplacementComponent{component_index}();\n'.format(**locals())
 
-def _generate_component_header(component_index):
-    component_type = _get_component_type(component_index)
     template = """
 #ifndef COMPONENT{component_index}_H
 #define COMPONENT{component_index}_H
 
 #include <fruit/fruit.h>
-
+{extra_includes}
 // Example include that the code might use
 #include <vector>
 
 struct Interface{component_index} {{
   virtual ~Interface{component_index}() = default;
 }};
-
-{component_type} getComponent{component_index}();
+{extra_declarations}
+{component_type} getComponent{component_index}({component_params});
 
 #endif // COMPONENT{component_index}_H
 """
     return template.format(**locals())
 
-def _generate_component_source(component_index, deps):
-    include_directives = ''.join(['#include "component%s.h"\n' % index for index in deps + [component_index]])
+def _generate_class(class_name, component_index, deps, binding_style):
+    """Generates the definition of the class that implements Interface{component_index}."""
+    base_classes = 'public Interface%s' % component_index
+    if binding_style == 'multibinding':
+        base_classes += ', public Listener'
+
+    if binding_style == 'factory':
+        dep_types = ['Interface%sFactory' % dep for dep in deps]
+    else:
+        dep_types = ['Interface%s&' % dep for dep in deps]
 
-    fields = ''.join(['Interface%s& x%s;\n' % (dep, dep)
-                      for dep in deps])
+    fields = ''.join(['%s x%s;\n' % (dep_type, dep)
+                      for dep_type, dep in zip(dep_types, deps)])
 
-    component_deps = ', '.join(['Interface%s& x%s' % (dep, dep)
-                                for dep in deps])
-    param_initializers = ', '.join('x%s(x%s)' % (dep, dep)
-                                   for dep in deps)
+    if binding_style == 'annotated':
+        constructor_params = ['ANNOTATED(Annotation%s, %s) x%s' % (dep, dep_type, dep)
+                              for dep_type, dep in zip(dep_types, deps)]
+    else:
+        constructor_params = ['%s x%s' % (dep_type, dep)
+                              for dep_type, dep in zip(dep_types, deps)]
+    param_initializers = ['x%s(x%s)' % (dep, dep)
+                          for dep in deps]
+    if binding_style == 'factory':
+        # The assisted parameter.
+        fields = 'int n;\n' + fields
+        constructor_params = ['int n'] + constructor_params
+        param_initializers = ['n(n)'] + param_initializers
+    constructor_params = ', '.join(constructor_params)
+    param_initializers = ', '.join(param_initializers)
     if param_initializers:
         param_initializers = ': ' + param_initializers
 
-    install_expressions = ''.join(['        .install(getComponent%s)\n' % dep for dep in deps])
-
-    component_type = _get_component_type(component_index)
+    # With these binding styles the objects are constructed by a lambda instead.
+    if binding_style in ('factory', 'provider'):
+        constructor = '{class_name}({constructor_params}) {param_initializers} {{}}'.format(**locals())
+    else:
+        constructor = 'INJECT({class_name}({constructor_params})) {param_initializers} {{}}'.format(**locals())
 
     template = """
-{include_directives}
-
-namespace {{
-struct X{component_index} : public Interface{component_index} {{
+struct {class_name} : {base_classes} {{
   {fields}
 
-  INJECT(X{component_index}({component_deps})) {param_initializers} {{}}
+  {constructor}
 
-  virtual ~X{component_index}() = default;
+  virtual ~{class_name}() = default;
 }};
+"""
+    return template.format(**locals())
+
+def _generate_bindings(class_name, component_index, deps, binding_style):
+    """Generates the calls to PartialComponent methods that bind Interface{component_index} to class_name."""
+    if binding_style == 'factory':
+        factory_params = ''.join([', Interface%sFactory' % dep for dep in deps])
+        lambda_params = ''.join([', Interface%sFactory x%s' % (dep, dep) for dep in deps])
+        constructor_args = ''.join([', x%s' % dep for dep in deps])
+        template = """
+        .registerFactory<std::unique_ptr<Interface{component_index}>(fruit::Assisted<int>{factory_params})>(
+            [](int n{lambda_params}) {{
+              return std::unique_ptr<Interface{component_index}>(new {class_name}(n{constructor_args}));
+            }})"""
+    elif binding_style == 'provider':
+        lambda_params = ', '.join(['Interface%s& x%s' % (dep, dep) for dep in deps])
+        constructor_args = ', '.join(['x%s' % dep for dep in deps])
+        template = """
+        .registerProvider([]({lambda_params}) {{ return {class_name}({constructor_args}); }})
+        .bind<Interface{component_index}, {class_name}>()"""
+    elif binding_style == 'annotated':
+        template = """
+        .bind<fruit::Annotated<Annotation{component_index}, Interface{component_index}>, {class_name}>()"""
+    elif binding_style == 'multibinding':
+        template = """
+        .bind<Interface{component_index}, {class_name}>()
+        .addMultibinding<Listener, {class_name}>()"""
+    else:
+        template = """
+        .bind<Interface{component_index}, {class_name}>()"""
+    return template.format(**locals()).lstrip('\n')
+
+def _generate_install_expressions(deps, binding_style):
+    install_expressions = ''
+    for dep in deps:
+        component_args = _get_component_args(dep, binding_style)
+        if binding_style == 'replace':
+            install_expressions += '        .replace(getComponent{dep}).with(getReplacementComponent{dep})\n'.format(**locals())
+        install_expressions += '        .install(getComponent{dep}{component_args})\n'.format(**locals())
+    return install_expressions
+
+def _generate_component_source(component_index, deps, binding_style):
+    include_directives = ''.join(['#include "component%s.h"\n' % index for index in deps + [component_index]])
+
+    classes = _generate_class('X%s' % component_index, component_index, deps, binding_style)
+    if binding_style == 'replace':
+        classes += _generate_class('Y%s' % component_index, component_index, deps, binding_style)
+
+    install_expressions = _generate_install_expressions(deps, binding_style)
+    bindings = _generate_bindings('X%s' % component_index, component_index, deps, binding_style)
+
+    component_type = _get_component_type(component_index, binding_style)
+    component_params = _get_component_params(binding_style)
+    unused_params = '    (void) name;\n' if binding_style == 'component_args' else ''
+
+    template = """
+{include_directives}
+
+namespace {{
+{classes}
 }}
 
 """
 
     template += """
-{component_type} getComponent{component_index}() {{
-    return fruit::createComponent(){install_expressions}
-        .bind<Interface{component_index}, X{component_index}>();
+{component_type} getComponent{component_index}({component_params}) {{
+{unused_params}    return fruit::createComponent()
+{install_expressions}{bindings};
+}}
+"""
+
+    if binding_style == 'replace':
+        replacement_bindings = _generate_bindings('Y%s' % component_index, component_index, deps, binding_style)
+        template += """
+{component_type} getReplacementComponent{component_index}() {{
+    return fruit::createComponent()
+{install_expressions}{replacement_bindings};
 }}
 """
 
     return template.format(**locals())
 
-def _generate_main(toplevel_component, generate_runtime_bench_code):
+def _generate_main(toplevel_component, generate_runtime_bench_code, binding_style):
+    injected_type = _get_injected_type(toplevel_component, binding_style)
+    component_args = _get_component_args(toplevel_component, binding_style)
+    if binding_style == 'factory':
+        get_expression = 'injector.get<Interface{toplevel_component}Factory>()(42)'.format(**locals())
+    elif binding_style == 'annotated':
+        get_expression = 'injector.get<fruit::Annotated<Annotation{toplevel_component}, std::shared_ptr<Interface{toplevel_component}>>>()'.format(**locals())
+    else:
+        get_expression = 'injector.get<std::shared_ptr<Interface{toplevel_component}>>()'.format(**locals())
+    if binding_style == 'multibinding':
+        get_expression += ';\n  injector.getMultibindings<Listener>()'
+
     if generate_runtime_bench_code:
         template = """
 #include "component{toplevel_component}.h"
@@ -119,12 +282,12 @@ int main(int argc, char* argv[]) {{
   }}
   size_t num_loops = std::atoi(argv[1]);
   
-  fruit::NormalizedComponent<Interface{toplevel_component}> normalizedComponent(getComponent{toplevel_component});
+  fruit::NormalizedComponent<{injected_type}> normalizedComponent(getComponent{toplevel_component}{component_args});
     
   std::chrono::high_resolution_clock::time_point start_time = std::chrono::high_resolution_clock::now();
   for (size_t i = 0; i < num_loops; i++) {{
-    fruit::Injector<Interface{toplevel_component}> injector(normalizedComponent, getEmptyComponent);
-    injector.get<std::shared_ptr<Interface{toplevel_component}>>();
+    fruit::Injector<{injected_type}> injector(normalizedComponent, getEmptyComponent);
+    {get_expression};
   }}
   double perRequestTime = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - start_time).count();
 
@@ -145,9 +308,9 @@ fruit::Component<> getEmptyComponent() {{
 }}
 
 int main(void) {{
-  fruit::NormalizedComponent<Interface{toplevel_component}> normalizedComponent(getComponent{toplevel_component});
-  fruit::Injector<Interface{toplevel_component}> injector(normalizedComponent, getEmptyComponent);
-  injector.get<std::shared_ptr<Interface{toplevel_component}>>();
+  fruit::NormalizedComponent<{injected_type}> normalizedComponent(getComponent{toplevel_component}{component_args});
+  fruit::Injector<{injected_type}> injector(normalizedComponent, getEmptyComponent);
+  {get_expression};
   std::cout << "Hello, world" << std::endl;
   return 0;
 }}
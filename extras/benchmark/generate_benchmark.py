@@ -70,6 +70,48 @@ def generate_injection_graph(num_components_with_no_deps,
 
     return injection_graph
 
+def generate_chain_injection_graph(num_components):
+    """Generates a single chain of components, where each component depends on the previous one."""
+    injection_graph = nx.DiGraph()
+    injection_graph.add_node(0)
+    for component_id in range(1, num_components):
+        injection_graph.add_edge(component_id, component_id - 1)
+    return injection_graph
+
+def generate_fan_out_injection_graph(num_components, num_deps):
+    """Generates a tree of components, where each component depends on (up to) num_deps components that nothing else depends on."""
+    injection_graph = nx.DiGraph()
+    injection_graph.add_node(0)
+    for component_id in range(1, num_components):
+        injection_graph.add_edge((component_id - 1) // num_deps, component_id)
+    return injection_graph
+
+def generate_diamond_injection_graph(num_components, num_deps):
+    """Generates layers of num_deps components, where each component depends on all the components of the previous layer.
+
+    This forms many "diamonds", i.e. components that are reachable from another one through multiple paths. The last
+    component depends on all the components of the last layer.
+    """
+    injection_graph = nx.DiGraph()
+    layers = [list(range(i, min(i + num_deps, num_components - 1)))
+              for i in range(0, num_components - 1, num_deps)]
+    for component_id in layers[0]:
+        injection_graph.add_node(component_id)
+    for previous_layer, layer in zip(layers, layers[1:]):
+        for component_id in layer:
+            for dep in previous_layer:
+                injection_graph.add_edge(component_id, dep)
+    for dep in layers[-1]:
+        injection_graph.add_edge(num_components - 1, dep)
+    return injection_graph
+
+# The shapes of the injection graphs that can be generated:
+#  * 'random': components that depend on a random set of num_deps previous components.
+#  * 'chain': a single chain of components, see generate_chain_injection_graph().
+#  * 'fan_out': a tree with num_deps children for each component, see generate_fan_out_injection_graph().
+#  * 'diamond': layers of components that depend on the whole previous layer, see generate_diamond_injection_graph().
+GRAPH_SHAPES = ['random', 'chain', 'fan_out', 'diamond']
+
 def generate_benchmark(
         di_library,
         compiler,
@@ -87,27 +129,46 @@ def generate_benchmark(
         generate_debuginfo=False,
         use_new_delete=False,
         use_interfaces=False,
-        use_normalized_component=False):
+        use_normalized_component=False,
+        graph_shape='random',
+        binding_style='interface'):
     """Generates a sample codebase using the specified DI library, meant for benchmarking.
 
     :param boost_di_sources_dir: this is only used if di_library=='boost_di', it can be None otherwise.
+    :param graph_shape: one of GRAPH_SHAPES. With shapes other than 'random', num_components_with_no_deps and
+           num_components_with_deps only determine the total number of components.
+    :param binding_style: one of fruit_source_generator.BINDING_STYLES. Only 'interface' is supported with
+           di_library!='fruit'.
     """
 
-    if num_components_with_no_deps < num_deps:
-        raise Exception(
-            "Too few components with no deps. num_components_with_no_deps=%s but num_deps=%s." % (num_components_with_no_deps, num_deps))
     if num_deps < 2:
         raise Exception("num_deps should be at least 2.")
+    if graph_shape not in GRAPH_SHAPES:
+        raise Exception('Unrecognized graph_shape: %s. Allowed values are %s' % (graph_shape, GRAPH_SHAPES))
+    if di_library != 'fruit' and binding_style != 'interface':
+        raise Exception('binding_style=%s is only supported with di_library=fruit.' % binding_style)
 
     # This is a constant so that we always generate the same file (=> benchmark more repeatable).
     random.seed(42)
 
-    injection_graph = generate_injection_graph(num_components_with_no_deps=num_components_with_no_deps,
-                                               num_components_with_deps=num_components_with_deps,
-                                               num_deps=num_deps)
+    num_components = num_components_with_no_deps + num_components_with_deps
+    if graph_shape == 'random':
+        if num_components_with_no_deps < num_deps:
+            raise Exception(
+                "Too few components with no deps. num_components_with_no_deps=%s but num_deps=%s." % (num_components_with_no_deps, num_deps))
+        injection_graph = generate_injection_graph(num_components_with_no_deps=num_components_with_no_deps,
+                                                   num_components_with_deps=num_components_with_deps,
+                                                   num_deps=num_deps)
+    elif graph_shape == 'chain':
+        injection_graph = generate_chain_injection_graph(num_components)
+    elif graph_shape == 'fan_out':
+        injection_graph = generate_fan_out_injection_graph(num_components, num_deps)
+    else:
+        injection_graph = generate_diamond_injection_graph(num_components, num_deps)
 
     if di_library == 'fruit':
-        file_content_by_name = fruit_source_generator.generate_files(injection_graph, generate_runtime_bench_code)
+        file_content_by_name = fruit_source_generator.generate_files(injection_graph, generate_runtime_bench_code,
+                                                                     binding_style=binding_style)
         include_dirs = [fruit_build_dir + '/include', fruit_sources_dir + '/include']
         library_dirs = [fruit_build_dir + '/src']
         link_libraries = ['fruit']
@@ -169,6 +230,8 @@ def main():
     parser.add_argument('--use-new-delete', default='false', help='Set this to \'true\' to use new/delete. Only relevant when --di_library=none.')
     parser.add_argument('--use-interfaces', default='false', help='Set this to \'true\' to use interfaces. Only relevant when --di_library=none.')
     parser.add_argument('--use-normalized-component', default='false', help='Set this to \'true\' to create a NormalizedComponent and create the injector from that. Only relevant when --di_library=fruit and --generate-runtime-bench-code=false.')
+    parser.add_argument('--graph-shape', default='random', help='The shape of the injection graph. One of %s. (default: random)' % GRAPH_SHAPES)
+    parser.add_argument('--binding-style', default='interface', help='How the generated components bind their types. One of %s (see fruit_source_generator.py). Only relevant when --di_library=fruit. (default: interface)' % fruit_source_generator.BINDING_STYLES)
     parser.add_argument('--generate-runtime-bench-code', default='true', help='Set this to \'false\' for compile benchmarks.')
     parser.add_argument('--generate-debuginfo', default='false', help='Set this to \'true\' to generate debugging information (-g).')
     parser.add_argument('--use-exceptions', default='true', help='Set this to \'false\' to disable exceptions.')
@@ -214,6 +277,8 @@ def main():
         use_new_delete=(args.use_new_delete == 'true'),
         use_interfaces=(args.use_interfaces == 'true'),
         use_normalized_component=(args.use_normalized_component == 'true'),
+        graph_shape=args.graph_shape,
+        binding_style=args.binding_style,
         generate_runtime_bench_code=(args.generate_runtime_bench_code == 'true'),
         use_exceptions=(args.use_exceptions == 'true'),
         use_rtti=(args.use_rtti == 'true'))
@@ -0,0 +1,246 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Microbenchmarks for the operations on Fruit's hot paths, on an injector with MULTIPLIER bindings (and on internal
+// data structures with MULTIPLIER elements).
+//
+// Usage: microbenchmarks <num_loops>
+//
+// The output is in the format expected by run_benchmarks.py (one "Metric name = value" line per metric). All values
+// are the average time (in seconds) of a single operation.
+
+#define IN_FRUIT_CPP_FILE 1
+
+#include "exposed_component.h"
+
+#include <fruit/fruit.h>
+#include <fruit/impl/data_structures/fixed_size_allocator.h>
+#include <fruit/impl/data_structures/fixed_size_vector.templates.h>
+#include <fruit/impl/data_structures/memory_pool.h>
+#include <fruit/impl/data_structures/semistatic_graph.templates.h>
+#include <fruit/impl/data_structures/semistatic_map.templates.h>
+#include <fruit/impl/injector/injector_accessor_for_tests.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace fruit::impl;
+
+using Clock = std::chrono::high_resolution_clock;
+
+#define GET(N) checksum += reinterpret_cast<std::uintptr_t>(injector.get<I##N*>());
+
+#define GET_PROVIDER(N) fruit::Provider<I##N> provider##N = injector.get<fruit::Provider<I##N>>();
+
+#define PROVIDER_GET(N) checksum += reinterpret_cast<std::uintptr_t>(provider##N.get());
+
+#define UNSAFE_GET(N) checksum += reinterpret_cast<std::uintptr_t>(InjectorAccessorForTests::unsafeGet<I##N>(injector));
+
+namespace {
+
+constexpr std::size_t num_bindings = MULTIPLIER;
+
+// This is printed at the end, so that the compiler can't optimize out the operations under benchmark.
+std::uintptr_t checksum = 0;
+
+double secondsSince(Clock::time_point start_time) {
+  return std::chrono::duration_cast<std::chrono::duration<double>>(Clock::now() - start_time).count();
+}
+
+// A node of the graph used in the SemistaticGraph benchmark, see the SemistaticGraph constructor for the requirements.
+// Each node has edges to the (up to) 3 previous ones.
+struct GraphNode {
+  std::size_t id;
+  const std::vector<std::size_t>* ids;
+
+  std::size_t getId() {
+    return (*ids)[id];
+  }
+  void* getValue() {
+    return nullptr;
+  }
+  bool isTerminal() {
+    return false;
+  }
+  std::vector<std::size_t>::const_iterator getEdgesBegin() {
+    return ids->begin() + (id < 3 ? 0 : id - 3);
+  }
+  std::vector<std::size_t>::const_iterator getEdgesEnd() {
+    return ids->begin() + id;
+  }
+};
+
+} // namespace
+
+int main(int argc, const char* argv[]) {
+  if (argc != 2) {
+    std::cout << "Error: you need to specify the number of loops as argument." << std::endl;
+    return 1;
+  }
+  std::size_t num_loops = std::atoi(argv[1]);
+
+  std::cout << std::fixed;
+  std::cout << std::setprecision(15);
+
+  ExposedNormalizedComponent normalized_component(getComponent);
+
+  {
+    double total_time = 0;
+    for (std::size_t i = 0; i < num_loops; i++) {
+      ExposedInjector injector(normalized_component, getEmptyComponent);
+      Clock::time_point start_time = Clock::now();
+      EVAL(REPEAT(GET))
+      total_time += secondsSince(start_time);
+    }
+    printMetric("Injector::get() (unconstructed)", total_time / num_loops / num_bindings);
+  }
+
+  ExposedInjector injector(normalized_component, getEmptyComponent);
+  EVAL(REPEAT(GET))
+
+  {
+    Clock::time_point start_time = Clock::now();
+    for (std::size_t i = 0; i < num_loops; i++) {
+      EVAL(REPEAT(GET))
+    }
+    printMetric("Injector::get() (constructed)", secondsSince(start_time) / num_loops / num_bindings);
+  }
+
+  {
+    EVAL(REPEAT(GET_PROVIDER))
+    Clock::time_point start_time = Clock::now();
+    for (std::size_t i = 0; i < num_loops; i++) {
+      EVAL(REPEAT(PROVIDER_GET))
+    }
+    printMetric("Provider::get() (constructed)", secondsSince(start_time) / num_loops / num_bindings);
+  }
+
+  {
+    Clock::time_point start_time = Clock::now();
+    for (std::size_t i = 0; i < num_loops; i++) {
+      EVAL(REPEAT(UNSAFE_GET))
+    }
+    printMetric("unsafeGet() (constructed)", secondsSince(start_time) / num_loops / num_bindings);
+  }
+
+  {
+    double total_time = 0;
+    for (std::size_t i = 0; i < num_loops; i++) {
+      ExposedInjector injector(normalized_component, getEmptyComponent);
+      Clock::time_point start_time = Clock::now();
+      checksum += injector.getMultibindings<Listener>().size();
+      total_time += secondsSince(start_time);
+    }
+    printMetric("Injector::getMultibindings() (unconstructed)", total_time / num_loops);
+
+    Clock::time_point start_time = Clock::now();
+    for (std::size_t i = 0; i < num_loops * num_bindings; i++) {
+      checksum += injector.getMultibindings<Listener>().size();
+    }
+    printMetric("Injector::getMultibindings() (constructed)", secondsSince(start_time) / num_loops / num_bindings);
+  }
+
+  // The keys of the maps in injectors are pointers to TypeInfo objects, that the compiler typically puts next to each
+  // other. These keys are never dereferenced.
+  std::vector<TypeInfo> type_infos_storage(2 * num_bindings, TypeInfo(TypeInfo::ConcreteTypeInfo{0, 0, false}));
+  std::vector<std::pair<TypeId, std::size_t>> map_values;
+  for (std::size_t i = 0; i < num_bindings; ++i) {
+    map_values.emplace_back(TypeId{&type_infos_storage[i]}, i);
+  }
+
+  {
+    MemoryPool memory_pool;
+    SemistaticMap<TypeId, std::size_t> map(map_values.begin(), map_values.end(), map_values.size(), memory_pool);
+
+    Clock::time_point start_time = Clock::now();
+    for (std::size_t i = 0; i < num_loops; i++) {
+      for (const std::pair<TypeId, std::size_t>& value : map_values) {
+        checksum += map.at(value.first);
+      }
+    }
+    printMetric("SemistaticMap::at()", secondsSince(start_time) / num_loops / num_bindings);
+
+    start_time = Clock::now();
+    for (std::size_t i = 0; i < num_loops; i++) {
+      for (std::size_t j = 0; j < num_bindings; j++) {
+        checksum += *map.find(TypeId{&type_infos_storage[j]});
+        // The second half of type_infos_storage is not in the map.
+        checksum += reinterpret_cast<std::uintptr_t>(map.find(TypeId{&type_infos_storage[num_bindings + j]}));
+      }
+    }
+    printMetric("SemistaticMap::find() (50% hits)", secondsSince(start_time) / num_loops / num_bindings / 2);
+  }
+
+  {
+    std::vector<std::size_t> node_ids;
+    for (std::size_t i = 0; i < num_bindings; ++i) {
+      // Spread the ids as TypeId pointers would be.
+      node_ids.push_back(reinterpret_cast<std::size_t>(&type_infos_storage[i]));
+    }
+    std::vector<GraphNode> nodes;
+    for (std::size_t i = 0; i < num_bindings; ++i) {
+      nodes.push_back(GraphNode{i, &node_ids});
+    }
+    // Only the first `num_loops / 10 + 1' constructions are timed, this is much slower than the other operations.
+    std::size_t num_graph_loops = num_loops / 10 + 1;
+    Clock::time_point start_time = Clock::now();
+    for (std::size_t i = 0; i < num_graph_loops; i++) {
+      MemoryPool memory_pool;
+      SemistaticGraph<std::size_t, void*> graph(nodes.begin(), nodes.end(), memory_pool);
+      checksum += graph.size();
+    }
+    printMetric("SemistaticGraph construction (per node)", secondsSince(start_time) / num_graph_loops / num_bindings);
+  }
+
+  {
+    FixedSizeAllocator::FixedSizeAllocatorData allocator_data;
+    for (std::size_t i = 0; i < num_bindings; ++i) {
+      allocator_data.addType(getTypeId<Root>());
+    }
+    double total_time = 0;
+    for (std::size_t i = 0; i < num_loops; i++) {
+      FixedSizeAllocator allocator(allocator_data);
+      Clock::time_point start_time = Clock::now();
+      for (std::size_t j = 0; j < num_bindings; ++j) {
+        checksum += reinterpret_cast<std::uintptr_t>(allocator.constructObject<Root>());
+      }
+      total_time += secondsSince(start_time);
+    }
+    printMetric("FixedSizeAllocator::constructObject()", total_time / num_loops / num_bindings);
+  }
+
+  {
+    double total_time = 0;
+    for (std::size_t i = 0; i < num_loops; i++) {
+      MemoryPool memory_pool;
+      Clock::time_point start_time = Clock::now();
+      for (std::size_t j = 0; j < num_bindings; ++j) {
+        checksum += reinterpret_cast<std::uintptr_t>(memory_pool.allocate<std::pair<TypeId, std::size_t>>(4));
+      }
+      total_time += secondsSince(start_time);
+    }
+    printMetric("MemoryPool::allocate()", total_time / num_loops / num_bindings);
+  }
+
+  // This goes to stderr, so run_benchmarks.py ignores it.
+  std::cerr << "Checksum: " << checksum << std::endl;
+
+  return 0;
+}
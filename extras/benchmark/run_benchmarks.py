@@ -170,6 +170,166 @@ class SimpleNewDeleteRunTimeBenchmark:
         return self.benchmark_definition
 
 
+class FruitSemistaticMapBenchmark:
+    def __init__(self, benchmark_definition, fruit_sources_dir, fruit_build_dir, fruit_benchmark_sources_dir):
+        self.benchmark_definition = add_synthetic_benchmark_parameters(benchmark_definition, path_to_code_under_test=fruit_sources_dir)
+        self.fruit_sources_dir = fruit_sources_dir
+        self.fruit_build_dir = fruit_build_dir
+        self.fruit_benchmark_sources_dir = fruit_benchmark_sources_dir
+
+    def prepare(self):
+        cxx_std = self.benchmark_definition['cxx_std']
+        compiler_executable_name = self.benchmark_definition['compiler']
+
+        self.tmpdir = tempfile.gettempdir() + '/fruit-benchmark-dir'
+        ensure_empty_dir(self.tmpdir)
+        run_command(compiler_executable_name,
+                    args=compile_flags + [
+                        '-std=%s' % cxx_std,
+                        '-I', self.fruit_sources_dir + '/include',
+                        '-I', self.fruit_build_dir + '/include',
+                        self.fruit_benchmark_sources_dir + '/extras/benchmark/semistatic_map_benchmark.cpp',
+                        '-o',
+                        self.tmpdir + '/main',
+                    ])
+
+    def run(self):
+        num_bindings = self.benchmark_definition['num_bindings']
+        loop_factor = self.benchmark_definition['loop_factor']
+        # The number of maps constructed is inversely proportional to their size, so that each run takes a similar time.
+        num_loops = max(1, int(10000000 * loop_factor / num_bindings))
+        stdout, _ = run_command(self.tmpdir + '/main', args = [num_bindings, num_loops])
+        return parse_results(stdout.splitlines())
+
+    def describe(self):
+        return self.benchmark_definition
+
+
+class FruitMicrobenchmarks:
+    def __init__(self, benchmark_definition, fruit_sources_dir, fruit_build_dir, fruit_benchmark_sources_dir):
+        self.benchmark_definition = add_synthetic_benchmark_parameters(benchmark_definition, path_to_code_under_test=fruit_sources_dir)
+        self.fruit_sources_dir = fruit_sources_dir
+        self.fruit_build_dir = fruit_build_dir
+        self.fruit_benchmark_sources_dir = fruit_benchmark_sources_dir
+
+    def prepare(self):
+        num_bindings = self.benchmark_definition['num_bindings']
+        assert (num_bindings % 10) == 0, num_bindings
+        cxx_std = self.benchmark_definition['cxx_std']
+        compiler_executable_name = self.benchmark_definition['compiler']
+
+        self.tmpdir = tempfile.gettempdir() + '/fruit-benchmark-dir'
+        ensure_empty_dir(self.tmpdir)
+        run_command(compiler_executable_name,
+                    args=compile_flags + [
+                        '-std=%s' % cxx_std,
+                        '-DMULTIPLIER=%s' % num_bindings,
+                        '-I', self.fruit_sources_dir + '/include',
+                        '-I', self.fruit_build_dir + '/include',
+                        '-Wl,-rpath,%s/src' % self.fruit_build_dir,
+                        self.fruit_benchmark_sources_dir + '/extras/benchmark/microbenchmarks.cpp',
+                        '-L', self.fruit_build_dir + '/src',
+                        '-lfruit',
+                        '-o',
+                        self.tmpdir + '/main',
+                    ])
+
+    def run(self):
+        loop_factor = self.benchmark_definition['loop_factor']
+        stdout, _ = run_command(self.tmpdir + '/main', args = [int(100000 * loop_factor)])
+        return parse_results(stdout.splitlines())
+
+    def describe(self):
+        return self.benchmark_definition
+
+
+class FruitConcurrencyBenchmark:
+    def __init__(self, benchmark_definition, fruit_sources_dir, fruit_build_dir, fruit_benchmark_sources_dir):
+        self.benchmark_definition = add_synthetic_benchmark_parameters(benchmark_definition, path_to_code_under_test=fruit_sources_dir)
+        self.fruit_sources_dir = fruit_sources_dir
+        self.fruit_build_dir = fruit_build_dir
+        self.fruit_benchmark_sources_dir = fruit_benchmark_sources_dir
+
+    def prepare(self):
+        num_bindings = self.benchmark_definition['num_bindings']
+        assert (num_bindings % 10) == 0, num_bindings
+        cxx_std = self.benchmark_definition['cxx_std']
+        compiler_executable_name = self.benchmark_definition['compiler']
+
+        self.tmpdir = tempfile.gettempdir() + '/fruit-benchmark-dir'
+        ensure_empty_dir(self.tmpdir)
+        run_command(compiler_executable_name,
+                    args=compile_flags + [
+                        '-std=%s' % cxx_std,
+                        '-DMULTIPLIER=%s' % num_bindings,
+                        '-pthread',
+                        '-I', self.fruit_sources_dir + '/include',
+                        '-I', self.fruit_build_dir + '/include',
+                        '-Wl,-rpath,%s/src' % self.fruit_build_dir,
+                        self.fruit_benchmark_sources_dir + '/extras/benchmark/concurrency_benchmark.cpp',
+                        '-L', self.fruit_build_dir + '/src',
+                        '-lfruit',
+                        '-o',
+                        self.tmpdir + '/main',
+                    ])
+
+    def run(self):
+        num_bindings = self.benchmark_definition['num_bindings']
+        num_threads = self.benchmark_definition['num_threads']
+        loop_factor = self.benchmark_definition['loop_factor']
+        num_loops = max(1, int(100000 * loop_factor / num_bindings))
+        stdout, _ = run_command(self.tmpdir + '/main', args = [num_threads, num_loops])
+        return parse_results(stdout.splitlines())
+
+    def describe(self):
+        return self.benchmark_definition
+
+
+class FruitServerBenchmark:
+    def __init__(self, benchmark_definition, fruit_sources_dir, fruit_build_dir, fruit_benchmark_sources_dir):
+        self.benchmark_definition = add_synthetic_benchmark_parameters(benchmark_definition, path_to_code_under_test=fruit_sources_dir)
+        self.fruit_sources_dir = fruit_sources_dir
+        self.fruit_build_dir = fruit_build_dir
+        self.fruit_benchmark_sources_dir = fruit_benchmark_sources_dir
+
+    def prepare(self):
+        # Here num_bindings is the number of request handlers.
+        num_bindings = self.benchmark_definition['num_bindings']
+        assert (num_bindings % 10) == 0, num_bindings
+        cxx_std = self.benchmark_definition['cxx_std']
+        compiler_executable_name = self.benchmark_definition['compiler']
+
+        self.tmpdir = tempfile.gettempdir() + '/fruit-benchmark-dir'
+        ensure_empty_dir(self.tmpdir)
+        run_command(compiler_executable_name,
+                    args=compile_flags + [
+                        '-std=%s' % cxx_std,
+                        '-DMULTIPLIER=%s' % num_bindings,
+                        '-pthread',
+                        '-I', self.fruit_sources_dir + '/include',
+                        '-I', self.fruit_build_dir + '/include',
+                        '-Wl,-rpath,%s/src' % self.fruit_build_dir,
+                        self.fruit_benchmark_sources_dir + '/extras/benchmark/server_benchmark.cpp',
+                        '-L', self.fruit_build_dir + '/src',
+                        '-lfruit',
+                        '-o',
+                        self.tmpdir + '/main',
+                    ])
+
+    def run(self):
+        num_threads = self.benchmark_definition['num_threads']
+        num_request_bindings = self.benchmark_definition['num_request_bindings']
+        num_touched_handlers = self.benchmark_definition['num_touched_handlers']
+        loop_factor = self.benchmark_definition['loop_factor']
+        num_requests = max(1, int(100000 * loop_factor))
+        stdout, _ = run_command(self.tmpdir + '/main',
+                                args = [num_threads, num_request_bindings, num_touched_handlers, num_requests])
+        return parse_results(stdout.splitlines())
+
+    def describe(self):
+        return self.benchmark_definition
+
+
 class FruitSingleFileCompileTimeBenchmark:
     def __init__(self, benchmark_definition, fruit_sources_dir, fruit_build_dir, fruit_benchmark_sources_dir):
         self.benchmark_definition = add_synthetic_benchmark_parameters(benchmark_definition, path_to_code_under_test=fruit_sources_dir)
@@ -243,6 +403,8 @@ class GenericGeneratedSourcesBenchmark:
             output_dir=self.tmpdir,
             cxx_std=cxx_std,
             di_library=self.di_library,
+            graph_shape=self.benchmark_definition.get('graph_shape', 'random'),
+            binding_style=self.benchmark_definition.get('binding_style', 'interface'),
             **benchmark_generation_flags,
             **self.other_args)
 
@@ -740,6 +902,30 @@ def main():
                     fruit_sources_dir=args.fruit_sources_dir,
                     fruit_benchmark_sources_dir=args.fruit_benchmark_sources_dir,
                     fruit_build_dir=fruit_build_dir)
+            elif benchmark_name == 'fruit_semistatic_map':
+                benchmark = FruitSemistaticMapBenchmark(
+                    benchmark_definition,
+                    fruit_sources_dir=args.fruit_sources_dir,
+                    fruit_benchmark_sources_dir=args.fruit_benchmark_sources_dir,
+                    fruit_build_dir=fruit_build_dir)
+            elif benchmark_name == 'fruit_microbenchmarks':
+                benchmark = FruitMicrobenchmarks(
+                    benchmark_definition,
+                    fruit_sources_dir=args.fruit_sources_dir,
+                    fruit_benchmark_sources_dir=args.fruit_benchmark_sources_dir,
+                    fruit_build_dir=fruit_build_dir)
+            elif benchmark_name == 'fruit_concurrency':
+                benchmark = FruitConcurrencyBenchmark(
+                    benchmark_definition,
+                    fruit_sources_dir=args.fruit_sources_dir,
+                    fruit_benchmark_sources_dir=args.fruit_benchmark_sources_dir,
+                    fruit_build_dir=fruit_build_dir)
+            elif benchmark_name == 'fruit_server':
+                benchmark = FruitServerBenchmark(
+                    benchmark_definition,
+                    fruit_sources_dir=args.fruit_sources_dir,
+                    fruit_benchmark_sources_dir=args.fruit_benchmark_sources_dir,
+                    fruit_build_dir=fruit_build_dir)
             elif benchmark_name.startswith('fruit_'):
                 benchmark_class = {
                     'fruit_compile_time': FruitCompileTimeBenchmark,
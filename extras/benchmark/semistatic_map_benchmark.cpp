@@ -0,0 +1,138 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures the quality of the hashing scheme of SemistaticMap (the hash table used to look up the types in an
+// injector) for a given number of keys.
+//
+// Usage: semistatic_map_benchmark <num_keys> <num_loops>
+//
+// The output is in the format expected by run_benchmarks.py (one "Metric name = value" line per metric), all values are
+// averages over the <num_loops> maps constructed.
+
+#define IN_FRUIT_CPP_FILE 1
+
+#include <fruit/impl/data_structures/semistatic_map.templates.h>
+#include <fruit/impl/util/type_info.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace fruit::impl;
+
+using Map = SemistaticMap<TypeId, std::size_t>;
+using Clock = std::chrono::high_resolution_clock;
+
+namespace {
+
+double secondsSince(Clock::time_point start_time) {
+  return std::chrono::duration_cast<std::chrono::duration<double>>(Clock::now() - start_time).count();
+}
+
+void printMetric(const std::string& name, double value) {
+  std::cout << std::left << std::setw(40) << name << " = " << value << std::endl;
+}
+
+} // namespace
+
+int main(int argc, const char* argv[]) {
+  if (argc != 3) {
+    std::cout << "Error: you need to specify the number of keys and the number of loops as arguments." << std::endl;
+    return 1;
+  }
+  std::size_t num_keys = std::atoi(argv[1]);
+  std::size_t num_loops = std::atoi(argv[2]);
+  // The number of keys added to each map with the extending constructor, as when an injector is created from a
+  // NormalizedComponent.
+  std::size_t num_additional_keys = num_keys / 10 + 1;
+
+  // The keys of the maps in injectors are pointers to TypeInfo objects, that the compiler typically puts next to each
+  // other. These keys are never dereferenced.
+  std::vector<TypeInfo> type_infos_storage(num_keys + num_additional_keys,
+                                           TypeInfo(TypeInfo::ConcreteTypeInfo{0, 0, false}));
+  std::vector<std::pair<TypeId, std::size_t>> values;
+  for (std::size_t i = 0; i < num_keys; ++i) {
+    values.emplace_back(TypeId{&type_infos_storage[i]}, i);
+  }
+
+  double construction_time = 0;
+  double extension_time = 0;
+  double lookup_time = 0;
+  double num_retries = 0;
+  double load_factor = 0;
+  double max_bucket_size = 0;
+  double num_wasted_values = 0;
+  // The fraction of buckets with 0, 1, 2, ... elements.
+  std::vector<double> bucket_size_fractions;
+
+  for (std::size_t loop = 0; loop < num_loops; ++loop) {
+    MemoryPool memory_pool;
+
+    Clock::time_point start_time = Clock::now();
+    Map map(values.begin(), values.end(), values.size(), memory_pool);
+    construction_time += secondsSince(start_time);
+
+    std::vector<std::pair<TypeId, std::size_t>, ArenaAllocator<std::pair<TypeId, std::size_t>>> new_values(
+        ArenaAllocator<std::pair<TypeId, std::size_t>>{memory_pool});
+    for (std::size_t i = num_keys; i < num_keys + num_additional_keys; ++i) {
+      new_values.emplace_back(TypeId{&type_infos_storage[i]}, i);
+    }
+    start_time = Clock::now();
+    Map extended_map(map, std::move(new_values));
+    extension_time += secondsSince(start_time);
+
+    std::size_t checksum = 0;
+    start_time = Clock::now();
+    for (const std::pair<TypeId, std::size_t>& value : values) {
+      checksum += map.at(value.first);
+    }
+    lookup_time += secondsSince(start_time);
+    if (checksum != num_keys * (num_keys - 1) / 2) {
+      std::cout << "Error: wrong lookup result." << std::endl;
+      return 1;
+    }
+
+    SemistaticMapDiagnostics diagnostics = map.getDiagnostics();
+    num_retries += diagnostics.num_hash_function_retries;
+    load_factor += diagnostics.getLoadFactor();
+    max_bucket_size += diagnostics.bucket_size_histogram.size() - 1;
+    if (bucket_size_fractions.size() < diagnostics.bucket_size_histogram.size()) {
+      bucket_size_fractions.resize(diagnostics.bucket_size_histogram.size());
+    }
+    for (std::size_t i = 0; i < diagnostics.bucket_size_histogram.size(); ++i) {
+      bucket_size_fractions[i] += double(diagnostics.bucket_size_histogram[i]) / diagnostics.num_buckets;
+    }
+    num_wasted_values += extended_map.getDiagnostics().num_wasted_values;
+  }
+
+  std::cout << std::fixed;
+  std::cout << std::setprecision(15);
+  printMetric("Construction time", construction_time / num_loops);
+  printMetric("Extension time", extension_time / num_loops);
+  printMetric("Lookup time", lookup_time / num_loops / num_keys);
+  printMetric("Hash function retries", num_retries / num_loops);
+  printMetric("Load factor", load_factor / num_loops);
+  printMetric("Max bucket size", max_bucket_size / num_loops);
+  for (std::size_t i = 0; i < bucket_size_fractions.size(); ++i) {
+    printMetric("Fraction of buckets with " + std::to_string(i) + " elements", bucket_size_fractions[i] / num_loops);
+  }
+  printMetric("Wasted slots after extension", num_wasted_values / num_loops);
+
+  return 0;
+}
@@ -0,0 +1,259 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures the throughput of a server that handles each request with a separate injector, as in examples/server: the
+// component with the MULTIPLIER request handlers is normalized once at startup, and then each request is handled with
+// an injector created from that NormalizedComponent and a small component with the request-specific bindings.
+//
+// The requests are generated in-process and handled by a pool of <num_threads> threads. Each request adds
+// <num_request_bindings> multibindings to its injector and uses <num_touched_handlers> of the handlers.
+//
+// Usage: server_benchmark <num_threads> <num_request_bindings> <num_touched_handlers> <num_requests>
+//
+// The output is in the format expected by run_benchmarks.py (one "Metric name = value" line per metric). Times are in
+// seconds, and all per-request metrics are averages.
+
+#include "benchmark_utils.h"
+
+#include <fruit/fruit.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+// The number of memory allocations done so far by the current thread.
+thread_local std::size_t num_allocations = 0;
+} // namespace
+
+void* operator new(std::size_t size) {
+  ++num_allocations;
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+struct Request {
+  std::size_t id;
+  // The index of the first handler used for this request.
+  std::size_t first_handler_index;
+};
+
+struct ServerContext {
+  std::size_t server_id;
+};
+
+// The request-specific bindings.
+struct RequestListener {
+  std::size_t id;
+};
+
+#define DEFINITIONS(N)                                                                                                 \
+  struct HandlerDependency##N {                                                                                        \
+    const ServerContext& server_context;                                                                               \
+                                                                                                                       \
+    INJECT(HandlerDependency##N(const ServerContext& server_context)) : server_context(server_context) {}              \
+  };                                                                                                                   \
+                                                                                                                       \
+  struct Handler##N {                                                                                                  \
+    const Request& request;                                                                                            \
+    HandlerDependency##N* dependency;                                                                                  \
+                                                                                                                       \
+    INJECT(Handler##N(const Request& request, HandlerDependency##N* dependency))                                       \
+        : request(request), dependency(dependency) {}                                                                  \
+                                                                                                                       \
+    std::size_t handleRequest() {                                                                                      \
+      return request.id + dependency->server_context.server_id;                                                        \
+    }                                                                                                                  \
+  };
+
+#define EXPOSED_TYPE(N) Handler##N,
+
+// GroupRoot##G is just used to terminate the list of types. The handlers are bound automatically, through their
+// INJECT-annotated constructors.
+#define GROUP_COMPONENT(G)                                                                                             \
+  struct GroupRoot##G {                                                                                                \
+    INJECT(GroupRoot##G()) = default;                                                                                  \
+  };                                                                                                                   \
+                                                                                                                       \
+  fruit::Component<fruit::Required<Request, ServerContext>, REPEAT_IN_GROUP(EXPOSED_TYPE, G) GroupRoot##G>             \
+  getHandlersComponent##G() {                                                                                          \
+    return fruit::createComponent();                                                                                   \
+  }
+
+#define INSTALL_GROUP_COMPONENT(G) .install(getHandlersComponent##G)
+
+#define HANDLE_REQUEST_FUNCTION(N)                                                                                     \
+  [](RequestInjector& injector) -> std::size_t { return injector.get<Handler##N*>()->handleRequest(); },
+
+EVAL(REPEAT(DEFINITIONS))
+
+using RequestDispatcherComponent = fruit::Component<fruit::Required<Request>, EVAL(REPEAT(EXPOSED_TYPE)) ServerContext>;
+using RequestDispatcherNormalizedComponent =
+    fruit::NormalizedComponent<fruit::Required<Request>, EVAL(REPEAT(EXPOSED_TYPE)) ServerContext>;
+using RequestInjector = fruit::Injector<EVAL(REPEAT(EXPOSED_TYPE)) ServerContext>;
+
+EVAL(REPEAT_GROUPS(GROUP_COMPONENT))
+
+RequestDispatcherComponent getRequestDispatcherComponent(ServerContext* server_context) {
+  return fruit::createComponent() EVAL(REPEAT_GROUPS(INSTALL_GROUP_COMPONENT)).bindInstance(*server_context);
+}
+
+fruit::Component<Request> getRequestComponent(Request* request, std::vector<RequestListener>* request_listeners) {
+  return fruit::createComponent().bindInstance(*request).addInstanceMultibindings(*request_listeners);
+}
+
+namespace {
+
+constexpr std::size_t num_handlers = MULTIPLIER;
+
+// These allow to use the i-th handler (chosen at run-time).
+using HandleRequestFunction = std::size_t (*)(RequestInjector&);
+const HandleRequestFunction handle_request_functions[] = {EVAL(REPEAT(HANDLE_REQUEST_FUNCTION))};
+
+// This is printed at the end, so that the compiler can't optimize out the operations under benchmark.
+std::atomic<std::size_t> checksum{0};
+
+double secondsBetween(Clock::time_point start_time, Clock::time_point end_time) {
+  return std::chrono::duration_cast<std::chrono::duration<double>>(end_time - start_time).count();
+}
+
+// The metrics collected by each thread of the pool.
+struct WorkerStats {
+  double injector_construction_time = 0;
+  double request_time = 0;
+  std::size_t num_allocations = 0;
+};
+
+struct Server {
+  Server(const RequestDispatcherNormalizedComponent& normalized_component, const std::vector<Request>& requests,
+         std::size_t num_request_bindings, std::size_t num_touched_handlers)
+      : normalized_component(normalized_component), requests(requests), num_request_bindings(num_request_bindings),
+        num_touched_handlers(num_touched_handlers) {}
+
+  const RequestDispatcherNormalizedComponent& normalized_component;
+  const std::vector<Request>& requests;
+  std::size_t num_request_bindings;
+  std::size_t num_touched_handlers;
+
+  // The index of the next request to handle.
+  std::atomic<std::size_t> next_request_index{0};
+
+  void workerThreadMain(WorkerStats& stats) {
+    // The objects bound by the request components are reused across requests, so that they don't count as allocations.
+    std::vector<RequestListener> request_listeners(num_request_bindings);
+    std::size_t result = 0;
+    while (true) {
+      std::size_t request_index = next_request_index++;
+      if (request_index >= requests.size()) {
+        break;
+      }
+      Request request = requests[request_index];
+
+      std::size_t num_allocations_before_request = num_allocations;
+      Clock::time_point start_time = Clock::now();
+      {
+        RequestInjector injector(normalized_component, getRequestComponent, &request, &request_listeners);
+        stats.injector_construction_time += secondsBetween(start_time, Clock::now());
+
+        for (std::size_t i = 0; i < num_touched_handlers; ++i) {
+          result += handle_request_functions[(request.first_handler_index + i) % num_handlers](injector);
+        }
+        for (RequestListener* request_listener : injector.getMultibindings<RequestListener>()) {
+          result += request_listener->id;
+        }
+      }
+      stats.request_time += secondsBetween(start_time, Clock::now());
+      stats.num_allocations += num_allocations - num_allocations_before_request;
+    }
+    checksum += result;
+  }
+};
+
+} // namespace
+
+int main(int argc, const char* argv[]) {
+  if (argc != 5) {
+    std::cout << "Error: you need to specify the number of threads, the number of request bindings, the number of "
+                 "handlers used by each request and the number of requests as arguments."
+              << std::endl;
+    return 1;
+  }
+  std::size_t num_threads = std::atoi(argv[1]);
+  std::size_t num_request_bindings = std::atoi(argv[2]);
+  std::size_t num_touched_handlers = std::min<std::size_t>(std::atoi(argv[3]), num_handlers);
+  std::size_t num_requests = std::atoi(argv[4]);
+
+  std::cout << std::fixed;
+  std::cout << std::setprecision(15);
+
+  // The requests are generated upfront, so that generating them doesn't affect the metrics.
+  std::vector<Request> requests;
+  std::default_random_engine random_engine(42);
+  std::uniform_int_distribution<std::size_t> handler_index_distribution(0, num_handlers - 1);
+  for (std::size_t i = 0; i < num_requests; ++i) {
+    requests.push_back(Request{i, handler_index_distribution(random_engine)});
+  }
+
+  ServerContext server_context{1};
+  Clock::time_point startup_start_time = Clock::now();
+  const RequestDispatcherNormalizedComponent normalized_component(getRequestDispatcherComponent, &server_context);
+  printMetric("Server startup time", secondsBetween(startup_start_time, Clock::now()));
+
+  Server server(normalized_component, requests, num_request_bindings, num_touched_handlers);
+  std::vector<WorkerStats> stats_by_thread(num_threads);
+  std::vector<std::thread> threads;
+  Clock::time_point start_time = Clock::now();
+  for (std::size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back(&Server::workerThreadMain, &server, std::ref(stats_by_thread[i]));
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  double total_time = secondsBetween(start_time, Clock::now());
+
+  WorkerStats stats;
+  for (const WorkerStats& thread_stats : stats_by_thread) {
+    stats.injector_construction_time += thread_stats.injector_construction_time;
+    stats.request_time += thread_stats.request_time;
+    stats.num_allocations += thread_stats.num_allocations;
+  }
+  printMetric("Requests per second", num_requests / total_time);
+  printMetric("Request handling time", stats.request_time / num_requests);
+  printMetric("Injector construction time", stats.injector_construction_time / num_requests);
+  printMetric("Allocations per request", double(stats.num_allocations) / num_requests);
+
+  // This goes to stderr, so run_benchmarks.py ignores it.
+  std::cerr << "Checksum: " << checksum << std::endl;
+
+  return 0;
+}
@@ -144,8 +144,9 @@ def add_bazel_tests(ubuntu_version, smoke_tests=[]):
 
 
 # TODO: re-enable ASan/UBSan once they work in Travis CI. ATM (as of 18 November 2017) they fail due to https://github.com/google/sanitizers/issues/837
+# DebugMemoryPool is the only configuration that tests FRUIT_ALLOCATE_COMPONENTS_IN_MEMORY_POOL.
 add_ubuntu_tests(ubuntu_version='19.04', compiler='gcc-9', asan=False, ubsan=False,
-                 smoke_tests=['DebugPlain', 'ReleasePlain'])
+                 smoke_tests=['DebugPlain', 'DebugMemoryPool', 'ReleasePlain'])
 add_ubuntu_tests(ubuntu_version='19.04', compiler='clang-6.0', stl='libstdc++',
                  smoke_tests=['DebugPlain', 'DebugAsanUbsan', 'ReleasePlain'])
 add_ubuntu_tests(ubuntu_version='19.04', compiler='clang-8.0', stl='libstdc++',
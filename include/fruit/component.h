@@ -510,6 +510,72 @@ public:
   PartialComponent<fruit::impl::RegisterProvider<AnnotatedSignature, Lambda>, Bindings...>
   registerProvider(Lambda lambda);
 
+  /**
+   * Similar to registerProvider(), but `provider' returns a std::future<C> or a std::future<C*> instead, e.g. because
+   * constructing a C requires some I/O. This is useful when the injector has to construct multiple such objects.
+   *
+   * When the injector needs to construct an object, it first calls the async providers of all the (not yet constructed)
+   * types in the dependencies of that object (transitively). An async provider is called once its own dependencies are
+   * constructed; this is the case for all of them if they don't depend on other async providers. The injector then
+   * constructs the object and its dependencies as usual, waiting for the result of each async provider only when an
+   * object that depends on it is constructed. So the asynchronous operations that don't depend on each other run
+   * concurrently.
+   *
+   * Example:
+   *
+   * fruit::Component<Foo> getFooComponent() {
+   *   return fruit::createComponent()
+   *       .install(getModelComponent)
+   *       .install(getConnectionComponent)
+   *       .registerProvider([](Model* model, Connection* connection) {
+   *          return Foo(model, connection);
+   *       });
+   * }
+   *
+   * fruit::Component<Model> getModelComponent() {
+   *   return fruit::createComponent()
+   *       .install(getConfigComponent)
+   *       .registerAsyncProvider([](Config* config) {
+   *          return std::async(std::launch::async, [config]() {
+   *            return Model::loadFromFile(config->model_path);
+   *          });
+   *       });
+   * }
+   *
+   * Here, if Connection is also bound with registerAsyncProvider(), the injector starts both the model loading and the
+   * connection when a Foo is first needed, and then waits for both.
+   *
+   * Note that the future must not access the injector, and that the injector keeps its lock while it waits for a
+   * future, so other threads using the same injector wait too. The objects injected in the provider (e.g. `config'
+   * above) are owned by the injector, so they can be used by the future.
+   * A dependency injected as a fruit::Provider counts as a dependency here too, so its async provider might be called
+   * even if the object is never constructed; in that case the future is destroyed (without calling get()) when the
+   * injector is destroyed, before the other objects in the injector.
+   * If the future throws an exception, the exception is propagated out of the Injector::get() call that needed the
+   * object. In that case the object (and the objects that depend on it) can't be injected later.
+   */
+  template <typename Lambda>
+  PartialComponent<fruit::impl::RegisterAsyncProvider<Lambda>, Bindings...> registerAsyncProvider(Lambda lambda);
+
+  /**
+   * Similar to the previous version of registerAsyncProvider(), but allows to specify an annotated signature, as in the
+   * 2-argument version of registerProvider(). The return type in the signature is a (possibly annotated)
+   * std::future<C> or std::future<C*>, e.g.:
+   *
+   * fruit::Component<fruit::Annotated<Annotation1, Model>> getModelComponent() {
+   *   return fruit::createComponent()
+   *       .install(getConfigComponent)
+   *       .registerAsyncProvider<fruit::Annotated<Annotation1, std::future<Model>>(Config*)>([](Config* config) {
+   *          return std::async(std::launch::async, [config]() {
+   *            return Model::loadFromFile(config->model_path);
+   *          });
+   *       });
+   * }
+   */
+  template <typename AnnotatedSignature, typename Lambda>
+  PartialComponent<fruit::impl::RegisterAsyncProvider<AnnotatedSignature, Lambda>, Bindings...>
+  registerAsyncProvider(Lambda lambda);
+
   /**
    * Similar to bind<I, C>(), but adds a multibinding instead.
    *
@@ -531,6 +597,33 @@ public:
   template <typename I, typename C>
   PartialComponent<fruit::impl::AddMultibinding<I, C>, Bindings...> addMultibinding();
 
+  /**
+   * Similar to addMultibinding<I, C>(), but the multibinding is associated with `key'. Keyed multibindings are
+   * retrieved with the getKeyedMultibindings<K, I>() method of the injector, that returns a map from the keys to the
+   * (lazily constructed) objects. They are not returned by getMultibindings<I>(), and they are not constructed by the
+   * injector's eagerlyInjectAll() and prefetchAll() (unless something else depends on them).
+   *
+   * K must be copyable, it must be comparable with operator== and std::hash<K> must be defined (e.g. std::string or
+   * int). The key is copied into storage that is never freed (once for each distinct keyed multibinding, no matter how
+   * many times it's added), so keys should come from a bounded set, e.g. the paths served by a server.
+   *
+   * Adding the same keyed multibinding more than once (e.g. in different components) is allowed and it's only added
+   * once. Two different keyed multibindings for the same I with the same key are a fatal error when the injector's
+   * getKeyedMultibindings() is called.
+   *
+   * Example use:
+   *
+   * fruit::Component<> getRequestHandlersComponent() {
+   *   return fruit::createComponent()
+   *       .addKeyedMultibinding<std::string, RequestHandler, FooHandler>("/foo")
+   *       .addKeyedMultibinding<std::string, RequestHandler, BarHandler>("/bar");
+   * }
+   *
+   * As bind(), this supports annotated injection, just wrap I and/or C in fruit::Annotated<> if desired.
+   */
+  template <typename K, typename I, typename C>
+  PartialComponent<fruit::impl::AddKeyedMultibinding<K, I, C>, Bindings...> addKeyedMultibinding(const K& key);
+
   /**
    * Similar to bindInstance(), but adds a multibinding instead.
    *
@@ -758,6 +851,14 @@ public:
    * The parameters marked as Assisted will become parameters of the std::function (in the same order), while the others
    * (e.g. Foo in the example above) will be injected.
    *
+   * This also binds fruit::Factory<std::unique_ptr<MyClass>(int)>, that can be injected instead of the std::function.
+   * Copying or calling a Factory never allocates memory, so prefer it when the factory is called very often (see
+   * Factory for details).
+   * Note that the std::function contains a copy of the injected parameters (references still refer to the objects in
+   * the injector), so it can be called after the injector is destroyed as long as those parameters are still valid.
+   * A Factory instead points to an object owned by the injector, so it must not be called after the injector is
+   * destroyed.
+   *
    * Unlike registerProvider(), where the signature is inferred, for this method the signature (including any Assisted
    * annotations) must be specified explicitly, while the second template parameter is inferred.
    *
@@ -811,6 +912,71 @@ public:
   PartialComponent<fruit::impl::RegisterFactory<DecoratedSignature, Factory>, Bindings...>
   registerFactory(Factory factory);
 
+  /**
+   * Registers a factory of fruit::Pooled<C> objects, that constructs C with the constructor with the specified
+   * signature, in memory taken from the fruit::ObjectPool<C> of the injector.
+   * This is useful for objects that are created and destroyed at a high rate (e.g. one or more per request), since most
+   * of them will then reuse the memory of previously destroyed objects instead of allocating.
+   *
+   * As with registerFactory(), the parameters marked as Assisted become parameters of the factory while the others are
+   * injected. For example:
+   *
+   * class MyClass {
+   * public:
+   *   MyClass(Foo* foo, int n) {...}
+   * };
+   *
+   * Component<fruit::Factory<fruit::Pooled<MyClass>(int)>> getMyClassComponent() {
+   *   return fruit::createComponent()
+   *       ... // Bind Foo
+   *       .registerPooledFactory<MyClass(Foo*, Assisted<int>)>();
+   * }
+   *
+   * Injector<fruit::Factory<fruit::Pooled<MyClass>(int)>> injector(getMyClassComponent);
+   * fruit::Factory<fruit::Pooled<MyClass>(int)> factory(injector);
+   * fruit::Pooled<MyClass> x = factory(42);
+   *
+   * This binds both fruit::Factory<fruit::Pooled<MyClass>(int)> and std::function<fruit::Pooled<MyClass>(int)>.
+   * The pool itself (fruit::ObjectPool<MyClass>) is constructed by the injector with the default maximum size, unless
+   * it's bound explicitly (e.g. to use a different size). It can also be injected, e.g. to get its statistics.
+   *
+   * A fruit::Pooled<MyClass> is a std::unique_ptr with a custom deleter, and it must be destroyed before the injector.
+   */
+  template <typename DecoratedSignature>
+  PartialComponent<fruit::impl::RegisterPooledFactory<DecoratedSignature>, Bindings...> registerPooledFactory();
+
+  /**
+   * Registers a factory of MyClass* objects, that constructs MyClass with the constructor with the specified signature,
+   * in an arena owned by the injector.
+   * The objects are never destroyed individually: they are all destroyed when the injector is destroyed (before the
+   * other objects in the injector, so they can depend on them). So this is useful for objects whose lifetime is tied to
+   * the injector, e.g. the objects created while handling a request with a per-request injector, since they don't need
+   * an allocation and a deallocation each.
+   *
+   * As with registerFactory(), the parameters marked as Assisted become parameters of the factory while the others are
+   * injected. For example:
+   *
+   * class MyClass {
+   * public:
+   *   MyClass(Foo* foo, int n) {...}
+   * };
+   *
+   * Component<fruit::Factory<MyClass*(int)>> getMyClassComponent() {
+   *   return fruit::createComponent()
+   *       ... // Bind Foo
+   *       .registerArenaFactory<MyClass(Foo*, Assisted<int>)>();
+   * }
+   *
+   * Injector<fruit::Factory<MyClass*(int)>> injector(getMyClassComponent);
+   * fruit::Factory<MyClass*(int)> factory(injector);
+   * MyClass* x = factory(42);
+   *
+   * This binds both fruit::Factory<MyClass*(int)> and std::function<MyClass*(int)>.
+   * The memory used by the arena is reported in Injector::getMemoryUsage().
+   */
+  template <typename DecoratedSignature>
+  PartialComponent<fruit::impl::RegisterArenaFactory<DecoratedSignature>, Bindings...> registerArenaFactory();
+
   /**
    * Adds the bindings (and multibindings) in the Component obtained by calling fun(args...) to the current component.
    *
@@ -834,6 +1000,9 @@ public:
    * - Equality comparable (i.e., operator== must be defined for two values of that type)
    * - Hashable (i.e., std::hash must be defined for values of that type)
    *
+   * For types that are expensive to hash or compare, fruit::ComponentArgKey can be specialized so that Fruit hashes and
+   * compares a cheaper key instead; in that case the requirements above apply to the key instead of the arg.
+   *
    * Note that this only applies to `args`. E.g. in the example above `int` and `std::string` must satisfy this
    * requirement (and they do), but `Foo` and `Bar` don't need to.
    *
@@ -891,6 +1060,46 @@ public:
   PartialComponent<fruit::impl::InstallComponent<fruit::Component<OtherComponentParams...>(FormalArgs...)>, Bindings...>
   install(fruit::Component<OtherComponentParams...> (*)(FormalArgs...), Args&&... args);
 
+  /**
+   * Similar to install(), but the component function is not called (and its bindings are not processed) when the
+   * injector is created. Instead, the types provided by the installed component are registered as placeholders, and the
+   * component is expanded the first time that one of them is injected (e.g. with get<>() or through a Provider).
+   * This can reduce the injector creation time when a large sub-component is only needed in some executions.
+   *
+   * Example usage:
+   *
+   * fruit::Component<fruit::Required<Foo>, Bar> getBarComponent() {...}
+   *
+   * fruit::Component<Foo, Bar> getFooBarComponent() {
+   *   return fruit::createComponent()
+   *      .installLazily(getBarComponent)
+   *      .bind<Foo, FooImpl>();
+   * }
+   *
+   * fruit::Injector<Foo, Bar> injector(getFooBarComponent);
+   * Foo* foo = injector.get<Foo*>(); // getBarComponent() hasn't been called yet.
+   * Bar* bar = injector.get<Bar*>(); // This calls getBarComponent().
+   *
+   * The expansion happens at most once for each injector, even if multiple threads inject the provided types
+   * concurrently. The types required by the lazily-installed component are injected from the enclosing injector at that
+   * point.
+   *
+   * The lazily-installed component is normalized separately from the enclosing component, so:
+   * - Its multibindings are not visible in the enclosing injector.
+   * - Component replacements (see replace()) in the enclosing component don't affect it.
+   * - The components that it installs (and the types that they bind) are separate from the ones in the enclosing
+   *   component, so they must not bind any type that's also bound in the enclosing component (except the types that
+   *   it declares as Required<>).
+   * - It can't be installed both with install() and installLazily() in the same injector, and two lazily-installed
+   *   components can't provide the same type.
+   *
+   * The requirements on `args` are the same as in install().
+   */
+  template <typename... OtherComponentParams, typename... FormalArgs, typename... Args>
+  PartialComponent<fruit::impl::InstallComponentLazily<fruit::Component<OtherComponentParams...>(FormalArgs...)>,
+                   Bindings...>
+  installLazily(fruit::Component<OtherComponentParams...> (*)(FormalArgs...), Args&&... args);
+
   /**
    * Similar to install(), but allows to install a variable number of component functions instead of just 1. This
    * additional flexibility is sometimes useful in templated `get*Component` functions and for other advanced use-cases.
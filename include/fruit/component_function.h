@@ -21,6 +21,32 @@
 
 namespace fruit {
 
+/**
+ * Fruit de-duplicates the installation of component functions with the same args (see PartialComponent::install()), so
+ * it needs to hash and compare those args. By default this is done with std::hash and operator== on the args
+ * themselves. For arg types that are expensive to hash or compare (e.g. large configuration objects), this template
+ * can be specialized to return a cheaper key that identifies the arg, and that will be hashed and compared instead.
+ * For example:
+ *
+ * namespace fruit {
+ * template <>
+ * struct ComponentArgKey<MyConfig> {
+ *   int operator()(const MyConfig& config) const {
+ *     return config.id;
+ *   }
+ * };
+ * }
+ *
+ * Two args with equal keys are considered equal, so the key must uniquely identify the value of the arg.
+ * The hash of each installed component is computed once, when the install() call is executed.
+ */
+template <typename T>
+struct ComponentArgKey {
+  const T& operator()(const T& arg) const {
+    return arg;
+  }
+};
+
 /**
  * See fruit::componentFunction() helper for how to construct a ComponentFunction, and see
  * PartialComponent::installComponentFunctions() for more information on using ComponentFunction objects.
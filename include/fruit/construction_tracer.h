@@ -0,0 +1,150 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_CONSTRUCTION_TRACER_H
+#define FRUIT_CONSTRUCTION_TRACER_H
+
+#include <fruit/impl/fruit_internal_forward_decls.h>
+#include <fruit/impl/util/type_info.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fruit {
+
+/**
+ * A ConstructionTracer records when each injected object is constructed, to find out where the time goes when
+ * injecting a large object graph.
+ *
+ * Example usage:
+ *
+ * fruit::ConstructionTracer tracer;
+ * fruit::Injector<Foo> injector(getFooComponent);
+ * injector.setConstructionTracer(&tracer);
+ * Foo* foo = injector.get<Foo*>();
+ * std::ofstream out("trace.json");
+ * tracer.writeChromeTraceJson(out);
+ *
+ * The resulting file can be opened with Perfetto (https://ui.perfetto.dev) or with chrome://tracing.
+ *
+ * Each event covers a call to the provider/constructor of a type, including the construction of any dependencies that
+ * weren't already constructed; those are recorded as separate, nested, events.
+ * A ConstructionTracer can be shared by multiple injectors and can be used concurrently by multiple threads.
+ *
+ * When no tracer is set, injectors don't record anything, and the only overhead is a null check when an object is
+ * constructed (not when an already-constructed object is returned).
+ */
+class ConstructionTracer {
+public:
+  struct Event {
+    // The name of the constructed type.
+    std::string type_name;
+
+    // True if the constructed object was a multibinding for `type_name', false if it was a binding.
+    bool is_multibinding;
+
+    // The start and end time of the construction, in nanoseconds since this tracer was created.
+    std::uint64_t start_ns;
+    std::uint64_t end_ns;
+
+    // Identifies the thread that constructed the object. Threads are numbered 0, 1, 2, ... in the order in which they
+    // first appear in the events.
+    std::size_t thread_index;
+
+    // The number of traced constructions that were in progress in the same thread when this one started, e.g. 0 for an
+    // object constructed directly by Injector::get() and 1 for the dependencies constructed to inject it.
+    std::size_t depth;
+  };
+
+  ConstructionTracer();
+
+  ConstructionTracer(const ConstructionTracer&) = delete;
+  ConstructionTracer& operator=(const ConstructionTracer&) = delete;
+
+  /**
+   * Returns the events recorded so far, in order of completion (so nested events come before the enclosing one).
+   */
+  std::vector<Event> getEvents() const;
+
+  /**
+   * Discards the events recorded so far.
+   */
+  void clear();
+
+  /**
+   * Writes the events recorded so far in the Chrome trace-event JSON format.
+   */
+  void writeChromeTraceJson(std::ostream& os) const;
+
+private:
+  struct Record {
+    fruit::impl::TypeId type;
+    bool is_multibinding;
+    std::uint64_t start_ns;
+    std::uint64_t end_ns;
+    std::thread::id thread_id;
+    std::size_t depth;
+  };
+
+  std::chrono::steady_clock::time_point creation_time;
+
+  // Protects the fields below.
+  mutable std::mutex mutex;
+
+  std::vector<Record> records;
+
+  // Returns the current time (in ns since this tracer was created) and increments the nesting depth of the current
+  // thread. Must be followed by a call to endConstruction() from the same thread.
+  std::uint64_t beginConstruction();
+
+  // Returns the duration of the construction, excluding the nested constructions traced in the same thread.
+  std::uint64_t endConstruction(fruit::impl::TypeId type, bool is_multibinding, std::uint64_t start_ns);
+
+  // Used instead of endConstruction() when the construction threw an exception; nothing is recorded.
+  void abortConstruction();
+
+  // Calls beginConstruction() on construction and endConstruction() in end(). If end() isn't called because the
+  // construction threw, the destructor calls abortConstruction() so that the nesting depth of the thread stays correct.
+  class ConstructionScope {
+  public:
+    explicit ConstructionScope(ConstructionTracer* tracer);
+    ~ConstructionScope();
+
+    ConstructionScope(const ConstructionScope&) = delete;
+    ConstructionScope& operator=(const ConstructionScope&) = delete;
+
+    std::uint64_t end(fruit::impl::TypeId type, bool is_multibinding);
+
+  private:
+    ConstructionTracer* tracer;
+    std::uint64_t start_ns;
+    bool ended = false;
+  };
+
+  // Computes the thread_index of each record, assigning indexes in order of first use.
+  std::vector<Event> getEventsLocked() const;
+
+  friend class fruit::impl::InjectorStorage;
+};
+
+} // namespace fruit
+
+#endif // FRUIT_CONSTRUCTION_TRACER_H
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_FACTORY_H
+#define FRUIT_FACTORY_H
+
+#include <fruit/fruit_forward_decls.h>
+#include <fruit/impl/fruit_internal_forward_decls.h>
+
+namespace fruit {
+
+/**
+ * A Factory<C(Args...)> is a callable object that constructs instances of C using some user-provided arguments of types
+ * Args... (see PartialComponent::registerFactory() for details on assisted injection).
+ * Whenever a std::function<C(Args...)> is bound (with registerFactory() or with an ASSISTED() parameter in an INJECT()
+ * constructor), Factory<C(Args...)> is bound too, and it can be injected instead of the std::function.
+ * For example:
+ *
+ * class Foo {
+ * public:
+ *   INJECT(Foo(Bar* bar, ASSISTED(int) n));
+ * };
+ *
+ * class Server {
+ * private:
+ *   fruit::Factory<Foo(int)> fooFactory;
+ *
+ * public:
+ *   INJECT(Server(fruit::Factory<Foo(int)> fooFactory))
+ *   : fooFactory(fooFactory) {
+ *   }
+ *
+ *   void handleRequest(int n) {
+ *     Foo foo = fooFactory(n);
+ *     ...
+ *   }
+ * };
+ *
+ * The injected dependencies of the factory (Bar* in the example above) are stored once in the injector, and a Factory
+ * only contains a pointer to them and a pointer to the function that constructs C. So, unlike std::function, copying a
+ * Factory never allocates memory and calling it doesn't involve any type-erased dispatch besides that function pointer.
+ *
+ * A Factory must not be called after the injector that created it has been destroyed.
+ */
+template <typename C, typename... Args>
+class Factory<C(Args...)> {
+public:
+  /**
+   * Constructs an instance of C, using `args' for the assisted parameters and the objects stored in the injector for
+   * the other ones.
+   */
+  C operator()(Args... args) const;
+
+private:
+  using Invoker = C (*)(void* state, Args... args);
+
+  // This is never nullptr.
+  Invoker invoker;
+
+  // The injected dependencies of the factory. This is owned by the injector, not by the factory object.
+  // This is never nullptr.
+  void* state;
+
+  Factory(Invoker invoker, void* state);
+
+  friend struct fruit::impl::meta::RegisterFactoryHelper;
+};
+
+} // namespace fruit
+
+#include <fruit/impl/factory.defn.h>
+
+#endif // FRUIT_FACTORY_H
@@ -26,10 +26,19 @@
 
 #include <fruit/component.h>
 #include <fruit/component_function.h>
+#include <fruit/construction_tracer.h>
+#include <fruit/factory.h>
 #include <fruit/fruit_forward_decls.h>
 #include <fruit/injector.h>
+#include <fruit/injector_graph.h>
+#include <fruit/injector_stats.h>
+#include <fruit/keyed_multibindings.h>
 #include <fruit/macro.h>
+#include <fruit/memory_usage.h>
+#include <fruit/multibinding_provider.h>
 #include <fruit/normalized_component.h>
+#include <fruit/object_pool.h>
 #include <fruit/provider.h>
+#include <fruit/teardown_policy.h>
 
 #endif // FRUIT_FRUIT_H
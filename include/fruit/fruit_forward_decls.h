@@ -57,12 +57,45 @@ class NormalizedComponent;
 template <typename C>
 class Provider;
 
+template <typename C>
+class MultibindingProvider;
+
+template <typename K, typename C>
+class KeyedMultibindings;
+
+template <typename Signature>
+class Factory;
+
+template <typename C>
+class ObjectPool;
+
+struct ObjectPoolStats;
+
 template <typename... P>
 class Injector;
 
 template <typename ComponentType, typename... ComponentFunctionArgs>
 class ComponentFunction;
 
+class ConstructionTracer;
+
+struct NormalizationStats;
+
+struct InjectorStats;
+struct LookupStats;
+
+struct MemoryUsage;
+
+struct InjectorGraph;
+
+enum class TeardownPolicy;
+
+template <typename C>
+struct LeakOnExit;
+
+template <typename C>
+struct HoldsExternalResources;
+
 } // namespace fruit
 
 #endif // FRUIT_FRUIT_FORWARD_DECLS_H
@@ -72,6 +72,23 @@ struct RegisterProvider<Lambda> {};
 template <typename AnnotatedSignature, typename Lambda>
 struct RegisterProvider<Lambda, AnnotatedSignature> {};
 
+template <typename... Params>
+struct RegisterAsyncProvider;
+
+/**
+ * Registers `provider' as an asynchronous provider of C, where provider is a lambda with no captures returning either
+ * std::future<C> or std::future<C*>.
+ */
+template <typename Lambda>
+struct RegisterAsyncProvider<Lambda> {};
+
+/**
+ * Registers `provider' as an asynchronous provider of C, where provider is a lambda with no captures returning either
+ * std::future<C> or std::future<C*>. Lambda must have the signature AnnotatedSignature (ignoring annotations).
+ */
+template <typename AnnotatedSignature, typename Lambda>
+struct RegisterAsyncProvider<AnnotatedSignature, Lambda> {};
+
 /**
  * Adds a multibinding for an instance (as a C&).
  */
@@ -90,6 +107,14 @@ struct AddInstanceVectorMultibindings {};
 template <typename I, typename C>
 struct AddMultibinding {};
 
+/**
+ * Similar to AddMultibinding<I, C>, but the multibinding is associated with a key of type K and it can only be
+ * retrieved by key (see Injector::getKeyedMultibindings()).
+ * NOTE: for this binding, the runtime binding is added in advance.
+ */
+template <typename K, typename I, typename C>
+struct AddKeyedMultibinding {};
+
 template <typename... Params>
 struct AddMultibindingProvider;
 
@@ -115,6 +140,21 @@ struct AddMultibindingProvider<AnnotatedSignature, Lambda> {};
 template <typename DecoratedSignature, typename Lambda>
 struct RegisterFactory {};
 
+/**
+ * Registers a factory of fruit::Pooled<C> that constructs C with the constructor with signature DecoratedSignature
+ * (ignoring any fruit::Annotated<> and fruit::Assisted<>), in memory taken from the fruit::ObjectPool<C> in the
+ * injector.
+ */
+template <typename DecoratedSignature>
+struct RegisterPooledFactory {};
+
+/**
+ * Registers a factory of C* that constructs C with the constructor with signature DecoratedSignature (ignoring any
+ * fruit::Annotated<> and fruit::Assisted<>), in the arena of the injector.
+ */
+template <typename DecoratedSignature>
+struct RegisterArenaFactory {};
+
 /**
  * Adds the bindings (and multibindings) in `component' to the current component.
  * OtherComponent must be of the form Component<...>.
@@ -123,6 +163,13 @@ struct RegisterFactory {};
 template <typename GetComponentFunction>
 struct InstallComponent {};
 
+/**
+ * Similar to InstallComponent, but the component is only expanded when one of the types that it provides is first
+ * injected. See PartialComponent::installLazily().
+ */
+template <typename GetComponentFunction>
+struct InstallComponentLazily {};
+
 /**
  * Installs all the specified ComponentFunction objects.
  */
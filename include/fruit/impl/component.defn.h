@@ -61,7 +61,7 @@ inline Component<Params...>::Component(PartialComponent<Bindings...>&& partial_c
 #endif // !FRUIT_NO_LOOP_CHECK
 
   std::size_t num_entries = partial_component.storage.numBindings() + Op().numEntries();
-  fruit::impl::FixedSizeVector<fruit::impl::ComponentStorageEntry> entries(num_entries);
+  fruit::impl::ComponentStorageEntryVector entries(num_entries);
 
   Op()(entries);
 
@@ -157,6 +157,24 @@ PartialComponent<Bindings...>::registerProvider(Lambda) {
   return {{storage}};
 }
 
+template <typename... Bindings>
+template <typename Lambda>
+inline PartialComponent<fruit::impl::RegisterAsyncProvider<Lambda>, Bindings...>
+PartialComponent<Bindings...>::registerAsyncProvider(Lambda) {
+  using Op = OpFor<fruit::impl::RegisterAsyncProvider<Lambda>>;
+  (void)typename fruit::impl::meta::CheckIfError<Op>::type();
+  return {{storage}};
+}
+
+template <typename... Bindings>
+template <typename AnnotatedSignature, typename Lambda>
+inline PartialComponent<fruit::impl::RegisterAsyncProvider<AnnotatedSignature, Lambda>, Bindings...>
+PartialComponent<Bindings...>::registerAsyncProvider(Lambda) {
+  using Op = OpFor<fruit::impl::RegisterAsyncProvider<AnnotatedSignature, Lambda>>;
+  (void)typename fruit::impl::meta::CheckIfError<Op>::type();
+  return {{storage}};
+}
+
 template <typename... Bindings>
 template <typename AnnotatedI, typename AnnotatedC>
 inline PartialComponent<fruit::impl::AddMultibinding<AnnotatedI, AnnotatedC>, Bindings...>
@@ -167,6 +185,16 @@ PartialComponent<Bindings...>::addMultibinding() {
   return {{storage}};
 }
 
+template <typename... Bindings>
+template <typename K, typename AnnotatedI, typename AnnotatedC>
+inline PartialComponent<fruit::impl::AddKeyedMultibinding<K, AnnotatedI, AnnotatedC>, Bindings...>
+PartialComponent<Bindings...>::addKeyedMultibinding(const K& key) {
+  using Op = OpFor<fruit::impl::AddKeyedMultibinding<K, AnnotatedI, AnnotatedC>>;
+  (void)typename fruit::impl::meta::CheckIfError<Op>::type();
+
+  return {{storage, key}};
+}
+
 template <typename... Bindings>
 template <typename C>
 inline PartialComponent<fruit::impl::AddInstanceMultibinding<C>, Bindings...>
@@ -239,6 +267,26 @@ PartialComponent<Bindings...>::registerFactory(Lambda) {
   return {{storage}};
 }
 
+template <typename... Bindings>
+template <typename DecoratedSignature>
+inline PartialComponent<fruit::impl::RegisterPooledFactory<DecoratedSignature>, Bindings...>
+PartialComponent<Bindings...>::registerPooledFactory() {
+  using Op = OpFor<fruit::impl::RegisterPooledFactory<DecoratedSignature>>;
+  (void)typename fruit::impl::meta::CheckIfError<Op>::type();
+
+  return {{storage}};
+}
+
+template <typename... Bindings>
+template <typename DecoratedSignature>
+inline PartialComponent<fruit::impl::RegisterArenaFactory<DecoratedSignature>, Bindings...>
+PartialComponent<Bindings...>::registerArenaFactory() {
+  using Op = OpFor<fruit::impl::RegisterArenaFactory<DecoratedSignature>>;
+  (void)typename fruit::impl::meta::CheckIfError<Op>::type();
+
+  return {{storage}};
+}
+
 template <typename... Bindings>
 inline PartialComponent<Bindings...>::PartialComponent(fruit::impl::PartialComponentStorage<Bindings...> storage)
     : storage(std::move(storage)) {}
@@ -260,6 +308,23 @@ PartialComponent<Bindings...>::install(fruit::Component<OtherComponentParams...>
   return {{storage, getComponent, std::move(args_tuple)}};
 }
 
+template <typename... Bindings>
+template <typename... OtherComponentParams, typename... FormalArgs, typename... Args>
+inline PartialComponent<
+    fruit::impl::InstallComponentLazily<fruit::Component<OtherComponentParams...>(FormalArgs...)>, Bindings...>
+PartialComponent<Bindings...>::installLazily(
+    fruit::Component<OtherComponentParams...> (*getComponent)(FormalArgs...), Args&&... args) {
+  using IntCollector = int[];
+  (void)IntCollector{0, fruit::impl::checkAcceptableComponentInstallArg<FormalArgs>()...};
+
+  using Op = OpFor<fruit::impl::InstallComponentLazily<fruit::Component<OtherComponentParams...>(FormalArgs...)>>;
+  (void)typename fruit::impl::meta::CheckIfError<Op>::type();
+
+  std::tuple<FormalArgs...> args_tuple{std::forward<Args>(args)...};
+
+  return {{storage, getComponent, std::move(args_tuple)}};
+}
+
 template <typename... Bindings>
 template <typename... ComponentFunctions>
 inline PartialComponent<fruit::impl::InstallComponentFunctions<ComponentFunctions...>, Bindings...>
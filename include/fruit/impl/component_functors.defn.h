@@ -18,24 +18,36 @@
 #define FRUIT_COMPONENT_FUNCTORS_DEFN_H
 
 #include <fruit/component.h>
+#include <fruit/factory.h>
+#include <fruit/object_pool.h>
 
 #include <fruit/impl/injection_debug_errors.h>
 #include <fruit/impl/injection_errors.h>
 #include <fruit/impl/injector/injector_storage.h>
 
+#include <future>
 #include <memory>
+#include <tuple>
 
 /*********************************************************************************************************************************
   This file contains functors that take a Comp and return a struct Op with the form:
   struct {
     using Result = Comp1;
-    void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {...}
+    void operator()(ComponentStorageEntryVector& entries) {...}
     std::size_t numEntries() {...}
   }
 *********************************************************************************************************************************/
 
 namespace fruit {
 namespace impl {
+
+// The injected dependencies of the fruit::Factory objects bound by registerFactory(). There's one of these in the
+// injector for each factory binding, AnnotatedFactory and Lambda are only used to make the type unique.
+template <typename AnnotatedFactory, typename Lambda, typename... InjectedArgs>
+struct FactoryState {
+  std::tuple<InjectedArgs...> injected_args;
+};
+
 namespace meta {
 
 struct GetResult {
@@ -65,7 +77,7 @@ struct ComponentFunctorIdentity {
   struct apply {
     struct type {
       using Result = Comp;
-      void operator()(FixedSizeVector<ComponentStorageEntry>&) {}
+      void operator()(ComponentStorageEntryVector&) {}
       std::size_t numEntries() {
         return 0;
       }
@@ -83,7 +95,7 @@ struct Compose2ComponentFunctors {
         using Op2 = F2(GetResult(Op1));
         struct Op {
           using Result = Eval<GetResult(Op2)>;
-          void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+          void operator()(ComponentStorageEntryVector& entries) {
             Eval<Op2>()(entries);
             Eval<Op1>()(entries);
           }
@@ -147,7 +159,7 @@ struct AddDeferredInterfaceBinding {
       // Note that we do NOT call AddProvidedType here. We'll only know the right required type
       // when the binding will be used.
       using Result = Eval<Comp1>;
-      void operator()(FixedSizeVector<ComponentStorageEntry>&) {}
+      void operator()(ComponentStorageEntryVector&) {}
       std::size_t numEntries() {
         return 0;
       }
@@ -179,7 +191,7 @@ struct ProcessInterfaceBinding {
       // This must be here (and not in AddDeferredInterfaceBinding) because the binding might be
       // used to bind functors instead, so we might never need to add C to the requirements.
       using Result = Eval<R>;
-      void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+      void operator()(ComponentStorageEntryVector& entries) {
         entries.push_back(
             InjectorStorage::createComponentStorageEntryForConstBind<UnwrapType<AnnotatedI>, UnwrapType<AnnotatedC>>());
       };
@@ -192,7 +204,7 @@ struct ProcessInterfaceBinding {
       // This must be here (and not in AddDeferredInterfaceBinding) because the binding might be
       // used to bind functors instead, so we might never need to add C to the requirements.
       using Result = Eval<R>;
-      void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+      void operator()(ComponentStorageEntryVector& entries) {
         entries.push_back(
             InjectorStorage::createComponentStorageEntryForBind<UnwrapType<AnnotatedI>, UnwrapType<AnnotatedC>>());
       };
@@ -213,7 +225,7 @@ struct AddInterfaceMultibinding {
     using R = AddRequirements(Comp, Vector<AnnotatedC>, Vector<AnnotatedC>);
     struct Op {
       using Result = Eval<R>;
-      void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+      void operator()(ComponentStorageEntryVector& entries) {
         entries.push_back(InjectorStorage::createComponentStorageEntryForMultibinding<UnwrapType<AnnotatedI>,
                                                                                       UnwrapType<AnnotatedC>>());
         entries.push_back(
@@ -236,7 +248,7 @@ struct PostProcessRegisterProviderHelper;
 
 template <typename AnnotatedSignature, typename Lambda, typename AnnotatedI>
 struct PostProcessRegisterProviderHelper<AnnotatedSignature, Lambda, Type<AnnotatedI>> {
-  inline void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+  inline void operator()(ComponentStorageEntryVector& entries) {
     entries.push_back(
         InjectorStorage::createComponentStorageEntryForCompressedProvider<AnnotatedSignature, Lambda, AnnotatedI>());
     entries.push_back(InjectorStorage::createComponentStorageEntryForProvider<AnnotatedSignature, Lambda>());
@@ -249,7 +261,7 @@ struct PostProcessRegisterProviderHelper<AnnotatedSignature, Lambda, Type<Annota
 
 template <typename AnnotatedSignature, typename Lambda>
 struct PostProcessRegisterProviderHelper<AnnotatedSignature, Lambda, None> {
-  inline void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+  inline void operator()(ComponentStorageEntryVector& entries) {
     entries.push_back(InjectorStorage::createComponentStorageEntryForProvider<AnnotatedSignature, Lambda>());
   }
 
@@ -270,7 +282,7 @@ struct PostProcessRegisterProvider {
 
       using Helper = PostProcessRegisterProviderHelper<UnwrapType<AnnotatedSignature>, UnwrapType<Lambda>,
                                                        Eval<OptionalAnnotatedI>>;
-      void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+      void operator()(ComponentStorageEntryVector& entries) {
         Helper()(entries);
       }
       std::size_t numEntries() {
@@ -328,6 +340,88 @@ struct DeferredRegisterProvider {
   };
 };
 
+struct IsFuture {
+  template <typename T>
+  struct apply {
+    using type = Bool<false>;
+  };
+
+  template <typename T>
+  struct apply<Type<std::future<T>>> {
+    using type = Bool<true>;
+  };
+};
+
+struct RemoveFuture {
+  template <typename T>
+  struct apply {
+    using type = T;
+  };
+
+  template <typename T>
+  struct apply<Type<std::future<T>>> {
+    using type = Type<T>;
+  };
+};
+
+// The binding is not deferred (unlike registerProvider()) since async providers don't take part in binding compression.
+struct RegisterAsyncProviderWithAnnotations {
+  template <typename Comp, typename AnnotatedSignature, typename Lambda>
+  struct apply {
+    using Signature = RemoveAnnotationsFromSignature(AnnotatedSignature);
+    using SignatureFromLambda = FunctionSignature(Lambda);
+
+    using AnnotatedFuture = SignatureType(AnnotatedSignature);
+    // This is either C or C*, possibly annotated.
+    using AnnotatedT = CopyAnnotation(AnnotatedFuture, RemoveFuture(RemoveAnnotations(AnnotatedFuture)));
+    using T = RemoveAnnotations(AnnotatedT);
+    // The signature of a provider that returns the result of the future.
+    using AnnotatedProviderSignature = ConsSignatureWithVector(AnnotatedT, SignatureArgs(AnnotatedSignature));
+
+    using AnnotatedC = NormalizeType(AnnotatedT);
+    using AnnotatedCDeps = NormalizeTypeVector(SignatureArgs(AnnotatedSignature));
+    using R = AddProvidedType(Comp, AnnotatedC, Bool<true>, AnnotatedCDeps,
+                              Id<NormalizedNonConstTypesIn(SignatureArgs(AnnotatedSignature))>);
+    struct Op {
+      using Result = Eval<R>;
+      using ProviderSignature = UnwrapType<Eval<AnnotatedProviderSignature>>;
+      void operator()(ComponentStorageEntryVector& entries) {
+        entries.push_back(
+            InjectorStorage::createComponentStorageEntryForAsyncProvider<ProviderSignature, UnwrapType<Lambda>>());
+        entries.push_back(
+            InjectorStorage::createComponentStorageEntryForAsyncProviderInfo<ProviderSignature, UnwrapType<Lambda>>());
+        entries.push_back(InjectorStorage::createComponentStorageEntryForMultibindingVectorCreator<
+                          InjectorStorage::AsyncProviderInfo>());
+      }
+      std::size_t numEntries() {
+        return 3;
+      }
+    };
+    using type = If(
+        Not(IsValidSignature(AnnotatedSignature)), ConstructError(NotASignatureErrorTag, AnnotatedSignature),
+        If(Not(IsSame(Signature, SignatureFromLambda)),
+           ConstructError(AnnotatedSignatureDifferentFromLambdaSignatureErrorTag, Signature, SignatureFromLambda),
+           If(Not(IsFuture(RemoveAnnotations(AnnotatedFuture))),
+              ConstructError(AsyncProviderNotReturningFutureErrorTag, RemoveAnnotations(AnnotatedFuture)),
+              PropagateError(
+                  CheckInjectableType(T),
+                  PropagateError(
+                      CheckInjectableTypeVector(RemoveAnnotationsFromVector(AnnotatedCDeps)),
+                      If(And(IsPointer(T),
+                             And(IsAbstract(RemovePointer(T)), Not(HasVirtualDestructor(RemovePointer(T))))),
+                         ConstructError(ProviderReturningPointerToAbstractClassWithNoVirtualDestructorErrorTag,
+                                        RemovePointer(T)),
+                         PropagateError(R, Op)))))));
+  };
+};
+
+struct RegisterAsyncProvider {
+  template <typename Comp, typename Lambda>
+  struct apply {
+    using type = RegisterAsyncProviderWithAnnotations(Comp, FunctionSignature(Lambda), Lambda);
+  };
+};
+
 // T can't be any injectable type, it must match the return type of the provider in one of
 // the registerMultibindingProvider() overloads in ComponentStorage.
 struct RegisterMultibindingProviderWithAnnotations {
@@ -342,7 +436,7 @@ struct RegisterMultibindingProviderWithAnnotations {
     using R = AddRequirements(Comp, AnnotatedArgVector, NonConstRequirements);
     struct Op {
       using Result = Eval<R>;
-      void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+      void operator()(ComponentStorageEntryVector& entries) {
         entries.push_back(
             InjectorStorage::createComponentStorageEntryForMultibindingProvider<UnwrapType<AnnotatedSignature>,
                                                                                 UnwrapType<Lambda>>());
@@ -428,47 +522,74 @@ struct RegisterFactoryHelper {
     using NakedInjectedSignature = NakedC(NakedUserProvidedArgs...);
     using NakedRequiredSignature = NakedC(NakedAllArgs...);
     using NakedFunctor = std::function<NakedInjectedSignature>;
-    // This is usually the same as Functor, but this might be annotated.
+    using NakedFactory = fruit::Factory<NakedInjectedSignature>;
+    // These are usually the same as NakedFunctor and NakedFactory, but they might be annotated.
     using AnnotatedFunctor = CopyAnnotation(AnnotatedT, Type<NakedFunctor>);
+    using AnnotatedFactory = CopyAnnotation(AnnotatedT, Type<NakedFactory>);
     using FunctorDeps = NormalizeTypeVector(Vector<InjectedAnnotatedArgs...>);
     using FunctorNonConstDeps = NormalizedNonConstTypesIn(Vector<InjectedAnnotatedArgs...>);
-    using R = AddProvidedType(Comp, AnnotatedFunctor, Bool<true>, FunctorDeps, FunctorNonConstDeps);
+    // The std::function and the Factory are both provided here, with the same dependencies.
+    using R1 = AddProvidedType(Comp, AnnotatedFunctor, Bool<true>, FunctorDeps, FunctorNonConstDeps);
+    using R = PropagateError(R1, AddProvidedType(R1, AnnotatedFactory, Bool<true>, FunctorDeps, FunctorNonConstDeps));
     struct Op {
       using Result = Eval<R>;
-      void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+      // The injected arguments of a Factory are stored in the injector (as a hidden binding for this type), so that a
+      // Factory only needs to point to them.
+      using State = FactoryState<UnwrapType<Eval<AnnotatedFactory>>, UnwrapType<Lambda>, NakedInjectedArgs...>;
+      template <typename InjectedArgsTuple>
+      static NakedC invoke(InjectedArgsTuple& injected_args, std::tuple<NakedUserProvidedArgs&...> user_provided_args) {
+        // These are unused if they are 0-arg tuples. Silence the unused-variable warnings anyway.
+        (void)injected_args;
+        (void)user_provided_args;
+
+        return LambdaInvoker::invoke<UnwrapType<Lambda>, NakedAllArgs...>(
+            GetAssistedArg<
+                Eval<NumAssistedBefore(Indexes, DecoratedArgs)>::value,
+                getIntValue<Indexes>() - Eval<NumAssistedBefore(Indexes, DecoratedArgs)>::value,
+                // Note that the Assisted<> wrapper (if any) remains, we just remove any wrapping Annotated<>.
+                UnwrapType<Eval<RemoveAnnotations(GetNthType(Indexes, DecoratedArgs))>>>()(injected_args,
+                                                                                           user_provided_args)...);
+      }
+      void operator()(ComponentStorageEntryVector& entries) {
+        // The std::function owns a copy of the injected arguments, so unlike a Factory it doesn't point to the State.
+        // The Factory (and its State) is only constructed if it's injected.
         auto function_provider = [](NakedInjectedArgs... args) {
-          auto injected_args = std::make_tuple(args...);
+          std::tuple<NakedInjectedArgs...> injected_args(args...);
           auto object_provider = [injected_args](NakedUserProvidedArgs... params) mutable {
-            auto user_provided_args = std::tie(params...);
-            // These are unused if they are 0-arg tuples. Silence the unused-variable warnings anyway.
-            (void)injected_args;
-            (void)user_provided_args;
-
-            return LambdaInvoker::invoke<UnwrapType<Lambda>, NakedAllArgs...>(
-                GetAssistedArg<
-                    Eval<NumAssistedBefore(Indexes, DecoratedArgs)>::value,
-                    getIntValue<Indexes>() - Eval<NumAssistedBefore(Indexes, DecoratedArgs)>::value,
-                    // Note that the Assisted<> wrapper (if any) remains, we just remove any wrapping Annotated<>.
-                    UnwrapType<Eval<RemoveAnnotations(GetNthType(Indexes, DecoratedArgs))>>>()(injected_args,
-                                                                                               user_provided_args)...);
+            return invoke(injected_args, std::tie(params...));
           };
           return NakedFunctor(object_provider);
         };
+        auto state_provider = [](NakedInjectedArgs... args) {
+          return State{std::tuple<NakedInjectedArgs...>(args...)};
+        };
+        auto factory_provider = [](State& state) {
+          NakedC (*invoker)(void*, NakedUserProvidedArgs...) = [](void* state_ptr, NakedUserProvidedArgs... params) {
+            return invoke(static_cast<State*>(state_ptr)->injected_args, std::tie(params...));
+          };
+          return NakedFactory(invoker, &state);
+        };
         entries.push_back(InjectorStorage::createComponentStorageEntryForProvider<
                           UnwrapType<Eval<ConsSignatureWithVector(AnnotatedFunctor, Vector<InjectedAnnotatedArgs...>)>>,
                           decltype(function_provider)>());
+        entries.push_back(InjectorStorage::createComponentStorageEntryForProvider<
+                          UnwrapType<Eval<ConsSignatureWithVector(Type<State>, Vector<InjectedAnnotatedArgs...>)>>,
+                          decltype(state_provider)>());
+        entries.push_back(InjectorStorage::createComponentStorageEntryForProvider<
+                          UnwrapType<Eval<ConsSignature(AnnotatedFactory, Type<State&>)>>,
+                          decltype(factory_provider)>());
       }
       std::size_t numEntries() {
-        return 1;
+        return 3;
       }
     };
     // The first two IsValidSignature checks are a bit of a hack, they are needed to make the F2/RealF2 split
     // work in the caller (we need to allow Lambda to be a function type).
+    // Note that T can be a pointer here (registerArenaFactory() relies on that), RegisterFactory checks that it isn't.
     using type = If(Not(IsSame(Type<NakedRequiredSignature>, FunctionSignature(Lambda))),
                     ConstructError(FunctorSignatureDoesNotMatchErrorTag, Type<NakedRequiredSignature>,
                                    FunctionSignature(Lambda)),
-                    If(IsPointer(T), ConstructError(FactoryReturningPointerErrorTag, DecoratedSignature),
-                       PropagateError(R, Op)));
+                    PropagateError(R, Op));
   };
 };
 
@@ -498,14 +619,18 @@ struct RegisterFactory {
                                        Not(HasVirtualDestructor(RemoveUniquePtr(LambdaReturnType))))),
                                ConstructError(RegisterFactoryForUniquePtrOfAbstractClassWithNoVirtualDestructorErrorTag,
                                               RemoveUniquePtr(LambdaReturnType)),
-                               RegisterFactoryHelper(
-                                   Comp, DecoratedSignature, Lambda,
-                                   InjectedSignatureForAssistedFactory(DecoratedSignature),
-                                   RequiredLambdaSignatureForAssistedFactory(DecoratedSignature),
-                                   RemoveAssisted(SignatureArgs(DecoratedSignature)),
-                                   RemoveAnnotationsFromVector(RemoveAssisted(SignatureArgs(DecoratedSignature))),
-                                   GenerateIntSequence(
-                                       VectorSize(RequiredLambdaArgsForAssistedFactory(DecoratedSignature)))))))))));
+                               If(And(IsSame(RequiredLambdaSignatureForAssistedFactory(DecoratedSignature),
+                                             FunctionSignature(Lambda)),
+                                      IsPointer(RemoveAnnotations(SignatureType(DecoratedSignature)))),
+                                  ConstructError(FactoryReturningPointerErrorTag, DecoratedSignature),
+                                  RegisterFactoryHelper(
+                                      Comp, DecoratedSignature, Lambda,
+                                      InjectedSignatureForAssistedFactory(DecoratedSignature),
+                                      RequiredLambdaSignatureForAssistedFactory(DecoratedSignature),
+                                      RemoveAssisted(SignatureArgs(DecoratedSignature)),
+                                      RemoveAnnotationsFromVector(RemoveAssisted(SignatureArgs(DecoratedSignature))),
+                                      GenerateIntSequence(VectorSize(
+                                          RequiredLambdaArgsForAssistedFactory(DecoratedSignature))))))))))));
   };
 };
 
@@ -519,7 +644,7 @@ struct PostProcessRegisterConstructorHelper;
 
 template <typename AnnotatedSignature, typename AnnotatedI>
 struct PostProcessRegisterConstructorHelper<AnnotatedSignature, Type<AnnotatedI>> {
-  inline void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+  inline void operator()(ComponentStorageEntryVector& entries) {
     entries.push_back(
         InjectorStorage::createComponentStorageEntryForCompressedConstructor<AnnotatedSignature, AnnotatedI>());
     entries.push_back(InjectorStorage::createComponentStorageEntryForConstructor<AnnotatedSignature>());
@@ -531,7 +656,7 @@ struct PostProcessRegisterConstructorHelper<AnnotatedSignature, Type<AnnotatedI>
 
 template <typename AnnotatedSignature>
 struct PostProcessRegisterConstructorHelper<AnnotatedSignature, None> {
-  inline void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+  inline void operator()(ComponentStorageEntryVector& entries) {
     entries.push_back(InjectorStorage::createComponentStorageEntryForConstructor<AnnotatedSignature>());
   }
   std::size_t numEntries() {
@@ -548,7 +673,7 @@ struct PostProcessRegisterConstructor {
       using Helper =
           PostProcessRegisterConstructorHelper<UnwrapType<AnnotatedSignature>,
                                                Eval<FindValueInMap(typename Comp::InterfaceBindings, AnnotatedC)>>;
-      void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+      void operator()(ComponentStorageEntryVector& entries) {
         Helper()(entries);
       }
       std::size_t numEntries() {
@@ -597,7 +722,7 @@ struct RegisterInstance {
     using R = AddProvidedType(Comp, AnnotatedC, IsNonConst, Vector<>, Vector<>);
     struct Op {
       using Result = Eval<R>;
-      void operator()(FixedSizeVector<ComponentStorageEntry>&) {}
+      void operator()(ComponentStorageEntryVector&) {}
       std::size_t numEntries() {
         return 0;
       }
@@ -628,7 +753,7 @@ struct RegisterConstructorAsValueFactory {
     using Op1 = RegisterFactory(Comp, DecoratedSignature, RequiredSignature);
     struct Op {
       using Result = Eval<GetResult(Op1)>;
-      void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+      void operator()(ComponentStorageEntryVector& entries) {
         auto provider = [](NakedArgs... args) { return NakedT(std::forward<NakedArgs>(args)...); };
         using RealOp = RegisterFactory(Comp, DecoratedSignature, Type<decltype(provider)>);
         FruitStaticAssert(IsSame(GetResult(Op1), GetResult(RealOp)));
@@ -658,7 +783,7 @@ struct RegisterConstructorAsUniquePtrFactory {
     using Op1 = RegisterFactory(Comp, DecoratedSignature, RequiredSignature);
     struct Op {
       using Result = Eval<GetResult(Op1)>;
-      void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+      void operator()(ComponentStorageEntryVector& entries) {
         auto provider = [](NakedArgs... args) {
           return std::unique_ptr<NakedT>(new NakedT(std::forward<NakedArgs>(args)...));
         };
@@ -682,6 +807,145 @@ struct RegisterConstructorAsUniquePtrFactory {
   };
 };
 
+struct RegisterPooledFactoryHelper {
+  template <typename Comp, typename DecoratedSignature, typename RequiredSignature>
+  struct apply;
+
+  template <typename Comp, typename DecoratedSignature, typename NakedT, typename... NakedArgs>
+  struct apply<Comp, DecoratedSignature, Type<NakedT(NakedArgs...)>> {
+    using NakedPool = fruit::ObjectPool<NakedT>;
+    using NakedPooledT = fruit::Pooled<NakedT>;
+    // This is DecoratedSignature with the return type replaced by Pooled<T> (keeping any annotation) and with an
+    // additional ObjectPool<T>& parameter, that is injected.
+    using PooledDecoratedSignature =
+        ConsSignatureWithVector(CopyAnnotation(SignatureType(DecoratedSignature), Type<NakedPooledT>),
+                                PushFront(SignatureArgs(DecoratedSignature), Type<NakedPool&>));
+    using RequiredSignature = Type<NakedPooledT(NakedPool&, NakedArgs...)>;
+    using Op1 = RegisterFactory(Comp, PooledDecoratedSignature, RequiredSignature);
+    struct Op {
+      using Result = Eval<GetResult(Op1)>;
+      void operator()(ComponentStorageEntryVector& entries) {
+        auto provider = [](NakedPool& pool, NakedArgs... args) {
+          return pool.make(std::forward<NakedArgs>(args)...);
+        };
+        using RealOp = RegisterFactory(Comp, PooledDecoratedSignature, Type<decltype(provider)>);
+        FruitStaticAssert(IsSame(GetResult(Op1), GetResult(RealOp)));
+        Eval<RealOp>()(entries);
+      };
+      std::size_t numEntries() {
+#if FRUIT_EXTRA_DEBUG
+        auto provider = [](NakedPool& pool, NakedArgs... args) {
+          return pool.make(std::forward<NakedArgs>(args)...);
+        };
+        using RealOp = RegisterFactory(Comp, PooledDecoratedSignature, Type<decltype(provider)>);
+        FruitAssert(Eval<Op1>().numEntries() == Eval<RealOp>().numEntries());
+#endif
+        return Eval<Op1>().numEntries();
+      }
+    };
+
+    using type = If(IsAbstract(Type<NakedT>), ConstructError(CannotConstructAbstractClassErrorTag, Type<NakedT>),
+                    PropagateError(Op1, Op));
+  };
+};
+
+struct RegisterPooledFactory {
+  template <typename Comp, typename DecoratedSignature>
+  struct apply {
+    using type = If(Not(IsValidSignature(DecoratedSignature)),
+                    ConstructError(NotASignatureErrorTag, DecoratedSignature),
+                    RegisterPooledFactoryHelper(Comp, DecoratedSignature,
+                                                RequiredLambdaSignatureForAssistedFactory(DecoratedSignature)));
+  };
+};
+
+// Removes T from the requirements of Comp. This is used for types that are bound in every injector (so components don't
+// need to declare them as requirements), but that are not exposed.
+struct RemoveInjectorProvidedRequirement {
+  template <typename Comp, typename T>
+  struct apply {
+    using type = ConsComp(SetDifference(typename Comp::RsSuperset, Vector<T>), typename Comp::Ps,
+                          SetDifference(typename Comp::NonConstRsPs, Vector<T>),
+#if !FRUIT_NO_LOOP_CHECK
+                          typename Comp::Deps,
+#endif
+                          typename Comp::InterfaceBindings, typename Comp::DeferredBindingFunctors);
+  };
+};
+
+struct RegisterArenaFactoryHelper {
+  template <typename Comp, typename DecoratedSignature, typename RequiredSignature>
+  struct apply;
+
+  template <typename Comp, typename DecoratedSignature, typename NakedT, typename... NakedArgs>
+  struct apply<Comp, DecoratedSignature, Type<NakedT(NakedArgs...)>> {
+    // This is DecoratedSignature with the return type replaced by T* (keeping any annotation) and with an additional
+    // ObjectArena& parameter, that is injected.
+    using ArenaDecoratedSignature =
+        ConsSignatureWithVector(CopyAnnotation(SignatureType(DecoratedSignature), Type<NakedT*>),
+                                PushFront(SignatureArgs(DecoratedSignature), Type<ObjectArena&>));
+    using RequiredSignature = Type<NakedT*(ObjectArena&, NakedArgs...)>;
+
+    // Lambda can also be RequiredSignature, see RegisterFactoryHelper.
+    template <typename Lambda>
+    using RegisterFactoryHelperFor =
+        RegisterFactoryHelper(Comp, ArenaDecoratedSignature, Lambda,
+                              InjectedSignatureForAssistedFactory(ArenaDecoratedSignature), RequiredSignature,
+                              RemoveAssisted(SignatureArgs(ArenaDecoratedSignature)),
+                              RemoveAnnotationsFromVector(RemoveAssisted(SignatureArgs(ArenaDecoratedSignature))),
+                              GenerateIntSequence(VectorSize(SignatureArgs(RequiredSignature))));
+
+    using Op1 = RegisterFactoryHelperFor<RequiredSignature>;
+    struct Op {
+      // The ObjectArena is bound in every injector that uses it (see below), so it's not a requirement of the
+      // component.
+      using Result = Eval<RemoveInjectorProvidedRequirement(GetResult(Op1), Type<ObjectArena>)>;
+      void operator()(ComponentStorageEntryVector& entries) {
+        auto provider = [](ObjectArena& arena, NakedArgs... args) {
+          return arena.make<NakedT>(std::forward<NakedArgs>(args)...);
+        };
+        using RealOp = RegisterFactoryHelperFor<Type<decltype(provider)>>;
+        FruitStaticAssert(IsSame(GetResult(Op1), GetResult(RealOp)));
+        Eval<RealOp>()(entries);
+        // If there are multiple arena factories, these bindings are identical, so only one of them is kept.
+        entries.push_back(InjectorStorage::createComponentStorageEntryForObjectArena());
+      };
+      std::size_t numEntries() {
+#if FRUIT_EXTRA_DEBUG
+        auto provider = [](ObjectArena& arena, NakedArgs... args) {
+          return arena.make<NakedT>(std::forward<NakedArgs>(args)...);
+        };
+        using RealOp = RegisterFactoryHelperFor<Type<decltype(provider)>>;
+        FruitAssert(Eval<Op1>().numEntries() == Eval<RealOp>().numEntries());
+#endif
+        return Eval<Op1>().numEntries() + 1;
+      }
+    };
+
+    using type = PropagateError(Op1, Op);
+  };
+};
+
+struct RegisterArenaFactory {
+  template <typename Comp, typename DecoratedSignature>
+  struct apply {
+    using AnnotatedT = SignatureType(DecoratedSignature);
+    using type = If(
+        Not(IsValidSignature(DecoratedSignature)), ConstructError(NotASignatureErrorTag, DecoratedSignature),
+        PropagateError(
+            CheckInjectableType(RemoveAnnotations(AnnotatedT)),
+            PropagateError(
+                CheckInjectableTypeVector(
+                    RemoveAnnotationsFromVector(RemoveAssisted(SignatureArgs(DecoratedSignature)))),
+                If(IsPointer(RemoveAnnotations(AnnotatedT)),
+                   ConstructError(FactoryReturningPointerErrorTag, DecoratedSignature),
+                   If(IsAbstract(RemoveAnnotations(AnnotatedT)),
+                      ConstructError(CannotConstructAbstractClassErrorTag, RemoveAnnotations(AnnotatedT)),
+                      RegisterArenaFactoryHelper(Comp, DecoratedSignature,
+                                                 RequiredLambdaSignatureForAssistedFactory(DecoratedSignature)))))));
+  };
+};
+
 struct InstallComponent {
   template <typename Comp, typename OtherComp>
   struct apply {
@@ -704,7 +968,7 @@ struct InstallComponent {
                        new_InterfaceBindings, new_DeferredBindingFunctors);
     struct Op {
       using Result = Eval<R>;
-      void operator()(FixedSizeVector<ComponentStorageEntry>&) {}
+      void operator()(ComponentStorageEntryVector&) {}
       std::size_t numEntries() {
         return 0;
       }
@@ -912,7 +1176,7 @@ struct AutoRegisterFactoryHelper {
     using R = Call(ComposeFunctors(F1, F2, F3), Comp);
     struct Op {
       using Result = Eval<GetResult(R)>;
-      void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+      void operator()(ComponentStorageEntryVector& entries) {
         using NakedC = UnwrapType<Eval<C>>;
         auto provider = [](const UnwrapType<Eval<CFunctor>>& fun) {
           return UnwrapType<Eval<IFunctor>>([=](typename TypeUnwrapper<Args>::type... args) {
@@ -976,7 +1240,7 @@ struct AutoRegisterFactoryHelper {
     using R = Call(ComposeFunctors(F1, F2, F3), Comp);
     struct Op {
       using Result = Eval<GetResult(R)>;
-      void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+      void operator()(ComponentStorageEntryVector& entries) {
         auto provider = [](const UnwrapType<Eval<CFunctor>>& fun) {
           return UnwrapType<Eval<CUniquePtrFunctor>>([=](typename TypeUnwrapper<Args>::type... args) {
             NakedC* c = new NakedC(fun(args...));
@@ -1128,6 +1392,56 @@ struct AutoRegister {
                                            Type<fruit::Annotated<Annotation, std::unique_ptr<NakedC>>(NakedArgs...)>,
                                            Id<RemoveAnnotations(Type<NakedArgs>)>...);
   };
+
+  // A fruit::Factory can only be auto-registered using the Inject typedef of the class, since it can't be constructed
+  // from a std::function (e.g. one obtained through an interface binding).
+  template <typename Comp, typename TargetRequirements, typename TargetNonConstRequirements, typename NakedC,
+            typename... NakedArgs>
+  struct apply<Comp, TargetRequirements, TargetNonConstRequirements, Type<fruit::Factory<NakedC(NakedArgs...)>>> {
+    using type = If(HasInjectAnnotation(Type<NakedC>),
+                    AutoRegisterFactoryHelper(Comp, TargetRequirements, TargetNonConstRequirements, None, Bool<true>,
+                                              Bool<false>, Type<NakedC>, Type<NakedC(NakedArgs...)>,
+                                              Id<RemoveAnnotations(Type<NakedArgs>)>...),
+                    ConstructNoBindingFoundError(Type<fruit::Factory<NakedC(NakedArgs...)>>));
+  };
+
+  template <typename Comp, typename TargetRequirements, typename TargetNonConstRequirements, typename NakedC,
+            typename... NakedArgs>
+  struct apply<Comp, TargetRequirements, TargetNonConstRequirements,
+               Type<fruit::Factory<std::unique_ptr<NakedC>(NakedArgs...)>>> {
+    using type = If(HasInjectAnnotation(Type<NakedC>),
+                    AutoRegisterFactoryHelper(Comp, TargetRequirements, TargetNonConstRequirements, None, Bool<true>,
+                                              Bool<false>, Type<std::unique_ptr<NakedC>>,
+                                              Type<std::unique_ptr<NakedC>(NakedArgs...)>,
+                                              Id<RemoveAnnotations(Type<NakedArgs>)>...),
+                    ConstructNoBindingFoundError(Type<fruit::Factory<std::unique_ptr<NakedC>(NakedArgs...)>>));
+  };
+
+  template <typename Comp, typename TargetRequirements, typename TargetNonConstRequirements, typename Annotation,
+            typename NakedC, typename... NakedArgs>
+  struct apply<Comp, TargetRequirements, TargetNonConstRequirements,
+               Type<fruit::Annotated<Annotation, fruit::Factory<NakedC(NakedArgs...)>>>> {
+    using type = If(HasInjectAnnotation(Type<NakedC>),
+                    AutoRegisterFactoryHelper(Comp, TargetRequirements, TargetNonConstRequirements, None, Bool<true>,
+                                              Bool<false>, Type<NakedC>,
+                                              Type<fruit::Annotated<Annotation, NakedC>(NakedArgs...)>,
+                                              Id<RemoveAnnotations(Type<NakedArgs>)>...),
+                    ConstructNoBindingFoundError(
+                        Type<fruit::Annotated<Annotation, fruit::Factory<NakedC(NakedArgs...)>>>));
+  };
+
+  template <typename Comp, typename TargetRequirements, typename TargetNonConstRequirements, typename Annotation,
+            typename NakedC, typename... NakedArgs>
+  struct apply<Comp, TargetRequirements, TargetNonConstRequirements,
+               Type<fruit::Annotated<Annotation, fruit::Factory<std::unique_ptr<NakedC>(NakedArgs...)>>>> {
+    using type = If(HasInjectAnnotation(Type<NakedC>),
+                    AutoRegisterFactoryHelper(Comp, TargetRequirements, TargetNonConstRequirements, None, Bool<true>,
+                                              Bool<false>, Type<std::unique_ptr<NakedC>>,
+                                              Type<fruit::Annotated<Annotation, std::unique_ptr<NakedC>>(NakedArgs...)>,
+                                              Id<RemoveAnnotations(Type<NakedArgs>)>...),
+                    ConstructNoBindingFoundError(
+                        Type<fruit::Annotated<Annotation, fruit::Factory<std::unique_ptr<NakedC>(NakedArgs...)>>>));
+  };
 };
 
 template <typename AnnotatedT>
@@ -1239,6 +1553,16 @@ struct ProcessBinding {
     using type = ComponentFunctor(DeferredRegisterProviderWithAnnotations, Type<AnnotatedSignature>, Type<Lambda>);
   };
 
+  template <typename Lambda>
+  struct apply<fruit::impl::RegisterAsyncProvider<Lambda>> {
+    using type = ComponentFunctor(RegisterAsyncProvider, Type<Lambda>);
+  };
+
+  template <typename AnnotatedSignature, typename Lambda>
+  struct apply<fruit::impl::RegisterAsyncProvider<AnnotatedSignature, Lambda>> {
+    using type = ComponentFunctor(RegisterAsyncProviderWithAnnotations, Type<AnnotatedSignature>, Type<Lambda>);
+  };
+
   template <typename AnnotatedC>
   struct apply<fruit::impl::AddInstanceMultibinding<AnnotatedC>> {
     using type = ComponentFunctorIdentity;
@@ -1254,6 +1578,18 @@ struct ProcessBinding {
     using type = ComponentFunctor(AddInterfaceMultibinding, Type<I>, Type<C>);
   };
 
+  // The KeyedMultibindingElement is added by the PartialComponentStorage. Here we also add a (key-less) multibinding of
+  // a type that can't be retrieved by the user, so that C is in the injector's graph (and is not removed by binding
+  // compression) when the element is looked up. The vector of this multibinding is never constructed, see
+  // InjectorStorage::createNoMultibindingVector().
+  template <typename K, typename I, typename C>
+  struct apply<fruit::impl::AddKeyedMultibinding<K, I, C>> {
+    using type = ComponentFunctor(
+        AddInterfaceMultibinding,
+        Type<fruit::Annotated<fruit::impl::KeyedMultibindingTag<K, I>, InjectorStorage::RemoveAnnotations<I>>>,
+        Type<C>);
+  };
+
   template <typename Lambda>
   struct apply<fruit::impl::AddMultibindingProvider<Lambda>> {
     using type = ComponentFunctor(RegisterMultibindingProvider, Type<Lambda>);
@@ -1269,11 +1605,28 @@ struct ProcessBinding {
     using type = ComponentFunctor(RegisterFactory, Type<DecoratedSignature>, Type<Lambda>);
   };
 
+  template <typename DecoratedSignature>
+  struct apply<fruit::impl::RegisterPooledFactory<DecoratedSignature>> {
+    using type = ComponentFunctor(RegisterPooledFactory, Type<DecoratedSignature>);
+  };
+
+  template <typename DecoratedSignature>
+  struct apply<fruit::impl::RegisterArenaFactory<DecoratedSignature>> {
+    using type = ComponentFunctor(RegisterArenaFactory, Type<DecoratedSignature>);
+  };
+
   template <typename... Params, typename... Args>
   struct apply<fruit::impl::InstallComponent<fruit::Component<Params...>(Args...)>> {
     using type = ComponentFunctor(InstallComponentHelper, Type<Params>...);
   };
 
+  // The types in the lazily-installed component are checked and exposed in the same way as with install(), only the
+  // runtime expansion is deferred.
+  template <typename... Params, typename... Args>
+  struct apply<fruit::impl::InstallComponentLazily<fruit::Component<Params...>(Args...)>> {
+    using type = ComponentFunctor(InstallComponentHelper, Type<Params>...);
+  };
+
   template <typename... ComponentFunctions>
   struct apply<fruit::impl::InstallComponentFunctions<ComponentFunctions...>> {
     using type = ComponentFunctor(InstallComponentFunctions, Type<ComponentFunctions>...);
@@ -18,9 +18,11 @@
 #define FRUIT_COMPONENT_INSTALL_ARG_CHECKS_DEFN_H
 
 #include <fruit/impl/component_install_arg_checks.h>
+#include <fruit/component_function.h>
 
-#include <utility>
 #include <functional>
+#include <type_traits>
+#include <utility>
 
 namespace fruit {
 namespace impl {
@@ -34,8 +36,11 @@ FRUIT_ALWAYS_INLINE inline int checkAcceptableComponentInstallArg() {
         T x2(std::move(value));
         x1 = constRef;
         x2 = std::move(value);
-        bool b = (constRef == constRef);
-        std::size_t h = std::hash<T>()(constRef);
+        // Fruit hashes and compares the keys of the args, that by default are the args themselves.
+        const auto& key = fruit::ComponentArgKey<T>()(constRef);
+        using Key = typename std::remove_const<typename std::remove_reference<decltype(key)>::type>::type;
+        bool b = (key == key);
+        std::size_t h = std::hash<Key>()(key);
         (void)x1;
         (void)x2;
         (void)b;
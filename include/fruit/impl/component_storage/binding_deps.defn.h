@@ -29,8 +29,8 @@ template <typename... Ts>
 struct GetBindingDepsHelper<fruit::impl::meta::Vector<fruit::impl::meta::Type<Ts>...>> {
   inline const BindingDeps* operator()() {
     static const TypeId types[] = {getTypeId<Ts>()..., TypeId{nullptr}}; // LCOV_EXCL_BR_LINE
-    static const BindingDeps deps = {types, sizeof...(Ts)};
-    return &deps;
+    static const BindingDeps* deps = internBindingDeps(types, sizeof...(Ts));
+    return deps;
   }
 };
 
@@ -38,9 +38,8 @@ struct GetBindingDepsHelper<fruit::impl::meta::Vector<fruit::impl::meta::Type<Ts
 template <>
 struct GetBindingDepsHelper<fruit::impl::meta::Vector<>> {
   inline const BindingDeps* operator()() {
-    static const TypeId types[] = {TypeId{nullptr}};
-    static const BindingDeps deps = {types, 0};
-    return &deps;
+    static const BindingDeps* deps = internBindingDeps(nullptr, 0);
+    return deps;
   }
 };
 
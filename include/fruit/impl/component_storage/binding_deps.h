@@ -30,6 +30,12 @@ struct BindingDeps {
   std::size_t num_deps;
 };
 
+// Returns a BindingDeps object with the same deps (in the same order) as the given array.
+// All calls with arrays that have the same contents return the same object, even if they come from different shared
+// libraries. This allows to share the storage of the edges for these deps in SemistaticGraph.
+// The returned object is never destroyed.
+const BindingDeps* internBindingDeps(const TypeId* deps, std::size_t num_deps);
+
 template <typename Deps>
 const BindingDeps* getBindingDeps();
 
@@ -23,7 +23,7 @@
 namespace fruit {
 namespace impl {
 
-inline ComponentStorage::ComponentStorage(FixedSizeVector<ComponentStorageEntry>&& entries)
+inline ComponentStorage::ComponentStorage(ComponentStorageEntryVector&& entries)
     : entries(std::move(entries)) {}
 
 inline ComponentStorage::ComponentStorage(const ComponentStorage& other) {
@@ -45,7 +45,7 @@ inline ComponentStorage::~ComponentStorage() {
   destroy();
 }
 
-inline FixedSizeVector<ComponentStorageEntry> ComponentStorage::release() && {
+inline ComponentStorageEntryVector ComponentStorage::release() && {
   return std::move(entries);
 }
 
@@ -56,7 +56,7 @@ inline std::size_t ComponentStorage::numEntries() const {
 inline ComponentStorage& ComponentStorage::operator=(const ComponentStorage& other) {
   destroy();
 
-  entries = FixedSizeVector<ComponentStorageEntry>(other.entries.size());
+  entries = ComponentStorageEntryVector(other.entries.size());
   for (const ComponentStorageEntry& entry : other.entries) {
     entries.push_back(entry.copy());
   }
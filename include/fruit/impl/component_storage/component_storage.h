@@ -17,6 +17,7 @@
 #ifndef FRUIT_COMPONENT_STORAGE_H
 #define FRUIT_COMPONENT_STORAGE_H
 
+#include <fruit/impl/component_storage/component_storage_entry.h>
 #include <fruit/impl/data_structures/fixed_size_vector.h>
 #include <fruit/impl/fruit_internal_forward_decls.h>
 
@@ -37,19 +38,19 @@ namespace impl {
 class ComponentStorage {
 private:
   // The entries for this component storage (potentially including lazy component), *in reverse order*.
-  FixedSizeVector<ComponentStorageEntry> entries;
+  ComponentStorageEntryVector entries;
 
   void destroy();
 
 public:
   ComponentStorage() = default;
-  ComponentStorage(FixedSizeVector<ComponentStorageEntry>&& entries);
+  ComponentStorage(ComponentStorageEntryVector&& entries);
   ComponentStorage(const ComponentStorage&);
   ComponentStorage(ComponentStorage&&);
 
   ~ComponentStorage();
 
-  FixedSizeVector<ComponentStorageEntry> release() &&;
+  ComponentStorageEntryVector release() &&;
 
   std::size_t numEntries() const;
 
@@ -39,6 +39,13 @@ inline ComponentStorageEntry ComponentStorageEntry::copy() const {
     result.lazy_component_with_args = lazy_component_with_args.copy();
     break;
 
+  case Kind::LAZY_SUBCOMPONENT:
+    result.kind = kind;
+    result.type_id = type_id;
+    result.lazy_subcomponent.component = lazy_subcomponent.component.copy();
+    result.lazy_subcomponent.types = lazy_subcomponent.types;
+    break;
+
   default:
     result = *this;
   }
@@ -59,13 +66,54 @@ inline void ComponentStorageEntry::destroy() const {
 #endif
     break;
 
+  case Kind::LAZY_SUBCOMPONENT:
+    lazy_subcomponent.component.destroy();
+#if FRUIT_EXTRA_DEBUG
+    kind = Kind::INVALID;
+#endif
+    break;
+
   default:
     break;
   }
 }
 
-inline ComponentStorageEntry::LazyComponentWithArgs::ComponentInterface::ComponentInterface(erased_fun_t erased_fun)
-    : erased_fun(erased_fun) {}
+inline ComponentStorageEntry::LazyComponentWithArgs::ComponentInterface::ComponentInterface(erased_fun_t erased_fun,
+                                                                                          std::size_t hash_code)
+    : erased_fun(erased_fun), hash_code(hash_code) {}
+
+inline std::size_t ComponentStorageEntry::LazyComponentWithArgs::ComponentInterface::hashCode() const {
+  return hash_code;
+}
+
+template <typename IntVector, typename ArgsTuple>
+struct ComponentArgsHelper;
+
+// Hashes and compares the args of a lazy component through their ComponentArgKey.
+template <typename... Ints, typename... Args>
+struct ComponentArgsHelper<fruit::impl::meta::Vector<Ints...>, std::tuple<Args...>> {
+  std::size_t hash(const std::tuple<Args...>& args_tuple) {
+    // This parameter *is* used, but when the tuple is empty some compilers report is as unused.
+    (void)args_tuple;
+    return hashTuple(std::forward_as_tuple(
+        fruit::ComponentArgKey<Args>()(std::get<fruit::impl::meta::getIntValue<Ints>()>(args_tuple))...));
+  }
+
+  bool areEqual(const std::tuple<Args...>& args_tuple1, const std::tuple<Args...>& args_tuple2) {
+    // These parameters *are* used, but when the tuples are empty some compilers report them as unused.
+    (void)args_tuple1;
+    (void)args_tuple2;
+    return std::forward_as_tuple(
+               fruit::ComponentArgKey<Args>()(std::get<fruit::impl::meta::getIntValue<Ints>()>(args_tuple1))...) ==
+           std::forward_as_tuple(
+               fruit::ComponentArgKey<Args>()(std::get<fruit::impl::meta::getIntValue<Ints>()>(args_tuple2))...);
+  }
+};
+
+template <typename... Args>
+using ComponentArgsHelperFor = ComponentArgsHelper<
+    fruit::impl::meta::Eval<fruit::impl::meta::GenerateIntSequence(fruit::impl::meta::Int<sizeof...(Args)>)>,
+    std::tuple<Args...>>;
 
 template <typename Component, typename... Args>
 class ComponentInterfaceImpl : public ComponentStorageEntry::LazyComponentWithArgs::ComponentInterface {
@@ -75,9 +123,42 @@ private:
   using fun_t = Component (*)(Args...);
   std::tuple<Args...> args_tuple;
 
+  static inline std::size_t computeHashCode(fun_t fun, const std::tuple<Args...>& args_tuple) {
+    std::size_t fun_hash = std::hash<fun_t>()(fun);
+    std::size_t args_hash = ComponentArgsHelperFor<Args...>().hash(args_tuple);
+    return combineHashes(fun_hash, args_hash);
+  }
+
 public:
-  inline ComponentInterfaceImpl(fun_t fun, std::tuple<Args...> args_tuple)
-      : ComponentInterface(reinterpret_cast<erased_fun_t>(fun)), args_tuple(std::move(args_tuple)) {}
+  inline ComponentInterfaceImpl(fun_t fun, std::tuple<Args...> args_tuple, std::size_t hash_code)
+      : ComponentInterface(reinterpret_cast<erased_fun_t>(fun), hash_code), args_tuple(std::move(args_tuple)) {}
+
+  // Allocates a new ComponentInterfaceImpl, in the current lazy components MemoryPool if there is one (see
+  // ComponentStorageMemoryPoolScope) or on the heap otherwise.
+  // If hash_code is not specified, it's computed from fun and args_tuple.
+  static inline ComponentInterface* create(fun_t fun, std::tuple<Args...> args_tuple) {
+    std::size_t hash_code = computeHashCode(fun, args_tuple);
+    return create(fun, std::move(args_tuple), hash_code);
+  }
+
+  // Similar to create(), but always allocates the object on the heap (ignoring any ComponentStorageMemoryPoolScope).
+  static inline ComponentInterface* createOnHeap(fun_t fun, std::tuple<Args...> args_tuple) {
+    std::size_t hash_code = computeHashCode(fun, args_tuple);
+    return new ComponentInterfaceImpl(fun, std::move(args_tuple), hash_code);
+  }
+
+  static inline ComponentInterface* create(fun_t fun, std::tuple<Args...> args_tuple, std::size_t hash_code) {
+#if FRUIT_ALLOCATE_COMPONENTS_IN_MEMORY_POOL
+    MemoryPool* memory_pool = ComponentStorageMemoryPoolScope::getLazyComponentsMemoryPool();
+    if (memory_pool != nullptr) {
+      ComponentInterfaceImpl* result = new (memory_pool->allocate<ComponentInterfaceImpl>(1))
+          ComponentInterfaceImpl(fun, std::move(args_tuple), hash_code);
+      result->allocated_in_memory_pool = true;
+      return result;
+    }
+#endif
+    return new ComponentInterfaceImpl(fun, std::move(args_tuple), hash_code);
+  }
 
   inline bool
   areParamsEqual(const ComponentStorageEntry::LazyComponentWithArgs::ComponentInterface& other) const final {
@@ -85,23 +166,17 @@ public:
       return false;
     }
     const auto& casted_other = static_cast<const ComponentInterfaceImpl<Component, Args...>&>(other);
-    return args_tuple == casted_other.args_tuple;
+    return ComponentArgsHelperFor<Args...>().areEqual(args_tuple, casted_other.args_tuple);
   }
 
   inline void addBindings(entry_vector_t& entries) const final {
     Component component = callWithTuple<Component, Args...>(reinterpret_cast<fun_t>(erased_fun), args_tuple);
-    FixedSizeVector<ComponentStorageEntry> component_entries = std::move(component.storage).release();
+    ComponentStorageEntryVector component_entries = std::move(component.storage).release();
     entries.insert(entries.end(), component_entries.begin(), component_entries.end());
   }
 
-  inline std::size_t hashCode() const final {
-    std::size_t fun_hash = std::hash<fun_t>()(reinterpret_cast<fun_t>(erased_fun));
-    std::size_t args_hash = hashTuple(args_tuple);
-    return combineHashes(fun_hash, args_hash);
-  }
-
   inline ComponentInterface* copy() const final {
-    return new ComponentInterfaceImpl{reinterpret_cast<fun_t>(erased_fun), args_tuple};
+    return create(reinterpret_cast<fun_t>(erased_fun), args_tuple, hash_code);
   }
 
   inline TypeId getFunTypeId() const final {
@@ -116,7 +191,20 @@ inline ComponentStorageEntry ComponentStorageEntry::LazyComponentWithArgs::creat
   result.type_id = getTypeId<Component (*)(Args...)>();
   result.kind = ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_ARGS;
   result.lazy_component_with_args.component =
-      new ComponentInterfaceImpl<Component, Args...>(fun, std::move(args_tuple));
+      ComponentInterfaceImpl<Component, Args...>::create(fun, std::move(args_tuple));
+  return result;
+}
+
+template <typename Component, typename... Args>
+inline ComponentStorageEntry
+ComponentStorageEntry::LazySubcomponent::create(Component (*fun)(Args...), std::tuple<Args...> args_tuple,
+                                                const Types* types) {
+  ComponentStorageEntry result;
+  result.type_id = getTypeId<Component (*)(Args...)>();
+  result.kind = ComponentStorageEntry::Kind::LAZY_SUBCOMPONENT;
+  result.lazy_subcomponent.component.component =
+      ComponentInterfaceImpl<Component, Args...>::createOnHeap(fun, std::move(args_tuple));
+  result.lazy_subcomponent.types = types;
   return result;
 }
 
@@ -134,7 +222,7 @@ ComponentStorageEntry::LazyComponentWithArgs::createReplacedComponentEntry(Compo
   result.type_id = getTypeId<Component (*)(Args...)>();
   result.kind = ComponentStorageEntry::Kind::REPLACED_LAZY_COMPONENT_WITH_ARGS;
   result.lazy_component_with_args.component =
-      new ComponentInterfaceImpl<Component, Args...>(fun, std::move(args_tuple));
+      ComponentInterfaceImpl<Component, Args...>::create(fun, std::move(args_tuple));
   return result;
 }
 
@@ -146,7 +234,7 @@ ComponentStorageEntry::LazyComponentWithArgs::createReplacementComponentEntry(Co
   result.type_id = getTypeId<Component (*)(Args...)>();
   result.kind = ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS;
   result.lazy_component_with_args.component =
-      new ComponentInterfaceImpl<Component, Args...>(fun, std::move(args_tuple));
+      ComponentInterfaceImpl<Component, Args...>::create(fun, std::move(args_tuple));
   return result;
 }
 
@@ -157,18 +245,25 @@ inline ComponentStorageEntry::LazyComponentWithArgs ComponentStorageEntry::LazyC
 }
 
 inline void ComponentStorageEntry::LazyComponentWithArgs::destroy() const {
+#if FRUIT_ALLOCATE_COMPONENTS_IN_MEMORY_POOL
+  if (component->allocated_in_memory_pool) {
+    // The memory will be deallocated when the MemoryPool is destroyed.
+    component->~ComponentInterface();
+    return;
+  }
+#endif
   delete component;
 }
 
 inline bool ComponentStorageEntry::LazyComponentWithArgs::ComponentInterface::
 operator==(const ComponentInterface& other) const {
-  return erased_fun == other.erased_fun && areParamsEqual(other);
+  return erased_fun == other.erased_fun && hash_code == other.hash_code && areParamsEqual(other);
 }
 
 template <typename Component>
 void ComponentStorageEntry::LazyComponentWithNoArgs::addBindings(erased_fun_t erased_fun, entry_vector_t& entries) {
   Component component = reinterpret_cast<Component (*)()>(erased_fun)();
-  FixedSizeVector<ComponentStorageEntry> component_entries = std::move(component.storage).release();
+  ComponentStorageEntryVector component_entries = std::move(component.storage).release();
   entries.insert(entries.end(), component_entries.begin(), component_entries.end());
 }
 
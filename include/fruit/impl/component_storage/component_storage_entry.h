@@ -18,7 +18,9 @@
 #define FRUIT_COMPONENT_STORAGE_ENTRY_H
 
 #include <fruit/impl/component_storage/binding_deps.h>
+#include <fruit/impl/component_storage/component_storage_memory_pool.h>
 #include <fruit/impl/data_structures/arena_allocator.h>
+#include <fruit/impl/data_structures/fixed_size_vector.h>
 #include <fruit/impl/data_structures/semistatic_graph.h>
 #include <fruit/impl/fruit_internal_forward_decls.h>
 
@@ -61,6 +63,10 @@ struct ComponentStorageEntry {
     REPLACEMENT_LAZY_COMPONENT_WITH_NO_ARGS,
     REPLACEMENT_LAZY_COMPONENT_WITH_ARGS,
 
+    // A component installed with PartialComponent::installLazily(). During normalization this is replaced by
+    // placeholder bindings for the types that it provides, see LazySubcomponent below.
+    LAZY_SUBCOMPONENT,
+
     // These markers are used in expandLazyComponents(), see the comments there for details.
     COMPONENT_WITH_ARGS_END_MARKER,
     COMPONENT_WITHOUT_ARGS_END_MARKER,
@@ -73,7 +79,7 @@ struct ComponentStorageEntry {
 
   // This is usually the TypeId for the bound type, except:
   // * when kind==COMPRESSED_BINDING, this is the interface's TypeId
-  // * when kind==*LAZY_COMPONENT_*, this is the TypeId of the
+  // * when kind==*LAZY_COMPONENT_* or kind==LAZY_SUBCOMPONENT, this is the TypeId of the
   //       Component<...>-returning function.
   TypeId type_id;
 
@@ -236,9 +242,21 @@ struct ComponentStorageEntry {
       // pointer without virtual calls (and we can then do the rest of the comparison via virtual call if needed).
       erased_fun_t erased_fun;
 
+      // The hash of erased_fun and of the args, computed once on construction since it's used for all lookups in
+      // the hash sets/maps of lazy components during normalization (and hashing the args can be expensive).
+      // This is also compared before calling areParamsEqual(), to avoid most param comparisons between different
+      // components.
+      std::size_t hash_code;
+
+#if FRUIT_ALLOCATE_COMPONENTS_IN_MEMORY_POOL
+      // Whether this object was allocated in a MemoryPool (see ComponentStorageMemoryPoolScope). If so, it must be
+      // destroyed without deallocating its memory.
+      bool allocated_in_memory_pool = false;
+#endif
+
       using entry_vector_t = std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>;
 
-      ComponentInterface(erased_fun_t erased_fun);
+      ComponentInterface(erased_fun_t erased_fun, std::size_t hash_code);
 
       virtual ~ComponentInterface() = default;
 
@@ -248,7 +266,7 @@ struct ComponentStorageEntry {
       bool operator==(const ComponentInterface& other) const;
 
       virtual void addBindings(entry_vector_t& component_storage_entries) const = 0;
-      virtual std::size_t hashCode() const = 0;
+      std::size_t hashCode() const;
       virtual ComponentInterface* copy() const = 0;
 
       /**
@@ -289,6 +307,33 @@ struct ComponentStorageEntry {
     ComponentInterface* component;
   };
 
+  /**
+   * This represents an entry in ComponentStorage for a component installed with PartialComponent::installLazily().
+   */
+  struct LazySubcomponent {
+    // Information on the types of the component, that doesn't depend on the args.
+    // There's one static instance of this for each lazily-installed component type.
+    struct Types {
+      // The types provided by the component.
+      const BindingDeps* provided_types;
+
+      // The i-th element is the `create' function for the placeholder binding for provided_types->deps[i].
+      const BindingForObjectToConstruct::create_t* placeholder_creates;
+
+      // The types required by the component. Each placeholder binding depends on all of them, in this order.
+      const BindingDeps* required_types;
+    };
+
+    template <typename Component, typename... Args>
+    static ComponentStorageEntry create(Component (*fun)(Args...), std::tuple<Args...> args_tuple, const Types* types);
+
+    // The component and its args. Unlike in LAZY_COMPONENT_WITH_ARGS entries, this is always allocated on the heap
+    // (even when a ComponentStorageMemoryPoolScope is active) since it must outlive the normalization.
+    LazyComponentWithArgs component;
+
+    const Types* types;
+  };
+
   union {
     // Valid iff kind is BINDING_FOR_CONSTRUCTED_OBJECT.
     BindingForConstructedObject binding_for_constructed_object;
@@ -316,6 +361,9 @@ struct ComponentStorageEntry {
     // Valid iff kind is LAZY_COMPONENT_WITH_ARGS, REPLACED_LAZY_COMPONENT_WITH_ARGS or
     // REPLACEMENT_LAZY_COMPONENT_WITH_ARGS.
     LazyComponentWithArgs lazy_component_with_args;
+
+    // Valid iff kind is LAZY_SUBCOMPONENT.
+    LazySubcomponent lazy_subcomponent;
   };
 
   // We use a custom method instead of a real copy constructor so that all copies are explicit (since copying is a
@@ -327,6 +375,14 @@ struct ComponentStorageEntry {
   void destroy() const;
 };
 
+// The vector used to store the entries of a ComponentStorage.
+#if FRUIT_ALLOCATE_COMPONENTS_IN_MEMORY_POOL
+using ComponentStorageEntryVector =
+    FixedSizeVector<ComponentStorageEntry, ComponentStorageAllocator<ComponentStorageEntry>>;
+#else
+using ComponentStorageEntryVector = FixedSizeVector<ComponentStorageEntry>;
+#endif
+
 // We can't have this assert in debug mode because we add debug-only fields that increase the size.
 #if !FRUIT_EXTRA_DEBUG
 // This is not required for correctness, but 4 64-bit words should be enough to hold this object, if not we'd end up
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_COMPONENT_STORAGE_MEMORY_POOL_DEFN_H
+#define FRUIT_COMPONENT_STORAGE_MEMORY_POOL_DEFN_H
+
+#include <fruit/impl/component_storage/component_storage_memory_pool.h>
+
+#include <memory>
+
+namespace fruit {
+namespace impl {
+
+template <typename T>
+inline ComponentStorageAllocator<T>::ComponentStorageAllocator()
+    : pool(ComponentStorageMemoryPoolScope::getEntriesMemoryPool()) {}
+
+template <typename T>
+template <typename U>
+inline ComponentStorageAllocator<T>::ComponentStorageAllocator(const ComponentStorageAllocator<U>& other)
+    : pool(other.pool) {}
+
+template <typename T>
+inline T* ComponentStorageAllocator<T>::allocate(std::size_t n) {
+  if (pool == nullptr) {
+    return std::allocator<T>().allocate(n);
+  } else {
+    return pool->allocate<T>(n);
+  }
+}
+
+template <typename T>
+inline void ComponentStorageAllocator<T>::deallocate(T* p, std::size_t n) {
+  if (pool == nullptr) {
+    std::allocator<T>().deallocate(p, n);
+  }
+  // Otherwise, the memory will be deallocated when the MemoryPool is destroyed.
+}
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_COMPONENT_STORAGE_MEMORY_POOL_DEFN_H
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_COMPONENT_STORAGE_MEMORY_POOL_H
+#define FRUIT_COMPONENT_STORAGE_MEMORY_POOL_H
+
+#include <fruit/impl/data_structures/memory_pool.h>
+#include <fruit/impl/fruit-config.h>
+
+#include <cstddef>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * While an object of this class is alive, the ComponentStorage objects constructed in the current thread (and the
+ * lazy components with args that they contain) are allocated in the specified MemoryPool objects instead of on the
+ * heap. This is used during binding normalization, so that expanding the component tree doesn't require a separate
+ * allocation for each component.
+ *
+ * This only has an effect when FRUIT_ALLOCATE_COMPONENTS_IN_MEMORY_POOL is set. In that case, Component objects
+ * constructed while the normalization is in progress (e.g. in component functions) must not outlive it.
+ *
+ * Scopes can be nested, the destruction of a scope restores the memory pools that were in use before its creation.
+ */
+class ComponentStorageMemoryPoolScope {
+private:
+  MemoryPool* previous_entries_memory_pool;
+  MemoryPool* previous_lazy_components_memory_pool;
+
+public:
+  /**
+   * entries_memory_pool is used for the ComponentStorageEntry vectors, that are discarded at the end of the
+   * normalization.
+   * lazy_components_memory_pool is used for the lazy components with args, that can be kept in the
+   * NormalizedComponentStorage, so this MemoryPool must outlive it.
+   */
+  ComponentStorageMemoryPoolScope(MemoryPool& entries_memory_pool, MemoryPool& lazy_components_memory_pool);
+
+  ComponentStorageMemoryPoolScope(const ComponentStorageMemoryPoolScope&) = delete;
+  ComponentStorageMemoryPoolScope& operator=(const ComponentStorageMemoryPoolScope&) = delete;
+
+  ~ComponentStorageMemoryPoolScope();
+
+  // Returns the MemoryPool to use for ComponentStorageEntry vectors in the current thread, or nullptr if they should
+  // be allocated on the heap.
+  static MemoryPool* getEntriesMemoryPool();
+
+  // Returns the MemoryPool to use for lazy components with args in the current thread, or nullptr if they should be
+  // allocated on the heap.
+  static MemoryPool* getLazyComponentsMemoryPool();
+};
+
+/**
+ * An allocator that uses the entries MemoryPool of the ComponentStorageMemoryPoolScope that was active (in the current
+ * thread) when the allocator was constructed, or the heap if there was none.
+ * This only supports the operations used by FixedSizeVector.
+ */
+template <typename T>
+class ComponentStorageAllocator {
+private:
+  // The MemoryPool used to allocate memory, or nullptr to use the heap.
+  MemoryPool* pool;
+
+  template <class U>
+  friend class ComponentStorageAllocator;
+
+public:
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = ComponentStorageAllocator<U>;
+  };
+
+  ComponentStorageAllocator();
+
+  template <typename U>
+  ComponentStorageAllocator(const ComponentStorageAllocator<U>&);
+
+  T* allocate(std::size_t n);
+  void deallocate(T* p, std::size_t n);
+};
+
+} // namespace impl
+} // namespace fruit
+
+#include <fruit/impl/component_storage/component_storage_memory_pool.defn.h>
+
+#endif // FRUIT_COMPONENT_STORAGE_MEMORY_POOL_H
@@ -31,7 +31,7 @@ namespace impl {
 template <>
 class PartialComponentStorage<> {
 public:
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
     (void)entries;
   }
 
@@ -49,7 +49,7 @@ public:
   PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage)
       : previous_storage(previous_storage) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
     previous_storage.addBindings(entries);
   }
 
@@ -67,7 +67,7 @@ public:
   PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage)
       : previous_storage(previous_storage) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
     previous_storage.addBindings(entries);
   }
 
@@ -86,7 +86,7 @@ public:
   PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, C& instance)
       : previous_storage(previous_storage), instance(instance) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
     entries.push_back(InjectorStorage::createComponentStorageEntryForBindInstance<C, C>(instance));
     previous_storage.addBindings(entries);
   }
@@ -106,7 +106,7 @@ public:
   PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, const C& instance)
       : previous_storage(previous_storage), instance(instance) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
     entries.push_back(InjectorStorage::createComponentStorageEntryForBindConstInstance<C, C>(instance));
     previous_storage.addBindings(entries);
   }
@@ -126,7 +126,7 @@ public:
   PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, C& instance)
       : previous_storage(previous_storage), instance(instance) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
     entries.push_back(
         InjectorStorage::createComponentStorageEntryForBindInstance<fruit::Annotated<Annotation, C>, C>(instance));
     previous_storage.addBindings(entries);
@@ -147,7 +147,7 @@ public:
   PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, const C& instance)
       : previous_storage(previous_storage), instance(instance) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
     entries.push_back(
         InjectorStorage::createComponentStorageEntryForBindConstInstance<fruit::Annotated<Annotation, C>, C>(instance));
     previous_storage.addBindings(entries);
@@ -167,7 +167,25 @@ public:
   PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage)
       : previous_storage(previous_storage) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
+    previous_storage.addBindings(entries);
+  }
+
+  std::size_t numBindings() const {
+    return previous_storage.numBindings();
+  }
+};
+
+template <typename... Params, typename... PreviousBindings>
+class PartialComponentStorage<RegisterAsyncProvider<Params...>, PreviousBindings...> {
+private:
+  PartialComponentStorage<PreviousBindings...>& previous_storage;
+
+public:
+  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage)
+      : previous_storage(previous_storage) {}
+
+  void addBindings(ComponentStorageEntryVector& entries) const {
     previous_storage.addBindings(entries);
   }
 
@@ -186,7 +204,7 @@ public:
   PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, C& instance)
       : previous_storage(previous_storage), instance(instance) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
     entries.push_back(InjectorStorage::createComponentStorageEntryForInstanceMultibinding<C, C>(instance));
     entries.push_back(InjectorStorage::createComponentStorageEntryForMultibindingVectorCreator<C>());
     previous_storage.addBindings(entries);
@@ -207,7 +225,7 @@ public:
   PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, C& instance)
       : previous_storage(previous_storage), instance(instance) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
     entries.push_back(
         InjectorStorage::createComponentStorageEntryForInstanceMultibinding<fruit::Annotated<Annotation, C>, C>(
             instance));
@@ -231,7 +249,7 @@ public:
   PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, std::vector<C>& instances)
       : previous_storage(previous_storage), instances(instances) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
     for (auto i = instances.rbegin(), i_end = instances.rend(); i != i_end; ++i) {
       // TODO: consider optimizing this so that we need just 1 MULTIBINDING_VECTOR_CREATOR entry (removing the
       // assumption that each multibinding entry is always preceded by that).
@@ -256,7 +274,7 @@ public:
   PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, std::vector<C>& instances)
       : previous_storage(previous_storage), instances(instances) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
     for (auto i = instances.rbegin(), i_end = instances.rend(); i != i_end; ++i) {
       // TODO: consider optimizing this so that we need just 1 MULTIBINDING_VECTOR_CREATOR entry (removing the
       // assumption that each multibinding entry is always preceded by that).
@@ -282,7 +300,7 @@ public:
   PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage)
       : previous_storage(previous_storage) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
     previous_storage.addBindings(entries);
   }
 
@@ -291,6 +309,32 @@ public:
   }
 };
 
+template <typename K, typename I, typename C, typename... PreviousBindings>
+class PartialComponentStorage<AddKeyedMultibinding<K, I, C>, PreviousBindings...> {
+private:
+  using Element = KeyedMultibindingElement<K, InjectorStorage::RemoveAnnotations<I>>;
+
+  PartialComponentStorage<PreviousBindings...>& previous_storage;
+  const Element* element;
+
+public:
+  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage, const K& key)
+      : previous_storage(previous_storage),
+        element(Element::intern(key, InjectorStorage::getKeyedMultibindingObject<I, C>)) {}
+
+  void addBindings(ComponentStorageEntryVector& entries) const {
+    // The multibinding that constructs C (without a key) is added by the corresponding ComponentFunctor.
+    entries.push_back(InjectorStorage::createComponentStorageEntryForKeyedMultibinding<K, I>(element));
+    entries.push_back(
+        InjectorStorage::createComponentStorageEntryForMultibindingVectorCreator<KeyedMultibindingTag<K, I>>());
+    previous_storage.addBindings(entries);
+  }
+
+  std::size_t numBindings() const {
+    return previous_storage.numBindings() + 2;
+  }
+};
+
 template <typename... Params, typename... PreviousBindings>
 class PartialComponentStorage<AddMultibindingProvider<Params...>, PreviousBindings...> {
 private:
@@ -300,7 +344,7 @@ public:
   PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage)
       : previous_storage(previous_storage) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
     previous_storage.addBindings(entries);
   }
 
@@ -318,7 +362,43 @@ public:
   PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage)
       : previous_storage(previous_storage) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
+    previous_storage.addBindings(entries);
+  }
+
+  std::size_t numBindings() const {
+    return previous_storage.numBindings();
+  }
+};
+
+template <typename DecoratedSignature, typename... PreviousBindings>
+class PartialComponentStorage<RegisterPooledFactory<DecoratedSignature>, PreviousBindings...> {
+private:
+  PartialComponentStorage<PreviousBindings...>& previous_storage;
+
+public:
+  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage)
+      : previous_storage(previous_storage) {}
+
+  void addBindings(ComponentStorageEntryVector& entries) const {
+    previous_storage.addBindings(entries);
+  }
+
+  std::size_t numBindings() const {
+    return previous_storage.numBindings();
+  }
+};
+
+template <typename DecoratedSignature, typename... PreviousBindings>
+class PartialComponentStorage<RegisterArenaFactory<DecoratedSignature>, PreviousBindings...> {
+private:
+  PartialComponentStorage<PreviousBindings...>& previous_storage;
+
+public:
+  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage)
+      : previous_storage(previous_storage) {}
+
+  void addBindings(ComponentStorageEntryVector& entries) const {
     previous_storage.addBindings(entries);
   }
 
@@ -338,7 +418,7 @@ public:
                           std::tuple<>)
       : previous_storage(previous_storage), fun(fun1) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
     entries.push_back(ComponentStorageEntry::LazyComponentWithNoArgs::create(fun));
     previous_storage.addBindings(entries);
   }
@@ -360,7 +440,7 @@ public:
                           OtherComponent (*fun1)(Args...), std::tuple<Args...> args_tuple)
       : previous_storage(previous_storage), fun(fun1), args_tuple(std::move(args_tuple)) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
+  void addBindings(ComponentStorageEntryVector& entries) {
     entries.push_back(ComponentStorageEntry::LazyComponentWithArgs::create(fun, std::move(args_tuple)));
     previous_storage.addBindings(entries);
   }
@@ -370,9 +450,31 @@ public:
   }
 };
 
+template <typename OtherComponent, typename... Args, typename... PreviousBindings>
+class PartialComponentStorage<InstallComponentLazily<OtherComponent(Args...)>, PreviousBindings...> {
+private:
+  PartialComponentStorage<PreviousBindings...>& previous_storage;
+  OtherComponent (*fun)(Args...);
+  std::tuple<Args...> args_tuple;
+
+public:
+  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage,
+                          OtherComponent (*fun1)(Args...), std::tuple<Args...> args_tuple)
+      : previous_storage(previous_storage), fun(fun1), args_tuple(std::move(args_tuple)) {}
+
+  void addBindings(ComponentStorageEntryVector& entries) {
+    entries.push_back(InjectorStorage::createComponentStorageEntryForLazySubcomponent(fun, std::move(args_tuple)));
+    previous_storage.addBindings(entries);
+  }
+
+  std::size_t numBindings() const {
+    return previous_storage.numBindings() + 1;
+  }
+};
+
 template <std::size_t i, typename ComponentFunctionsTuple>
 struct AddAllComponentStorageEntries {
-    inline void operator()(FixedSizeVector<ComponentStorageEntry>& entries,
+    inline void operator()(ComponentStorageEntryVector& entries,
                            ComponentFunctionsTuple& component_functions_tuple) {
       AddAllComponentStorageEntries<i - 1, ComponentFunctionsTuple>()(entries, component_functions_tuple);
       entries.push_back(createEntry(std::move(std::get<i - 1>(component_functions_tuple))));
@@ -393,12 +495,12 @@ struct AddAllComponentStorageEntries {
 
 template <typename ComponentFunctionsTuple>
 struct AddAllComponentStorageEntries<0, ComponentFunctionsTuple> {
-    inline void operator()(FixedSizeVector<ComponentStorageEntry>&,
+    inline void operator()(ComponentStorageEntryVector&,
                            ComponentFunctionsTuple&) {}
 };
 
 template <typename ComponentFunctionsTuple>
-void addAllComponentStorageEntries(FixedSizeVector<ComponentStorageEntry>& entries,
+void addAllComponentStorageEntries(ComponentStorageEntryVector& entries,
                                    ComponentFunctionsTuple&& component_functions_tuple) {
   AddAllComponentStorageEntries<std::tuple_size<ComponentFunctionsTuple>::value,
                                 ComponentFunctionsTuple>()(
@@ -416,7 +518,7 @@ public:
                           std::tuple<ComponentFunctions...> component_functions_tuple)
       : previous_storage(previous_storage), component_functions_tuple(std::move(component_functions_tuple)) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
+  void addBindings(ComponentStorageEntryVector& entries) {
     addAllComponentStorageEntries(entries, std::move(component_functions_tuple));
     previous_storage.addBindings(entries);
   }
@@ -437,7 +539,7 @@ public:
                           std::tuple<>)
       : previous_storage(previous_storage), fun(fun1) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
     entries.push_back(ComponentStorageEntry::LazyComponentWithNoArgs::createReplacedComponentEntry(fun));
     previous_storage.addBindings(entries);
   }
@@ -459,7 +561,7 @@ public:
                           OtherComponent (*fun1)(ReplacedFunArgs...), std::tuple<ReplacedFunArgs...> args_tuple)
       : previous_storage(previous_storage), fun(fun1), args_tuple(std::move(args_tuple)) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
+  void addBindings(ComponentStorageEntryVector& entries) {
     entries.push_back(
         ComponentStorageEntry::LazyComponentWithArgs::createReplacedComponentEntry(fun, std::move(args_tuple)));
     previous_storage.addBindings(entries);
@@ -484,7 +586,7 @@ public:
   PartialComponentStorage(previous_storage_t& previous_storage, OtherComponent (*fun1)(), std::tuple<>)
       : previous_storage(previous_storage), fun(fun1) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+  void addBindings(ComponentStorageEntryVector& entries) const {
     entries.push_back(ComponentStorageEntry::LazyComponentWithNoArgs::createReplacementComponentEntry(fun));
     previous_storage.addBindings(entries);
   }
@@ -511,7 +613,7 @@ public:
                           std::tuple<ReplacementFunArgs...> args_tuple)
       : previous_storage(previous_storage), fun(fun1), args_tuple(std::move(args_tuple)) {}
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) {
+  void addBindings(ComponentStorageEntryVector& entries) {
     entries.push_back(
         ComponentStorageEntry::LazyComponentWithArgs::createReplacementComponentEntry(fun, std::move(args_tuple)));
     previous_storage.addBindings(entries);
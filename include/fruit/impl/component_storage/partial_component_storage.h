@@ -34,7 +34,7 @@ template <typename... Bindings>
 class PartialComponentStorage; /* {
 All specializations support the following methods:
 
-  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries);
+  void addBindings(ComponentStorageEntryVector& entries);
   std::size_t numBindings();
 };*/
 
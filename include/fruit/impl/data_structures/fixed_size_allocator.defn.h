@@ -32,15 +32,32 @@ namespace fruit {
 namespace impl {
 
 template <typename C>
-void FixedSizeAllocator::destroyObject(void* p) {
-  C* cPtr = reinterpret_cast<C*>(p);
-  cPtr->C::~C();
+inline bool FixedSizeAllocator::shouldDestroy(TeardownPolicy policy) {
+  switch (policy) {
+  case TeardownPolicy::DESTROY_ALL:
+    return true;
+  case TeardownPolicy::LEAK_MARKED_TYPES:
+    return !fruit::LeakOnExit<C>::value || fruit::HoldsExternalResources<C>::value;
+  case TeardownPolicy::LEAK_ALL:
+    return fruit::HoldsExternalResources<C>::value;
+  }
+  return true; // LCOV_EXCL_LINE
 }
 
 template <typename C>
-void FixedSizeAllocator::destroyExternalObject(void* p) {
-  C* cPtr = reinterpret_cast<C*>(p);
-  delete cPtr; // LCOV_EXCL_BR_LINE
+void FixedSizeAllocator::destroyObject(void* p, TeardownPolicy policy) {
+  if (shouldDestroy<C>(policy)) {
+    C* cPtr = reinterpret_cast<C*>(p);
+    cPtr->C::~C();
+  }
+}
+
+template <typename C>
+void FixedSizeAllocator::destroyExternalObject(void* p, TeardownPolicy policy) {
+  if (shouldDestroy<C>(policy)) {
+    C* cPtr = reinterpret_cast<C*>(p);
+    delete cPtr; // LCOV_EXCL_BR_LINE
+  }
 }
 
 inline void FixedSizeAllocator::FixedSizeAllocatorData::addType(TypeId typeId) {
@@ -58,6 +75,14 @@ inline void FixedSizeAllocator::FixedSizeAllocatorData::addExternallyAllocatedTy
   num_types_to_destroy++;
 }
 
+inline std::size_t FixedSizeAllocator::FixedSizeAllocatorData::getTotalSize() const {
+  return total_size;
+}
+
+inline std::size_t FixedSizeAllocator::FixedSizeAllocatorData::getNumTypesToDestroy() const {
+  return num_types_to_destroy;
+}
+
 inline std::size_t FixedSizeAllocator::FixedSizeAllocatorData::maximumRequiredSpace(TypeId type) {
   return type.type_info->alignment() + type.type_info->size() - 1;
 }
@@ -101,7 +126,8 @@ inline void FixedSizeAllocator::registerExternallyAllocatedObject(T* p) {
 inline FixedSizeAllocator::FixedSizeAllocator(FixedSizeAllocatorData allocator_data)
     : on_destruction(allocator_data.num_types_to_destroy) {
   // The +1 is because we waste the first byte (storage_last_used points to the beginning of storage).
-  storage_begin = new char[allocator_data.total_size + 1];
+  storage_size = allocator_data.total_size + 1;
+  storage_begin = new char[storage_size];
   storage_last_used = storage_begin;
 #if FRUIT_EXTRA_DEBUG
   remaining_types = allocator_data.types;
@@ -116,7 +142,9 @@ inline FixedSizeAllocator::FixedSizeAllocator(FixedSizeAllocatorData allocator_d
 inline FixedSizeAllocator::FixedSizeAllocator(FixedSizeAllocator&& x) : FixedSizeAllocator() {
   std::swap(storage_begin, x.storage_begin);
   std::swap(storage_last_used, x.storage_last_used);
+  std::swap(storage_size, x.storage_size);
   std::swap(on_destruction, x.on_destruction);
+  std::swap(teardown_policy, x.teardown_policy);
 #if FRUIT_EXTRA_DEBUG
   std::swap(remaining_types, x.remaining_types);
 #endif
@@ -125,13 +153,51 @@ inline FixedSizeAllocator::FixedSizeAllocator(FixedSizeAllocator&& x) : FixedSiz
 inline FixedSizeAllocator& FixedSizeAllocator::operator=(FixedSizeAllocator&& x) {
   std::swap(storage_begin, x.storage_begin);
   std::swap(storage_last_used, x.storage_last_used);
+  std::swap(storage_size, x.storage_size);
   std::swap(on_destruction, x.on_destruction);
+  std::swap(teardown_policy, x.teardown_policy);
 #if FRUIT_EXTRA_DEBUG
   std::swap(remaining_types, x.remaining_types);
 #endif
   return *this;
 }
 
+inline void FixedSizeAllocator::setTeardownPolicy(TeardownPolicy policy) {
+  teardown_policy = policy;
+}
+
+inline TeardownPolicy FixedSizeAllocator::getTeardownPolicy() const {
+  return teardown_policy;
+}
+
+inline std::size_t FixedSizeAllocator::getNumObjectsToDestroy() const {
+  return on_destruction.size();
+}
+
+inline const void* FixedSizeAllocator::getObjectToDestroy(std::size_t i) const {
+  return on_destruction[i].second;
+}
+
+inline void FixedSizeAllocator::destroyObjectAt(std::size_t i) {
+  std::pair<destroy_t, void*>& entry = on_destruction[i];
+  entry.first(entry.second, teardown_policy);
+  // So that the destructor doesn't destroy this object again.
+  entry.first = nullptr;
+}
+
+inline std::size_t FixedSizeAllocator::getReservedBytes() const {
+  return storage_size;
+}
+
+inline std::size_t FixedSizeAllocator::getUsedBytes() const {
+  // The first byte is always wasted, see the constructor.
+  return storage_begin == nullptr ? 0 : storage_last_used - storage_begin + 1;
+}
+
+inline std::size_t FixedSizeAllocator::getDestructionListBytes() const {
+  return on_destruction.getCapacity() * sizeof(std::pair<destroy_t, void*>);
+}
+
 } // namespace fruit
 } // namespace impl
 
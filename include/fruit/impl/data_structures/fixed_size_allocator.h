@@ -17,6 +17,7 @@
 #ifndef FRUIT_FIXED_SIZE_ALLOCATOR_H
 #define FRUIT_FIXED_SIZE_ALLOCATOR_H
 
+#include <fruit/teardown_policy.h>
 #include <fruit/impl/data_structures/fixed_size_vector.h>
 #include <fruit/impl/meta/component.h>
 #include <fruit/impl/util/type_info.h>
@@ -34,7 +35,8 @@ namespace impl {
  */
 class FixedSizeAllocator {
 public:
-  using destroy_t = void (*)(void*);
+  // Destroys the object at the specified address, unless it should be leaked under the specified policy.
+  using destroy_t = void (*)(void*, TeardownPolicy);
 
 private:
   // A pointer to the last used byte in the allocated memory chunk starting at storage_begin.
@@ -43,6 +45,9 @@ private:
   // The chunk of memory that will be used for all allocations.
   char* storage_begin = nullptr;
 
+  // The size of the chunk of memory starting at storage_begin.
+  std::size_t storage_size = 0;
+
 #if FRUIT_EXTRA_DEBUG
   std::unordered_map<TypeId, std::size_t> remaining_types;
 #endif
@@ -52,13 +57,19 @@ private:
   // These must be called in reverse order.
   FixedSizeVector<std::pair<destroy_t, void*>> on_destruction;
 
+  TeardownPolicy teardown_policy = TeardownPolicy::DESTROY_ALL;
+
+  // Returns true if objects of type C must be destroyed under the specified policy.
+  template <typename C>
+  static bool shouldDestroy(TeardownPolicy policy);
+
   // Destroys an object previously created using constructObject().
   template <typename C>
-  static void destroyObject(void* p);
+  static void destroyObject(void* p, TeardownPolicy policy);
 
   // Calls delete on an object previously allocated using new.
   template <typename C>
-  static void destroyExternalObject(void* p);
+  static void destroyExternalObject(void* p, TeardownPolicy policy);
 
 public:
   // Data used to construct an allocator for a fixed set of types.
@@ -83,6 +94,12 @@ public:
     // resulting
     // allocator.
     void addExternallyAllocatedType(TypeId typeId);
+
+    // Returns the number of bytes that the resulting allocator will reserve.
+    std::size_t getTotalSize() const;
+
+    // Returns the number of objects that the resulting allocator might need to destroy.
+    std::size_t getNumTypesToDestroy() const;
   };
 
   // Constructs an empty allocator (no allocations are allowed).
@@ -98,9 +115,26 @@ public:
   FixedSizeAllocator& operator=(const FixedSizeAllocator&) = delete;
 
   // On destruction, all objects allocated with constructObject() and all externally-allocated objects registered with
-  // registerExternallyAllocatedObject() are destroyed.
+  // registerExternallyAllocatedObject() are destroyed, except the ones that should be leaked according to the
+  // teardown policy (see setTeardownPolicy()).
   ~FixedSizeAllocator();
 
+  // Sets the policy used in the destructor to decide which objects to destroy. The default is DESTROY_ALL.
+  void setTeardownPolicy(TeardownPolicy policy);
+
+  TeardownPolicy getTeardownPolicy() const;
+
+  // Returns the number of entries in the list of objects to destroy (in order of construction), including the ones
+  // already destroyed with destroyObjectAt().
+  std::size_t getNumObjectsToDestroy() const;
+
+  // Returns the address of the object destroyed by the i-th entry in the list of objects to destroy.
+  const void* getObjectToDestroy(std::size_t i) const;
+
+  // Destroys the object of the i-th entry in the list of objects to destroy now (unless the teardown policy says to
+  // leak it) instead of in the destructor. This can be called concurrently for different entries.
+  void destroyObjectAt(std::size_t i);
+
   // Allocates an object of type T, constructing it with the specified arguments. Similar to:
   // new C(args...)
   template <typename AnnotatedT, typename... Args>
@@ -110,6 +144,16 @@ public:
 
   template <typename T>
   void registerExternallyAllocatedObject(T* p);
+
+  // Returns the size (in bytes) of the memory reserved for the objects constructed with constructObject().
+  std::size_t getReservedBytes() const;
+
+  // Returns the size (in bytes) of the part of the reserved memory that has been used so far, including the padding
+  // needed to align the objects.
+  std::size_t getUsedBytes() const;
+
+  // Returns the size (in bytes) of the memory allocated for the list of objects to destroy.
+  std::size_t getDestructionListBytes() const;
 };
 
 } // namespace impl
@@ -63,6 +63,11 @@ inline std::size_t FixedSizeVector<T, Allocator>::size() const {
   return end() - begin();
 }
 
+template <typename T, typename Allocator>
+inline std::size_t FixedSizeVector<T, Allocator>::getCapacity() const {
+  return capacity;
+}
+
 template <typename T, typename Allocator>
 inline T& FixedSizeVector<T, Allocator>::operator[](std::size_t i) {
   FruitAssert(begin() + i < end());
@@ -80,6 +85,7 @@ inline void FixedSizeVector<T, Allocator>::swap(FixedSizeVector& x) {
   std::swap(v_end, x.v_end);
   std::swap(v_begin, x.v_begin);
   std::swap(capacity, x.capacity);
+  std::swap(allocator, x.allocator);
 }
 
 template <typename T, typename Allocator>
@@ -60,6 +60,10 @@ public:
 
   std::size_t size() const;
 
+  // Returns the maximum number of elements that this vector can hold (i.e. the number of elements it allocated space
+  // for).
+  std::size_t getCapacity() const;
+
   T& operator[](std::size_t i);
   const T& operator[](std::size_t i) const;
 
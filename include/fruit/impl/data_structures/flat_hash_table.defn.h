@@ -0,0 +1,565 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_FLAT_HASH_TABLE_DEFN_H
+#define FRUIT_FLAT_HASH_TABLE_DEFN_H
+
+#include <fruit/impl/data_structures/flat_hash_table.h>
+#include <fruit/impl/fruit-config.h>
+#include <fruit/impl/fruit_assert.h>
+
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace fruit {
+namespace impl {
+
+#if FRUIT_FLAT_HASH_TABLE_USES_SSE2
+
+inline FlatHashTableGroup::FlatHashTableGroup(const std::int8_t* ctrl)
+    : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+inline std::uint32_t FlatHashTableGroup::match(std::int8_t h2) const {
+  return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+}
+
+inline std::uint32_t FlatHashTableGroup::matchEmpty() const {
+  return match(EMPTY);
+}
+
+inline std::uint32_t FlatHashTableGroup::matchEmptyOrDeleted() const {
+  // EMPTY and DELETED are the only control bytes with the high bit set.
+  return static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl));
+}
+
+#else
+
+inline FlatHashTableGroup::FlatHashTableGroup(const std::int8_t* ctrl) : ctrl(ctrl) {}
+
+inline std::uint32_t FlatHashTableGroup::match(std::int8_t h2) const {
+  std::uint32_t result = 0;
+  for (std::size_t i = 0; i < WIDTH; ++i) {
+    if (ctrl[i] == h2) {
+      result |= std::uint32_t(1) << i;
+    }
+  }
+  return result;
+}
+
+inline std::uint32_t FlatHashTableGroup::matchEmpty() const {
+  return match(EMPTY);
+}
+
+inline std::uint32_t FlatHashTableGroup::matchEmptyOrDeleted() const {
+  std::uint32_t result = 0;
+  for (std::size_t i = 0; i < WIDTH; ++i) {
+    if (ctrl[i] < 0) {
+      result |= std::uint32_t(1) << i;
+    }
+  }
+  return result;
+}
+
+#endif // FRUIT_FLAT_HASH_TABLE_USES_SSE2
+
+inline std::size_t FlatHashTableGroup::lowestBitIndex(std::uint32_t mask) {
+  FruitAssert(mask != 0);
+#if defined(__GNUC__)
+  return static_cast<std::size_t>(__builtin_ctz(mask));
+#elif defined(_MSC_VER)
+  unsigned long result;
+  _BitScanForward(&result, mask);
+  return result;
+#else
+  std::size_t result = 0;
+  while ((mask & 1) == 0) {
+    mask >>= 1;
+    ++result;
+  }
+  return result;
+#endif
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+template <typename Reference, typename Pointer>
+inline FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::Iterator<Reference, Pointer>::Iterator(
+    const std::int8_t* ctrl, const std::int8_t* ctrl_end, ValueType* slot)
+    : ctrl(ctrl), ctrl_end(ctrl_end), slot(slot) {
+  skipNonFullSlots();
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+template <typename Reference, typename Pointer>
+template <typename OtherReference, typename OtherPointer>
+inline FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::Iterator<Reference, Pointer>::Iterator(
+    const Iterator<OtherReference, OtherPointer>& other)
+    : ctrl(other.ctrl), ctrl_end(other.ctrl_end), slot(other.slot) {}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+template <typename Reference, typename Pointer>
+inline void FlatHashTable<Key, ValueType, KeyOfValue, Hasher,
+                          EqualityComparator>::Iterator<Reference, Pointer>::skipNonFullSlots() {
+  while (ctrl != ctrl_end && *ctrl < 0) {
+    ++ctrl;
+    ++slot;
+  }
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+template <typename Reference, typename Pointer>
+inline Reference FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::Iterator<Reference, Pointer>::
+operator*() const {
+  FruitAssert(ctrl != ctrl_end);
+  return *slot;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+template <typename Reference, typename Pointer>
+inline Pointer FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::Iterator<Reference, Pointer>::
+operator->() const {
+  FruitAssert(ctrl != ctrl_end);
+  return slot;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+template <typename Reference, typename Pointer>
+inline typename FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::template Iterator<Reference,
+                                                                                                          Pointer>&
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::Iterator<Reference, Pointer>::operator++() {
+  FruitAssert(ctrl != ctrl_end);
+  ++ctrl;
+  ++slot;
+  skipNonFullSlots();
+  return *this;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+template <typename Reference, typename Pointer>
+inline bool FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::Iterator<Reference, Pointer>::
+operator==(const Iterator& other) const {
+  return ctrl == other.ctrl;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+template <typename Reference, typename Pointer>
+inline bool FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::Iterator<Reference, Pointer>::
+operator!=(const Iterator& other) const {
+  return ctrl != other.ctrl;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::FlatHashTable(
+    std::size_t capacity, Hasher hasher, EqualityComparator equality_comparator, MemoryPool& memory_pool)
+    : memory_pool(&memory_pool), hasher(hasher), equality_comparator(equality_comparator), slots(nullptr),
+      ctrl(nullptr), num_slots(0), num_elements(0), growth_left(0) {
+  if (capacity != 0) {
+    std::size_t new_num_slots = FlatHashTableGroup::WIDTH;
+    while (maxElementsForNumSlots(new_num_slots) < capacity) {
+      new_num_slots *= 2;
+    }
+    allocate(new_num_slots);
+  }
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::FlatHashTable(FlatHashTable&& other)
+    : memory_pool(other.memory_pool), hasher(std::move(other.hasher)),
+      equality_comparator(std::move(other.equality_comparator)), slots(other.slots), ctrl(other.ctrl),
+      num_slots(other.num_slots), num_elements(other.num_elements), growth_left(other.growth_left) {
+  other.slots = nullptr;
+  other.ctrl = nullptr;
+  other.num_slots = 0;
+  other.num_elements = 0;
+  other.growth_left = 0;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>&
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::operator=(FlatHashTable&& other) {
+  if (this != &other) {
+    destroyElements();
+    memory_pool = other.memory_pool;
+    hasher = std::move(other.hasher);
+    equality_comparator = std::move(other.equality_comparator);
+    slots = other.slots;
+    ctrl = other.ctrl;
+    num_slots = other.num_slots;
+    num_elements = other.num_elements;
+    growth_left = other.growth_left;
+    other.slots = nullptr;
+    other.ctrl = nullptr;
+    other.num_slots = 0;
+    other.num_elements = 0;
+    other.growth_left = 0;
+  }
+  return *this;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::~FlatHashTable() {
+  // The memory is owned by the MemoryPool, we only need to destroy the elements.
+  destroyElements();
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline typename FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::iterator
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::begin() {
+  return iterator(ctrl, ctrl + num_slots, slots);
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline typename FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::iterator
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::end() {
+  return iterator(ctrl + num_slots, ctrl + num_slots, slots + num_slots);
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline typename FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::const_iterator
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::begin() const {
+  return const_iterator(ctrl, ctrl + num_slots, slots);
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline typename FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::const_iterator
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::end() const {
+  return const_iterator(ctrl + num_slots, ctrl + num_slots, slots + num_slots);
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline std::size_t FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::size() const {
+  return num_elements;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline bool FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::empty() const {
+  return num_elements == 0;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline typename FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::iterator
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::find(const Key& key) {
+  std::size_t index = findIndex(key);
+  if (index == notFound()) {
+    return end();
+  }
+  return iteratorAt(index);
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline typename FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::const_iterator
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::find(const Key& key) const {
+  std::size_t index = findIndex(key);
+  if (index == notFound()) {
+    return end();
+  }
+  return iteratorAt(index);
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline std::size_t FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::count(const Key& key) const {
+  return findIndex(key) == notFound() ? 0 : 1;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline std::pair<typename FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::iterator, bool>
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::insert(const ValueType& value) {
+  return insertHelper(value);
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline std::pair<typename FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::iterator, bool>
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::insert(ValueType&& value) {
+  return insertHelper(std::move(value));
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+template <typename V>
+inline std::pair<typename FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::iterator, bool>
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::insertHelper(V&& value) {
+  std::pair<std::size_t, bool> result = findOrEmplace(KeyOfValue()(value), std::forward<V>(value));
+  return std::make_pair(iteratorAt(result.first), result.second);
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline void FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::erase(iterator itr) {
+  std::size_t index = &*itr - slots;
+  FruitAssert(index < num_slots);
+  FruitAssert(ctrl[index] >= 0);
+  slots[index].~ValueType();
+  // We can't mark the slot as EMPTY, or lookups for elements that were inserted after this one (and that collided
+  // with it) would stop here.
+  setCtrl(index, FlatHashTableGroup::DELETED);
+  --num_elements;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline std::size_t FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::erase(const Key& key) {
+  std::size_t index = findIndex(key);
+  if (index == notFound()) {
+    return 0;
+  }
+  erase(iteratorAt(index));
+  return 1;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline void FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::clear() {
+  destroyElements();
+  if (num_slots != 0) {
+    std::memset(ctrl, static_cast<unsigned char>(FlatHashTableGroup::EMPTY), num_slots + FlatHashTableGroup::WIDTH);
+  }
+  num_elements = 0;
+  growth_left = maxElementsForNumSlots(num_slots);
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+template <typename... Args>
+inline std::pair<std::size_t, bool>
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::findOrEmplace(const Key& key, Args&&... args) {
+  std::size_t key_hash = hash(key);
+  std::size_t index = findIndex(key, key_hash);
+  if (index != notFound()) {
+    return std::make_pair(index, false);
+  }
+  index = prepareInsert(key_hash);
+  // `key' might refer to a value in `args', so it must not be used after this point.
+  new (slots + index) ValueType(std::forward<Args>(args)...);
+  finishInsert(index, key_hash);
+  return std::make_pair(index, true);
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline ValueType& FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::slotAt(std::size_t index) {
+  FruitAssert(index < num_slots);
+  return slots[index];
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline const ValueType&
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::slotAt(std::size_t index) const {
+  FruitAssert(index < num_slots);
+  return slots[index];
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline std::size_t FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::notFound() {
+  return std::size_t(-1);
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline std::size_t
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::findIndex(const Key& key) const {
+  return findIndex(key, hash(key));
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline std::size_t FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::hash(const Key& key) const {
+  std::size_t h = hasher(key);
+  // A multiply-xorshift mixer, so that both the low bits (used for H2) and the high bits (used for H1) depend on all
+  // the bits of the original hash.
+  constexpr const unsigned half_bits = sizeof(std::size_t) * CHAR_BIT / 2;
+  h ^= h >> half_bits;
+  h *= static_cast<std::size_t>(0x9E3779B97F4A7C15ULL);
+  h ^= h >> half_bits;
+  return h;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline std::size_t FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::h1(std::size_t hash) {
+  return hash >> 7;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline std::int8_t FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::h2(std::size_t hash) {
+  return static_cast<std::int8_t>(hash & 0x7F);
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline std::size_t
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::maxElementsForNumSlots(std::size_t num_slots) {
+  // Max load factor: 7/8.
+  return num_slots - num_slots / 8;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline void FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::setCtrl(std::size_t index,
+                                                                                        std::int8_t value) {
+  ctrl[index] = value;
+  if (index < FlatHashTableGroup::WIDTH) {
+    ctrl[num_slots + index] = value;
+  }
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline std::size_t FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::findIndex(
+    const Key& key, std::size_t key_hash) const {
+  if (num_slots == 0) {
+    return notFound();
+  }
+  std::size_t mask = num_slots - 1;
+  std::size_t position = h1(key_hash) & mask;
+  std::int8_t key_h2 = h2(key_hash);
+  // Triangular probing over groups. Since the number of groups is a power of 2 this visits all of them.
+  for (std::size_t step = FlatHashTableGroup::WIDTH;; step += FlatHashTableGroup::WIDTH) {
+    FlatHashTableGroup group(ctrl + position);
+    for (std::uint32_t matches = group.match(key_h2); matches != 0; matches &= matches - 1) {
+      std::size_t index = (position + FlatHashTableGroup::lowestBitIndex(matches)) & mask;
+      if (equality_comparator(KeyOfValue()(slots[index]), key)) {
+        return index;
+      }
+    }
+    if (group.matchEmpty() != 0) {
+      return notFound();
+    }
+    position = (position + step) & mask;
+  }
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline std::size_t
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::findFirstNonFull(std::size_t key_hash) const {
+  FruitAssert(num_slots != 0);
+  std::size_t mask = num_slots - 1;
+  std::size_t position = h1(key_hash) & mask;
+  for (std::size_t step = FlatHashTableGroup::WIDTH;; step += FlatHashTableGroup::WIDTH) {
+    std::uint32_t candidates = FlatHashTableGroup(ctrl + position).matchEmptyOrDeleted();
+    if (candidates != 0) {
+      return (position + FlatHashTableGroup::lowestBitIndex(candidates)) & mask;
+    }
+    position = (position + step) & mask;
+  }
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline std::size_t
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::prepareInsert(std::size_t key_hash) {
+  std::size_t index = num_slots == 0 ? notFound() : findFirstNonFull(key_hash);
+  if (index == notFound() || (growth_left == 0 && ctrl[index] == FlatHashTableGroup::EMPTY)) {
+    if (num_slots == 0) {
+      rehash(FlatHashTableGroup::WIDTH);
+    } else if (num_elements * 2 < maxElementsForNumSlots(num_slots)) {
+      // Most of the non-full slots are DELETED, we just need to clean them up.
+      rehash(num_slots);
+    } else {
+      rehash(num_slots * 2);
+    }
+    index = findFirstNonFull(key_hash);
+  }
+  return index;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline void FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::finishInsert(std::size_t index,
+                                                                                                std::size_t key_hash) {
+  if (ctrl[index] == FlatHashTableGroup::EMPTY) {
+    --growth_left;
+  }
+  setCtrl(index, h2(key_hash));
+  ++num_elements;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline void FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::allocate(std::size_t new_num_slots) {
+  FruitAssert(new_num_slots >= FlatHashTableGroup::WIDTH);
+  FruitAssert((new_num_slots & (new_num_slots - 1)) == 0);
+  // The slots and the control bytes are allocated in a single block, with the control bytes at the end so that the
+  // slots are aligned.
+  std::size_t num_ctrl_bytes = new_num_slots + FlatHashTableGroup::WIDTH;
+  std::size_t num_slots_for_ctrl_bytes = (num_ctrl_bytes + sizeof(ValueType) - 1) / sizeof(ValueType);
+  slots = memory_pool->allocate<ValueType>(new_num_slots + num_slots_for_ctrl_bytes);
+  ctrl = reinterpret_cast<std::int8_t*>(slots + new_num_slots);
+  std::memset(ctrl, static_cast<unsigned char>(FlatHashTableGroup::EMPTY), num_ctrl_bytes);
+  num_slots = new_num_slots;
+  growth_left = maxElementsForNumSlots(new_num_slots) - num_elements;
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline void FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::rehash(std::size_t new_num_slots) {
+  ValueType* old_slots = slots;
+  std::int8_t* old_ctrl = ctrl;
+  std::size_t old_num_slots = num_slots;
+
+  // The old block is not returned to the MemoryPool, it will be deallocated with the pool.
+  allocate(new_num_slots);
+
+  for (std::size_t i = 0; i < old_num_slots; ++i) {
+    if (old_ctrl[i] >= 0) {
+      std::size_t key_hash = hash(KeyOfValue()(old_slots[i]));
+      std::size_t index = findFirstNonFull(key_hash);
+      setCtrl(index, h2(key_hash));
+      new (slots + index) ValueType(std::move(old_slots[i]));
+      old_slots[i].~ValueType();
+    }
+  }
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline void FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::destroyElements() {
+  for (std::size_t i = 0; i < num_slots; ++i) {
+    if (ctrl[i] >= 0) {
+      slots[i].~ValueType();
+    }
+  }
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline typename FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::iterator
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::iteratorAt(std::size_t index) {
+  return iterator(ctrl + index, ctrl + num_slots, slots + index);
+}
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+inline typename FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::const_iterator
+FlatHashTable<Key, ValueType, KeyOfValue, Hasher, EqualityComparator>::iteratorAt(std::size_t index) const {
+  return const_iterator(ctrl + index, ctrl + num_slots, slots + index);
+}
+
+template <typename Key, typename Value, typename Hasher, typename EqualityComparator>
+inline Value& FlatHashMap<Key, Value, Hasher, EqualityComparator>::operator[](const Key& key) {
+  std::pair<std::size_t, bool> result = this->findOrEmplace(key, key, Value());
+  return this->slotAt(result.first).second;
+}
+
+template <typename Key, typename Value, typename Hasher, typename EqualityComparator>
+inline Value& FlatHashMap<Key, Value, Hasher, EqualityComparator>::at(const Key& key) {
+  std::size_t index = this->findIndex(key);
+  if (index == Base::notFound()) {
+    // This is a bug in the caller; we abort() even in release builds, instead of returning a garbage reference.
+    std::abort();
+  }
+  return this->slotAt(index).second;
+}
+
+template <typename Key, typename Value, typename Hasher, typename EqualityComparator>
+inline const Value& FlatHashMap<Key, Value, Hasher, EqualityComparator>::at(const Key& key) const {
+  std::size_t index = this->findIndex(key);
+  if (index == Base::notFound()) {
+    // This is a bug in the caller; we abort() even in release builds, instead of returning a garbage reference.
+    std::abort();
+  }
+  return this->slotAt(index).second;
+}
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_FLAT_HASH_TABLE_DEFN_H
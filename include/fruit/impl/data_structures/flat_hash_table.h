@@ -0,0 +1,270 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_FLAT_HASH_TABLE_H
+#define FRUIT_FLAT_HASH_TABLE_H
+
+#include <fruit/impl/data_structures/memory_pool.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUIT_FLAT_HASH_TABLE_USES_SSE2 1
+#include <emmintrin.h>
+#else
+#define FRUIT_FLAT_HASH_TABLE_USES_SSE2 0
+#endif
+
+namespace fruit {
+namespace impl {
+
+/**
+ * A group of consecutive control bytes of a FlatHashTable, that are probed together.
+ * With SSE2 a group has 16 control bytes and each probe takes a few instructions; otherwise a group has 8 control
+ * bytes and they're checked one by one.
+ */
+class FlatHashTableGroup {
+public:
+#if FRUIT_FLAT_HASH_TABLE_USES_SSE2
+  enum { WIDTH = 16 };
+#else
+  enum { WIDTH = 8 };
+#endif
+
+  // The control byte of a full slot is the H2 part of the hash of its element (0-127), so it's never negative.
+  enum : std::int8_t {
+    EMPTY = -128,
+    DELETED = -2,
+  };
+
+  explicit FlatHashTableGroup(const std::int8_t* ctrl);
+
+  // Returns a bitmask with the i-th bit set iff the i-th control byte in this group is h2.
+  std::uint32_t match(std::int8_t h2) const;
+
+  // Returns a bitmask with the i-th bit set iff the i-th slot in this group is empty.
+  std::uint32_t matchEmpty() const;
+
+  // Returns a bitmask with the i-th bit set iff the i-th slot in this group is empty or deleted.
+  std::uint32_t matchEmptyOrDeleted() const;
+
+  // Returns the index of the lowest set bit in `mask', that must be non-zero.
+  static std::size_t lowestBitIndex(std::uint32_t mask);
+
+private:
+#if FRUIT_FLAT_HASH_TABLE_USES_SSE2
+  __m128i ctrl;
+#else
+  const std::int8_t* ctrl;
+#endif
+};
+
+/**
+ * An open-addressing hash table whose elements are stored inline in a single array allocated from a MemoryPool, so
+ * there's no per-element allocation. Each slot has a control byte that stores whether it's empty/deleted or the 7
+ * lowest bits of the hash of its element; lookups probe a FlatHashTableGroup of control bytes at a time and only
+ * compare the keys whose control byte matches.
+ *
+ * This supports the subset of the std::unordered_{set,map} API that Fruit needs. Unlike the std containers, erase()
+ * doesn't invalidate iterators to other elements (but insertions invalidate all iterators).
+ * When the table grows, the old array is not reclaimed until the MemoryPool is destroyed, so an appropriate capacity
+ * should be specified at construction when possible.
+ *
+ * Use FlatHashSet or FlatHashMap instead of using this class directly.
+ */
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hasher, typename EqualityComparator>
+class FlatHashTable {
+private:
+  template <typename Reference, typename Pointer>
+  class Iterator {
+  private:
+    const std::int8_t* ctrl;
+    const std::int8_t* ctrl_end;
+    ValueType* slot;
+
+    void skipNonFullSlots();
+
+  public:
+    Iterator(const std::int8_t* ctrl, const std::int8_t* ctrl_end, ValueType* slot);
+
+    // Allows the conversion from iterator to const_iterator.
+    template <typename OtherReference, typename OtherPointer>
+    Iterator(const Iterator<OtherReference, OtherPointer>& other);
+
+    Reference operator*() const;
+    Pointer operator->() const;
+    Iterator& operator++();
+    bool operator==(const Iterator& other) const;
+    bool operator!=(const Iterator& other) const;
+
+    template <typename, typename>
+    friend class Iterator;
+  };
+
+public:
+  using key_type = Key;
+  using value_type = ValueType;
+  using iterator = Iterator<ValueType&, ValueType*>;
+  using const_iterator = Iterator<const ValueType&, const ValueType*>;
+
+  /**
+   * Constructs an empty table that can hold `capacity' elements before growing.
+   * The memory_pool must outlive this object.
+   */
+  FlatHashTable(std::size_t capacity, Hasher hasher, EqualityComparator equality_comparator, MemoryPool& memory_pool);
+
+  FlatHashTable(FlatHashTable&& other);
+  FlatHashTable& operator=(FlatHashTable&& other);
+
+  FlatHashTable(const FlatHashTable&) = delete;
+  FlatHashTable& operator=(const FlatHashTable&) = delete;
+
+  ~FlatHashTable();
+
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  std::size_t size() const;
+  bool empty() const;
+
+  iterator find(const Key& key);
+  const_iterator find(const Key& key) const;
+  std::size_t count(const Key& key) const;
+
+  std::pair<iterator, bool> insert(const ValueType& value);
+  std::pair<iterator, bool> insert(ValueType&& value);
+
+  void erase(iterator itr);
+  std::size_t erase(const Key& key);
+
+  void clear();
+
+protected:
+  /**
+   * Returns the index of the slot that holds the element with key `key' and false if there is one, otherwise
+   * constructs a ValueType with key `key' from `args' in a new slot and returns its index and true.
+   * If that constructor throws, the table is left unchanged (except that it might have been rehashed).
+   */
+  template <typename... Args>
+  std::pair<std::size_t, bool> findOrEmplace(const Key& key, Args&&... args);
+
+  ValueType& slotAt(std::size_t index);
+  const ValueType& slotAt(std::size_t index) const;
+
+  // A value returned by findIndex() when the key is not in the table.
+  static std::size_t notFound();
+
+  std::size_t findIndex(const Key& key) const;
+
+private:
+  MemoryPool* memory_pool;
+  Hasher hasher;
+  EqualityComparator equality_comparator;
+
+  // The slots, where only the full ones contain a constructed ValueType.
+  ValueType* slots;
+
+  // The control bytes: ctrl[i] is the control byte for slots[i]. There are FlatHashTableGroup::WIDTH extra bytes at the
+  // end, mirroring the first ones, so that a group can be loaded from any position.
+  std::int8_t* ctrl;
+
+  // Either 0 or a power of 2 that's >= FlatHashTableGroup::WIDTH.
+  std::size_t num_slots;
+
+  std::size_t num_elements;
+
+  // The number of elements that can be inserted in empty (not deleted) slots before we need to rehash.
+  std::size_t growth_left;
+
+  template <typename V>
+  std::pair<iterator, bool> insertHelper(V&& value);
+
+  // Mixes the hash, since hashers like std::hash<T*> often have low-entropy low bits.
+  std::size_t hash(const Key& key) const;
+
+  static std::size_t h1(std::size_t hash);
+  static std::int8_t h2(std::size_t hash);
+
+  static std::size_t maxElementsForNumSlots(std::size_t num_slots);
+
+  void setCtrl(std::size_t index, std::int8_t value);
+
+  std::size_t findIndex(const Key& key, std::size_t hash) const;
+  std::size_t findFirstNonFull(std::size_t hash) const;
+  // Returns the index of the slot where an element with this hash should be inserted, rehashing if needed. The slot
+  // is only marked as full by finishInsert(), after the element has been constructed in it.
+  std::size_t prepareInsert(std::size_t hash);
+  void finishInsert(std::size_t index, std::size_t hash);
+
+  void allocate(std::size_t new_num_slots);
+  void rehash(std::size_t new_num_slots);
+  void destroyElements();
+
+  iterator iteratorAt(std::size_t index);
+  const_iterator iteratorAt(std::size_t index) const;
+};
+
+template <typename T>
+struct FlatHashSetKeyOfValue {
+  const T& operator()(const T& value) const {
+    return value;
+  }
+};
+
+template <typename Key, typename Value>
+struct FlatHashMapKeyOfValue {
+  const Key& operator()(const std::pair<const Key, Value>& value) const {
+    return value.first;
+  }
+};
+
+template <typename T, typename Hasher, typename EqualityComparator>
+using FlatHashSet = FlatHashTable<T, T, FlatHashSetKeyOfValue<T>, Hasher, EqualityComparator>;
+
+template <typename Key, typename Value, typename Hasher, typename EqualityComparator>
+class FlatHashMap : public FlatHashTable<Key, std::pair<const Key, Value>, FlatHashMapKeyOfValue<Key, Value>, Hasher,
+                                         EqualityComparator> {
+private:
+  using Base =
+      FlatHashTable<Key, std::pair<const Key, Value>, FlatHashMapKeyOfValue<Key, Value>, Hasher, EqualityComparator>;
+
+public:
+  using mapped_type = Value;
+
+  using Base::Base;
+
+  /**
+   * Returns the value associated with `key', inserting a value-initialized one if there was none.
+   */
+  Value& operator[](const Key& key);
+
+  /**
+   * Returns the value associated with `key', that must be in the map.
+   */
+  Value& at(const Key& key);
+  const Value& at(const Key& key) const;
+};
+
+} // namespace impl
+} // namespace fruit
+
+#include <fruit/impl/data_structures/flat_hash_table.defn.h>
+
+#endif // FRUIT_FLAT_HASH_TABLE_H
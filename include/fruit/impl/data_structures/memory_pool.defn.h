@@ -26,12 +26,14 @@
 namespace fruit {
 namespace impl {
 
-inline MemoryPool::MemoryPool() : first_free(nullptr), capacity(0) {}
+inline MemoryPool::MemoryPool() : first_free(nullptr), capacity(0), allocated_bytes(0) {}
 
 inline MemoryPool::MemoryPool(MemoryPool&& other)
-    : allocated_chunks(std::move(other.allocated_chunks)), first_free(other.first_free), capacity(other.capacity) {
+    : allocated_chunks(std::move(other.allocated_chunks)), first_free(other.first_free), capacity(other.capacity),
+      allocated_bytes(other.allocated_bytes) {
   // This is to be sure that we don't double-deallocate.
   other.allocated_chunks.clear();
+  other.allocated_bytes = 0;
 }
 
 inline MemoryPool& MemoryPool::operator=(MemoryPool&& other) {
@@ -40,9 +42,11 @@ inline MemoryPool& MemoryPool::operator=(MemoryPool&& other) {
   allocated_chunks = std::move(other.allocated_chunks);
   first_free = other.first_free;
   capacity = other.capacity;
+  allocated_bytes = other.allocated_bytes;
 
   // This is to be sure that we don't double-deallocate.
   other.allocated_chunks.clear();
+  other.allocated_bytes = 0;
 
   return *this;
 }
@@ -56,6 +60,7 @@ FRUIT_ALWAYS_INLINE inline T* MemoryPool::allocate(std::size_t n) {
 #if FRUIT_DISABLE_ARENA_ALLOCATION
   void* p = operator new(n * sizeof(T));
   allocated_chunks.push_back(p);
+  allocated_bytes += n * sizeof(T);
   return static_cast<T*>(p);
 #else
 
@@ -74,8 +79,10 @@ FRUIT_ALWAYS_INLINE inline T* MemoryPool::allocate(std::size_t n) {
     void* p;
     if (required_space > CHUNK_SIZE) {
       p = operator new(required_space); // LCOV_EXCL_BR_LINE
+      allocated_bytes += required_space;
     } else {
       p = operator new(CHUNK_SIZE);
+      allocated_bytes += CHUNK_SIZE;
       first_free = static_cast<char*>(p) + required_space;
       capacity = CHUNK_SIZE - required_space;
     }
@@ -91,6 +98,10 @@ FRUIT_ALWAYS_INLINE inline T* MemoryPool::allocate(std::size_t n) {
 #endif
 }
 
+inline std::size_t MemoryPool::getAllocatedBytes() const {
+  return allocated_bytes;
+}
+
 } // namespace impl
 } // namespace fruit
 
@@ -38,6 +38,9 @@ private:
   char* first_free;
   std::size_t capacity;
 
+  // The total size of the chunks in allocated_chunks.
+  std::size_t allocated_bytes;
+
   void destroy();
 
 public:
@@ -55,6 +58,12 @@ public:
    */
   template <typename T>
   T* allocate(std::size_t n);
+
+  /**
+   * Returns the total size (in bytes) of the memory obtained from the system so far, that will be retained until
+   * this object is destroyed.
+   */
+  std::size_t getAllocatedBytes() const;
 };
 
 } // namespace impl
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef FRUIT_OBJECT_ARENA_DEFN_H
+#define FRUIT_OBJECT_ARENA_DEFN_H
+
+#include <fruit/impl/data_structures/object_arena.h>
+
+#include <new>
+#include <type_traits>
+
+namespace fruit {
+namespace impl {
+
+template <typename C>
+void ObjectArena::destroyObject(void* p) {
+  C* cPtr = reinterpret_cast<C*>(p);
+  cPtr->C::~C();
+}
+
+template <typename C, typename... Args>
+inline C* ObjectArena::make(Args&&... args) {
+  void* p;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    p = allocate(sizeof(C), alignof(C));
+  }
+  // The constructor is called without holding the lock, since it might construct other objects in this arena (e.g.
+  // through a fruit::Factory).
+  C* c = new (p) C(std::forward<Args>(args)...);
+  if (!std::is_trivially_destructible<C>::value) {
+    try {
+      registerObjectToDestroy(destroyObject<C>, c);
+    } catch (...) {
+      // The memory is released with the rest of the arena, but the object must be destroyed here.
+      c->C::~C();
+      throw;
+    }
+  }
+  return c;
+}
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_OBJECT_ARENA_DEFN_H
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef FRUIT_OBJECT_ARENA_H
+#define FRUIT_OBJECT_ARENA_H
+
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * A growable arena where an injector constructs the objects returned by the factories bound with
+ * PartialComponent::registerArenaFactory(). The objects are never destroyed individually: they are all destroyed (in
+ * reverse order of construction) and their memory is released in clear(), or when the arena is destroyed.
+ *
+ * Unlike MemoryPool, this can be used concurrently by multiple threads.
+ */
+class ObjectArena {
+public:
+  using destroy_t = void (*)(void*);
+
+  ObjectArena() = default;
+
+  ObjectArena(const ObjectArena&) = delete;
+  ObjectArena& operator=(const ObjectArena&) = delete;
+
+  ~ObjectArena();
+
+  /**
+   * Constructs a C with the specified arguments in the arena.
+   * If the constructor throws, the memory reserved for the object is only reclaimed when the arena is cleared.
+   */
+  template <typename C, typename... Args>
+  C* make(Args&&... args);
+
+  /**
+   * Destroys all the objects constructed so far and releases their memory.
+   */
+  void clear();
+
+  /**
+   * Returns the total size (in bytes) of the memory obtained from the system so far, that will be retained until
+   * clear() is called.
+   */
+  std::size_t getAllocatedBytes();
+
+private:
+  // The size of the first chunk. Each new chunk is twice as big as the previous one, up to MAX_CHUNK_SIZE.
+  // We don't use the full 4KB for the same reason as in MemoryPool.
+  constexpr static const std::size_t INITIAL_CHUNK_SIZE = 4 * 1024 - 64;
+  constexpr static const std::size_t MAX_CHUNK_SIZE = 256 * 1024 - 64;
+
+  // Protects all the fields below.
+  std::mutex mutex;
+
+  std::vector<void*> allocated_chunks;
+
+  // The memory block [first_free, first_free + capacity) is available for allocation.
+  char* first_free = nullptr;
+  std::size_t capacity = 0;
+
+  // The size of the next chunk that will be allocated (unless a bigger one is needed for a single object).
+  std::size_t next_chunk_size = INITIAL_CHUNK_SIZE;
+
+  // The total size of the chunks in allocated_chunks.
+  std::size_t allocated_bytes = 0;
+
+  // The objects to destroy in clear(), in order of construction. Trivially-destructible objects are not included.
+  std::vector<std::pair<destroy_t, void*>> on_destruction;
+
+  // Returns `size' bytes of memory aligned to `alignment' (that must be a power of 2).
+  void* allocate(std::size_t size, std::size_t alignment);
+
+  void registerObjectToDestroy(destroy_t destroy, void* p);
+
+  template <typename C>
+  static void destroyObject(void* p);
+};
+
+} // namespace impl
+} // namespace fruit
+
+#include <fruit/impl/data_structures/object_arena.defn.h>
+
+#endif // FRUIT_OBJECT_ARENA_H
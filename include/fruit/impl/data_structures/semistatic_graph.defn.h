@@ -144,6 +144,57 @@ SemistaticGraph<NodeId, Node>::find(NodeId nodeId) const {
   }
 }
 
+template <typename NodeId, typename Node>
+inline std::size_t SemistaticGraph<NodeId, Node>::size() const {
+  return nodes.size();
+}
+
+template <typename NodeId, typename Node>
+inline std::size_t SemistaticGraph<NodeId, Node>::indexOf(node_iterator itr) const {
+  return itr.itr - nodes.data();
+}
+
+template <typename NodeId, typename Node>
+inline std::size_t SemistaticGraph<NodeId, Node>::getNumHashFunctionRetries() const {
+  return node_index_map.getNumHashFunctionRetries();
+}
+
+template <typename NodeId, typename Node>
+inline std::size_t SemistaticGraph<NodeId, Node>::getNodesBytes() const {
+  return nodes.getCapacity() * sizeof(NodeData);
+}
+
+template <typename NodeId, typename Node>
+inline std::size_t SemistaticGraph<NodeId, Node>::getEdgesBytes() const {
+  return edges_storage.getCapacity() * sizeof(InternalNodeId);
+}
+
+template <typename NodeId, typename Node>
+inline std::size_t SemistaticGraph<NodeId, Node>::getNodeIndexLookupTableBytes() const {
+  return node_index_map.getLookupTableBytes();
+}
+
+template <typename NodeId, typename Node>
+inline std::size_t SemistaticGraph<NodeId, Node>::getNodeIndexValuesBytes() const {
+  return node_index_map.getValuesBytes();
+}
+
+template <typename NodeId, typename Node>
+inline SemistaticMapDiagnostics SemistaticGraph<NodeId, Node>::getNodeIndexMapDiagnostics() const {
+  return node_index_map.getDiagnostics();
+}
+
+template <typename NodeId, typename Node>
+template <typename Visitor>
+inline void SemistaticGraph<NodeId, Node>::forEachNode(Visitor visitor) {
+  node_index_map.forEach([this, &visitor](NodeId node_id, InternalNodeId internal_node_id) {
+    NodeData* node_data = nodeAtId(internal_node_id);
+    if (node_data->edges_begin != 1) {
+      visitor(node_id, node_iterator{node_data});
+    }
+  });
+}
+
 template <typename NodeId, typename Node>
 inline typename SemistaticGraph<NodeId, Node>::node_iterator SemistaticGraph<NodeId, Node>::find(NodeId nodeId) {
   const InternalNodeId* internalNodeIdPtr = node_index_map.find(nodeId);
@@ -98,6 +98,11 @@ private:
   void printGraph(NodeIter first, NodeIter last);
 #endif
 
+  // Appends the edges of *i to edges_storage (unless they can be shared with another node that was already added) and
+  // returns the resulting value for the edges_begin field of the node.
+  template <typename NodeIter, typename SharedEdgesMap>
+  std::uintptr_t getOrAddEdges(NodeIter i, SharedEdgesMap& shared_edges);
+
   NodeData* nodeAtId(InternalNodeId internalNodeId);
   const NodeData* nodeAtId(InternalNodeId internalNodeId) const;
 
@@ -179,7 +184,8 @@ public:
    * - x.getValue(), returning a Node
    * - x.isTerminal(), returning a bool
    * - x.getEdgesBegin() and x.getEdgesEnd(), that if !x.isTerminal() define a range of values of type NodeId
-   *   (the outgoing edges).
+   *   (the outgoing edges). If these are pointers, nodes with the same [begin, end) range will share the storage for
+   *   their edges.
    *
    * This constructor is *not* defined in semistatic_graph.templates.h, but only in semistatic_graph.cc.
    * All instantiations must have a matching instantiation in semistatic_graph.cc.
@@ -226,6 +232,33 @@ public:
   node_iterator find(NodeId nodeId);
   const_node_iterator find(NodeId nodeId) const;
 
+  // Returns the number of nodes in the graph, including the ones that are only referenced as neighbors of other nodes.
+  std::size_t size() const;
+
+  // Returns the index of the node pointed to by `itr', that is in [0, size()).
+  // Each node has a different index, so this can be used to store additional data for nodes in a vector.
+  std::size_t indexOf(node_iterator itr) const;
+
+  // Calls visitor(nodeId, node_itr) for each node in the graph, in an unspecified order.
+  // Nodes that are only referenced as neighbors of other nodes are skipped.
+  // This is O(n) (where n is the number of nodes), so it should only be used for diagnostics.
+  template <typename Visitor>
+  void forEachNode(Visitor visitor);
+
+  // Returns the number of hash functions that were discarded at construction, see
+  // SemistaticMap::getNumHashFunctionRetries().
+  std::size_t getNumHashFunctionRetries() const;
+
+  // Returns the size (in bytes) of the memory allocated for the nodes, for the edges and for the map used to find the
+  // node of a NodeId (see SemistaticMap::getLookupTableBytes() and SemistaticMap::getValuesBytes()).
+  std::size_t getNodesBytes() const;
+  std::size_t getEdgesBytes() const;
+  std::size_t getNodeIndexLookupTableBytes() const;
+  std::size_t getNodeIndexValuesBytes() const;
+
+  // Returns statistics on the hash table used to find the node of a NodeId, see SemistaticMap::getDiagnostics().
+  SemistaticMapDiagnostics getNodeIndexMapDiagnostics() const;
+
 #if FRUIT_EXTRA_DEBUG
   // Emits a runtime error if some node was not created but there is an edge pointing to it.
   void checkFullyConstructed();
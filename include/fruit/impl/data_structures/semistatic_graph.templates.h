@@ -26,6 +26,7 @@
 #include <fruit/impl/data_structures/memory_pool.h>
 #include <fruit/impl/data_structures/semistatic_graph.h>
 #include <fruit/impl/data_structures/semistatic_map.templates.h>
+#include <fruit/impl/util/hash_codes.h>
 #include <fruit/impl/util/hash_helpers.h>
 
 #if FRUIT_EXTRA_DEBUG
@@ -54,6 +55,40 @@ struct indexing_iterator {
   }
 };
 
+// Nodes whose edges are given by the same range of pointers (e.g. because they have the same interned BindingDeps)
+// share their edges in edges_storage. For other iterator types we don't attempt this, and getSharedEdgesKey() returns
+// a key with begin==nullptr.
+struct SharedEdgesKey {
+  const void* begin;
+  const void* end;
+
+  bool operator==(const SharedEdgesKey& other) const {
+    return begin == other.begin && end == other.end;
+  }
+};
+
+struct HashSharedEdgesKey {
+  std::size_t operator()(const SharedEdgesKey& key) const {
+    return combineHashes(std::hash<const void*>()(key.begin), std::hash<const void*>()(key.end));
+  }
+};
+
+template <typename EdgeIter>
+inline SharedEdgesKey getSharedEdgesKey(EdgeIter, EdgeIter) {
+  return SharedEdgesKey{nullptr, nullptr};
+}
+
+template <typename T>
+inline SharedEdgesKey getSharedEdgesKey(T* begin, T* end) {
+  return SharedEdgesKey{begin, end};
+}
+
+inline HashMapWithArenaAllocator<SharedEdgesKey, std::uintptr_t, HashSharedEdgesKey>
+createSharedEdgesMap(std::size_t capacity, MemoryPool& memory_pool) {
+  return createHashMapWithArenaAllocatorAndCustomFunctors<SharedEdgesKey, std::uintptr_t>(
+      capacity, memory_pool, HashSharedEdgesKey(), std::equal_to<SharedEdgesKey>());
+}
+
 #if FRUIT_EXTRA_DEBUG
 template <typename NodeId, typename Node>
 template <typename NodeIter>
@@ -85,9 +120,15 @@ SemistaticGraph<NodeId, Node>::SemistaticGraph(NodeIter first, NodeIter last, Me
   std::size_t num_edges = 0;
   // Step 1: assign IDs to all nodes, fill node_index_map and set first_unused_index.
   HashSetWithArenaAllocator<NodeId> node_ids = createHashSetWithArenaAllocator<NodeId>(last - first, memory_pool);
+  auto shared_edges = createSharedEdgesMap(last - first, memory_pool);
   for (NodeIter i = first; i != last; ++i) {
     node_ids.insert(i->getId());
     if (!i->isTerminal()) {
+      SharedEdgesKey shared_edges_key = getSharedEdgesKey(i->getEdgesBegin(), i->getEdgesEnd());
+      if (shared_edges_key.begin != nullptr && !shared_edges.insert(std::make_pair(shared_edges_key, 0)).second) {
+        // These edges (and their target nodes) have already been seen.
+        continue;
+      }
       for (auto j = i->getEdgesBegin(); j != i->getEdgesEnd(); ++j) {
         node_ids.insert(*j);
         ++num_edges;
@@ -123,11 +164,7 @@ SemistaticGraph<NodeId, Node>::SemistaticGraph(NodeIter first, NodeIter last, Me
     if (i->isTerminal()) {
       nodeData.edges_begin = 0;
     } else {
-      nodeData.edges_begin = reinterpret_cast<std::uintptr_t>(edges_storage.data() + edges_storage.size());
-      for (auto j = i->getEdgesBegin(); j != i->getEdgesEnd(); ++j) {
-        InternalNodeId other_node_id = node_index_map.at(*j);
-        edges_storage.push_back(other_node_id);
-      }
+      nodeData.edges_begin = getOrAddEdges(i, shared_edges);
     }
   }
 
@@ -152,11 +189,17 @@ SemistaticGraph<NodeId, Node>::SemistaticGraph(const SemistaticGraph& x, NodeIte
   using node_ids_elem_t = std::pair<NodeId, InternalNodeId>;
   using node_ids_t = std::vector<node_ids_elem_t, ArenaAllocator<node_ids_elem_t>>;
   node_ids_t node_ids = node_ids_t(ArenaAllocator<node_ids_elem_t>(memory_pool));
+  auto shared_edges = createSharedEdgesMap(last - first, memory_pool);
   for (NodeIter i = first; i != last; ++i) {
     if (x.node_index_map.find(i->getId()) == nullptr) {
       node_ids.push_back(std::make_pair(i->getId(), InternalNodeId()));
     }
     if (!i->isTerminal()) {
+      SharedEdgesKey shared_edges_key = getSharedEdgesKey(i->getEdgesBegin(), i->getEdgesEnd());
+      if (shared_edges_key.begin != nullptr && !shared_edges.insert(std::make_pair(shared_edges_key, 0)).second) {
+        // These edges (and their target nodes) have already been seen.
+        continue;
+      }
       for (auto j = i->getEdgesBegin(); j != i->getEdgesEnd(); ++j) {
         if (x.node_index_map.find(*j) == nullptr) {
           node_ids.push_back(std::make_pair(*j, InternalNodeId()));
@@ -200,11 +243,7 @@ SemistaticGraph<NodeId, Node>::SemistaticGraph(const SemistaticGraph& x, NodeIte
     if (i->isTerminal()) {
       nodeData.edges_begin = 0;
     } else {
-      nodeData.edges_begin = reinterpret_cast<std::uintptr_t>(edges_storage.data() + edges_storage.size());
-      for (auto j = i->getEdgesBegin(); j != i->getEdgesEnd(); ++j) {
-        InternalNodeId otherNodeId = node_index_map.at(*j);
-        edges_storage.push_back(otherNodeId);
-      }
+      nodeData.edges_begin = getOrAddEdges(i, shared_edges);
     }
   }
 
@@ -213,6 +252,28 @@ SemistaticGraph<NodeId, Node>::SemistaticGraph(const SemistaticGraph& x, NodeIte
 #endif
 }
 
+template <typename NodeId, typename Node>
+template <typename NodeIter, typename SharedEdgesMap>
+std::uintptr_t SemistaticGraph<NodeId, Node>::getOrAddEdges(NodeIter i, SharedEdgesMap& shared_edges) {
+  SharedEdgesKey shared_edges_key = getSharedEdgesKey(i->getEdgesBegin(), i->getEdgesEnd());
+  std::uintptr_t* shared_edges_begin = nullptr;
+  if (shared_edges_key.begin != nullptr) {
+    shared_edges_begin = &shared_edges.at(shared_edges_key);
+    if (*shared_edges_begin != 0) {
+      return *shared_edges_begin;
+    }
+  }
+  std::uintptr_t edges_begin = reinterpret_cast<std::uintptr_t>(edges_storage.data() + edges_storage.size());
+  for (auto j = i->getEdgesBegin(); j != i->getEdgesEnd(); ++j) {
+    InternalNodeId other_node_id = node_index_map.at(*j);
+    edges_storage.push_back(other_node_id);
+  }
+  if (shared_edges_begin != nullptr) {
+    *shared_edges_begin = edges_begin;
+  }
+  return edges_begin;
+}
+
 #if FRUIT_EXTRA_DEBUG
 template <typename NodeId, typename Node>
 void SemistaticGraph<NodeId, Node>::checkFullyConstructed() {
@@ -35,6 +35,50 @@ inline typename SemistaticMap<Key, Value>::Unsigned SemistaticMap<Key, Value>::h
   return hash_function.hash(std::hash<typename std::remove_cv<Key>::type>()(key));
 }
 
+template <typename Key, typename Value>
+template <typename Visitor>
+inline void SemistaticMap<Key, Value>::forEach(Visitor visitor) const {
+  // Each element is in exactly one bucket, so this visits each element once (even in a shallow copy, where some of the
+  // buckets point to the values[] vector of another map).
+  for (const CandidateValuesRange& range : lookup_table) {
+    for (const value_type* itr = range.begin; itr != range.end; ++itr) {
+      visitor(itr->first, itr->second);
+    }
+  }
+}
+
+template <typename Key, typename Value>
+inline std::size_t SemistaticMap<Key, Value>::getNumHashFunctionRetries() const {
+  return num_hash_function_retries;
+}
+
+template <typename Key, typename Value>
+inline std::size_t SemistaticMap<Key, Value>::getLookupTableBytes() const {
+  return lookup_table.getCapacity() * sizeof(CandidateValuesRange);
+}
+
+template <typename Key, typename Value>
+inline std::size_t SemistaticMap<Key, Value>::getValuesBytes() const {
+  return values.getCapacity() * sizeof(value_type);
+}
+
+template <typename Key, typename Value>
+inline SemistaticMapDiagnostics SemistaticMap<Key, Value>::getDiagnostics() const {
+  SemistaticMapDiagnostics diagnostics;
+  diagnostics.num_hash_function_retries = num_hash_function_retries;
+  diagnostics.num_buckets = lookup_table.size();
+  for (const CandidateValuesRange& range : lookup_table) {
+    std::size_t bucket_size = range.end - range.begin;
+    if (diagnostics.bucket_size_histogram.size() <= bucket_size) {
+      diagnostics.bucket_size_histogram.resize(bucket_size + 1);
+    }
+    ++diagnostics.bucket_size_histogram[bucket_size];
+    diagnostics.num_values += bucket_size;
+  }
+  diagnostics.num_wasted_values = num_moved_values + (values.getCapacity() - values.size());
+  return diagnostics;
+}
+
 } // namespace impl
 } // namespace fruit
 
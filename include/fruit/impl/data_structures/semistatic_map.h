@@ -29,6 +29,32 @@
 namespace fruit {
 namespace impl {
 
+/**
+ * Statistics on the hash table of a SemistaticMap, see SemistaticMap::getDiagnostics().
+ * These are only meant to be used to evaluate (and tune) the hashing scheme.
+ */
+struct SemistaticMapDiagnostics {
+  // The number of hash functions that were discarded at construction because of too many collisions.
+  std::size_t num_hash_function_retries = 0;
+
+  // The number of buckets in the lookup table.
+  std::size_t num_buckets = 0;
+
+  // The number of elements in the map.
+  std::size_t num_values = 0;
+
+  // bucket_size_histogram[k] is the number of buckets with k elements.
+  std::vector<std::size_t> bucket_size_histogram;
+
+  // The number of slots of values[] (of this map and, for shallow copies, of the map it was copied from) that are
+  // not reachable from this map: the unused capacity and the old copies of the buckets that were moved by insert().
+  std::size_t num_wasted_values = 0;
+
+  double getLoadFactor() const {
+    return num_buckets == 0 ? 0 : double(num_values) / num_buckets;
+  }
+};
+
 /**
  * Provides a subset of the interface of std::map, and also has these additional assumptions:
  * - Key must be default constructible and trivially copyable
@@ -75,6 +101,14 @@ private:
   FixedSizeVector<CandidateValuesRange> lookup_table;
   FixedSizeVector<value_type> values;
 
+  // The number of hash functions that were discarded at construction because of too many collisions.
+  // This is only used for diagnostics.
+  std::size_t num_hash_function_retries = 0;
+
+  // The number of elements that were copied to the end of values[] by insert(), leaving behind the old copy.
+  // This is only used for diagnostics.
+  std::size_t num_moved_values = 0;
+
   Unsigned hash(const Key& key) const;
 
   // Inserts a range [elems_begin, elems_end) of new (key,value) pairs with hash h. The keys must not exist in the map.
@@ -117,6 +151,24 @@ public:
   // Prefer using at() when possible, this is slightly slower.
   // Returns nullptr if the key was not found.
   const Value* find(Key key) const;
+
+  // Calls visitor(key, value) for each element in the map, in an unspecified order.
+  // This is O(n) (where n is the number of elements), so it should only be used for diagnostics.
+  template <typename Visitor>
+  void forEach(Visitor visitor) const;
+
+  // Returns the number of hash functions that were discarded at construction (because of too many collisions) before
+  // finding a suitable one. This is always 0 for shallow copies.
+  std::size_t getNumHashFunctionRetries() const;
+
+  // Returns the size (in bytes) of the memory allocated for the lookup table and for the values of this map.
+  // For shallow copies, this only includes the values that are owned by the copy.
+  std::size_t getLookupTableBytes() const;
+  std::size_t getValuesBytes() const;
+
+  // Returns statistics on the buckets of the lookup table, see SemistaticMapDiagnostics.
+  // This is O(n) (where n is the number of buckets), so it should only be used for diagnostics.
+  SemistaticMapDiagnostics getDiagnostics() const;
 };
 
 } // namespace impl
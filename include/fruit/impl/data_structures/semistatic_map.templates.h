@@ -68,6 +68,7 @@ SemistaticMap<Key, Value>::SemistaticMap(
     break;
 
   pick_another:
+    ++num_hash_function_retries;
     std::memset(count.data(), 0, num_buckets * sizeof(Unsigned));
   }
 
@@ -145,6 +146,7 @@ void SemistaticMap<Key, Value>::insert(std::size_t h, const value_type* elems_be
   for (value_type* p = old_bucket_begin; p != old_bucket_end; ++p) {
     values.push_back(*p);
   }
+  num_moved_values += old_bucket_end - old_bucket_begin;
 
   // Step 2: also insert the new keys and values
   for (auto itr = elems_begin; itr != elems_end; ++itr) {
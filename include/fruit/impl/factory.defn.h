@@ -0,0 +1,37 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_FACTORY_DEFN_H
+#define FRUIT_FACTORY_DEFN_H
+
+// Redundant, but makes KDevelop happy.
+#include <fruit/factory.h>
+
+#include <utility>
+
+namespace fruit {
+
+template <typename C, typename... Args>
+inline Factory<C(Args...)>::Factory(Invoker invoker, void* state) : invoker(invoker), state(state) {}
+
+template <typename C, typename... Args>
+inline C Factory<C(Args...)>::operator()(Args... args) const {
+  return invoker(state, std::forward<Args>(args)...);
+}
+
+} // namespace fruit
+
+#endif // FRUIT_FACTORY_DEFN_H
@@ -42,6 +42,8 @@ class LazyComponentImpl;
 namespace meta {
 template <typename... PreviousBindings>
 struct OpForComponent;
+
+struct RegisterFactoryHelper;
 }
 
 } // namespace impl
@@ -180,6 +180,20 @@ struct TypesInInjectorProvidedAsConstOnlyError {
       "[Normalized]Component<T>).");
 };
 
+template <typename... TypesNotProvided>
+struct TypesInChildInjectorNotProvidedError {
+  static_assert(AlwaysFalse<TypesNotProvided...>::value,
+                "The types in TypesNotProvided are declared as provided by the child injector, but they are neither "
+                "provided by the parent injector nor bound to an instance passed to the Injector constructor.");
+};
+
+template <typename... TypesProvidedTwice>
+struct TypesProvidedByParentAndChildInjectorError {
+  static_assert(AlwaysFalse<TypesProvidedTwice...>::value,
+                "The types in TypesProvidedTwice are provided by the parent injector, so they can't also be bound to "
+                "an instance in the child injector.");
+};
+
 template <typename T>
 struct TypeNotProvidedError {
   static_assert(AlwaysFalse<T>::value,
@@ -241,6 +255,13 @@ struct FactoryReturningPointerError {
                 "std::unique_ptr instead.");
 };
 
+template <typename T>
+struct AsyncProviderNotReturningFutureError {
+  static_assert(AlwaysFalse<T>::value,
+                "registerAsyncProvider() was called with a lambda that returns T, but the lambda must return a "
+                "std::future<C> or a std::future<C*>. Use registerProvider() instead if the provider is synchronous.");
+};
+
 template <typename Lambda>
 struct LambdaWithCapturesError {
   // It's not guaranteed by the standard, but it's reasonable to expect lambdas with no captures
@@ -389,6 +410,11 @@ struct FactoryReturningPointerErrorTag {
   using apply = FactoryReturningPointerError<Signature>;
 };
 
+struct AsyncProviderNotReturningFutureErrorTag {
+  template <typename T>
+  using apply = AsyncProviderNotReturningFutureError<T>;
+};
+
 struct NoBindingFoundErrorTag {
   template <typename T>
   using apply = NoBindingFoundError<T>;
@@ -474,6 +500,16 @@ struct TypesInInjectorProvidedAsConstOnlyErrorTag {
   using apply = TypesInInjectorProvidedAsConstOnlyError<TypesProvidedAsConstOnly...>;
 };
 
+struct TypesInChildInjectorNotProvidedErrorTag {
+  template <typename... TypesNotProvided>
+  using apply = TypesInChildInjectorNotProvidedError<TypesNotProvided...>;
+};
+
+struct TypesProvidedByParentAndChildInjectorErrorTag {
+  template <typename... TypesProvidedTwice>
+  using apply = TypesProvidedByParentAndChildInjectorError<TypesProvidedTwice...>;
+};
+
 struct FunctorUsedAsProviderErrorTag {
   template <typename ProviderType>
   using apply = FunctorUsedAsProviderError<ProviderType>;
@@ -73,6 +73,28 @@ struct InjectorImplHelper {
                  None))))>;
   };
 
+  // This performs all checks needed in the constructor of Injector that takes a parent injector.
+  template <typename ParentComp, typename InstancesComp>
+  struct CheckConstructionFromParentInjector {
+    using Ps = SetUnion(GetComponentPs(ParentComp), GetComponentPs(InstancesComp));
+    using NonConstPs = SetUnion(GetComponentNonConstRsPs(ParentComp), GetComponentNonConstRsPs(InstancesComp));
+    using TypesProvidedTwice = SetIntersection(GetComponentPs(ParentComp), GetComponentPs(InstancesComp));
+    using TypesNotProvided = SetDifference(VectorToSetUnchecked(RemoveConstFromTypes(Vector<Type<P>...>)), Ps);
+    using TypesProvidedAsConstOnly =
+        SetDifference(VectorToSetUnchecked(RemoveConstTypes(Vector<Type<P>...>)), NonConstPs);
+
+    using type = Eval<PropagateError(
+        InstancesComp,
+        If(Not(IsEmptySet(TypesProvidedTwice)),
+           ConstructErrorWithArgVector(TypesProvidedByParentAndChildInjectorErrorTag, SetToVector(TypesProvidedTwice)),
+           If(Not(IsEmptySet(TypesNotProvided)),
+              ConstructErrorWithArgVector(TypesInChildInjectorNotProvidedErrorTag, SetToVector(TypesNotProvided)),
+              If(Not(IsEmptySet(TypesProvidedAsConstOnly)),
+                 ConstructErrorWithArgVector(TypesInInjectorProvidedAsConstOnlyErrorTag,
+                                             SetToVector(TypesProvidedAsConstOnly)),
+                 None))))>;
+  };
+
   template <typename T>
   struct CheckGet {
     using Comp = ConstructComponentImpl(Type<P>...);
@@ -112,6 +134,31 @@ inline Injector<P...>::Injector(const NormalizedComponent<NormalizedComponentPar
   (void)typename fruit::impl::meta::CheckIfError<E>::type();
 }
 
+template <typename... P>
+template <typename... ParentP, typename... Instances>
+inline Injector<P...>::Injector(Injector<ParentP...>& parent, Instances&... instances) {
+  using ParentComp = fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<ParentP>...);
+  using InstancesComp = fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<Instances>...);
+  using E = typename fruit::impl::meta::InjectorImplHelper<P...>::template CheckConstructionFromParentInjector<
+      ParentComp, InstancesComp>::type;
+  (void)typename fruit::impl::meta::CheckIfError<E>::type();
+
+  fruit::impl::MemoryPool memory_pool;
+  using exposed_types_t = std::vector<fruit::impl::TypeId, fruit::impl::ArenaAllocator<fruit::impl::TypeId>>;
+  using instances_t =
+      std::vector<fruit::impl::ComponentStorageEntry, fruit::impl::ArenaAllocator<fruit::impl::ComponentStorageEntry>>;
+  exposed_types_t exposed_types = exposed_types_t(
+      std::initializer_list<fruit::impl::TypeId>{
+          fruit::impl::getTypeId<fruit::impl::InjectorStorage::NormalizeType<P>>()...},
+      fruit::impl::ArenaAllocator<fruit::impl::TypeId>(memory_pool));
+  instances_t instance_entries = instances_t(
+      std::initializer_list<fruit::impl::ComponentStorageEntry>{
+          fruit::impl::InjectorStorage::createComponentStorageEntryForChildInstance(instances)...},
+      fruit::impl::ArenaAllocator<fruit::impl::ComponentStorageEntry>(memory_pool));
+  storage = std::unique_ptr<fruit::impl::InjectorStorage>(
+      new fruit::impl::InjectorStorage(*parent.storage, exposed_types, instance_entries, memory_pool));
+}
+
 template <typename... P>
 template <typename T>
 inline fruit::impl::RemoveAnnotations<T> Injector<P...>::get() {
@@ -137,6 +184,94 @@ inline const std::vector<fruit::impl::RemoveAnnotations<AnnotatedC>*>& Injector<
   return storage->template getMultibindings<AnnotatedC>();
 }
 
+template <typename... P>
+template <typename AnnotatedC>
+inline const std::vector<fruit::MultibindingProvider<fruit::impl::RemoveAnnotations<AnnotatedC>>>&
+Injector<P...>::getMultibindingProviders() {
+
+  using Op = fruit::impl::meta::Eval<fruit::impl::meta::CheckNormalizedTypes(
+      fruit::impl::meta::Vector<fruit::impl::meta::Type<AnnotatedC>>)>;
+  (void)typename fruit::impl::meta::CheckIfError<Op>::type();
+
+  return storage->template getMultibindingProviders<AnnotatedC>();
+}
+
+template <typename... P>
+template <typename K, typename AnnotatedC>
+inline const fruit::KeyedMultibindings<K, fruit::impl::RemoveAnnotations<AnnotatedC>>&
+Injector<P...>::getKeyedMultibindings() {
+
+  using Op = fruit::impl::meta::Eval<fruit::impl::meta::CheckNormalizedTypes(
+      fruit::impl::meta::Vector<fruit::impl::meta::Type<AnnotatedC>>)>;
+  (void)typename fruit::impl::meta::CheckIfError<Op>::type();
+
+  return storage->template getKeyedMultibindings<K, AnnotatedC>();
+}
+
+template <typename... P>
+template <typename... T>
+inline std::shared_future<void> Injector<P...>::prefetch() {
+  (void)std::initializer_list<int>{
+      ((void)typename fruit::impl::meta::CheckIfError<
+           typename fruit::impl::meta::InjectorImplHelper<P...>::template CheckGet<T>::type>::type(),
+       0)...};
+  return storage->prefetch(
+      std::vector<fruit::impl::TypeId>{fruit::impl::getTypeId<fruit::impl::InjectorStorage::NormalizeType<T>>()...},
+      false /* include_multibindings */);
+}
+
+template <typename... P>
+inline std::shared_future<void> Injector<P...>::prefetchAll() {
+  return storage->prefetch(
+      std::vector<fruit::impl::TypeId>{fruit::impl::getTypeId<fruit::impl::InjectorStorage::NormalizeType<P>>()...},
+      true /* include_multibindings */);
+}
+
+template <typename... P>
+inline const InjectorStats& Injector<P...>::getStats() const {
+  return storage->getStats();
+}
+
+template <typename... P>
+inline void Injector<P...>::setLookupCounting(bool enabled) {
+  storage->setLookupCounting(enabled);
+}
+
+template <typename... P>
+inline LookupStats Injector<P...>::getLookupStats() {
+  return storage->getLookupStats();
+}
+
+template <typename... P>
+inline void Injector<P...>::clearLookupStats() {
+  storage->clearLookupStats();
+}
+
+template <typename... P>
+inline MemoryUsage Injector<P...>::getMemoryUsage() {
+  return storage->getMemoryUsage();
+}
+
+template <typename... P>
+inline InjectorGraph Injector<P...>::getGraph() {
+  return storage->getGraph();
+}
+
+template <typename... P>
+inline void Injector<P...>::setConstructionTracer(fruit::ConstructionTracer* tracer) {
+  storage->setConstructionTracer(tracer);
+}
+
+template <typename... P>
+inline void Injector<P...>::setTeardownPolicy(fruit::TeardownPolicy policy) {
+  storage->setTeardownPolicy(policy);
+}
+
+template <typename... P>
+inline void Injector<P...>::setTeardownThreads(std::size_t num_threads) {
+  storage->setTeardownThreads(num_threads);
+}
+
 template <typename... P>
 FRUIT_DEPRECATED_DEFINITION(inline void Injector<P...>::eagerlyInjectAll()) {
   // Eagerly inject normal bindings.
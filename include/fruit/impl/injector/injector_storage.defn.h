@@ -26,6 +26,7 @@
 #include <fruit/impl/util/type_info.h>
 
 #include <cassert>
+#include <future>
 
 // Redundant, but makes KDevelop happy.
 #include <fruit/impl/injector/injector_storage.h>
@@ -231,7 +232,22 @@ struct GetSecondStage<fruit::Annotated<Annotation, T>> : public GetSecondStage<T
 
 template <typename AnnotatedT>
 inline InjectorStorage::RemoveAnnotations<AnnotatedT> InjectorStorage::get() {
+  if (lookup_counting.load(std::memory_order_relaxed)) {
+    return getWithLookupCounting<AnnotatedT>();
+  }
   std::lock_guard<std::recursive_mutex> lock(mutex);
+  return getLocked<AnnotatedT>();
+}
+
+template <typename AnnotatedT>
+InjectorStorage::RemoveAnnotations<AnnotatedT> InjectorStorage::getWithLookupCounting() {
+  std::unique_lock<std::recursive_mutex> lock =
+      lockAndCountLookup(getTypeId<NormalizeType<AnnotatedT>>(), LookupKind::GET);
+  return getLocked<AnnotatedT>();
+}
+
+template <typename AnnotatedT>
+inline InjectorStorage::RemoveAnnotations<AnnotatedT> InjectorStorage::getLocked() {
   return GetSecondStage<AnnotatedT>()(GetFirstStage<AnnotatedT>()(*this, lazyGetPtr<NormalizeType<AnnotatedT>>()));
 }
 
@@ -269,12 +285,23 @@ inline const C* InjectorStorage::getPtr(Graph::node_iterator itr) {
 
 template <typename AnnotatedC>
 inline const InjectorStorage::RemoveAnnotations<AnnotatedC>* InjectorStorage::unsafeGet() {
+  if (lookup_counting.load(std::memory_order_relaxed)) {
+    return unsafeGetWithLookupCounting<AnnotatedC>();
+  }
   std::lock_guard<std::recursive_mutex> lock(mutex);
   using C = RemoveAnnotations<AnnotatedC>;
   const void* p = unsafeGetPtr(getTypeId<AnnotatedC>());
   return reinterpret_cast<const C*>(p);
 }
 
+template <typename AnnotatedC>
+const InjectorStorage::RemoveAnnotations<AnnotatedC>* InjectorStorage::unsafeGetWithLookupCounting() {
+  std::unique_lock<std::recursive_mutex> lock = lockAndCountLookup(getTypeId<AnnotatedC>(), LookupKind::UNSAFE_GET);
+  using C = RemoveAnnotations<AnnotatedC>;
+  const void* p = unsafeGetPtr(getTypeId<AnnotatedC>());
+  return reinterpret_cast<const C*>(p);
+}
+
 inline InjectorStorage::Graph::node_iterator InjectorStorage::lazyGetPtr(TypeId type) {
   return bindings.at(type);
 }
@@ -289,7 +316,24 @@ inline const void* InjectorStorage::unsafeGetPtr(TypeId type) {
 
 template <typename AnnotatedC>
 inline const std::vector<InjectorStorage::RemoveAnnotations<AnnotatedC>*>& InjectorStorage::getMultibindings() {
+  if (lookup_counting.load(std::memory_order_relaxed)) {
+    return getMultibindingsWithLookupCounting<AnnotatedC>();
+  }
   std::lock_guard<std::recursive_mutex> lock(mutex);
+  return getMultibindingsLocked<AnnotatedC>();
+}
+
+template <typename AnnotatedC>
+const std::vector<InjectorStorage::RemoveAnnotations<AnnotatedC>*>&
+InjectorStorage::getMultibindingsWithLookupCounting() {
+  std::unique_lock<std::recursive_mutex> lock =
+      lockAndCountLookup(getTypeId<AnnotatedC>(), LookupKind::MULTIBINDINGS);
+  return getMultibindingsLocked<AnnotatedC>();
+}
+
+template <typename AnnotatedC>
+inline const std::vector<InjectorStorage::RemoveAnnotations<AnnotatedC>*>&
+InjectorStorage::getMultibindingsLocked() {
   using C = RemoveAnnotations<AnnotatedC>;
   void* p = getMultibindings(getTypeId<AnnotatedC>());
   if (p == nullptr) {
@@ -300,9 +344,101 @@ inline const std::vector<InjectorStorage::RemoveAnnotations<AnnotatedC>*>& Injec
   }
 }
 
+template <typename AnnotatedC>
+inline const std::vector<fruit::MultibindingProvider<InjectorStorage::RemoveAnnotations<AnnotatedC>>>&
+InjectorStorage::getMultibindingProviders() {
+  if (parent != nullptr) {
+    return parent->getMultibindingProviders<AnnotatedC>();
+  }
+  if (lookup_counting.load(std::memory_order_relaxed)) {
+    std::unique_lock<std::recursive_mutex> lock =
+        lockAndCountLookup(getTypeId<AnnotatedC>(), LookupKind::MULTIBINDINGS);
+    return getMultibindingProvidersLocked<AnnotatedC>();
+  }
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  return getMultibindingProvidersLocked<AnnotatedC>();
+}
+
+template <typename AnnotatedC>
+inline const std::vector<fruit::MultibindingProvider<InjectorStorage::RemoveAnnotations<AnnotatedC>>>&
+InjectorStorage::getMultibindingProvidersLocked() {
+  using C = RemoveAnnotations<AnnotatedC>;
+  using ProviderVector = std::vector<fruit::MultibindingProvider<C>>;
+  TypeId type = getTypeId<AnnotatedC>();
+  NormalizedMultibindingSet* multibinding_set = getNormalizedMultibindingSet(type);
+  if (multibinding_set == nullptr) {
+    static ProviderVector empty_vector;
+    return empty_vector;
+  }
+
+  if (multibinding_set->providers.get() == nullptr) {
+    // No object is constructed here. The providers of the objects that are already constructed (e.g. by a previous
+    // getMultibindings() call) start with the pointer to the object, so they never need to lock.
+    ProviderVector providers;
+    providers.reserve(multibinding_set->elems.size());
+    for (NormalizedMultibinding& multibinding : multibinding_set->elems) {
+      C* object = multibinding.is_constructed ? reinterpret_cast<C*>(multibinding.object) : nullptr;
+      providers.push_back(fruit::MultibindingProvider<C>(this, type, &multibinding, object));
+    }
+    std::shared_ptr<ProviderVector> vector_ptr = std::make_shared<ProviderVector>(std::move(providers));
+    multibinding_set->providers = std::shared_ptr<char>(vector_ptr, reinterpret_cast<char*>(vector_ptr.get()));
+  }
+  return *reinterpret_cast<ProviderVector*>(multibinding_set->providers.get());
+}
+
+template <typename K, typename AnnotatedI>
+inline const fruit::KeyedMultibindings<K, InjectorStorage::RemoveAnnotations<AnnotatedI>>&
+InjectorStorage::getKeyedMultibindings() {
+  if (parent != nullptr) {
+    return parent->getKeyedMultibindings<K, AnnotatedI>();
+  }
+  if (lookup_counting.load(std::memory_order_relaxed)) {
+    std::unique_lock<std::recursive_mutex> lock =
+        lockAndCountLookup(getTypeId<KeyedMultibindingTag<K, AnnotatedI>>(), LookupKind::MULTIBINDINGS);
+    return getKeyedMultibindingsLocked<K, AnnotatedI>();
+  }
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  return getKeyedMultibindingsLocked<K, AnnotatedI>();
+}
+
+template <typename K, typename AnnotatedI>
+inline const fruit::KeyedMultibindings<K, InjectorStorage::RemoveAnnotations<AnnotatedI>>&
+InjectorStorage::getKeyedMultibindingsLocked() {
+  using I = RemoveAnnotations<AnnotatedI>;
+  using Element = KeyedMultibindingElement<K, I>;
+  using Map = fruit::KeyedMultibindings<K, I>;
+  TypeId type = getTypeId<KeyedMultibindingTag<K, AnnotatedI>>();
+  std::shared_ptr<char>& map_ptr = keyed_multibindings[type];
+  if (map_ptr.get() == nullptr) {
+    // This doesn't construct any object: the multibindings of this type are the (already constructed) elements.
+    std::vector<const Element*> elements;
+    NormalizedMultibindingSet* multibinding_set = getNormalizedMultibindingSet(type);
+    if (multibinding_set != nullptr) {
+      elements.reserve(multibinding_set->elems.size());
+      for (const NormalizedMultibinding& multibinding : multibinding_set->elems) {
+        FruitAssert(multibinding.is_constructed);
+        elements.push_back(reinterpret_cast<const Element*>(multibinding.object));
+      }
+    }
+    std::shared_ptr<Map> map = std::shared_ptr<Map>(new Map(this, elements));
+    map_ptr = std::shared_ptr<char>(map, reinterpret_cast<char*>(map.get()));
+  }
+  return *reinterpret_cast<Map*>(map_ptr.get());
+}
+
+inline const fruit::InjectorStats& InjectorStorage::getStats() const {
+  return stats;
+}
+
 inline const void* InjectorStorage::getPtrInternal(Graph::node_iterator node_itr) {
   NormalizedBinding& normalized_binding = node_itr.getNode();
   if (!node_itr.isTerminal()) {
+    if (!async_providers_to_start.empty() && !async_providers_started) {
+      return getPtrInternalStartingAsyncProviders(node_itr);
+    }
+    if (construction_tracer != nullptr) {
+      return getPtrInternalWithTracing(node_itr);
+    }
     normalized_binding.object = normalized_binding.create(*this, node_itr);
     FruitAssert(node_itr.isTerminal());
   }
@@ -333,7 +469,7 @@ inline std::shared_ptr<char> InjectorStorage::createMultibindingVector(InjectorS
     return multibinding_set->v;
   }
 
-  storage.ensureConstructedMultibinding(*multibinding_set);
+  storage.ensureConstructedMultibinding(type, *multibinding_set);
 
   std::vector<C*> s;
   s.reserve(multibinding_set->elems.size());
@@ -428,6 +564,16 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForBind
   return result;
 }
 
+template <typename C>
+inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForChildInstance(C& instance) {
+  return createComponentStorageEntryForBindInstance<C, C>(instance);
+}
+
+template <typename C>
+inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForChildInstance(const C& instance) {
+  return createComponentStorageEntryForBindConstInstance<C, C>(instance);
+}
+
 // The inner operator() takes an InjectorStorage& and a Graph::edge_iterator (the type's deps) and
 // returns the injected object as a C*.
 // This takes care of move-constructing a C into the injector's own allocator if needed.
@@ -456,7 +602,7 @@ struct InvokeLambdaWithInjectedArgVector<AnnotatedSignature, Lambda, true /* lam
     CPtr cPtr =
         LambdaInvoker::invoke<Lambda, typename InjectorStorage::AnnotationRemover<
                                           typename fruit::impl::meta::TypeUnwrapper<AnnotatedArgs>::type>::type...>(
-            injector.get<fruit::impl::meta::UnwrapType<AnnotatedArgs>>()...);
+            injector.getLocked<fruit::impl::meta::UnwrapType<AnnotatedArgs>>()...);
 
     allocator.registerExternallyAllocatedObject(cPtr);
 
@@ -537,7 +683,7 @@ struct InvokeLambdaWithInjectedArgVector<AnnotatedSignature, Lambda, false /* la
     return allocator.constructObject<AnnotatedC, C&&>(
         LambdaInvoker::invoke<Lambda, typename InjectorStorage::AnnotationRemover<
                                           typename fruit::impl::meta::TypeUnwrapper<AnnotatedArgs>::type>::type&&...>(
-            injector.get<typename fruit::impl::meta::TypeUnwrapper<AnnotatedArgs>::type>()...));
+            injector.getLocked<typename fruit::impl::meta::TypeUnwrapper<AnnotatedArgs>::type>()...));
   }
 
   // This is not inlined in outerConstructHelper so that when get<> needs to construct an object more complex than a
@@ -772,13 +918,31 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForMult
   result.kind = ComponentStorageEntry::Kind::MULTIBINDING_VECTOR_CREATOR;
   result.type_id = getTypeId<AnnotatedT>();
   ComponentStorageEntry::MultibindingVectorCreator& binding = result.multibinding_vector_creator;
-  binding.get_multibindings_vector = createMultibindingVector<AnnotatedT>;
+  binding.get_multibindings_vector = GetMultibindingsVectorFunction<AnnotatedT>::get();
   return result;
 }
 
+template <typename AnnotatedT>
+struct InjectorStorage::GetMultibindingsVectorFunction {
+  static ComponentStorageEntry::MultibindingVectorCreator::get_multibindings_vector_t get() {
+    return createMultibindingVector<AnnotatedT>;
+  }
+};
+
+template <typename K, typename I, typename T>
+struct InjectorStorage::GetMultibindingsVectorFunction<fruit::Annotated<KeyedMultibindingTag<K, I>, T>> {
+  static ComponentStorageEntry::MultibindingVectorCreator::get_multibindings_vector_t get() {
+    return createNoMultibindingVector;
+  }
+};
+
+inline std::shared_ptr<char> InjectorStorage::createNoMultibindingVector(InjectorStorage&) {
+  return nullptr;
+}
+
 template <typename I, typename C, typename AnnotatedCPtr>
 InjectorStorage::object_ptr_t InjectorStorage::createInjectedObjectForMultibinding(InjectorStorage& m) {
-  C* cPtr = m.get<AnnotatedCPtr>();
+  C* cPtr = m.getLocked<AnnotatedCPtr>();
   // This step is needed when the cast C->I changes the pointer
   // (e.g. for multiple inheritance).
   I* iPtr = static_cast<I*>(cPtr);
@@ -810,6 +974,29 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForInst
   return result;
 }
 
+template <typename K, typename AnnotatedI>
+inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForKeyedMultibinding(
+    const KeyedMultibindingElement<K, RemoveAnnotations<AnnotatedI>>* element) {
+  ComponentStorageEntry result;
+  result.kind = ComponentStorageEntry::Kind::MULTIBINDING_FOR_CONSTRUCTED_OBJECT;
+  result.type_id = getTypeId<KeyedMultibindingTag<K, AnnotatedI>>();
+  ComponentStorageEntry::MultibindingForConstructedObject& binding = result.multibinding_for_constructed_object;
+  // The element is never modified, this is just because multibinding objects are non-const.
+  binding.object_ptr = const_cast<KeyedMultibindingElement<K, RemoveAnnotations<AnnotatedI>>*>(element);
+  return result;
+}
+
+template <typename AnnotatedI, typename AnnotatedC>
+InjectorStorage::RemoveAnnotations<AnnotatedI>* InjectorStorage::getKeyedMultibindingObject(InjectorStorage& injector) {
+  using AnnotatedCPtr = fruit::impl::meta::UnwrapType<
+      fruit::impl::meta::Eval<fruit::impl::meta::AddPointerInAnnotatedType(fruit::impl::meta::Type<AnnotatedC>)>>;
+  using I = RemoveAnnotations<AnnotatedI>;
+  using C = RemoveAnnotations<AnnotatedC>;
+  std::lock_guard<std::recursive_mutex> lock(injector.mutex);
+  C* cPtr = injector.getLocked<AnnotatedCPtr>();
+  return static_cast<I*>(cPtr);
+}
+
 template <typename C, typename T, typename AnnotatedSignature, typename Lambda>
 InjectorStorage::object_ptr_t InjectorStorage::createInjectedObjectForMultibindingProvider(InjectorStorage& injector) {
   C* cPtr = InvokeLambdaWithInjectedArgVector<AnnotatedSignature, Lambda, std::is_pointer<T>::value>()(
@@ -844,6 +1031,161 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForMult
   return result;
 }
 
+template <typename AnnotatedT>
+InjectorStorage::const_object_ptr_t
+InjectorStorage::createInjectedObjectForLazySubcomponent(InjectorStorage& injector, Graph::node_iterator node_itr) {
+  const void* p = injector.getLazySubcomponentPtr(getTypeId<AnnotatedT>(), node_itr);
+  node_itr.setTerminal();
+  return p;
+}
+
+template <typename... Params>
+struct InjectorStorage::LazySubcomponentTypes<fruit::Component<Params...>> {
+  using Comp = fruit::impl::meta::Eval<fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<Params>...)>;
+  using ProvidedTypes = fruit::impl::meta::Eval<fruit::impl::meta::SetToVector(typename Comp::Ps)>;
+  using RequiredTypes = fruit::impl::meta::Eval<fruit::impl::meta::SetToVector(
+      fruit::impl::meta::SetDifference(typename Comp::RsSuperset, typename Comp::Ps))>;
+
+  template <typename ProvidedTypesVector>
+  struct PlaceholderCreates;
+
+  template <typename... AnnotatedTs>
+  struct PlaceholderCreates<fruit::impl::meta::Vector<fruit::impl::meta::Type<AnnotatedTs>...>> {
+    static const ComponentStorageEntry::BindingForObjectToConstruct::create_t* get() {
+      // The last element is just to avoid a zero-sized array when the component provides no types.
+      static const ComponentStorageEntry::BindingForObjectToConstruct::create_t creates[] = {
+          createInjectedObjectForLazySubcomponent<AnnotatedTs>..., nullptr};
+      return creates;
+    }
+  };
+
+  static const ComponentStorageEntry::LazySubcomponent::Types* get() {
+    static const ComponentStorageEntry::LazySubcomponent::Types types = {
+        getBindingDeps<ProvidedTypes>(), PlaceholderCreates<ProvidedTypes>::get(), getBindingDeps<RequiredTypes>()};
+    return &types;
+  }
+};
+
+// Calls the lambda of an async provider (injecting its arguments) and returns the std::future returned by the lambda.
+// AnnotatedSignature is the signature of a provider returning the result of the future.
+template <typename AnnotatedSignature, typename Lambda,
+          typename AnnotatedArgVector =
+              fruit::impl::meta::Eval<fruit::impl::meta::SignatureArgs(fruit::impl::meta::Type<AnnotatedSignature>)>>
+struct InvokeAsyncProviderWithInjectedArgVector;
+
+template <typename AnnotatedSignature, typename Lambda, typename... AnnotatedArgs>
+struct InvokeAsyncProviderWithInjectedArgVector<AnnotatedSignature, Lambda,
+                                                fruit::impl::meta::Vector<AnnotatedArgs...>> {
+  using T = InjectorStorage::RemoveAnnotations<InjectorStorage::SignatureType<AnnotatedSignature>>;
+
+  std::future<T> operator()(InjectorStorage& injector) {
+    // `injector' *is* used below, but when there are no AnnotatedArgs some compilers report it as unused.
+    (void)injector;
+    return LambdaInvoker::invoke<Lambda, typename InjectorStorage::AnnotationRemover<
+                                             typename fruit::impl::meta::TypeUnwrapper<AnnotatedArgs>::type>::type...>(
+        injector.getLocked<fruit::impl::meta::UnwrapType<AnnotatedArgs>>()...);
+  }
+};
+
+// Stores the result of the future returned by an async provider in the injector, and returns a pointer to it.
+// T is either C or C*.
+template <typename AnnotatedC, typename T>
+struct StoreAsyncProviderResult {
+  T* operator()(FixedSizeAllocator& allocator, T&& t) {
+    return allocator.constructObject<AnnotatedC, T&&>(std::move(t));
+  }
+};
+
+template <typename AnnotatedC, typename C>
+struct StoreAsyncProviderResult<AnnotatedC, C*> {
+  C* operator()(FixedSizeAllocator& allocator, C* cPtr) {
+    allocator.registerExternallyAllocatedObject(cPtr);
+
+    // This can happen if the future returned by the user-supplied provider returns nullptr.
+    if (cPtr == nullptr) {
+      InjectorStorage::fatal("attempting to get an instance for the type " + std::string(getTypeId<AnnotatedC>()) +
+                             " but the future returned by the async provider returned nullptr");
+      FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
+    }
+
+    return cPtr;
+  }
+};
+
+template <typename AnnotatedSignature, typename Lambda>
+std::shared_ptr<void> InjectorStorage::startAsyncProvider(InjectorStorage& injector) {
+  using T = RemoveAnnotations<SignatureType<AnnotatedSignature>>;
+  return std::make_shared<std::future<T>>(
+      InvokeAsyncProviderWithInjectedArgVector<AnnotatedSignature, Lambda>()(injector));
+}
+
+template <typename C, typename T, typename AnnotatedSignature, typename Lambda>
+InjectorStorage::const_object_ptr_t
+InjectorStorage::createInjectedObjectForAsyncProvider(InjectorStorage& injector, Graph::node_iterator node_itr) {
+  using AnnotatedC = NormalizeType<SignatureType<AnnotatedSignature>>;
+  std::shared_ptr<void> future_ptr = injector.takeAsyncProviderFuture(node_itr);
+  std::future<T>& future = *static_cast<std::future<T>*>(future_ptr.get());
+  if (!future.valid()) {
+    fatal("attempting to get an instance for the type " + std::string(getTypeId<AnnotatedC>()) +
+          " but the async provider returned an invalid std::future");
+    FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
+  }
+  C* cPtr = StoreAsyncProviderResult<AnnotatedC, T>()(injector.allocator, future.get());
+  node_itr.setTerminal();
+  injector.async_providers_to_start.erase(injector.bindings.indexOf(node_itr));
+  return reinterpret_cast<const_object_ptr_t>(cPtr);
+}
+
+template <typename AnnotatedSignature, typename Lambda>
+inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForAsyncProvider() {
+  using AnnotatedT = SignatureType<AnnotatedSignature>;
+  using AnnotatedC = NormalizeType<AnnotatedT>;
+  // T is either C or C*.
+  using T = RemoveAnnotations<AnnotatedT>;
+  using C = NormalizeType<T>;
+  ComponentStorageEntry result;
+  constexpr bool needs_allocation = !std::is_pointer<T>::value;
+  result.kind = needs_allocation
+                    ? ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
+                    : ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION;
+  result.type_id = getTypeId<AnnotatedC>();
+  ComponentStorageEntry::BindingForObjectToConstruct& binding = result.binding_for_object_to_construct;
+  binding.create = createInjectedObjectForAsyncProvider<C, T, AnnotatedSignature, Lambda>;
+  binding.deps = getBindingDeps<NormalizedSignatureArgs<AnnotatedSignature>>();
+#if FRUIT_EXTRA_DEBUG
+  binding.is_nonconst = true;
+#endif
+  return result;
+}
+
+template <typename AnnotatedSignature, typename Lambda>
+inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForAsyncProviderInfo() {
+  static AsyncProviderInfo info = {getTypeId<NormalizeType<SignatureType<AnnotatedSignature>>>(),
+                                   startAsyncProvider<AnnotatedSignature, Lambda>};
+  return createComponentStorageEntryForInstanceMultibinding<AsyncProviderInfo, AsyncProviderInfo>(info);
+}
+
+inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForObjectArena() {
+  ComponentStorageEntry result;
+  result.kind = ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION;
+  result.type_id = getTypeId<ObjectArena>();
+  ComponentStorageEntry::BindingForObjectToConstruct& binding = result.binding_for_object_to_construct;
+  binding.create = createInjectedObjectForObjectArena;
+  binding.deps = getBindingDeps<fruit::impl::meta::Vector<>>();
+#if FRUIT_EXTRA_DEBUG
+  binding.is_nonconst = true;
+#endif
+  return result;
+}
+
+template <typename Component, typename... Args>
+inline ComponentStorageEntry
+InjectorStorage::createComponentStorageEntryForLazySubcomponent(Component (*fun)(Args...),
+                                                               std::tuple<Args...> args_tuple) {
+  return ComponentStorageEntry::LazySubcomponent::create(fun, std::move(args_tuple),
+                                                         LazySubcomponentTypes<Component>::get());
+}
+
 } // namespace fruit
 } // namespace impl
 
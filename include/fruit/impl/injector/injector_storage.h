@@ -19,13 +19,21 @@
 
 #include <fruit/fruit_forward_decls.h>
 #include <fruit/impl/data_structures/fixed_size_allocator.h>
+#include <fruit/impl/data_structures/object_arena.h>
+#include <fruit/impl/keyed_multibinding_element.h>
 #include <fruit/impl/meta/component.h>
 #include <fruit/impl/normalized_component_storage/normalized_bindings.h>
+#include <fruit/injector_graph.h>
+#include <fruit/injector_stats.h>
+#include <fruit/memory_usage.h>
 
-#include <unordered_map>
-#include <vector>
+#include <atomic>
+#include <future>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace fruit {
 namespace impl {
@@ -93,6 +101,13 @@ public:
   template <typename AnnotatedC, typename C>
   static ComponentStorageEntry createComponentStorageEntryForBindConstInstance(const C& instance);
 
+  // The binding for an instance passed to the constructor of a child injector (const instances get a const binding).
+  template <typename C>
+  static ComponentStorageEntry createComponentStorageEntryForChildInstance(C& instance);
+
+  template <typename C>
+  static ComponentStorageEntry createComponentStorageEntryForChildInstance(const C& instance);
+
   template <typename AnnotatedSignature, typename Lambda>
   static ComponentStorageEntry createComponentStorageEntryForProvider();
 
@@ -114,9 +129,43 @@ public:
   template <typename AnnotatedC, typename C>
   static ComponentStorageEntry createComponentStorageEntryForInstanceMultibinding(C& instance);
 
+  // The multibinding that stores the key of a multibinding added with PartialComponent::addKeyedMultibinding().
+  template <typename K, typename AnnotatedI>
+  static ComponentStorageEntry createComponentStorageEntryForKeyedMultibinding(
+      const KeyedMultibindingElement<K, RemoveAnnotations<AnnotatedI>>* element);
+
+  // The KeyedMultibindingElement::get function for a keyed multibinding of AnnotatedI to AnnotatedC.
+  template <typename AnnotatedI, typename AnnotatedC>
+  static RemoveAnnotations<AnnotatedI>* getKeyedMultibindingObject(InjectorStorage& injector);
+
   template <typename AnnotatedSignature, typename Lambda>
   static ComponentStorageEntry createComponentStorageEntryForMultibindingProvider();
 
+  // The binding for the ObjectArena of the injector, used by the factories bound with registerArenaFactory().
+  static ComponentStorageEntry createComponentStorageEntryForObjectArena();
+
+  // Describes a binding added with PartialComponent::registerAsyncProvider(). There's a multibinding of this type for
+  // each such binding, so that the injector can find them.
+  struct AsyncProviderInfo {
+    // Calls the provider (injecting its arguments) and returns the std::future returned by the provider.
+    using start_t = std::shared_ptr<void> (*)(InjectorStorage&);
+
+    TypeId type;
+    start_t start;
+  };
+
+  // AnnotatedSignature is the signature of a provider returning the result of the future (i.e. C or C*).
+  template <typename AnnotatedSignature, typename Lambda>
+  static ComponentStorageEntry createComponentStorageEntryForAsyncProvider();
+
+  // The AsyncProviderInfo multibinding for the binding created by createComponentStorageEntryForAsyncProvider().
+  template <typename AnnotatedSignature, typename Lambda>
+  static ComponentStorageEntry createComponentStorageEntryForAsyncProviderInfo();
+
+  template <typename Component, typename... Args>
+  static ComponentStorageEntry createComponentStorageEntryForLazySubcomponent(Component (*fun)(Args...),
+                                                                             std::tuple<Args...> args_tuple);
+
 private:
   // The NormalizedComponentStorage owned by this object (if any).
   // Only used for the 1-argument constructor, otherwise it's nullptr.
@@ -124,22 +173,188 @@ private:
 
   FixedSizeAllocator allocator;
 
+  // The objects returned by the factories bound with registerArenaFactory(). These are destroyed before all the other
+  // objects in the injector, since they might depend on them.
+  ObjectArena factory_arena;
+
+  // The number of threads used to destroy the objects in `allocator' (see setTeardownThreads()). When this is 1, they
+  // are destroyed by the allocator itself, in reverse order of construction.
+  std::size_t teardown_threads = 1;
+
+  // Destroys the objects in `allocator' using `teardown_threads' threads, destroying each object only after the objects
+  // that depend on it (according to the dependency graph). If the dependencies of some objects are not known, this
+  // does nothing and the allocator will destroy all objects sequentially instead.
+  void destroyObjectsInParallel();
+
   // A graph with injected types as nodes (each node stores the NormalizedBindingData for the type) and dependencies as
   // edges.
   // For types that have a constructed object already, the corresponding node is stored as terminal node.
   SemistaticGraph<TypeId, NormalizedBinding> bindings;
 
+  // The NormalizedBindingInfo for each node of `bindings' (see SemistaticGraph::indexOf()).
+  std::vector<NormalizedBindingInfo> node_infos;
+
+  // For a child injector, the parent injector (see the corresponding constructor). Otherwise nullptr.
+  InjectorStorage* parent = nullptr;
+
+  // For a child injector, maps the index of each node of `bindings' for a type provided by the parent (and not yet
+  // constructed by the parent when the child was created) to the node for that type in the parent's graph.
+  std::vector<Graph::node_iterator> parent_nodes;
+
   // Maps the type index of a type T to the corresponding NormalizedMultibindingSet object (that stores all
   // multibindings).
   std::unordered_map<TypeId, NormalizedMultibindingSet> multibindings;
 
+  // Maps the type index of a KeyedMultibindingTag<K, AnnotatedI> to a (casted) pointer to the corresponding
+  // KeyedMultibindings<K, I> object, for the ones that were requested (see getKeyedMultibindings()).
+  std::unordered_map<TypeId, std::shared_ptr<char>> keyed_multibindings;
+
   // This mutex is used to synchronize concurrent accesses to this InjectorStorage object.
   std::recursive_mutex mutex;
 
+  // The bindings added with registerAsyncProvider() whose object wasn't constructed yet, indexed by
+  // bindings.indexOf(node_itr). An entry is only removed once the object is stored, so that if the provider or its
+  // future throws the provider is called again the next time the object is needed. This is empty unless there are such
+  // bindings, so that getPtrInternal() only needs to check that.
+  std::unordered_map<std::size_t, AsyncProviderInfo::start_t> async_providers_to_start;
+
+  // The futures returned by the async providers that were called, for the objects that weren't constructed yet (and
+  // whose future wasn't consumed yet). Indexed by bindings.indexOf(node_itr).
+  std::unordered_map<std::size_t, std::shared_ptr<void>> started_async_providers;
+
+  // True while constructing an object (and its dependencies) after calling the async providers it depends on.
+  bool async_providers_started = false;
+
+  // The prefetches started with prefetch() that might still be in progress. The destructor waits for these.
+  std::vector<std::shared_future<void>> prefetches;
+
+  // Does the work of prefetch(), in the current thread.
+  void prefetchInCurrentThread(const std::vector<TypeId>& types, bool include_multibindings);
+
+  // Adds to `nodes' the unconstructed nodes in the (transitive) dependencies of node_itr, including node_itr itself.
+  // Each node is added after its dependencies. `visited' contains the indexes (see SemistaticGraph::indexOf()) of the
+  // nodes visited so far.
+  void findUnconstructedDependencies(Graph::node_iterator node_itr, std::vector<bool>& visited,
+                                     std::vector<Graph::node_iterator>& nodes);
+
+  // Populates async_providers_to_start. This is called by the constructors, once `bindings' and `multibindings' are
+  // populated.
+  void findAsyncProviders();
+
+  // The slow path of getPtrInternal() when async_providers_to_start is not empty: this calls the async providers of the
+  // unconstructed objects in the (transitive) dependencies of node_itr, and then constructs the object.
+  const void* getPtrInternalStartingAsyncProviders(Graph::node_iterator node_itr);
+
+  // Adds to `to_start' the async providers to call in the dependencies of node_itr (including node_itr itself), each
+  // with the length of the longest chain of async providers ending in it. Returns the same length for node_itr.
+  // depth_by_node_index contains the visited nodes.
+  std::size_t findAsyncProvidersToStart(Graph::node_iterator node_itr,
+                                        std::unordered_map<std::size_t, std::size_t>& depth_by_node_index,
+                                        std::vector<std::pair<std::size_t, Graph::node_iterator>>& to_start);
+
+  // Returns the future for node_itr, calling the async provider if it wasn't called already (or if its previous future
+  // was already consumed).
+  std::shared_ptr<void> takeAsyncProviderFuture(Graph::node_iterator node_itr);
+
+  // Defined in injector_storage.cpp.
+  struct LazySubcomponentState;
+
+  // The components installed with PartialComponent::installLazily() (including the ones in the NormalizedComponent, if
+  // any). These are empty when there are no such components.
+  std::vector<std::unique_ptr<LazySubcomponentState>> lazy_subcomponents;
+  std::unordered_map<TypeId, LazySubcomponentState*> lazy_subcomponent_by_provided_type;
+
+  // Takes ownership of `entry', that must have kind LAZY_SUBCOMPONENT.
+  void addLazySubcomponent(ComponentStorageEntry entry);
+
+  // Returns the object for `type' (provided by a lazy subcomponent), creating the injector for the lazy subcomponent if
+  // it wasn't created yet.
+  // node_itr is the node of the placeholder binding for `type'.
+  const void* getLazySubcomponentPtr(TypeId type, Graph::node_iterator node_itr);
+
+  // Creates the injector for a lazy subcomponent, see getLazySubcomponentPtr().
+  void expandLazySubcomponent(LazySubcomponentState& state, Graph::node_iterator node_itr);
+
+  // Used to compute the ComponentStorageEntry::LazySubcomponent::Types for a Component<...> type.
+  template <typename Component>
+  struct LazySubcomponentTypes;
+
+  // Statistics on the construction of this object.
+  fruit::InjectorStats stats;
+
+  // The tracer set with setConstructionTracer(), or nullptr if construction tracing is disabled.
+  fruit::ConstructionTracer* construction_tracer = nullptr;
+
+  // Only populated while construction_tracer != nullptr. Maps bindings.indexOf(node_itr) to the type of the node.
+  std::vector<TypeId> type_id_by_node_index;
+
+  // Populated once a tracer is set. Maps bindings.indexOf(node_itr) to the time spent constructing the object
+  // (excluding its dependencies), or to NOT_TRACED if it wasn't constructed while a tracer was set.
+  std::vector<std::uint64_t> construction_ns_by_node_index;
+  static constexpr std::uint64_t NOT_TRACED = static_cast<std::uint64_t>(-1);
+
+  // The slow path of getPtrInternal() when construction_tracer != nullptr and the object is not constructed yet.
+  const void* getPtrInternalWithTracing(Graph::node_iterator node_itr);
+
+  // The kinds of lookups counted in LookupStats.
+  enum class LookupKind { GET, UNSAFE_GET, MULTIBINDINGS };
+
+  struct LookupCounters {
+    std::size_t num_gets = 0;
+    std::size_t num_unsafe_gets = 0;
+    std::size_t num_multibinding_gets = 0;
+  };
+
+  // Whether lookups are being counted, see setLookupCounting(). This is read before locking `mutex', so that the
+  // time spent waiting for the lock can be measured.
+  std::atomic<bool> lookup_counting{false};
+
+  // These are only updated while lookup_counting is true.
+  std::unordered_map<TypeId, LookupCounters> lookup_counters_by_type;
+  std::size_t num_contended_lookups = 0;
+  std::uint64_t mutex_wait_ns = 0;
+  std::uint64_t max_mutex_wait_ns = 0;
+
+  // Locks `mutex' and records a lookup of `type' in the counters above.
+  std::unique_lock<std::recursive_mutex> lockAndCountLookup(TypeId type, LookupKind kind);
+
+  // The slow paths of get(), unsafeGet() and getMultibindings() used when lookup_counting is true.
+  template <typename AnnotatedT>
+  RemoveAnnotations<AnnotatedT> getWithLookupCounting();
+  template <typename AnnotatedC>
+  const RemoveAnnotations<AnnotatedC>* unsafeGetWithLookupCounting();
+  template <typename AnnotatedC>
+  const std::vector<RemoveAnnotations<AnnotatedC>*>& getMultibindingsWithLookupCounting();
+
+  // Like getMultibindings(), but this doesn't count the lookup. The caller must hold the lock on `mutex'.
+  template <typename AnnotatedC>
+  const std::vector<RemoveAnnotations<AnnotatedC>*>& getMultibindingsLocked();
+
+  // Like getMultibindingProviders(), but this doesn't count the lookup. The caller must hold the lock on `mutex'.
+  template <typename AnnotatedC>
+  const std::vector<fruit::MultibindingProvider<RemoveAnnotations<AnnotatedC>>>& getMultibindingProvidersLocked();
+
+  // Like getKeyedMultibindings(), but this doesn't count the lookup. The caller must hold the lock on `mutex'.
+  template <typename K, typename AnnotatedI>
+  const fruit::KeyedMultibindings<K, RemoveAnnotations<AnnotatedI>>& getKeyedMultibindingsLocked();
+
+  // Adds the memory used by this object (including the injectors of lazy subcomponents) to `memory_usage'.
+  // The caller must hold the lock on `mutex'.
+  void addMemoryUsage(fruit::MemoryUsage& memory_usage);
+
 private:
   template <typename AnnotatedC>
   static std::shared_ptr<char> createMultibindingVector(InjectorStorage& storage);
 
+  // Used instead of createMultibindingVector() for the multibindings that are only added to keep the objects of keyed
+  // multibindings in the graph (see PartialComponent::addKeyedMultibinding()). Those are never retrieved as a vector,
+  // and this doesn't construct anything, so that eagerlyInjectAll() and prefetchAll() keep the keyed objects lazy.
+  static std::shared_ptr<char> createNoMultibindingVector(InjectorStorage& storage);
+
+  // Selects the get_multibindings_vector function for the multibindings of AnnotatedT.
+  template <typename AnnotatedT>
+  struct GetMultibindingsVectorFunction;
+
   // If not bound, returns nullptr.
   NormalizedMultibindingSet* getNormalizedMultibindingSet(TypeId type);
 
@@ -169,7 +384,15 @@ private:
   void* getMultibindings(TypeId type);
 
   // Constructs any necessary instances, but NOT the instance set.
-  void ensureConstructedMultibinding(NormalizedMultibindingSet& multibinding_set);
+  // `type' is the type of the multibindings, it's only used for construction tracing.
+  void ensureConstructedMultibinding(TypeId type, NormalizedMultibindingSet& multibinding_set);
+
+  // Constructs a single multibinding (that must not be constructed yet). The caller must hold the lock on `mutex'.
+  // `type' is the type of the multibinding, it's only used for construction tracing.
+  void constructMultibinding(TypeId type, NormalizedMultibinding& multibinding);
+
+  // Returns the object for `multibinding', constructing it if needed. Used by MultibindingProvider.
+  void* getMultibindingObject(TypeId type, NormalizedMultibinding& multibinding);
 
   template <typename T>
   friend struct GetFirstStage;
@@ -177,6 +400,9 @@ private:
   template <typename T>
   friend class fruit::Provider;
 
+  template <typename C>
+  friend class fruit::MultibindingProvider;
+
   using object_ptr_t = void*;
   using const_object_ptr_t = const void*;
 
@@ -205,6 +431,23 @@ private:
   template <typename C, typename T, typename AnnotatedSignature, typename Lambda>
   static object_ptr_t createInjectedObjectForMultibindingProvider(InjectorStorage& injector);
 
+  template <typename C, typename T, typename AnnotatedSignature, typename Lambda>
+  static const_object_ptr_t createInjectedObjectForAsyncProvider(InjectorStorage& injector,
+                                                                 Graph::node_iterator node_itr);
+
+  template <typename AnnotatedSignature, typename Lambda>
+  static std::shared_ptr<void> startAsyncProvider(InjectorStorage& injector);
+
+  static const_object_ptr_t createInjectedObjectForObjectArena(InjectorStorage& injector,
+                                                               Graph::node_iterator node_itr);
+
+  // The create function of the bindings of a child injector for the types provided by the parent.
+  static const_object_ptr_t createInjectedObjectFromParent(InjectorStorage& injector, Graph::node_iterator node_itr);
+
+  template <typename AnnotatedT>
+  static const_object_ptr_t createInjectedObjectForLazySubcomponent(InjectorStorage& injector,
+                                                                    Graph::node_iterator node_itr);
+
 public:
   // Wraps a std::vector<ComponentStorageEntry>::iterator as an iterator on tuples
   // (typeId, normalizedBindingData, isTerminal, edgesBegin, edgesEnd)
@@ -239,8 +482,18 @@ public:
   InjectorStorage(const NormalizedComponentStorage& normalized_storage, ComponentStorage&& storage,
                   MemoryPool& memory_pool);
 
-  // This is just the default destructor, but we declare it here to avoid including
-  // normalized_component_storage.h in fruit.h.
+  /**
+   * Creates a child injector of `parent' that provides `exposed_types' (the normalized types), resolving them through
+   * the parent's graph unless they're bound by one of the entries in `instances' (that must all have kind
+   * BINDING_FOR_CONSTRUCTED_OBJECT). See the corresponding constructor of Injector.
+   * The MemoryPool is only used during construction, the constructed object *can* outlive the memory pool.
+   */
+  InjectorStorage(InjectorStorage& parent, const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+                  const std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& instances,
+                  MemoryPool& memory_pool);
+
+  // This is declared here (instead of using the default destructor) to avoid including normalized_component_storage.h
+  // in fruit.h.
   ~InjectorStorage();
 
   InjectorStorage(InjectorStorage&&) = delete;
@@ -254,6 +507,11 @@ public:
   template <typename AnnotatedT>
   RemoveAnnotations<AnnotatedT> get();
 
+  // Like get(), but the lookup is not counted in LookupStats and the caller must hold the lock on `mutex'.
+  // This is used to inject the dependencies of providers and multibindings.
+  template <typename AnnotatedT>
+  RemoveAnnotations<AnnotatedT> getLocked();
+
   // Similar to the above, but specifying the node_iterator of the type. Use this together with lazyGetPtr when the
   // node_iterator is known, it's faster.
   // Note that T should *not* be annotated.
@@ -275,10 +533,55 @@ public:
   template <typename AnnotatedC>
   const std::vector<RemoveAnnotations<AnnotatedC>*>& getMultibindings();
 
+  // Returns a provider for each multibinding of type AnnotatedC, that constructs it on demand. See
+  // Injector::getMultibindingProviders().
+  template <typename AnnotatedC>
+  const std::vector<fruit::MultibindingProvider<RemoveAnnotations<AnnotatedC>>>& getMultibindingProviders();
+
+  // Returns the keyed multibindings of type AnnotatedI with keys of type K. See Injector::getKeyedMultibindings().
+  template <typename K, typename AnnotatedI>
+  const fruit::KeyedMultibindings<K, RemoveAnnotations<AnnotatedI>>& getKeyedMultibindings();
+
   void eagerlyInjectMultibindings();
+
+  // Constructs the objects for `types' (and their dependencies) in a new thread, see Injector::prefetch().
+  // If include_multibindings is true, this also constructs all multibindings.
+  std::shared_future<void> prefetch(std::vector<TypeId> types, bool include_multibindings);
+
+  // Starts (or, if tracer==nullptr, stops) recording constructions of objects in this injector (and in the injectors of
+  // lazily-installed components) in `tracer', that must outlive this object or be replaced before it's destroyed.
+  void setConstructionTracer(fruit::ConstructionTracer* tracer);
+
+  // Sets the teardown policy of this injector (and of the injectors of lazily-installed components), see
+  // FixedSizeAllocator::setTeardownPolicy().
+  void setTeardownPolicy(fruit::TeardownPolicy policy);
+
+  // Sets the number of threads used to destroy the objects of this injector (and of the injectors of lazily-installed
+  // components) when it's destroyed. 0 means std::thread::hardware_concurrency().
+  void setTeardownThreads(std::size_t num_threads);
+
+  const fruit::InjectorStats& getStats() const;
+
+  // Starts (or, if enabled==false, stops) counting the lookups done with get(), unsafeGet() and getMultibindings().
+  void setLookupCounting(bool enabled);
+
+  fruit::LookupStats getLookupStats();
+
+  // Resets the counters returned by getLookupStats().
+  void clearLookupStats();
+
+  fruit::MemoryUsage getMemoryUsage();
+
+  fruit::InjectorGraph getGraph();
 };
 
 } // namespace impl
+
+// The injectors of lazily-installed components are always destroyed, so that they can in turn destroy the objects that
+// hold external resources (they have the same teardown policy as the parent injector).
+template <>
+struct HoldsExternalResources<fruit::impl::InjectorStorage> : std::true_type {};
+
 } // namespace fruit
 
 #include <fruit/impl/injector/injector_storage.defn.h>
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_KEYED_MULTIBINDING_ELEMENT_DEFN_H
+#define FRUIT_KEYED_MULTIBINDING_ELEMENT_DEFN_H
+
+#include <fruit/impl/keyed_multibinding_element.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace fruit {
+namespace impl {
+
+template <typename K, typename I>
+inline KeyedMultibindingElement<K, I>::KeyedMultibindingElement(const K& key, get_t get) : key(key), get(get) {}
+
+template <typename K, typename I>
+inline const KeyedMultibindingElement<K, I>* KeyedMultibindingElement<K, I>::intern(const K& key, get_t get) {
+  using Elements = std::unordered_multimap<K, std::unique_ptr<KeyedMultibindingElement>, std::hash<K>>;
+  static std::mutex mutex;
+  // This is intentionally never deleted, since components might be created during static destruction too.
+  static Elements* elements = new Elements();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto range = elements->equal_range(key);
+  for (auto itr = range.first; itr != range.second; ++itr) {
+    if (itr->second->get == get) {
+      return itr->second.get();
+    }
+  }
+  std::unique_ptr<KeyedMultibindingElement> element(new KeyedMultibindingElement(key, get));
+  const KeyedMultibindingElement* result = element.get();
+  elements->emplace(key, std::move(element));
+  return result;
+}
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_KEYED_MULTIBINDING_ELEMENT_DEFN_H
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_KEYED_MULTIBINDING_ELEMENT_H
+#define FRUIT_KEYED_MULTIBINDING_ELEMENT_H
+
+#include <fruit/impl/fruit_internal_forward_decls.h>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * The type of the multibindings that hold the KeyedMultibindingElement objects for the keyed multibindings of
+ * AnnotatedI with keys of type K (see PartialComponent::addKeyedMultibinding()).
+ * This is only used as a type, it's never instantiated.
+ */
+template <typename K, typename AnnotatedI>
+struct KeyedMultibindingTag {};
+
+/**
+ * The key of a keyed multibinding, with a function that gets the (I-casted) object for it from an injector.
+ *
+ * Components only store a pointer to one of these objects, like they do for instance multibindings. For this reason
+ * these objects are interned (see intern()) and never deallocated, so they can outlive the components and the
+ * injectors, and two equal keyed multibindings have the same address.
+ */
+template <typename K, typename I>
+struct KeyedMultibindingElement {
+  using get_t = I* (*)(InjectorStorage&);
+
+  K key;
+  get_t get;
+
+  KeyedMultibindingElement(const K& key, get_t get);
+
+  /**
+   * Returns the element with the specified key and get function, creating it the first time it's requested.
+   * This is thread-safe.
+   */
+  static const KeyedMultibindingElement* intern(const K& key, get_t get);
+};
+
+} // namespace impl
+} // namespace fruit
+
+#include <fruit/impl/keyed_multibinding_element.defn.h>
+
+#endif // FRUIT_KEYED_MULTIBINDING_ELEMENT_H
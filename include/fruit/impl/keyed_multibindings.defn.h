@@ -0,0 +1,89 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_KEYED_MULTIBINDINGS_DEFN_H
+#define FRUIT_KEYED_MULTIBINDINGS_DEFN_H
+
+#include <fruit/impl/injector/injector_storage.h>
+#include <fruit/impl/util/type_info.h>
+
+// Redundant, but makes KDevelop happy.
+#include <fruit/keyed_multibindings.h>
+
+namespace fruit {
+
+template <typename K, typename C>
+inline KeyedMultibindings<K, C>::KeyedMultibindings(fruit::impl::InjectorStorage* storage,
+                                                    const std::vector<const Element*>& elements)
+    : storage(storage), slots(new Slot[elements.size()]), num_slots(0),
+      slots_by_key(elements.size(), std::hash<K>(), std::equal_to<K>(), memory_pool) {
+  for (const Element* element : elements) {
+    auto itr = slots_by_key.find(element->key);
+    if (itr != slots_by_key.end()) {
+      if (itr->second->element != element) {
+        fruit::impl::InjectorStorage::fatal(
+            "the keyed multibindings for the type " + std::string(fruit::impl::getTypeId<C>()) + " with keys of type " +
+            std::string(fruit::impl::getTypeId<K>()) + " contain two different multibindings with the same key.");
+      }
+      // The same keyed multibinding was added more than once (e.g. by different components).
+      continue;
+    }
+    Slot& slot = slots[num_slots];
+    ++num_slots;
+    slot.element = element;
+    slot.object.store(nullptr, std::memory_order_relaxed);
+    slots_by_key.insert(std::make_pair(element->key, &slot));
+  }
+}
+
+template <typename K, typename C>
+inline C* KeyedMultibindings<K, C>::get(const K& key) const {
+  auto itr = slots_by_key.find(key);
+  if (itr == slots_by_key.end()) {
+    return nullptr;
+  }
+  Slot& slot = *itr->second;
+  C* result = slot.object.load(std::memory_order_acquire);
+  if (result == nullptr) {
+    result = slot.element->get(*storage);
+    slot.object.store(result, std::memory_order_release);
+  }
+  return result;
+}
+
+template <typename K, typename C>
+inline bool KeyedMultibindings<K, C>::contains(const K& key) const {
+  return slots_by_key.count(key) != 0;
+}
+
+template <typename K, typename C>
+inline std::size_t KeyedMultibindings<K, C>::size() const {
+  return num_slots;
+}
+
+template <typename K, typename C>
+inline std::vector<K> KeyedMultibindings<K, C>::getKeys() const {
+  std::vector<K> keys;
+  keys.reserve(num_slots);
+  for (std::size_t i = 0; i < num_slots; ++i) {
+    keys.push_back(slots[i].element->key);
+  }
+  return keys;
+}
+
+} // namespace fruit
+
+#endif // FRUIT_KEYED_MULTIBINDINGS_DEFN_H
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_MULTIBINDING_PROVIDER_DEFN_H
+#define FRUIT_MULTIBINDING_PROVIDER_DEFN_H
+
+#include <fruit/impl/injector/injector_storage.h>
+
+// Redundant, but makes KDevelop happy.
+#include <fruit/multibinding_provider.h>
+
+namespace fruit {
+
+template <typename C>
+inline MultibindingProvider<C>::MultibindingProvider(fruit::impl::InjectorStorage* storage, fruit::impl::TypeId type,
+                                                     fruit::impl::NormalizedMultibinding* multibinding, C* object)
+    : storage(storage), type(type), multibinding(multibinding), object(object) {}
+
+template <typename C>
+inline MultibindingProvider<C>::MultibindingProvider(const MultibindingProvider& other)
+    : storage(other.storage), type(other.type), multibinding(other.multibinding),
+      object(other.object.load(std::memory_order_acquire)) {}
+
+template <typename C>
+inline MultibindingProvider<C>& MultibindingProvider<C>::operator=(const MultibindingProvider& other) {
+  storage = other.storage;
+  type = other.type;
+  multibinding = other.multibinding;
+  object.store(other.object.load(std::memory_order_acquire), std::memory_order_release);
+  return *this;
+}
+
+template <typename C>
+inline C* MultibindingProvider<C>::get() const {
+  C* result = object.load(std::memory_order_acquire);
+  if (result == nullptr) {
+    result = reinterpret_cast<C*>(storage->getMultibindingObject(type, *multibinding));
+    object.store(result, std::memory_order_release);
+  }
+  return result;
+}
+
+template <typename C>
+inline bool MultibindingProvider<C>::isConstructed() const {
+  return object.load(std::memory_order_acquire) != nullptr;
+}
+
+template <typename C>
+inline C& MultibindingProvider<C>::operator*() const {
+  return *get();
+}
+
+template <typename C>
+inline C* MultibindingProvider<C>::operator->() const {
+  return get();
+}
+
+} // namespace fruit
+
+#endif // FRUIT_MULTIBINDING_PROVIDER_DEFN_H
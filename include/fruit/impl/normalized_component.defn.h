@@ -42,6 +42,16 @@ inline NormalizedComponent<Params...>::NormalizedComponent(fruit::impl::Componen
                       fruit::impl::meta::Type<Params>...)>::Ps)>>(memory_pool),
               memory_pool, fruit::impl::NormalizedComponentStorageHolder::WithUndoableCompression()) {}
 
+template <typename... Params>
+inline const NormalizationStats& NormalizedComponent<Params...>::getNormalizationStats() const {
+  return storage.getNormalizationStats();
+}
+
+template <typename... Params>
+inline MemoryUsage NormalizedComponent<Params...>::getMemoryUsage() const {
+  return storage.getMemoryUsage();
+}
+
 } // namespace fruit
 
 #endif // FRUIT_NORMALIZED_COMPONENT_INLINES_H
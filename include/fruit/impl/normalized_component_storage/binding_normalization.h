@@ -27,6 +27,7 @@
 #include <fruit/impl/data_structures/fixed_size_allocator.h>
 #include <fruit/impl/normalized_component_storage/normalized_component_storage.h>
 #include <fruit/impl/util/hash_helpers.h>
+#include <fruit/injector_stats.h>
 
 namespace fruit {
 namespace impl {
@@ -57,13 +58,16 @@ public:
    * Normalizes the toplevel entries and performs binding compression.
    * This does *not* keep track of what binding compressions were performed, so they can't be undone. When we might need
    * to undo the binding compression, use normalizeBindingsWithUndoableBindingCompression() instead.
+   * The interface types whose bindings were compressed are added to compressed_type_ids.
    */
   static void normalizeBindingsWithPermanentBindingCompression(
-      FixedSizeVector<ComponentStorageEntry>&& toplevel_entries,
+      ComponentStorageEntryVector&& toplevel_entries,
       FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data, MemoryPool& memory_pool,
       const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
       std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& bindings_vector,
-      std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings);
+      std::vector<TypeId, ArenaAllocator<TypeId>>& compressed_type_ids,
+      std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings,
+      std::vector<ComponentStorageEntry>& lazy_subcomponents, fruit::NormalizationStats& stats);
 
   /**
    * Normalizes the toplevel entries and performs binding compression, but keeps track of which compressions were
@@ -71,7 +75,7 @@ public:
    * This is more expensive than normalizeBindingsWithPermanentBindingCompression(), use that when it suffices.
    */
   static void normalizeBindingsWithUndoableBindingCompression(
-      FixedSizeVector<ComponentStorageEntry>&& toplevel_entries,
+      ComponentStorageEntryVector&& toplevel_entries,
       FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data, MemoryPool& memory_pool,
       MemoryPool& memory_pool_for_fully_expanded_components_maps,
       MemoryPool& memory_pool_for_component_replacements_maps,
@@ -82,14 +86,21 @@ public:
       LazyComponentWithNoArgsSet& fully_expanded_components_with_no_args,
       LazyComponentWithArgsSet& fully_expanded_components_with_args,
       LazyComponentWithNoArgsReplacementMap& component_with_no_args_replacements,
-      LazyComponentWithArgsReplacementMap& component_with_args_replacements);
+      LazyComponentWithArgsReplacementMap& component_with_args_replacements,
+      std::vector<ComponentStorageEntry>& lazy_subcomponents, fruit::NormalizationStats& stats);
 
+  /**
+   * The LAZY_SUBCOMPONENT entries found during the normalization are moved into `lazy_subcomponents' (for all the
+   * normalizeBindings* methods). The caller then owns them, and must call destroy() on them.
+   * Similarly, all the normalizeBindings* methods fill the fields of `stats' related to the phases that they perform.
+   */
   static void normalizeBindingsAndAddTo(
-      FixedSizeVector<ComponentStorageEntry>&& toplevel_entries, MemoryPool& memory_pool,
+      ComponentStorageEntryVector&& toplevel_entries, MemoryPool& memory_pool,
       const NormalizedComponentStorage& base_normalized_component,
       FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
       std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& new_bindings_vector,
-      std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings);
+      std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings,
+      std::vector<ComponentStorageEntry>& lazy_subcomponents, fruit::NormalizationStats& stats);
 
 private:
   using multibindings_vector_elem_t = std::pair<ComponentStorageEntry, ComponentStorageEntry>;
@@ -112,12 +123,12 @@ private:
    * Normalizes the toplevel entries (but doesn't perform binding compression).
    */
   template <typename... Functors>
-  static void normalizeBindings(FixedSizeVector<ComponentStorageEntry>&& toplevel_entries,
+  static void normalizeBindings(ComponentStorageEntryVector&& toplevel_entries,
                                 FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
                                 MemoryPool& memory_pool, MemoryPool& memory_pool_for_fully_expanded_components_maps,
                                 MemoryPool& memory_pool_for_component_replacements_maps,
                                 HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>& binding_data_map,
-                                Functors... functors);
+                                fruit::NormalizationStats& stats, Functors... functors);
 
   struct BindingCompressionInfo {
     TypeId i_type_id;
@@ -134,7 +145,7 @@ private:
             typename SaveFullyExpandedComponentsWithArgs, typename SaveComponentReplacementsWithNoArgs,
             typename SaveComponentReplacementsWithArgs>
   static void normalizeBindingsWithBindingCompression(
-      FixedSizeVector<ComponentStorageEntry>&& toplevel_entries,
+      ComponentStorageEntryVector&& toplevel_entries,
       FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data, MemoryPool& memory_pool,
       MemoryPool& memory_pool_for_fully_expanded_components_maps,
       MemoryPool& memory_pool_for_component_replacements_maps,
@@ -145,7 +156,8 @@ private:
       SaveFullyExpandedComponentsWithNoArgs save_fully_expanded_components_with_no_args,
       SaveFullyExpandedComponentsWithArgs save_fully_expanded_components_with_args,
       SaveComponentReplacementsWithNoArgs save_component_replacements_with_no_args,
-      SaveComponentReplacementsWithArgs save_component_replacements_with_args);
+      SaveComponentReplacementsWithArgs save_component_replacements_with_args,
+      std::vector<ComponentStorageEntry>& lazy_subcomponents, fruit::NormalizationStats& stats);
 
   /**
    * bindingCompressionInfoMap is an output parameter. This function will store information on all performed binding
@@ -180,7 +192,8 @@ private:
             typename GetComponentWithArgsReplacementInNormalizedComponent,
             typename IsLazyComponentWithNoArgsIteratorValid, typename IsLazyComponentWithArgsIteratorValid,
             typename DereferenceLazyComponentWithNoArgsIterator, typename DereferenceLazyComponentWithArgsIterator,
-            typename SaveComponentReplacementsWithNoArgs, typename SaveComponentReplacementsWithArgs>
+            typename SaveComponentReplacementsWithNoArgs, typename SaveComponentReplacementsWithArgs,
+            typename HandleLazySubcomponent>
   struct BindingNormalizationFunctors {
 
     /**
@@ -257,6 +270,12 @@ private:
 
     SaveComponentReplacementsWithNoArgs save_component_replacements_with_no_args;
     SaveComponentReplacementsWithArgs save_component_replacements_with_args;
+
+    /**
+     * This should have an operator()(ComponentStorageEntry&) that will be called for each LAZY_SUBCOMPONENT entry, and
+     * takes ownership of it (the placeholder bindings for it are added by the normalization itself).
+     */
+    HandleLazySubcomponent handle_lazy_subcomponent;
   };
 
   /**
@@ -270,6 +289,7 @@ private:
     MemoryPool& memory_pool_for_fully_expanded_components_maps;
     MemoryPool& memory_pool_for_component_replacements_maps;
     HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>& binding_data_map;
+    fruit::NormalizationStats& stats;
     BindingNormalizationFunctors<Functors...> functors;
 
     // These are in reversed order (note that toplevel_entries must also be in reverse order).
@@ -298,12 +318,12 @@ private:
         NormalizedComponentStorage::createLazyComponentWithArgsReplacementMap(
             20 /* capacity */, memory_pool_for_component_replacements_maps);
 
-    BindingNormalizationContext(FixedSizeVector<ComponentStorageEntry>& toplevel_entries,
+    BindingNormalizationContext(ComponentStorageEntryVector& toplevel_entries,
                                 FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
                                 MemoryPool& memory_pool, MemoryPool& memory_pool_for_fully_expanded_components_maps,
                                 MemoryPool& memory_pool_for_component_replacements_maps,
                                 HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>& binding_data_map,
-                                BindingNormalizationFunctors<Functors...> functors);
+                                fruit::NormalizationStats& stats, BindingNormalizationFunctors<Functors...> functors);
 
     BindingNormalizationContext(const BindingNormalizationContext&) = delete;
     BindingNormalizationContext(BindingNormalizationContext&&) = delete;
@@ -350,6 +370,9 @@ private:
   template <typename... Params>
   static void handleLazyComponentWithNoArgs(BindingNormalizationContext<Params...>& context);
 
+  template <typename... Params>
+  static void handleLazySubcomponent(BindingNormalizationContext<Params...>& context);
+
   template <typename... Params>
   static void performComponentReplacement(BindingNormalizationContext<Params...>& context,
                                           const ComponentStorageEntry& replacement);
@@ -24,6 +24,7 @@
 
 #include <fruit/impl/component_storage/component_storage_entry.h>
 #include <fruit/impl/normalized_component_storage/binding_normalization.h>
+#include <fruit/impl/util/stopwatch.h>
 #include <fruit/impl/util/type_info.h>
 
 using namespace fruit::impl;
@@ -33,15 +34,15 @@ namespace impl {
 
 template <typename... Functors>
 BindingNormalization::BindingNormalizationContext<Functors...>::BindingNormalizationContext(
-    FixedSizeVector<ComponentStorageEntry>& toplevel_entries,
+    ComponentStorageEntryVector& toplevel_entries,
     FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data, MemoryPool& memory_pool,
     MemoryPool& memory_pool_for_fully_expanded_components_maps, MemoryPool& memory_pool_for_component_replacements_maps,
-    HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>& binding_data_map,
+    HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>& binding_data_map, fruit::NormalizationStats& stats,
     BindingNormalizationFunctors<Functors...> functors)
     : fixed_size_allocator_data(fixed_size_allocator_data), memory_pool(memory_pool),
       memory_pool_for_fully_expanded_components_maps(memory_pool_for_fully_expanded_components_maps),
       memory_pool_for_component_replacements_maps(memory_pool_for_component_replacements_maps),
-      binding_data_map(binding_data_map), functors(functors),
+      binding_data_map(binding_data_map), stats(stats), functors(functors),
       entries_to_process(toplevel_entries.begin(), toplevel_entries.end(),
                          ArenaAllocator<ComponentStorageEntry>(memory_pool)) {
 
@@ -71,26 +72,29 @@ BindingNormalization::BindingNormalizationContext<Functors...>::~BindingNormaliz
 }
 
 template <typename... Functors>
-void BindingNormalization::normalizeBindings(FixedSizeVector<ComponentStorageEntry>&& toplevel_entries,
+void BindingNormalization::normalizeBindings(ComponentStorageEntryVector&& toplevel_entries,
                                              FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
                                              MemoryPool& memory_pool,
                                              MemoryPool& memory_pool_for_fully_expanded_components_maps,
                                              MemoryPool& memory_pool_for_component_replacements_maps,
                                              HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>& binding_data_map,
-                                             Functors... functors) {
+                                             fruit::NormalizationStats& stats, Functors... functors) {
 
   FruitAssert(binding_data_map.empty());
 
+  Stopwatch stopwatch;
+
   using Context = BindingNormalizationContext<Functors...>;
 
   Context context(toplevel_entries, fixed_size_allocator_data, memory_pool,
                   memory_pool_for_fully_expanded_components_maps, memory_pool_for_component_replacements_maps,
-                  binding_data_map, BindingNormalizationFunctors<Functors...>{functors...});
+                  binding_data_map, stats, BindingNormalizationFunctors<Functors...>{functors...});
 
   // When we expand a lazy component, instead of removing it from the stack we change its kind (in entries_to_process)
   // to one of the *_END_MARKER kinds. This allows to keep track of the "call stack" for the expansion.
 
   while (!context.entries_to_process.empty()) {
+    ++stats.num_entries_processed;
     switch (context.entries_to_process.back().kind) { // LCOV_EXCL_BR_LINE
     case ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT:
       handleBindingForConstructedObject(context);
@@ -142,6 +146,10 @@ void BindingNormalization::normalizeBindings(FixedSizeVector<ComponentStorageEnt
       handleLazyComponentWithNoArgs(context);
       break;
 
+    case ComponentStorageEntry::Kind::LAZY_SUBCOMPONENT:
+      handleLazySubcomponent(context);
+      break;
+
     default:
 #if FRUIT_EXTRA_DEBUG
       std::cerr << "Unexpected kind: " << (std::size_t)context.entries_to_process.back().kind << std::endl;
@@ -154,6 +162,8 @@ void BindingNormalization::normalizeBindings(FixedSizeVector<ComponentStorageEnt
   context.functors.save_fully_expanded_components_with_args(context.fully_expanded_components_with_args);
   context.functors.save_component_replacements_with_no_args(context.component_with_no_args_replacements);
   context.functors.save_component_replacements_with_args(context.component_with_args_replacements);
+
+  stats.component_expansion_ns += stopwatch.elapsedNs();
 }
 
 template <typename... Params>
@@ -172,6 +182,7 @@ BindingNormalization::handleBindingForConstructedObject(BindingNormalizationCont
       FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
     }
     // Otherwise ok, duplicate but consistent binding.
+    ++context.stats.num_duplicate_bindings;
     return;
   }
 
@@ -189,6 +200,7 @@ BindingNormalization::handleBindingForConstructedObject(BindingNormalizationCont
 #if FRUIT_EXTRA_DEBUG
     entry_in_map.binding_for_constructed_object.is_nonconst |= entry.binding_for_constructed_object.is_nonconst;
 #endif
+    ++context.stats.num_duplicate_bindings;
     return;
   }
 
@@ -211,6 +223,7 @@ FRUIT_ALWAYS_INLINE inline void BindingNormalization::handleBindingForObjectToCo
       FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
     }
     // Otherwise ok, duplicate but consistent binding.
+    ++context.stats.num_duplicate_bindings;
     return;
   }
 
@@ -223,6 +236,7 @@ FRUIT_ALWAYS_INLINE inline void BindingNormalization::handleBindingForObjectToCo
       FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
     }
     // Otherwise ok, duplicate but consistent binding.
+    ++context.stats.num_duplicate_bindings;
     return;
   }
 
@@ -245,6 +259,7 @@ FRUIT_ALWAYS_INLINE inline void BindingNormalization::handleBindingForObjectToCo
       FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
     }
     // Otherwise ok, duplicate but consistent binding.
+    ++context.stats.num_duplicate_bindings;
     return;
   }
 
@@ -257,6 +272,7 @@ FRUIT_ALWAYS_INLINE inline void BindingNormalization::handleBindingForObjectToCo
       FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
     }
     // Otherwise ok, duplicate but consistent binding.
+    ++context.stats.num_duplicate_bindings;
     return;
   }
 
@@ -329,6 +345,31 @@ BindingNormalization::handleComponentWithArgsEndMarker(BindingNormalizationConte
   context.fully_expanded_components_with_args.insert(std::move(entry.lazy_component_with_args));
 }
 
+template <typename... Params>
+void BindingNormalization::handleLazySubcomponent(BindingNormalizationContext<Params...>& context) {
+  ComponentStorageEntry entry = context.entries_to_process.back();
+  FruitAssert(entry.kind == ComponentStorageEntry::Kind::LAZY_SUBCOMPONENT);
+  context.entries_to_process.pop_back();
+
+  // The component is not expanded here. Instead, we add a placeholder binding for each type that it provides; these
+  // are then processed as normal bindings (e.g. to detect multiple bindings for the same type) and they expand the
+  // component when one of them is injected.
+  const ComponentStorageEntry::LazySubcomponent::Types& types = *entry.lazy_subcomponent.types;
+  for (std::size_t i = 0; i < types.provided_types->num_deps; ++i) {
+    ComponentStorageEntry placeholder;
+    placeholder.kind = ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION;
+    placeholder.type_id = types.provided_types->deps[i];
+    placeholder.binding_for_object_to_construct.create = types.placeholder_creates[i];
+    placeholder.binding_for_object_to_construct.deps = types.required_types;
+#if FRUIT_EXTRA_DEBUG
+    placeholder.binding_for_object_to_construct.is_nonconst = true;
+#endif
+    context.entries_to_process.push_back(placeholder);
+  }
+
+  context.functors.handle_lazy_subcomponent(entry);
+}
+
 template <typename... Params>
 void BindingNormalization::handleReplacedLazyComponentWithArgs(BindingNormalizationContext<Params...>& context) {
   ComponentStorageEntry entry = context.entries_to_process.back();
@@ -456,6 +497,7 @@ BindingNormalization::handleLazyComponentWithArgs(BindingNormalizationContext<Pa
       context.functors.is_component_with_args_already_expanded_in_normalized_component(
           entry.lazy_component_with_args)) {
     // This lazy component was already inserted, skip it.
+    ++context.stats.num_duplicate_components;
     entry.lazy_component_with_args.destroy();
     context.entries_to_process.pop_back();
     return;
@@ -489,6 +531,8 @@ BindingNormalization::handleLazyComponentWithArgs(BindingNormalizationContext<Pa
   std::cout << "Expanding lazy component: " << entry.lazy_component_with_args.component->getFunTypeId() << std::endl;
 #endif
 
+  ++context.stats.num_components_expanded;
+
   // Instead of removing the component from component.lazy_components, we just change its kind to the
   // corresponding *_END_MARKER kind.
   // When we pop this marker, this component's expansion will be complete.
@@ -509,6 +553,7 @@ BindingNormalization::handleLazyComponentWithNoArgs(BindingNormalizationContext<
       context.functors.is_component_with_no_args_already_expanded_in_normalized_component(
           entry.lazy_component_with_no_args)) {
     // This lazy component was already inserted, skip it.
+    ++context.stats.num_duplicate_components;
     context.entries_to_process.pop_back();
     return;
   }
@@ -541,6 +586,8 @@ BindingNormalization::handleLazyComponentWithNoArgs(BindingNormalizationContext<
   std::cout << "Expanding lazy component: " << entry.type_id << std::endl;
 #endif
 
+  ++context.stats.num_components_expanded;
+
   // Instead of removing the component from component.lazy_components, we just change its kind to the
   // corresponding *_END_MARKER kind.
   // When we pop this marker, this component's expansion will be complete.
@@ -668,7 +715,7 @@ template <typename SaveCompressedBindingUndoInfo, typename SaveFullyExpandedComp
           typename SaveFullyExpandedComponentsWithArgs, typename SaveComponentReplacementsWithNoArgs,
           typename SaveComponentReplacementsWithArgs>
 void BindingNormalization::normalizeBindingsWithBindingCompression(
-    FixedSizeVector<ComponentStorageEntry>&& toplevel_entries,
+    ComponentStorageEntryVector&& toplevel_entries,
     FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data, MemoryPool& memory_pool,
     MemoryPool& memory_pool_for_fully_expanded_components_maps, MemoryPool& memory_pool_for_component_replacements_maps,
     const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
@@ -678,7 +725,8 @@ void BindingNormalization::normalizeBindingsWithBindingCompression(
     SaveFullyExpandedComponentsWithNoArgs save_fully_expanded_components_with_no_args,
     SaveFullyExpandedComponentsWithArgs save_fully_expanded_components_with_args,
     SaveComponentReplacementsWithNoArgs save_component_replacements_with_no_args,
-    SaveComponentReplacementsWithArgs save_component_replacements_with_args) {
+    SaveComponentReplacementsWithArgs save_component_replacements_with_args,
+    std::vector<ComponentStorageEntry>& lazy_subcomponents, fruit::NormalizationStats& stats) {
 
   HashMapWithArenaAllocator<TypeId, ComponentStorageEntry> binding_data_map =
       createHashMapWithArenaAllocator<TypeId, ComponentStorageEntry>(20 /* capacity */, memory_pool);
@@ -694,6 +742,7 @@ void BindingNormalization::normalizeBindingsWithBindingCompression(
   normalizeBindings(
       std::move(toplevel_entries), fixed_size_allocator_data, memory_pool,
       memory_pool_for_fully_expanded_components_maps, memory_pool_for_component_replacements_maps, binding_data_map,
+      stats,
       [&compressed_bindings_map](ComponentStorageEntry entry) {
         BindingCompressionInfo& compression_info = compressed_bindings_map[entry.compressed_binding.c_type_id];
         compression_info.i_type_id = entry.type_id;
@@ -710,11 +759,18 @@ void BindingNormalization::normalizeBindingsWithBindingCompression(
       [](const LazyComponentWithArgs&) { return (ComponentStorageEntry*)nullptr; },
       [](ComponentStorageEntry*) { return false; }, [](ComponentStorageEntry*) { return false; },
       [](ComponentStorageEntry* p) { return *p; }, [](ComponentStorageEntry* p) { return *p; },
-      save_component_replacements_with_no_args, save_component_replacements_with_args);
+      save_component_replacements_with_no_args, save_component_replacements_with_args,
+      [&lazy_subcomponents](ComponentStorageEntry entry) { lazy_subcomponents.push_back(entry); });
 
+  Stopwatch stopwatch;
+  std::size_t num_bindings_before_compression = binding_data_map.size();
   bindings_vector = BindingNormalization::performBindingCompression(
       std::move(binding_data_map), std::move(compressed_bindings_map), memory_pool, multibindings_vector, exposed_types,
       save_compressed_binding_undo_info);
+  stats.binding_compression_ns += stopwatch.elapsedNs();
+  stats.num_compressed_bindings += num_bindings_before_compression - bindings_vector.size();
+  stats.num_bindings += bindings_vector.size();
+  stats.num_multibindings += multibindings_vector.size();
 
   addMultibindings(multibindings, fixed_size_allocator_data, multibindings_vector);
 }
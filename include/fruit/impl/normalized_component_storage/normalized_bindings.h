@@ -47,11 +47,31 @@ struct NormalizedBinding {
   explicit NormalizedBinding(ComponentStorageEntry entry);
 };
 
+/**
+ * Information on a NormalizedBinding that is not needed for injection and is only used for diagnostics. These are
+ * stored separately from the NormalizedBinding objects, to keep the nodes of the graph small.
+ */
+struct NormalizedBindingInfo {
+  // The dependencies of the binding, or nullptr for bindings to already-constructed objects (and for nodes that are
+  // only referenced by other nodes).
+  const BindingDeps* deps = nullptr;
+
+  // Whether space for the object is reserved in the injector's FixedSizeAllocator.
+  bool needs_allocation = false;
+
+  // Whether this is the binding for an interface, merged with the binding for its implementation class by binding
+  // compression.
+  bool is_compressed = false;
+};
+
 /** A single normalized multibinding. */
 struct NormalizedMultibinding {
 
   bool is_constructed;
 
+  // Whether space for this object is reserved in the injector's FixedSizeAllocator. Only used for diagnostics.
+  bool needs_allocation;
+
   union {
     // Valid iff is_constructed==true.
     ComponentStorageEntry::MultibindingForConstructedObject::object_ptr_t object;
@@ -75,6 +95,10 @@ struct NormalizedMultibindingSet {
   // A (casted) pointer to the std::vector<T*> of objects, or nullptr if the vector hasn't been constructed yet.
   // Can't be empty.
   std::shared_ptr<char> v;
+
+  // A (casted) pointer to the std::vector<fruit::MultibindingProvider<T>> for the objects, or nullptr if it hasn't been
+  // requested yet (see Injector::getMultibindingProviders()).
+  std::shared_ptr<char> providers;
 };
 
 } // namespace impl
@@ -30,9 +30,12 @@
 #include <fruit/impl/normalized_component_storage/normalized_bindings.h>
 #include <fruit/impl/util/hash_helpers.h>
 #include <fruit/impl/util/type_info.h>
+#include <fruit/injector_stats.h>
+#include <fruit/memory_usage.h>
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace fruit {
 namespace impl {
@@ -53,7 +56,6 @@ public:
   // A map from c_type_id to the corresponding CompressedBindingUndoInfo (if binding compression was performed for
   // c_type_id).
   using BindingCompressionInfoMap = HashMapWithArenaAllocator<TypeId, CompressedBindingUndoInfo>;
-  using BindingCompressionInfoMapAllocator = BindingCompressionInfoMap::allocator_type;
 
   using LazyComponentWithNoArgs = ComponentStorageEntry::LazyComponentWithNoArgs;
   using LazyComponentWithArgs = ComponentStorageEntry::LazyComponentWithArgs;
@@ -103,6 +105,9 @@ private:
   // For types that have a constructed object already, the corresponding node is stored as terminal node.
   SemistaticGraph<TypeId, NormalizedBinding> bindings;
 
+  // The NormalizedBindingInfo for each node of `bindings' (see SemistaticGraph::indexOf()).
+  std::vector<NormalizedBindingInfo> node_infos;
+
   // Maps the type index of a type T to the corresponding NormalizedMultibindingSet.
   std::unordered_map<TypeId, NormalizedMultibindingSet> multibindings;
 
@@ -123,8 +128,21 @@ private:
   LazyComponentWithNoArgsReplacementMap component_with_no_args_replacements;
   LazyComponentWithArgsReplacementMap component_with_args_replacements;
 
+  // The LAZY_SUBCOMPONENT entries (see PartialComponent::installLazily()), owned by this object. Each injector then
+  // expands them (separately) if needed.
+  std::vector<ComponentStorageEntry> lazy_subcomponents;
+
+  // Statistics on the construction of this object.
+  fruit::NormalizationStats normalization_stats;
+
+  // Constructs `bindings' (and node_infos) from the normalized bindings in `bindings_vector' and updates
+  // normalization_stats accordingly. compressed_type_ids are the interface types whose bindings were compressed.
+  void createGraph(std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& bindings_vector,
+                   const std::vector<TypeId, ArenaAllocator<TypeId>>& compressed_type_ids, MemoryPool& memory_pool);
+
   friend class InjectorStorage;
   friend class BindingNormalization;
+  friend class NormalizedComponentStorageHolder;
 
 public:
   using Graph = SemistaticGraph<TypeId, NormalizedBinding>;
@@ -158,6 +176,12 @@ public:
   // We don't use the default destructor because that will require the inclusion of
   // the Boost's hashmap header. We define this in the cpp file instead.
   ~NormalizedComponentStorage();
+
+  // Adds the memory used by this object to `memory_usage'.
+  void addMemoryUsage(fruit::MemoryUsage& memory_usage) const;
+
+  // Returns an estimate of the memory (in bytes) used by `multibindings', excluding the multibinding vectors.
+  static std::size_t getMultibindingsBytes(const std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings);
 };
 
 } // namespace impl
@@ -21,6 +21,8 @@
 #include <fruit/impl/data_structures/arena_allocator.h>
 #include <fruit/impl/data_structures/memory_pool.h>
 #include <fruit/impl/fruit_internal_forward_decls.h>
+#include <fruit/injector_stats.h>
+#include <fruit/memory_usage.h>
 #include <memory>
 
 namespace fruit {
@@ -63,6 +65,10 @@ public:
   // We don't use the default destructor because that would require the inclusion of
   // normalized_component_storage.h. We define this in the cpp file instead.
   ~NormalizedComponentStorageHolder();
+
+  const fruit::NormalizationStats& getNormalizationStats() const;
+
+  fruit::MemoryUsage getMemoryUsage() const;
 };
 
 } // namespace impl
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_OBJECT_POOL_DEFN_H
+#define FRUIT_OBJECT_POOL_DEFN_H
+
+// Redundant, but makes KDevelop happy.
+#include <fruit/object_pool.h>
+
+#include <fruit/impl/fruit_assert.h>
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace fruit {
+
+template <typename C>
+constexpr std::size_t ObjectPool<C>::default_max_size;
+
+template <typename C>
+inline ObjectPool<C>::Deleter::Deleter() noexcept : pool(nullptr) {}
+
+template <typename C>
+inline ObjectPool<C>::Deleter::Deleter(ObjectPool* pool) : pool(pool) {}
+
+template <typename C>
+inline void ObjectPool<C>::Deleter::operator()(C* p) const {
+  FruitAssert(pool != nullptr);
+  p->~C();
+  pool->deallocate(p);
+}
+
+template <typename C>
+inline ObjectPool<C>::ObjectPool(std::size_t max_size) : max_size(max_size) {
+  free_blocks.reserve(max_size);
+}
+
+template <typename C>
+inline ObjectPool<C>::~ObjectPool() {
+  FruitAssert(stats.num_live_objects == 0);
+  for (void* p : free_blocks) {
+    ::operator delete(p);
+  }
+}
+
+template <typename C>
+template <typename... Args>
+inline typename ObjectPool<C>::Ptr ObjectPool<C>::make(Args&&... args) {
+  void* p = allocate();
+  C* c;
+  try {
+    c = new (p) C(std::forward<Args>(args)...);
+  } catch (...) {
+    deallocate(p);
+    throw;
+  }
+  return Ptr(c, Deleter(this));
+}
+
+template <typename C>
+inline ObjectPoolStats ObjectPool<C>::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  ObjectPoolStats result = stats;
+  result.pool_size = free_blocks.size();
+  return result;
+}
+
+template <typename C>
+inline void* ObjectPool<C>::allocate() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!free_blocks.empty()) {
+      void* p = free_blocks.back();
+      free_blocks.pop_back();
+      ++stats.num_reuses;
+      ++stats.num_live_objects;
+      return p;
+    }
+  }
+  // The allocation is done without holding the lock.
+  void* p = ::operator new(sizeof(C));
+  std::lock_guard<std::mutex> lock(mutex);
+  ++stats.num_allocations;
+  ++stats.num_live_objects;
+  return p;
+}
+
+template <typename C>
+inline void ObjectPool<C>::deallocate(void* p) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    --stats.num_live_objects;
+    if (free_blocks.size() < max_size) {
+      free_blocks.push_back(p);
+      ++stats.num_returned_to_pool;
+      return;
+    }
+    ++stats.num_deallocations;
+  }
+  ::operator delete(p);
+}
+
+} // namespace fruit
+
+#endif // FRUIT_OBJECT_POOL_DEFN_H
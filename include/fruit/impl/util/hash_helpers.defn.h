@@ -35,15 +35,14 @@ inline HashSet<T> createHashSet(size_t capacity) {
 
 template <typename T>
 inline HashSetWithArenaAllocator<T> createHashSetWithArenaAllocator(size_t capacity, MemoryPool& memory_pool) {
-  return HashSetWithArenaAllocator<T>(capacity, std::hash<T>(), std::equal_to<T>(), ArenaAllocator<T>(memory_pool));
+  return HashSetWithArenaAllocator<T>(capacity, std::hash<T>(), std::equal_to<T>(), memory_pool);
 }
 
 template <typename T, typename Hasher, typename EqualityComparator>
 inline HashSetWithArenaAllocator<T, Hasher, EqualityComparator>
 createHashSetWithArenaAllocatorAndCustomFunctors(size_t capacity, MemoryPool& memory_pool, Hasher hasher,
                                                  EqualityComparator equality_comparator) {
-  return HashSetWithArenaAllocator<T, Hasher, EqualityComparator>(capacity, hasher, equality_comparator,
-                                                                  ArenaAllocator<T>(memory_pool));
+  return HashSetWithArenaAllocator<T, Hasher, EqualityComparator>(capacity, hasher, equality_comparator, memory_pool);
 }
 
 template <typename Key, typename Value>
@@ -67,8 +66,8 @@ template <typename Key, typename Value, typename Hasher, typename EqualityCompar
 inline HashMapWithArenaAllocator<Key, Value, Hasher, EqualityComparator>
 createHashMapWithArenaAllocatorAndCustomFunctors(size_t capacity, MemoryPool& memory_pool, Hasher hasher,
                                                  EqualityComparator equality_comparator) {
-  return HashMapWithArenaAllocator<Key, Value, Hasher, EqualityComparator>(
-      capacity, hasher, equality_comparator, ArenaAllocator<std::pair<const Key, Value>>(memory_pool));
+  return HashMapWithArenaAllocator<Key, Value, Hasher, EqualityComparator>(capacity, hasher, equality_comparator,
+                                                                          memory_pool);
 }
 
 } // namespace impl
@@ -17,7 +17,7 @@
 #ifndef FRUIT_HASH_HELPERS_H
 #define FRUIT_HASH_HELPERS_H
 
-#include <fruit/impl/data_structures/arena_allocator.h>
+#include <fruit/impl/data_structures/flat_hash_table.h>
 #include <fruit/impl/fruit-config.h>
 
 #if !IN_FRUIT_CPP_FILE
@@ -40,33 +40,28 @@ namespace impl {
 template <typename T, typename Hasher = std::hash<T>, typename EqualityComparator = std::equal_to<T>>
 using HashSet = boost::unordered_set<T, Hasher, EqualityComparator>;
 
-template <typename T, typename Hasher = std::hash<T>, typename EqualityComparator = std::equal_to<T>>
-using HashSetWithArenaAllocator = boost::unordered_set<T, Hasher, EqualityComparator, ArenaAllocator<T>>;
-
 template <typename Key, typename Value, typename Hasher = std::hash<Key>>
 using HashMap = boost::unordered_map<Key, Value, Hasher>;
 
-template <typename Key, typename Value, typename Hasher = std::hash<Key>,
-          typename EqualityComparator = std::equal_to<Key>>
-using HashMapWithArenaAllocator =
-    boost::unordered_map<Key, Value, Hasher, EqualityComparator, ArenaAllocator<std::pair<const Key, Value>>>;
-
 #else
 template <typename T, typename Hasher = std::hash<T>, typename EqualityComparator = std::equal_to<T>>
 using HashSet = std::unordered_set<T, Hasher, EqualityComparator>;
 
-template <typename T, typename Hasher = std::hash<T>, typename EqualityComparator = std::equal_to<T>>
-using HashSetWithArenaAllocator = std::unordered_set<T, Hasher, EqualityComparator, ArenaAllocator<T>>;
-
 template <typename Key, typename Value, typename Hasher = std::hash<Key>>
 using HashMap = std::unordered_map<Key, Value, Hasher>;
 
+#endif
+
+// The containers below are used during normalization, where most of the time is spent on lookups and insertions in
+// them. They are flat open-addressing tables whose memory comes from a MemoryPool (and is only reclaimed when the pool
+// is destroyed), so they don't depend on FRUIT_USES_BOOST.
+
+template <typename T, typename Hasher = std::hash<T>, typename EqualityComparator = std::equal_to<T>>
+using HashSetWithArenaAllocator = FlatHashSet<T, Hasher, EqualityComparator>;
+
 template <typename Key, typename Value, typename Hasher = std::hash<Key>,
           typename EqualityComparator = std::equal_to<Key>>
-using HashMapWithArenaAllocator =
-    std::unordered_map<Key, Value, Hasher, EqualityComparator, ArenaAllocator<std::pair<const Key, Value>>>;
-
-#endif
+using HashMapWithArenaAllocator = FlatHashMap<Key, Value, Hasher, EqualityComparator>;
 
 template <typename T>
 HashSet<T> createHashSet();
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_PARALLEL_TASK_GRAPH_H
+#define FRUIT_PARALLEL_TASK_GRAPH_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * A set of tasks with ordering constraints between them, that can be run by multiple threads. Each task is started
+ * only once all the tasks that must run before it have completed, so the total time is bounded by the longest chain of
+ * tasks (if there are enough threads) rather than by the sum of all tasks.
+ *
+ * Used by injectors to destroy independent objects in parallel (see Injector::setTeardownThreads()).
+ */
+class ParallelTaskGraph {
+public:
+  // Creates a graph with the tasks 0, ..., num_tasks-1 and no ordering constraints.
+  explicit ParallelTaskGraph(std::size_t num_tasks);
+
+  // Adds the constraint that the task `before' must complete before the task `after' starts.
+  void addOrdering(std::size_t before, std::size_t after);
+
+  // Runs the tasks using `num_threads' threads (including the current one), calling `run_task' with the index of each
+  // task. `run_task' must not throw.
+  // Returns the tasks that were not run because they're part of a loop of ordering constraints (or they must run after
+  // a task in such a loop), in increasing order.
+  std::vector<std::size_t> run(std::size_t num_threads, const std::function<void(std::size_t)>& run_task);
+
+private:
+  // successors[i] are the tasks that must run after task i.
+  std::vector<std::vector<std::size_t>> successors;
+
+  // The number of constraints of the form "x must run before i" for each task i.
+  std::vector<std::size_t> num_predecessors;
+};
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_PARALLEL_TASK_GRAPH_H
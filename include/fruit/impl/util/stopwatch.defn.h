@@ -0,0 +1,41 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_STOPWATCH_DEFN_H
+#define FRUIT_STOPWATCH_DEFN_H
+
+#include <fruit/impl/util/stopwatch.h>
+
+namespace fruit {
+namespace impl {
+
+inline Stopwatch::Stopwatch() : start(std::chrono::steady_clock::now()) {}
+
+inline std::uint64_t Stopwatch::elapsedNs() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline std::uint64_t Stopwatch::restart() {
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  std::uint64_t result = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count();
+  start = now;
+  return result;
+}
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_STOPWATCH_DEFN_H
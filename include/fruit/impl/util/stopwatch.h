@@ -0,0 +1,49 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_STOPWATCH_H
+#define FRUIT_STOPWATCH_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * Measures the time elapsed since its construction (or since the last call to restart()).
+ * Used to compute the times in fruit::NormalizationStats and fruit::InjectorStats.
+ */
+class Stopwatch {
+private:
+  std::chrono::steady_clock::time_point start;
+
+public:
+  Stopwatch();
+
+  // Returns the number of nanoseconds elapsed since the start.
+  std::uint64_t elapsedNs() const;
+
+  // Returns the number of nanoseconds elapsed since the start, and then restarts the measurement.
+  std::uint64_t restart();
+};
+
+} // namespace impl
+} // namespace fruit
+
+#include <fruit/impl/util/stopwatch.defn.h>
+
+#endif // FRUIT_STOPWATCH_H
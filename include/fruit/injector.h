@@ -21,10 +21,15 @@
 #include <fruit/impl/injection_errors.h>
 
 #include <fruit/component.h>
+#include <fruit/keyed_multibindings.h>
+#include <fruit/multibinding_provider.h>
 #include <fruit/normalized_component.h>
 #include <fruit/provider.h>
+#include <fruit/teardown_policy.h>
 #include <fruit/impl/meta_operation_wrappers.h>
 
+#include <future>
+
 namespace fruit {
 
 /**
@@ -125,6 +130,40 @@ public:
   Injector(NormalizedComponent<NormalizedComponentParams...>&& normalized_component,
            Component<ComponentParams...> (*)(FormalArgs...), Args&&... args) = delete;
 
+  /**
+   * This creates a child injector of `parent', that provides the types provided by the parent and one type for each
+   * instance in `instances' (bound to its own type, like bindInstance() does; const instances are bound as const).
+   * P... can be any subset of those types.
+   *
+   * The child doesn't normalize any component and it doesn't construct any object: when a type provided by the parent
+   * is requested, the child returns the parent's object for it (constructing it in the parent if needed), so objects
+   * like singletons are shared between the parent and all its children. The child only stores the pointers to the
+   * instances and to the parent's objects, so constructing it costs little more than recording those pointers.
+   * Multibindings are also looked up in the parent.
+   *
+   * The instances must be of types that the parent doesn't provide. Objects that depend on them can't be constructed by
+   * the child; the parent can provide factories for those instead (see registerFactory()), that can be called with
+   * the instances.
+   *
+   * `parent' and the instances must remain valid during the lifetime of the child injector.
+   *
+   * Example usage:
+   *
+   * // At startup (e.g. inside main()).
+   * Injector<RequestDispatcher, HandlerFactory> parent(getServerComponent);
+   *
+   * ...
+   * for (...) {
+   *   // For each request.
+   *   Request request = ...;
+   *
+   *   Injector<HandlerFactory, Request> injector(parent, request);
+   *   ...
+   * }
+   */
+  template <typename... ParentP, typename... Instances>
+  Injector(Injector<ParentP...>& parent, Instances&... instances);
+
   /**
    * Returns an instance of the specified type. For any class C in the Injector's template parameters, the following
    * variations are allowed:
@@ -202,6 +241,131 @@ public:
   template <typename T>
   const std::vector<fruit::impl::RemoveAnnotations<T>*>& getMultibindings();
 
+  /**
+   * Similar to getMultibindings(), but this returns a provider for each multibinding for T (in the same order) instead
+   * of the objects themselves, so each object is only constructed (with the objects it depends on) when get() is first
+   * called on its provider. This is useful when there are many multibindings (e.g. a registry of plugins) but only a
+   * few of them are used.
+   *
+   * Calling this doesn't construct any object. Once an object has been constructed, its provider returns it without
+   * locking the injector.
+   *
+   * With a non-annotated parameter T, this returns a const std::vector<fruit::MultibindingProvider<T>>&.
+   * With an annotated parameter AnnotatedT=Annotated<Annotation, T>, this returns a
+   * const std::vector<fruit::MultibindingProvider<T>>&.
+   */
+  template <typename T>
+  const std::vector<fruit::MultibindingProvider<fruit::impl::RemoveAnnotations<T>>>& getMultibindingProviders();
+
+  /**
+   * Returns the keyed multibindings for T with keys of type K (added with PartialComponent::addKeyedMultibinding()), as
+   * a map from each key to the corresponding object. Looking up a key takes constant time, and each object is only
+   * constructed (with the objects it depends on) when it's first looked up.
+   *
+   * The map is built the first time this is called (without constructing any object), and then it's reused: the
+   * returned reference is valid until the injector is destroyed.
+   *
+   * With a non-annotated parameter T, this returns a const fruit::KeyedMultibindings<K, T>&.
+   * With an annotated parameter AnnotatedT=Annotated<Annotation, T>, this returns a
+   * const fruit::KeyedMultibindings<K, T>&.
+   */
+  template <typename K, typename T>
+  const fruit::KeyedMultibindings<K, fruit::impl::RemoveAnnotations<T>>& getKeyedMultibindings();
+
+  /**
+   * Constructs the objects for the types T... (and the objects they depend on) in a background thread, so that later
+   * calls to get() for these types (e.g. through a Provider) don't have to.
+   * Each T can be any type that can be used with get().
+   *
+   * The objects are constructed one at a time, so a get() in another thread never waits for more than the construction
+   * in progress (if it needs that object, it's then constructed only once). Dependencies injected as a Provider are
+   * constructed too.
+   *
+   * The returned future becomes ready when all these objects have been constructed; its get() method rethrows any
+   * exception thrown while constructing them. It's not necessary to wait for it: the injector's destructor waits for
+   * any prefetch in progress.
+   */
+  template <typename... T>
+  std::shared_future<void> prefetch();
+
+  /**
+   * Similar to prefetch(), but this constructs the objects for all the types exposed by this injector (i.e. P...) and
+   * all multibindings, as eagerlyInjectAll() does (but in a background thread).
+   */
+  std::shared_future<void> prefetchAll();
+
+  /**
+   * Returns a breakdown of the time spent to construct this injector (after the component function was called), see
+   * InjectorStats for details.
+   */
+  const InjectorStats& getStats() const;
+
+  /**
+   * Starts (or, if enabled==false, stops) counting the calls to get() and getMultibindings() on this injector, and the
+   * time they spend waiting for the injector's lock. See LookupStats for details.
+   *
+   * When lookup counting is disabled (the default), the only overhead is an atomic load on each of those calls.
+   */
+  void setLookupCounting(bool enabled);
+
+  /**
+   * Returns a snapshot of the counters collected while lookup counting was enabled (see setLookupCounting()).
+   */
+  LookupStats getLookupStats();
+
+  /**
+   * Resets the counters returned by getLookupStats().
+   */
+  void clearLookupStats();
+
+  /**
+   * Returns a breakdown of the memory used by this injector, see MemoryUsage for details.
+   * This is O(n) (where n is the number of bindings), so it shouldn't be called in performance-sensitive code.
+   */
+  MemoryUsage getMemoryUsage();
+
+  /**
+   * Returns a snapshot of the dependency graph of this injector (see InjectorGraph), e.g. to find out which objects are
+   * the most expensive to construct.
+   * Construction times are only available for the objects constructed while a ConstructionTracer was set (see
+   * setConstructionTracer()).
+   * This is O(n) (where n is the number of bindings), so it shouldn't be called in performance-sensitive code.
+   */
+  InjectorGraph getGraph();
+
+  /**
+   * Records the construction of the objects created by this injector from now on in `tracer' (see ConstructionTracer
+   * for details). Call this with nullptr to stop tracing.
+   *
+   * The tracer must outlive this injector, or be replaced (e.g. with nullptr) before it's destroyed.
+   */
+  void setConstructionTracer(fruit::ConstructionTracer* tracer);
+
+  /**
+   * Sets the policy that decides which of the objects owned by this injector are destroyed when the injector is
+   * destroyed (see TeardownPolicy for details). By default all of them are destroyed.
+   *
+   * This is meant for injectors that live until the process exits, to skip the destruction of objects that only hold
+   * memory. The objects that are still destroyed are destroyed in reverse order of construction, as usual.
+   */
+  void setTeardownPolicy(fruit::TeardownPolicy policy);
+
+  /**
+   * Sets the number of threads used to destroy the objects owned by this injector when it's destroyed (by default 1).
+   * If this is 0, std::thread::hardware_concurrency() threads are used.
+   *
+   * With more than 1 thread, the objects that don't depend on each other are destroyed in parallel, using the
+   * dependency graph of the injector: each object is still destroyed before the objects that it depends on. So the time
+   * needed to destroy the injector is bounded by the longest chain of dependencies rather than by the sum of the
+   * destructors' times. This is useful when some destructors are slow (e.g. if they flush buffers or join worker
+   * threads).
+   *
+   * Note that the dependencies of an object are the ones declared in its binding. If an object uses other objects of
+   * the injector in its destructor (e.g. objects passed to it after its construction), those might be destroyed first.
+   * Multibindings are destroyed before all other objects, since their dependencies are not tracked.
+   */
+  void setTeardownThreads(std::size_t num_threads);
+
   /**
    * This method is deprecated since Fruit injectors can now be accessed concurrently by multiple threads. This will be
    * removed in a future Fruit release.
@@ -241,6 +405,9 @@ private:
 
   friend struct fruit::impl::InjectorAccessorForTests;
 
+  template <typename... OtherP>
+  friend class Injector;
+
   std::unique_ptr<fruit::impl::InjectorStorage> storage;
 };
 
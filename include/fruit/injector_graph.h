@@ -0,0 +1,113 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_INJECTOR_GRAPH_H
+#define FRUIT_INJECTOR_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace fruit {
+
+/**
+ * A snapshot of the dependency graph of an injector, with one node for each type bound in the injector. Multibindings
+ * are not included.
+ *
+ * Example usage:
+ *
+ * fruit::ConstructionTracer tracer;
+ * fruit::Injector<Foo> injector(getFooComponent);
+ * injector.setConstructionTracer(&tracer);
+ * injector.get<Foo*>();
+ * fruit::InjectorGraph graph = injector.getGraph();
+ * std::ofstream out("graph.dot");
+ * graph.writeDot(out);
+ *
+ * See Injector::getGraph().
+ */
+struct InjectorGraph {
+  enum class BindingKind {
+    // A binding for an object that was constructed before the injector (e.g. with bindInstance()).
+    INSTANCE,
+
+    // A binding for an object constructed by the injector in its own memory (e.g. with a constructor, or a provider
+    // that returns the object by value).
+    CONSTRUCTED_IN_INJECTOR,
+
+    // A binding for an object constructed by the injector, but not in its own memory (e.g. a provider that returns a
+    // pointer) or that is just another binding (e.g. with bind<Interface, Impl>()).
+    CONSTRUCTED_OUTSIDE_INJECTOR,
+
+    // A type provided by a component installed with installLazily().
+    LAZY_SUBCOMPONENT,
+  };
+
+  struct Node {
+    // The name of the bound type.
+    std::string type_name;
+
+    BindingKind kind;
+
+    // True if the binding for this type (an interface) was merged with the binding for its implementation class, that
+    // therefore doesn't have a node in the graph.
+    bool is_compressed;
+
+    // True if the object was already constructed (or was never constructed by the injector, for INSTANCE nodes).
+    bool is_constructed;
+
+    // True if the time spent to construct the object is known, i.e. if it was constructed while the injector had a
+    // ConstructionTracer set (see Injector::setConstructionTracer()).
+    bool has_construction_time;
+
+    // The time spent to construct the object (excluding the time spent to construct its dependencies), in nanoseconds.
+    // Only meaningful if has_construction_time is true.
+    std::uint64_t construction_ns;
+
+    // The nodes for the dependencies of this type, as indexes in `nodes'.
+    std::vector<std::size_t> dependencies;
+  };
+
+  std::vector<Node> nodes;
+
+  /**
+   * Returns the critical path of the construction of the objects in the injector, as indexes in `nodes': this is the
+   * chain of dependencies (each node depends on the next one) that took the longest to construct, summing the
+   * construction_ns of its nodes. This is empty if no construction times are known.
+   *
+   * Making one of these objects cheaper to construct (or making it lazy, e.g. injecting a Provider instead of the
+   * object) shortens the critical path.
+   */
+  std::vector<std::size_t> getCriticalPath() const;
+
+  /**
+   * Writes the graph in the DOT format used by Graphviz. Constructed nodes are filled, compressed ones are dashed and
+   * the critical path is drawn in red.
+   */
+  void writeDot(std::ostream& os) const;
+
+  /**
+   * Writes the graph as a JSON object with the nodes (with the same fields as Node), the critical path and its total
+   * construction time.
+   */
+  void writeJson(std::ostream& os) const;
+};
+
+} // namespace fruit
+
+#endif // FRUIT_INJECTOR_GRAPH_H
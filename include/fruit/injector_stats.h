@@ -0,0 +1,154 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_INJECTOR_STATS_H
+#define FRUIT_INJECTOR_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fruit {
+
+/**
+ * A breakdown of the time spent by Fruit to turn a component into the data structures used for injection (this is
+ * called "normalization"), with the amount of data processed in each phase.
+ *
+ * All times are in nanoseconds.
+ *
+ * See NormalizedComponent::getNormalizationStats() and Injector::getStats().
+ */
+struct NormalizationStats {
+  // The total time spent in the normalization, including the phases below.
+  std::uint64_t total_ns = 0;
+
+  // Expansion of the component into bindings: this calls the functions of the installed components, handles component
+  // replacements and removes duplicate bindings/components.
+  std::uint64_t component_expansion_ns = 0;
+
+  // The number of entries (bindings, multibindings, installed components, ...) processed during the expansion.
+  std::size_t num_entries_processed = 0;
+
+  // The number of components whose functions were called during the expansion.
+  std::size_t num_components_expanded = 0;
+
+  // The number of components that were skipped during the expansion because they were already expanded (i.e. they
+  // were installed multiple times).
+  std::size_t num_duplicate_components = 0;
+
+  // The number of bindings that were skipped during the expansion because an identical binding was already present.
+  std::size_t num_duplicate_bindings = 0;
+
+  // Binding compression, i.e. merging an interface binding with the binding of its implementation class when nothing
+  // else depends on the latter.
+  std::uint64_t binding_compression_ns = 0;
+
+  // The number of bindings removed by binding compression.
+  std::size_t num_compressed_bindings = 0;
+
+  // The number of binding compressions performed in a NormalizedComponent that had to be undone for an injector,
+  // because the additional component depends on the implementation class.
+  std::size_t num_undone_binding_compressions = 0;
+
+  // The number of bindings and multibindings after the expansion and binding compression.
+  std::size_t num_bindings = 0;
+  std::size_t num_multibindings = 0;
+
+  // Construction of the dependency graph (including the hash map used to look up types).
+  std::uint64_t graph_construction_ns = 0;
+
+  // The number of nodes in the dependency graph.
+  std::size_t num_graph_nodes = 0;
+
+  // The number of hash functions that were discarded (because of too many collisions) before finding a suitable one for
+  // the graph's hash map.
+  std::size_t num_hash_function_retries = 0;
+
+  // The memory that will be reserved for the objects constructed by an injector, in bytes.
+  std::size_t allocator_reserved_bytes = 0;
+
+  // The number of objects that might need to be destroyed when the injector is destroyed.
+  std::size_t allocator_num_types_to_destroy = 0;
+};
+
+/**
+ * A breakdown of the time spent by Fruit to construct an injector.
+ *
+ * All times are in nanoseconds.
+ *
+ * See Injector::getStats().
+ */
+struct InjectorStats {
+  // The total time spent in the constructor of the injector, after the component was created.
+  std::uint64_t total_ns = 0;
+
+  // The normalization of the component. For injectors created from a NormalizedComponent, this only covers the
+  // component passed to the injector's constructor, see NormalizedComponent::getNormalizationStats() for the rest.
+  NormalizationStats normalization;
+};
+
+/**
+ * Counters on the lookups done through an injector (Injector::get() and Injector::getMultibindings()) and on the time
+ * spent waiting for the injector's lock, collected while lookup counting is enabled (see
+ * Injector::setLookupCounting()).
+ *
+ * Types that are looked up many times are good candidates to be injected in constructors (or to be looked up once
+ * through a Provider that is then kept) instead. A large mutex_wait_ns means that the injector is accessed
+ * concurrently by multiple threads, and that its lock might limit their throughput.
+ *
+ * All times are in nanoseconds.
+ */
+struct LookupStats {
+  struct TypeLookups {
+    // The name of the looked up type.
+    std::string type_name;
+
+    // The number of calls to Injector::get() for this type.
+    // All the variants of a type (e.g. get<T&>(), get<T*>() and get<Provider<T>>()) are counted together.
+    std::size_t num_gets = 0;
+
+    // The number of lookups of this type that don't go through Injector::get() and skip its compile-time checks. These
+    // are only done by Fruit's own tests, so this is 0 in user code.
+    std::size_t num_unsafe_gets = 0;
+
+    // The number of calls to Injector::getMultibindings() for this type.
+    std::size_t num_multibinding_gets = 0;
+
+    // The number of lookups of this type that happened after the first one.
+    std::size_t getNumRepeatedLookups() const {
+      std::size_t total = num_gets + num_unsafe_gets + num_multibinding_gets;
+      return total == 0 ? 0 : total - 1;
+    }
+  };
+
+  // The looked up types, sorted by number of lookups (the most looked up first).
+  std::vector<TypeLookups> types;
+
+  // The total number of lookups.
+  std::size_t num_lookups = 0;
+
+  // The number of lookups that had to wait because another thread was holding the injector's lock.
+  std::size_t num_contended_lookups = 0;
+
+  // The total and maximum time spent waiting for the injector's lock in a single lookup.
+  std::uint64_t mutex_wait_ns = 0;
+  std::uint64_t max_mutex_wait_ns = 0;
+};
+
+} // namespace fruit
+
+#endif // FRUIT_INJECTOR_STATS_H
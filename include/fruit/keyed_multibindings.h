@@ -0,0 +1,100 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_KEYED_MULTIBINDINGS_H
+#define FRUIT_KEYED_MULTIBINDINGS_H
+
+#include <fruit/fruit_forward_decls.h>
+#include <fruit/impl/data_structures/flat_hash_table.h>
+#include <fruit/impl/data_structures/memory_pool.h>
+#include <fruit/impl/fruit_internal_forward_decls.h>
+#include <fruit/impl/keyed_multibinding_element.h>
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace fruit {
+
+/**
+ * An immutable map from the keys of the keyed multibindings for C with keys of type K (added with
+ * PartialComponent::addKeyedMultibinding()) to the corresponding objects. See Injector::getKeyedMultibindings().
+ *
+ * The keys are stored in a flat hash table, so looking up a key takes constant time. Each object is constructed (with
+ * the objects it depends on) only when it's first requested; after that get() returns it without locking the injector,
+ * so this can be used concurrently by multiple threads.
+ */
+template <typename K, typename C>
+class KeyedMultibindings {
+public:
+  KeyedMultibindings(const KeyedMultibindings&) = delete;
+  KeyedMultibindings& operator=(const KeyedMultibindings&) = delete;
+
+  /**
+   * Returns the object bound to `key', constructing it if it wasn't constructed yet. Returns nullptr if there's no
+   * keyed multibinding with this key.
+   */
+  C* get(const K& key) const;
+
+  /**
+   * Returns true if there's a keyed multibinding with this key. This never constructs any object.
+   */
+  bool contains(const K& key) const;
+
+  /**
+   * Returns the number of keys.
+   */
+  std::size_t size() const;
+
+  /**
+   * Returns all the keys, in an unspecified order.
+   */
+  std::vector<K> getKeys() const;
+
+private:
+  using Element = fruit::impl::KeyedMultibindingElement<K, C>;
+
+  struct Slot {
+    const Element* element;
+
+    // The object, or nullptr if it wasn't requested from this map yet.
+    mutable std::atomic<C*> object;
+  };
+
+  fruit::impl::InjectorStorage* storage;
+
+  // A Slot for each key, in the order of the keyed multibindings.
+  std::unique_ptr<Slot[]> slots;
+  std::size_t num_slots;
+
+  fruit::impl::MemoryPool memory_pool;
+
+  // Maps each key to its Slot. This must be declared after memory_pool, that it uses.
+  fruit::impl::FlatHashMap<K, Slot*, std::hash<K>, std::equal_to<K>> slots_by_key;
+
+  // `elements' can contain duplicates, but if two elements have the same key they must be the same element.
+  KeyedMultibindings(fruit::impl::InjectorStorage* storage, const std::vector<const Element*>& elements);
+
+  friend class fruit::impl::InjectorStorage;
+};
+
+} // namespace fruit
+
+#include <fruit/impl/keyed_multibindings.defn.h>
+
+#endif // FRUIT_KEYED_MULTIBINDINGS_H
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_MEMORY_USAGE_H
+#define FRUIT_MEMORY_USAGE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace fruit {
+
+/**
+ * A breakdown of the memory used by Fruit's own data structures in an injector or in a NormalizedComponent.
+ * This doesn't include the memory used by the injected objects, except for the space reserved for them in the
+ * injector.
+ *
+ * All sizes are in bytes.
+ *
+ * See NormalizedComponent::getMemoryUsage() and Injector::getMemoryUsage().
+ */
+struct MemoryUsage {
+  // The nodes and the edges of the dependency graph.
+  std::size_t graph_nodes_bytes = 0;
+  std::size_t graph_edges_bytes = 0;
+
+  // The hash map used to find the node of a type in the dependency graph: its lookup table and its values.
+  std::size_t graph_lookup_table_bytes = 0;
+  std::size_t graph_values_bytes = 0;
+
+  // The multibindings, excluding the vectors returned by getMultibindings().
+  std::size_t multibindings_bytes = 0;
+
+  // The memory retained by a NormalizedComponent for the data needed to create injectors from it (e.g. to undo binding
+  // compressions). This is always 0 for injectors, unless they were created directly from a Component.
+  std::size_t memory_pool_bytes = 0;
+
+  // The memory reserved by an injector for the objects that it might need to construct, and how much of that has been
+  // used so far (the rest is used for objects that haven't been injected yet, if any). These are always 0 for a
+  // NormalizedComponent.
+  std::size_t allocator_reserved_bytes = 0;
+  std::size_t allocator_used_bytes = 0;
+
+  // The list of the objects that the injector will destroy when it's destroyed.
+  std::size_t allocator_destruction_list_bytes = 0;
+
+  // The memory used by an injector for the objects returned by the factories bound with registerArenaFactory(). Always
+  // 0 for a NormalizedComponent.
+  std::size_t factory_arena_bytes = 0;
+
+  // The types (and multibinding types) that have some space reserved in the injector but that haven't been constructed
+  // yet, in an unspecified order. Multibinding types are listed once for each multibinding that wasn't constructed.
+  // Always empty for a NormalizedComponent.
+  std::vector<std::string> unconstructed_types;
+
+  // Returns the sum of all the sizes above, except allocator_used_bytes (that is part of allocator_reserved_bytes).
+  std::size_t getTotalBytes() const {
+    return graph_nodes_bytes + graph_edges_bytes + graph_lookup_table_bytes + graph_values_bytes + multibindings_bytes +
+           memory_pool_bytes + allocator_reserved_bytes + allocator_destruction_list_bytes + factory_arena_bytes;
+  }
+};
+
+} // namespace fruit
+
+#endif // FRUIT_MEMORY_USAGE_H
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_MULTIBINDING_PROVIDER_H
+#define FRUIT_MULTIBINDING_PROVIDER_H
+
+#include <fruit/fruit_forward_decls.h>
+#include <fruit/impl/fruit_internal_forward_decls.h>
+#include <fruit/impl/util/type_info.h>
+
+#include <atomic>
+
+namespace fruit {
+
+/**
+ * A MultibindingProvider<C> gives access to a single object bound with a multibinding for C, constructing it (and the
+ * objects it depends on) only when it's first requested. See Injector::getMultibindingProviders().
+ *
+ * Once the object has been constructed, get() returns it without locking the injector, so this can be used
+ * concurrently by multiple threads.
+ *
+ * This is cheap to copy, but the copies don't share the cached pointer to the object: a copy made before the object was
+ * constructed will lock the injector (once) the first time get() is called on it.
+ */
+template <typename C>
+class MultibindingProvider {
+public:
+  MultibindingProvider(const MultibindingProvider& other);
+  MultibindingProvider& operator=(const MultibindingProvider& other);
+
+  /**
+   * Returns the object, constructing it if it wasn't constructed yet (by this provider or by a call to
+   * Injector::getMultibindings()).
+   */
+  C* get() const;
+
+  /**
+   * Returns true if get() can return the object without locking the injector.
+   */
+  bool isConstructed() const;
+
+  C& operator*() const;
+  C* operator->() const;
+
+private:
+  fruit::impl::InjectorStorage* storage;
+  fruit::impl::TypeId type;
+  fruit::impl::NormalizedMultibinding* multibinding;
+
+  // The object, or nullptr if this provider hasn't seen it constructed yet.
+  mutable std::atomic<C*> object;
+
+  MultibindingProvider(fruit::impl::InjectorStorage* storage, fruit::impl::TypeId type,
+                       fruit::impl::NormalizedMultibinding* multibinding, C* object);
+
+  friend class fruit::impl::InjectorStorage;
+};
+
+} // namespace fruit
+
+#include <fruit/impl/multibinding_provider.defn.h>
+
+#endif // FRUIT_MULTIBINDING_PROVIDER_H
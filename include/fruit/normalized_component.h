@@ -24,6 +24,8 @@
 #include <fruit/impl/fruit_internal_forward_decls.h>
 #include <fruit/impl/meta/component.h>
 #include <fruit/impl/normalized_component_storage/normalized_component_storage_holder.h>
+#include <fruit/injector_stats.h>
+#include <fruit/memory_usage.h>
 #include <memory>
 
 namespace fruit {
@@ -119,6 +121,19 @@ public:
   NormalizedComponent& operator=(NormalizedComponent&&) = delete;
   NormalizedComponent& operator=(const NormalizedComponent&) = delete;
 
+  /**
+   * Returns a breakdown of the time spent to construct this NormalizedComponent (after the component function was
+   * called), see NormalizationStats for details.
+   */
+  const NormalizationStats& getNormalizationStats() const;
+
+  /**
+   * Returns a breakdown of the memory used by this NormalizedComponent, see MemoryUsage for details.
+   * This is O(n) (where n is the number of multibinding types), so it shouldn't be called in performance-sensitive
+   * code.
+   */
+  MemoryUsage getMemoryUsage() const;
+
 private:
   NormalizedComponent(fruit::impl::ComponentStorage&& storage, fruit::impl::MemoryPool memory_pool);
 
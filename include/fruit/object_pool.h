@@ -0,0 +1,142 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_OBJECT_POOL_H
+#define FRUIT_OBJECT_POOL_H
+
+#include <fruit/fruit_forward_decls.h>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace fruit {
+
+/**
+ * Counters on the objects constructed through an ObjectPool. See ObjectPool::getStats().
+ */
+struct ObjectPoolStats {
+  // The number of objects constructed in newly-allocated memory.
+  std::size_t num_allocations = 0;
+
+  // The number of objects constructed in memory taken from the pool (i.e. with no allocation).
+  std::size_t num_reuses = 0;
+
+  // The number of destroyed objects whose memory was returned to the pool.
+  std::size_t num_returned_to_pool = 0;
+
+  // The number of destroyed objects whose memory was deallocated because the pool was full.
+  std::size_t num_deallocations = 0;
+
+  // The number of objects currently constructed through the pool and not yet destroyed.
+  std::size_t num_live_objects = 0;
+
+  // The number of unused memory blocks currently in the pool.
+  std::size_t pool_size = 0;
+};
+
+/**
+ * An ObjectPool<C> constructs instances of C reusing the memory of the instances previously destroyed, so that objects
+ * that are created and destroyed at a high rate don't need an allocation (and a deallocation) each.
+ *
+ * It's mostly meant to be used through PartialComponent::registerPooledFactory(), that binds a factory of
+ * fruit::Pooled<C> objects using the ObjectPool<C> in the injector, but it can also be used directly.
+ *
+ * The pool keeps at most `max_size` unused blocks of memory; when an object is destroyed and the pool is full, its
+ * memory is deallocated. All the objects constructed through a pool must be destroyed before the pool itself (for a
+ * pool in an injector, before the injector).
+ *
+ * An ObjectPool can be used concurrently by multiple threads.
+ *
+ * C must not be over-aligned (i.e. alignof(C) must be at most alignof(std::max_align_t)), since the memory blocks are
+ * allocated with ::operator new.
+ */
+template <typename C>
+class ObjectPool {
+  static_assert(alignof(C) <= alignof(std::max_align_t),
+                "fruit::ObjectPool doesn't support over-aligned types.");
+
+public:
+  /**
+   * The deleter of the pointers returned by make(), it destroys the object and returns its memory to the pool.
+   * A default-constructed Deleter has no pool, it's only meant for empty pointers (e.g. a default-constructed Ptr).
+   */
+  class Deleter {
+  public:
+    Deleter() noexcept;
+
+    void operator()(C* p) const;
+
+  private:
+    // This is nullptr for a default-constructed Deleter.
+    ObjectPool* pool;
+
+    explicit Deleter(ObjectPool* pool);
+
+    friend class ObjectPool;
+  };
+
+  using Ptr = std::unique_ptr<C, Deleter>;
+
+  // The maximum number of unused blocks kept by an ObjectPool constructed by an injector. To use a different
+  // value, bind ObjectPool<C> explicitly, e.g. with:
+  // .registerProvider([]() { return new fruit::ObjectPool<C>(1024); })
+  static constexpr std::size_t default_max_size = 64;
+
+  using Inject = ObjectPool();
+
+  explicit ObjectPool(std::size_t max_size = default_max_size);
+
+  ObjectPool(const ObjectPool&) = delete;
+  ObjectPool& operator=(const ObjectPool&) = delete;
+
+  ~ObjectPool();
+
+  /**
+   * Constructs a C with the specified arguments, in memory taken from the pool if possible.
+   */
+  template <typename... Args>
+  Ptr make(Args&&... args);
+
+  ObjectPoolStats getStats() const;
+
+private:
+  std::size_t max_size;
+
+  // Protects the fields below.
+  mutable std::mutex mutex;
+
+  // The unused blocks of memory. This has capacity max_size, so returning a block to the pool never allocates.
+  std::vector<void*> free_blocks;
+
+  ObjectPoolStats stats;
+
+  void* allocate();
+  void deallocate(void* p);
+};
+
+/**
+ * The type of the objects returned by the factories bound with PartialComponent::registerPooledFactory().
+ */
+template <typename C>
+using Pooled = typename ObjectPool<C>::Ptr;
+
+} // namespace fruit
+
+#include <fruit/impl/object_pool.defn.h>
+
+#endif // FRUIT_OBJECT_POOL_H
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_TEARDOWN_POLICY_H
+#define FRUIT_TEARDOWN_POLICY_H
+
+#include <type_traits>
+
+namespace fruit {
+
+/**
+ * Controls which of the objects owned by an injector are destroyed when the injector is destroyed.
+ * See Injector::setTeardownPolicy().
+ *
+ * The objects that are destroyed are always destroyed in reverse order of construction (so each object is destroyed
+ * before the objects that it depends on), the others are just leaked. This is useful to speed up the shutdown of a
+ * process, for injectors that would otherwise be destroyed right before the process exits: there's no point in
+ * destroying objects whose only resource is memory.
+ */
+enum class TeardownPolicy {
+  // All objects are destroyed. This is the default.
+  DESTROY_ALL,
+
+  // Objects of types C such that LeakOnExit<C>::value is true are not destroyed, all the others are.
+  LEAK_MARKED_TYPES,
+
+  // Only objects of types C such that HoldsExternalResources<C>::value is true are destroyed.
+  LEAK_ALL,
+};
+
+/**
+ * Specialize this (inheriting from std::true_type) to mark C as a type whose objects only hold memory, so that they are
+ * not destroyed by injectors with the TeardownPolicy::LEAK_MARKED_TYPES policy. For example:
+ *
+ * namespace fruit {
+ * template <>
+ * struct LeakOnExit<MyCache> : std::true_type {};
+ * }
+ *
+ * This has no effect on injectors with the default TeardownPolicy::DESTROY_ALL policy.
+ */
+template <typename C>
+struct LeakOnExit : std::false_type {};
+
+/**
+ * Specialize this (inheriting from std::true_type) to mark C as a type whose objects hold resources that must be
+ * released even at process exit (e.g. buffered files that must be flushed), so that they are destroyed even by
+ * injectors with the TeardownPolicy::LEAK_ALL policy.
+ *
+ * If a type is marked with both LeakOnExit and HoldsExternalResources, HoldsExternalResources takes precedence.
+ */
+template <typename C>
+struct HoldsExternalResources : std::false_type {};
+
+} // namespace fruit
+
+#endif // FRUIT_TEARDOWN_POLICY_H
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define IN_FRUIT_CPP_FILE 1
+
+#include <fruit/impl/component_storage/binding_deps.h>
+#include <fruit/impl/util/hash_codes.h>
+#include <fruit/impl/util/hash_helpers.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace fruit::impl;
+
+namespace {
+
+struct HashBindingDeps {
+  std::size_t operator()(const BindingDeps* x) const {
+    std::size_t result = x->num_deps;
+    for (std::size_t i = 0; i < x->num_deps; ++i) {
+      result = combineHashes(result, std::hash<TypeId>()(x->deps[i]));
+    }
+    return result;
+  }
+};
+
+struct BindingDepsEqualTo {
+  bool operator()(const BindingDeps* x, const BindingDeps* y) const {
+    return x->num_deps == y->num_deps && std::equal(x->deps, x->deps + x->num_deps, y->deps);
+  }
+};
+
+// The interned BindingDeps objects. These are never destroyed, since pointers to them can be held in static variables
+// (see GetBindingDepsHelper) and we can't control the order in which those are destroyed.
+struct InternedBindingDeps {
+  std::mutex mutex;
+  HashSet<const BindingDeps*, HashBindingDeps, BindingDepsEqualTo> set;
+};
+
+InternedBindingDeps& getInternedBindingDeps() {
+  static InternedBindingDeps* interned_binding_deps = new InternedBindingDeps();
+  return *interned_binding_deps;
+}
+
+} // namespace
+
+namespace fruit {
+namespace impl {
+
+const BindingDeps* internBindingDeps(const TypeId* deps, std::size_t num_deps) {
+  BindingDeps key{deps, num_deps};
+  InternedBindingDeps& interned_binding_deps = getInternedBindingDeps();
+
+  std::lock_guard<std::mutex> lock(interned_binding_deps.mutex);
+  auto itr = interned_binding_deps.set.find(&key);
+  if (itr != interned_binding_deps.set.end()) {
+    return *itr;
+  }
+
+  // We copy the deps instead of referencing the caller's array, since that might belong to a shared library that can
+  // be unloaded before other users of the interned object.
+  // Note that we keep the terminating TypeId{nullptr}, like GetBindingDepsHelper does.
+  TypeId* deps_copy = new TypeId[num_deps + 1];
+  std::copy(deps, deps + num_deps, deps_copy);
+  deps_copy[num_deps] = TypeId{nullptr};
+
+  const BindingDeps* result = new BindingDeps{deps_copy, num_deps};
+  interned_binding_deps.set.insert(result);
+  return result;
+}
+
+} // namespace impl
+} // namespace fruit
@@ -241,6 +241,7 @@ void BindingNormalization::addMultibindings(std::unordered_map<TypeId, Normalize
     case ComponentStorageEntry::Kind::MULTIBINDING_FOR_CONSTRUCTED_OBJECT: {
       NormalizedMultibinding normalized_multibinding;
       normalized_multibinding.is_constructed = true;
+      normalized_multibinding.needs_allocation = false;
       normalized_multibinding.object = i->first.multibinding_for_constructed_object.object_ptr;
       b.elems.push_back(std::move(normalized_multibinding));
     } break;
@@ -249,6 +250,7 @@ void BindingNormalization::addMultibindings(std::unordered_map<TypeId, Normalize
       fixed_size_allocator_data.addExternallyAllocatedType(i->first.type_id);
       NormalizedMultibinding normalized_multibinding;
       normalized_multibinding.is_constructed = false;
+      normalized_multibinding.needs_allocation = false;
       normalized_multibinding.create = i->first.multibinding_for_object_to_construct.create;
       b.elems.push_back(std::move(normalized_multibinding));
     } break;
@@ -257,6 +259,7 @@ void BindingNormalization::addMultibindings(std::unordered_map<TypeId, Normalize
       fixed_size_allocator_data.addType(i->first.type_id);
       NormalizedMultibinding normalized_multibinding;
       normalized_multibinding.is_constructed = false;
+      normalized_multibinding.needs_allocation = true;
       normalized_multibinding.create = i->first.multibinding_for_object_to_construct.create;
       b.elems.push_back(std::move(normalized_multibinding));
     } break;
@@ -271,7 +274,7 @@ void BindingNormalization::addMultibindings(std::unordered_map<TypeId, Normalize
 }
 
 void BindingNormalization::normalizeBindingsWithUndoableBindingCompression(
-    FixedSizeVector<ComponentStorageEntry>&& toplevel_entries,
+    ComponentStorageEntryVector&& toplevel_entries,
     FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data, MemoryPool& memory_pool,
     MemoryPool& memory_pool_for_fully_expanded_components_maps, MemoryPool& memory_pool_for_component_replacements_maps,
     const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
@@ -281,10 +284,16 @@ void BindingNormalization::normalizeBindingsWithUndoableBindingCompression(
     LazyComponentWithNoArgsSet& fully_expanded_components_with_no_args,
     LazyComponentWithArgsSet& fully_expanded_components_with_args,
     LazyComponentWithNoArgsReplacementMap& component_with_no_args_replacements,
-    LazyComponentWithArgsReplacementMap& component_with_args_replacements) {
+    LazyComponentWithArgsReplacementMap& component_with_args_replacements,
+    std::vector<ComponentStorageEntry>& lazy_subcomponents, fruit::NormalizationStats& stats) {
 
   FruitAssert(bindingCompressionInfoMap.empty());
 
+  // The lazy components with args are kept in the fully-expanded components set and in the component replacement maps
+  // after the normalization, so they can't be allocated in memory_pool.
+  FruitAssert(&memory_pool_for_fully_expanded_components_maps == &memory_pool_for_component_replacements_maps);
+  ComponentStorageMemoryPoolScope memory_pool_scope(memory_pool, memory_pool_for_fully_expanded_components_maps);
+
   normalizeBindingsWithBindingCompression(
       std::move(toplevel_entries), fixed_size_allocator_data, memory_pool,
       memory_pool_for_fully_expanded_components_maps, memory_pool_for_component_replacements_maps, exposed_types,
@@ -307,28 +316,40 @@ void BindingNormalization::normalizeBindingsWithUndoableBindingCompression(
       [&component_with_args_replacements](LazyComponentWithArgsReplacementMap& component_replacements) {
         component_with_args_replacements = std::move(component_replacements);
         component_replacements.clear();
-      });
+      },
+      lazy_subcomponents, stats);
 }
 
 void BindingNormalization::normalizeBindingsWithPermanentBindingCompression(
-    FixedSizeVector<ComponentStorageEntry>&& toplevel_entries,
+    ComponentStorageEntryVector&& toplevel_entries,
     FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data, MemoryPool& memory_pool,
     const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
     std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& bindings_vector,
-    std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings) {
+    std::vector<TypeId, ArenaAllocator<TypeId>>& compressed_type_ids,
+    std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings,
+    std::vector<ComponentStorageEntry>& lazy_subcomponents, fruit::NormalizationStats& stats) {
+  ComponentStorageMemoryPoolScope memory_pool_scope(memory_pool, memory_pool);
+
   normalizeBindingsWithBindingCompression(
       std::move(toplevel_entries), fixed_size_allocator_data, memory_pool, memory_pool, memory_pool, exposed_types,
-      bindings_vector, multibindings, [](TypeId, NormalizedComponentStorage::CompressedBindingUndoInfo) {},
+      bindings_vector, multibindings,
+      [&compressed_type_ids](TypeId, NormalizedComponentStorage::CompressedBindingUndoInfo undo_info) {
+        compressed_type_ids.push_back(undo_info.i_type_id);
+      },
       [](LazyComponentWithNoArgsSet&) {}, [](LazyComponentWithArgsSet&) {},
-      [](LazyComponentWithNoArgsReplacementMap&) {}, [](LazyComponentWithArgsReplacementMap&) {});
+      [](LazyComponentWithNoArgsReplacementMap&) {}, [](LazyComponentWithArgsReplacementMap&) {},
+      lazy_subcomponents, stats);
 }
 
 void BindingNormalization::normalizeBindingsAndAddTo(
-    FixedSizeVector<ComponentStorageEntry>&& toplevel_entries, MemoryPool& memory_pool,
+    ComponentStorageEntryVector&& toplevel_entries, MemoryPool& memory_pool,
     const NormalizedComponentStorage& base_normalized_component,
     FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
     std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& new_bindings_vector,
-    std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings) {
+    std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings,
+    std::vector<ComponentStorageEntry>& lazy_subcomponents, fruit::NormalizationStats& stats) {
+
+  ComponentStorageMemoryPoolScope memory_pool_scope(memory_pool, memory_pool);
 
   multibindings = base_normalized_component.multibindings;
 
@@ -344,7 +365,7 @@ void BindingNormalization::normalizeBindingsAndAddTo(
 
   normalizeBindings(
       std::move(toplevel_entries), fixed_size_allocator_data, memory_pool, memory_pool, memory_pool, binding_data_map,
-      [](ComponentStorageEntry) {},
+      stats, [](ComponentStorageEntry) {},
       [&multibindings_vector](ComponentStorageEntry multibinding, ComponentStorageEntry multibinding_vector_creator) {
         multibindings_vector.emplace_back(multibinding, multibinding_vector_creator);
       },
@@ -376,7 +397,8 @@ void BindingNormalization::normalizeBindingsAndAddTo(
       },
       [](typename LazyComponentWithNoArgsReplacementMap::const_iterator itr) { return itr->second; },
       [](typename LazyComponentWithArgsReplacementMap::const_iterator itr) { return itr->second; },
-      [](LazyComponentWithNoArgsReplacementMap&) {}, [](LazyComponentWithArgsReplacementMap&) {});
+      [](LazyComponentWithNoArgsReplacementMap&) {}, [](LazyComponentWithArgsReplacementMap&) {},
+      [&lazy_subcomponents](ComponentStorageEntry entry) { lazy_subcomponents.push_back(entry); });
 
   // Copy the normalized bindings into the result vector.
   new_bindings_vector.clear();
@@ -387,6 +409,8 @@ void BindingNormalization::normalizeBindingsAndAddTo(
 
   // Determine what binding compressions must be undone.
 
+  Stopwatch stopwatch;
+
   HashSetWithArenaAllocator<TypeId> binding_compressions_to_undo =
       createHashSetWithArenaAllocator<TypeId>(20 /* capacity */, memory_pool);
   for (const ComponentStorageEntry& entry : new_bindings_vector) {
@@ -445,6 +469,12 @@ void BindingNormalization::normalizeBindingsAndAddTo(
 #endif
   }
 
+  stats.binding_compression_ns += stopwatch.elapsedNs();
+  stats.num_undone_binding_compressions += binding_compressions_to_undo.size();
+  // Each undone compression adds a binding for C, while the one for I replaces the one in base_normalized_component.
+  stats.num_bindings += binding_data_map.size() + binding_compressions_to_undo.size();
+  stats.num_multibindings += multibindings_vector.size();
+
   // Step 4: Add multibindings.
   BindingNormalization::addMultibindings(multibindings, fixed_size_allocator_data, multibindings_vector);
 }
@@ -21,8 +21,40 @@
 #include <exception>
 #include <iostream>
 
+namespace {
+
+thread_local fruit::impl::MemoryPool* current_entries_memory_pool = nullptr;
+thread_local fruit::impl::MemoryPool* current_lazy_components_memory_pool = nullptr;
+
+} // namespace
+
 namespace fruit {
 
+namespace impl {
+
+ComponentStorageMemoryPoolScope::ComponentStorageMemoryPoolScope(MemoryPool& entries_memory_pool,
+                                                                 MemoryPool& lazy_components_memory_pool)
+    : previous_entries_memory_pool(current_entries_memory_pool),
+      previous_lazy_components_memory_pool(current_lazy_components_memory_pool) {
+  current_entries_memory_pool = &entries_memory_pool;
+  current_lazy_components_memory_pool = &lazy_components_memory_pool;
+}
+
+ComponentStorageMemoryPoolScope::~ComponentStorageMemoryPoolScope() {
+  current_entries_memory_pool = previous_entries_memory_pool;
+  current_lazy_components_memory_pool = previous_lazy_components_memory_pool;
+}
+
+MemoryPool* ComponentStorageMemoryPoolScope::getEntriesMemoryPool() {
+  return current_entries_memory_pool;
+}
+
+MemoryPool* ComponentStorageMemoryPoolScope::getLazyComponentsMemoryPool() {
+  return current_lazy_components_memory_pool;
+}
+
+} // namespace impl
+
 // TODO: reimplement this check somehow.
 /*
 EmptyPartialComponent::~EmptyPartialComponent() {
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define IN_FRUIT_CPP_FILE 1
+
+#include <fruit/construction_tracer.h>
+#include <fruit/impl/util/json.h>
+
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+// The number of traced constructions in progress in the current thread.
+thread_local std::size_t current_construction_depth = 0;
+
+// For each traced construction in progress in the current thread (indexed by depth), the total duration of the nested
+// constructions completed so far.
+thread_local std::vector<std::uint64_t> nested_construction_ns;
+
+// Writes a duration in ns as a number of microseconds (the unit used in the trace-event format).
+void writeMicroseconds(std::ostream& os, std::uint64_t ns) {
+  os << (ns / 1000) << '.' << std::setw(3) << std::setfill('0') << (ns % 1000) << std::setfill(' ');
+}
+} // namespace
+
+namespace fruit {
+
+ConstructionTracer::ConstructionTracer() : creation_time(std::chrono::steady_clock::now()) {}
+
+std::uint64_t ConstructionTracer::beginConstruction() {
+  if (nested_construction_ns.size() <= current_construction_depth) {
+    nested_construction_ns.resize(current_construction_depth + 1);
+  }
+  nested_construction_ns[current_construction_depth] = 0;
+  ++current_construction_depth;
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - creation_time)
+      .count();
+}
+
+std::uint64_t ConstructionTracer::endConstruction(fruit::impl::TypeId type, bool is_multibinding,
+                                                  std::uint64_t start_ns) {
+  std::uint64_t end_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - creation_time).count();
+  --current_construction_depth;
+  std::uint64_t duration_ns = end_ns - start_ns;
+  std::uint64_t self_ns = duration_ns - nested_construction_ns[current_construction_depth];
+  if (current_construction_depth != 0) {
+    nested_construction_ns[current_construction_depth - 1] += duration_ns;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    records.push_back(
+        Record{type, is_multibinding, start_ns, end_ns, std::this_thread::get_id(), current_construction_depth});
+  }
+  return self_ns;
+}
+
+void ConstructionTracer::abortConstruction() {
+  --current_construction_depth;
+}
+
+ConstructionTracer::ConstructionScope::ConstructionScope(ConstructionTracer* tracer)
+    : tracer(tracer), start_ns(tracer->beginConstruction()) {}
+
+ConstructionTracer::ConstructionScope::~ConstructionScope() {
+  if (!ended) {
+    tracer->abortConstruction();
+  }
+}
+
+std::uint64_t ConstructionTracer::ConstructionScope::end(fruit::impl::TypeId type, bool is_multibinding) {
+  ended = true;
+  return tracer->endConstruction(type, is_multibinding, start_ns);
+}
+
+std::vector<ConstructionTracer::Event> ConstructionTracer::getEventsLocked() const {
+  std::unordered_map<std::thread::id, std::size_t> thread_indexes;
+  std::vector<Event> events;
+  events.reserve(records.size());
+  for (const Record& record : records) {
+    std::size_t thread_index = thread_indexes.emplace(record.thread_id, thread_indexes.size()).first->second;
+    events.push_back(
+        Event{std::string(record.type), record.is_multibinding, record.start_ns, record.end_ns, thread_index,
+              record.depth});
+  }
+  return events;
+}
+
+std::vector<ConstructionTracer::Event> ConstructionTracer::getEvents() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return getEventsLocked();
+}
+
+void ConstructionTracer::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  records.clear();
+}
+
+void ConstructionTracer::writeChromeTraceJson(std::ostream& os) const {
+  std::vector<Event> events = getEvents();
+
+  // We write to a separate stream so that the formatting flags of `os' are not affected.
+  std::ostringstream json;
+  json << "{\"traceEvents\":[";
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    const Event& event = events[i];
+    if (i != 0) {
+      json << ',';
+    }
+    // These are "complete" events (ph=X), i.e. each one has both a start time and a duration.
+    json << "\n{\"name\":";
+    fruit::impl::writeJsonString(json, event.type_name);
+    json << ",\"cat\":\"" << (event.is_multibinding ? "multibinding" : "binding") << "\",\"ph\":\"X\",\"ts\":";
+    writeMicroseconds(json, event.start_ns);
+    json << ",\"dur\":";
+    writeMicroseconds(json, event.end_ns - event.start_ns);
+    json << ",\"pid\":1,\"tid\":" << event.thread_index << ",\"args\":{\"depth\":" << event.depth << "}}";
+  }
+  json << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  os << json.str();
+}
+
+} // namespace fruit
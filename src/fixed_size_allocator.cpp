@@ -25,11 +25,14 @@ namespace fruit {
 namespace impl {
 
 FixedSizeAllocator::~FixedSizeAllocator() {
-  // Destroy all objects in reverse order.
+  // Destroy all objects in reverse order (except the ones that the teardown policy says to leak).
   std::pair<destroy_t, void*>* p = on_destruction.end();
   while (p != on_destruction.begin()) {
     --p;
-    p->first(p->second);
+    // The entries of the objects already destroyed with destroyObjectAt() are null.
+    if (p->first != nullptr) {
+      p->first(p->second, teardown_policy);
+    }
   }
   delete[] storage_begin;
 }
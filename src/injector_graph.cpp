@@ -0,0 +1,203 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define IN_FRUIT_CPP_FILE 1
+
+#include <fruit/injector_graph.h>
+#include <fruit/impl/util/json.h>
+
+#include <ostream>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+const char* getKindName(fruit::InjectorGraph::BindingKind kind) {
+  switch (kind) { // LCOV_EXCL_BR_LINE
+  case fruit::InjectorGraph::BindingKind::INSTANCE:
+    return "instance";
+  case fruit::InjectorGraph::BindingKind::CONSTRUCTED_IN_INJECTOR:
+    return "constructed_in_injector";
+  case fruit::InjectorGraph::BindingKind::CONSTRUCTED_OUTSIDE_INJECTOR:
+    return "constructed_outside_injector";
+  case fruit::InjectorGraph::BindingKind::LAZY_SUBCOMPONENT:
+    return "lazy_subcomponent";
+  }
+  return "unknown"; // LCOV_EXCL_LINE
+}
+
+// Writes `s' as a quoted string in the DOT format, where "\n" is a line break.
+void writeDotString(std::ostream& os, const std::string& s) {
+  os << '"';
+  for (char c : s) {
+    if (c == '\n') {
+      os << "\\n";
+    } else {
+      if (c == '"' || c == '\\') {
+        os << '\\';
+      }
+      os << c;
+    }
+  }
+  os << '"';
+}
+
+} // namespace
+
+namespace fruit {
+
+std::vector<std::size_t> InjectorGraph::getCriticalPath() const {
+  const std::size_t none = static_cast<std::size_t>(-1);
+  enum class VisitState : unsigned char { NOT_VISITED, IN_PROGRESS, DONE };
+
+  // The total construction time of the longest chain of dependencies starting at each node, and the next node in that
+  // chain (if any).
+  std::vector<std::uint64_t> path_ns(nodes.size(), 0);
+  std::vector<std::size_t> next(nodes.size(), none);
+
+  // This is an iterative DFS (to avoid a stack overflow with long chains), where each element of the stack is a node
+  // and the index of the next dependency to visit.
+  std::vector<VisitState> state(nodes.size(), VisitState::NOT_VISITED);
+  std::vector<std::pair<std::size_t, std::size_t>> stack;
+  for (std::size_t root = 0; root < nodes.size(); ++root) {
+    if (state[root] != VisitState::NOT_VISITED) {
+      continue;
+    }
+    state[root] = VisitState::IN_PROGRESS;
+    stack.push_back(std::make_pair(root, 0));
+    while (!stack.empty()) {
+      std::size_t node_index = stack.back().first;
+      const Node& node = nodes[node_index];
+      if (stack.back().second < node.dependencies.size()) {
+        std::size_t dep = node.dependencies[stack.back().second++];
+        // Dependencies that are IN_PROGRESS would form a loop; those can't be constructed, so we ignore them.
+        if (state[dep] == VisitState::NOT_VISITED) {
+          state[dep] = VisitState::IN_PROGRESS;
+          stack.push_back(std::make_pair(dep, 0));
+        }
+      } else {
+        std::uint64_t longest_dep_path_ns = 0;
+        for (std::size_t dep : node.dependencies) {
+          if (state[dep] == VisitState::DONE && path_ns[dep] > longest_dep_path_ns) {
+            longest_dep_path_ns = path_ns[dep];
+            next[node_index] = dep;
+          }
+        }
+        path_ns[node_index] = (node.has_construction_time ? node.construction_ns : 0) + longest_dep_path_ns;
+        state[node_index] = VisitState::DONE;
+        stack.pop_back();
+      }
+    }
+  }
+
+  std::vector<std::size_t> critical_path;
+  std::size_t start = none;
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    if (path_ns[i] > 0 && (start == none || path_ns[i] > path_ns[start])) {
+      start = i;
+    }
+  }
+  for (std::size_t i = start; i != none; i = next[i]) {
+    critical_path.push_back(i);
+  }
+  return critical_path;
+}
+
+void InjectorGraph::writeDot(std::ostream& os) const {
+  std::vector<std::size_t> critical_path = getCriticalPath();
+  std::vector<std::size_t> next_in_critical_path(nodes.size(), static_cast<std::size_t>(-1));
+  std::vector<bool> is_in_critical_path(nodes.size(), false);
+  for (std::size_t i = 0; i < critical_path.size(); ++i) {
+    is_in_critical_path[critical_path[i]] = true;
+    if (i + 1 < critical_path.size()) {
+      next_in_critical_path[critical_path[i]] = critical_path[i + 1];
+    }
+  }
+
+  // We write to a separate stream so that the formatting flags of `os' are not affected.
+  std::ostringstream dot;
+  dot << "digraph injector {\n";
+  dot << "  node [shape=box];\n";
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    const Node& node = nodes[i];
+    std::ostringstream label;
+    label << node.type_name << "\n" << getKindName(node.kind);
+    if (node.has_construction_time) {
+      label << "\n" << node.construction_ns << " ns";
+    }
+    dot << "  n" << i << " [label=";
+    writeDotString(dot, label.str());
+    if (node.is_constructed || node.is_compressed) {
+      dot << ", style=\"" << (node.is_constructed ? "filled" : "")
+          << (node.is_constructed && node.is_compressed ? "," : "") << (node.is_compressed ? "dashed" : "") << "\"";
+    }
+    if (is_in_critical_path[i]) {
+      dot << ", color=red";
+    }
+    dot << "];\n";
+  }
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    for (std::size_t dep : nodes[i].dependencies) {
+      dot << "  n" << i << " -> n" << dep;
+      if (next_in_critical_path[i] == dep) {
+        dot << " [color=red]";
+      }
+      dot << ";\n";
+    }
+  }
+  dot << "}\n";
+  os << dot.str();
+}
+
+void InjectorGraph::writeJson(std::ostream& os) const {
+  std::vector<std::size_t> critical_path = getCriticalPath();
+  std::uint64_t critical_path_ns = 0;
+  for (std::size_t i : critical_path) {
+    critical_path_ns += nodes[i].construction_ns;
+  }
+
+  // We write to a separate stream so that the formatting flags of `os' are not affected.
+  std::ostringstream json;
+  json << "{\"nodes\":[";
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    const Node& node = nodes[i];
+    if (i != 0) {
+      json << ',';
+    }
+    json << "\n{\"id\":" << i << ",\"type\":";
+    fruit::impl::writeJsonString(json, node.type_name);
+    json << ",\"kind\":\"" << getKindName(node.kind) << "\",\"compressed\":" << (node.is_compressed ? "true" : "false")
+         << ",\"constructed\":" << (node.is_constructed ? "true" : "false") << ",\"construction_ns\":";
+    if (node.has_construction_time) {
+      json << node.construction_ns;
+    } else {
+      json << "null";
+    }
+    json << ",\"dependencies\":[";
+    for (std::size_t j = 0; j < node.dependencies.size(); ++j) {
+      json << (j == 0 ? "" : ",") << node.dependencies[j];
+    }
+    json << "]}";
+  }
+  json << "\n],\"critical_path\":[";
+  for (std::size_t i = 0; i < critical_path.size(); ++i) {
+    json << (i == 0 ? "" : ",") << critical_path[i];
+  }
+  json << "],\"critical_path_ns\":" << critical_path_ns << "}\n";
+  os << json.str();
+}
+
+} // namespace fruit
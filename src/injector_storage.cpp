@@ -17,17 +17,21 @@
 #define IN_FRUIT_CPP_FILE 1
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <fruit/impl/util/type_info.h>
 #include <iostream>
 #include <memory>
 #include <vector>
 
+#include <fruit/construction_tracer.h>
 #include <fruit/impl/component_storage/component_storage.h>
 #include <fruit/impl/data_structures/semistatic_graph.templates.h>
 #include <fruit/impl/injector/injector_storage.h>
 #include <fruit/impl/normalized_component_storage/binding_normalization.h>
 #include <fruit/impl/normalized_component_storage/binding_normalization.templates.h>
+#include <fruit/impl/util/parallel_task_graph.h>
+#include <fruit/impl/util/stopwatch.h>
 
 using std::cout;
 using std::endl;
@@ -37,6 +41,8 @@ using namespace fruit::impl;
 namespace fruit {
 namespace impl {
 
+constexpr std::uint64_t InjectorStorage::NOT_TRACED;
+
 void InjectorStorage::fatal(const std::string& error) {
   std::cerr << "Fatal injection error: " << error << std::endl;
   exit(1);
@@ -65,60 +71,871 @@ struct DummyNode {
 }
 // LCOV_EXCL_STOP
 
+struct InjectorStorage::LazySubcomponentState {
+  // An entry with kind LAZY_SUBCOMPONENT, owned by this object.
+  ComponentStorageEntry entry;
+
+  // The injector for this subcomponent, or nullptr if it wasn't expanded yet. This is owned by the `allocator' of the
+  // enclosing injector, so that it's destroyed after any object constructed (by the enclosing injector) after it.
+  InjectorStorage* injector;
+
+  // Used to detect dependency loops that go through the enclosing injector.
+  bool expansion_in_progress;
+
+  LazySubcomponentState(ComponentStorageEntry entry) : entry(entry), injector(nullptr), expansion_in_progress(false) {}
+
+  LazySubcomponentState(const LazySubcomponentState&) = delete;
+  LazySubcomponentState& operator=(const LazySubcomponentState&) = delete;
+
+  ~LazySubcomponentState() {
+    entry.destroy();
+  }
+};
+
 InjectorStorage::InjectorStorage(ComponentStorage&& component,
                                  const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
                                  MemoryPool& memory_pool)
     : normalized_component_storage_ptr(new NormalizedComponentStorage(
           std::move(component), exposed_types, memory_pool, NormalizedComponentStorage::WithPermanentCompression())),
       allocator(normalized_component_storage_ptr->fixed_size_allocator_data),
-      bindings(normalized_component_storage_ptr->bindings, (DummyNode<TypeId, NormalizedBinding>*)nullptr,
-               (DummyNode<TypeId, NormalizedBinding>*)nullptr, memory_pool),
+      node_infos(std::move(normalized_component_storage_ptr->node_infos)),
       multibindings(std::move(normalized_component_storage_ptr->multibindings)) {
 
+  // The normalization was already performed by the NormalizedComponentStorage constructor, here we only measure the
+  // remaining work.
+  Stopwatch stopwatch;
+  stats.normalization = normalized_component_storage_ptr->normalization_stats;
+
+  bindings = Graph(normalized_component_storage_ptr->bindings, (DummyNode<TypeId, NormalizedBinding>*)nullptr,
+                   (DummyNode<TypeId, NormalizedBinding>*)nullptr, memory_pool);
+  stats.normalization.graph_construction_ns += stopwatch.elapsedNs();
+
+  for (const ComponentStorageEntry& entry : normalized_component_storage_ptr->lazy_subcomponents) {
+    addLazySubcomponent(entry);
+  }
+  normalized_component_storage_ptr->lazy_subcomponents.clear();
+  findAsyncProviders();
+
 #if FRUIT_EXTRA_DEBUG
   bindings.checkFullyConstructed();
 #endif
+
+  stats.total_ns = stats.normalization.total_ns + stopwatch.elapsedNs();
 }
 
 InjectorStorage::InjectorStorage(const NormalizedComponentStorage& normalized_component, ComponentStorage&& component,
                                  MemoryPool& memory_pool) {
 
+  Stopwatch stopwatch;
   FixedSizeAllocator::FixedSizeAllocatorData fixed_size_allocator_data;
   using new_bindings_vector_t = std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>;
   new_bindings_vector_t new_bindings_vector = new_bindings_vector_t(ArenaAllocator<ComponentStorageEntry>(memory_pool));
 
+  std::vector<ComponentStorageEntry> new_lazy_subcomponents;
+
   BindingNormalization::normalizeBindingsAndAddTo(std::move(component).release(), memory_pool, normalized_component,
-                                                  fixed_size_allocator_data, new_bindings_vector, multibindings);
+                                                  fixed_size_allocator_data, new_bindings_vector, multibindings,
+                                                  new_lazy_subcomponents, stats.normalization);
+
+  // The entries in the NormalizedComponent are shared with other injectors, so we need a copy.
+  for (const ComponentStorageEntry& entry : normalized_component.lazy_subcomponents) {
+    addLazySubcomponent(entry.copy());
+  }
+  for (const ComponentStorageEntry& entry : new_lazy_subcomponents) {
+    addLazySubcomponent(entry);
+  }
 
   allocator = FixedSizeAllocator(fixed_size_allocator_data);
 
+  Stopwatch graph_construction_stopwatch;
   bindings = Graph(normalized_component.bindings, BindingDataNodeIter{new_bindings_vector.begin()},
                    BindingDataNodeIter{new_bindings_vector.end()}, memory_pool);
+  node_infos = normalized_component.node_infos;
+  node_infos.resize(bindings.size());
+  for (const ComponentStorageEntry& entry : new_bindings_vector) {
+    NormalizedBindingInfo info;
+    if (entry.kind != ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT) {
+      info.deps = entry.binding_for_object_to_construct.deps;
+    }
+    if (entry.kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_WITH_UNKNOWN_ALLOCATION) {
+      // The binding compression for this type was undone. The space for it was reserved through the binding for the
+      // interface type.
+      TypeId i_type_id = normalized_component.binding_compression_info_map.find(entry.type_id)->second.i_type_id;
+      info.needs_allocation =
+          normalized_component.node_infos[bindings.indexOf(bindings.at(i_type_id))].needs_allocation;
+    } else {
+      info.needs_allocation =
+          entry.kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION;
+    }
+    node_infos[bindings.indexOf(bindings.at(entry.type_id))] = info;
+  }
+  findAsyncProviders();
+  stats.normalization.graph_construction_ns += graph_construction_stopwatch.elapsedNs();
+  stats.normalization.num_graph_nodes = bindings.size();
+  stats.normalization.allocator_reserved_bytes = fixed_size_allocator_data.getTotalSize();
+  stats.normalization.allocator_num_types_to_destroy = fixed_size_allocator_data.getNumTypesToDestroy();
 #if FRUIT_EXTRA_DEBUG
   bindings.checkFullyConstructed();
 #endif
+
+  stats.normalization.total_ns = stopwatch.elapsedNs();
+  stats.total_ns = stats.normalization.total_ns;
 }
 
-InjectorStorage::~InjectorStorage() {}
+InjectorStorage::InjectorStorage(
+    InjectorStorage& parent_injector, const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+    const std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& instances, MemoryPool& memory_pool)
+    : parent(&parent_injector) {
+
+  Stopwatch stopwatch;
+  using entries_vector_t = std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>;
+  entries_vector_t entries =
+      entries_vector_t(instances.begin(), instances.end(), ArenaAllocator<ComponentStorageEntry>(memory_pool));
+  using parent_nodes_vector_t = std::vector<Graph::node_iterator, ArenaAllocator<Graph::node_iterator>>;
+  parent_nodes_vector_t parent_nodes_of_entries =
+      parent_nodes_vector_t(ArenaAllocator<Graph::node_iterator>(memory_pool));
+  entries.reserve(instances.size() + exposed_types.size());
+  parent_nodes_of_entries.reserve(exposed_types.size());
+
+  {
+    // We lock the parent so that we see a consistent state of its objects. The types already constructed by the parent
+    // are bound to the parent's objects directly, so they're returned without locking the parent.
+    std::lock_guard<std::recursive_mutex> lock(parent_injector.mutex);
+    for (TypeId type : exposed_types) {
+      bool is_instance = false;
+      for (const ComponentStorageEntry& instance : instances) {
+        is_instance = is_instance || instance.type_id == type;
+      }
+      if (is_instance) {
+        continue;
+      }
+      Graph::node_iterator parent_node_itr = parent_injector.bindings.at(type);
+      ComponentStorageEntry entry;
+      entry.type_id = type;
+      if (parent_node_itr.isTerminal()) {
+        entry.kind = ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT;
+        entry.binding_for_constructed_object.object_ptr = parent_node_itr.getNode().object;
+#if FRUIT_EXTRA_DEBUG
+        entry.binding_for_constructed_object.is_nonconst = true;
+#endif
+      } else {
+        entry.kind = ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION;
+        entry.binding_for_object_to_construct.create = createInjectedObjectFromParent;
+        entry.binding_for_object_to_construct.deps = getBindingDeps<fruit::impl::meta::Vector<>>();
+#if FRUIT_EXTRA_DEBUG
+        entry.binding_for_object_to_construct.is_nonconst = true;
+#endif
+        parent_nodes_of_entries.push_back(parent_node_itr);
+      }
+      entries.push_back(entry);
+    }
+  }
+
+  bindings = Graph(BindingDataNodeIter{entries.begin()}, BindingDataNodeIter{entries.end()}, memory_pool);
+  node_infos.resize(bindings.size());
+  parent_nodes.resize(bindings.size(), parent_injector.bindings.end());
+  auto parent_node_itr = parent_nodes_of_entries.begin();
+  for (const ComponentStorageEntry& entry : entries) {
+    if (entry.kind != ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT) {
+      parent_nodes[bindings.indexOf(bindings.at(entry.type_id))] = *parent_node_itr;
+      ++parent_node_itr;
+    }
+  }
+
+  stats.normalization.graph_construction_ns = stopwatch.elapsedNs();
+  stats.normalization.num_graph_nodes = bindings.size();
+  stats.normalization.total_ns = stats.normalization.graph_construction_ns;
+  stats.total_ns = stats.normalization.total_ns;
+}
+
+InjectorStorage::~InjectorStorage() {
+  // The prefetches in progress use this object.
+  for (const std::shared_future<void>& prefetch : prefetches) {
+    prefetch.wait();
+  }
+
+  // The objects in the arena might depend on other objects in the injector (including the ones in the injectors of
+  // lazy subcomponents), so they must be destroyed first.
+  factory_arena.clear();
+
+  if (teardown_threads != 1) {
+    destroyObjectsInParallel();
+  }
+}
+
+void InjectorStorage::destroyObjectsInParallel() {
+  const std::size_t none = static_cast<std::size_t>(-1);
+  std::size_t num_objects = allocator.getNumObjectsToDestroy();
+
+  // Tasks [0, num_objects) destroy the object with the same index in the allocator. Then there's a task for each
+  // constructed node that doesn't own its object (e.g. interfaces, instances and types provided by lazy subcomponents),
+  // that does nothing but orders the objects that depend on it before the ones that it depends on.
+  std::unordered_map<const void*, std::size_t> task_by_object;
+  task_by_object.reserve(num_objects);
+  for (std::size_t i = 0; i < num_objects; ++i) {
+    task_by_object[allocator.getObjectToDestroy(i)] = i;
+  }
+  std::vector<bool> is_known(num_objects, false);
+  std::size_t num_tasks = num_objects;
+
+  // Maps bindings.indexOf(node_itr) to the task for the node, or to `none' if the node wasn't constructed.
+  std::vector<std::size_t> task_by_node_index(bindings.size(), none);
+  bindings.forEachNode([&](TypeId, Graph::node_iterator node_itr) {
+    if (!node_itr.isTerminal()) {
+      return;
+    }
+    auto itr = task_by_object.find(node_itr.getNode().object);
+    if (itr == task_by_object.end()) {
+      task_by_node_index[bindings.indexOf(node_itr)] = num_tasks++;
+    } else {
+      task_by_node_index[bindings.indexOf(node_itr)] = itr->second;
+      is_known[itr->second] = true;
+    }
+  });
+
+  // The dependencies of multibindings are not stored once they're constructed, but nothing else can depend on them. So
+  // they're all destroyed before this task, and all the other objects are destroyed after it.
+  std::size_t multibindings_destroyed_task = num_tasks++;
+  std::vector<std::size_t> multibinding_tasks;
+  std::vector<bool> is_multibinding_task(num_objects, false);
+  for (const auto& p : multibindings) {
+    for (const NormalizedMultibinding& multibinding : p.second.elems) {
+      if (multibinding.is_constructed) {
+        auto itr = task_by_object.find(multibinding.object);
+        if (itr != task_by_object.end() && !is_known[itr->second]) {
+          multibinding_tasks.push_back(itr->second);
+          is_multibinding_task[itr->second] = true;
+          is_known[itr->second] = true;
+        }
+      }
+    }
+  }
+
+  // The injectors of lazy subcomponents are destroyed after the objects of this injector that depend on the types that
+  // they provide, and before the objects that they require.
+  for (const std::unique_ptr<LazySubcomponentState>& state : lazy_subcomponents) {
+    if (state->injector != nullptr) {
+      auto itr = task_by_object.find(state->injector);
+      FruitAssert(itr != task_by_object.end());
+      is_known[itr->second] = true;
+    }
+  }
 
-void InjectorStorage::ensureConstructedMultibinding(NormalizedMultibindingSet& multibinding_set) {
+  for (std::size_t i = 0; i < num_objects; ++i) {
+    if (!is_known[i]) {
+      // We don't know what this object depends on, so we can't destroy objects in parallel safely.
+      return;
+    }
+  }
+
+  ParallelTaskGraph task_graph(num_tasks);
+  if (!multibinding_tasks.empty()) {
+    for (std::size_t task : multibinding_tasks) {
+      task_graph.addOrdering(task, multibindings_destroyed_task);
+    }
+    for (std::size_t task = 0; task < multibindings_destroyed_task; ++task) {
+      if (task >= num_objects || !is_multibinding_task[task]) {
+        task_graph.addOrdering(multibindings_destroyed_task, task);
+      }
+    }
+  }
+
+  auto task_for_type = [&](TypeId type) {
+    Graph::node_iterator node_itr = bindings.find(type);
+    return node_itr == bindings.end() ? none : task_by_node_index[bindings.indexOf(node_itr)];
+  };
+
+  // The edges in `bindings' are lost once the objects are constructed, so we use the deps in node_infos instead.
+  bindings.forEachNode([&](TypeId, Graph::node_iterator node_itr) {
+    std::size_t node_index = bindings.indexOf(node_itr);
+    std::size_t task = task_by_node_index[node_index];
+    const BindingDeps* deps = node_infos[node_index].deps;
+    if (task == none || deps == nullptr) {
+      return;
+    }
+    for (std::size_t i = 0; i < deps->num_deps; ++i) {
+      std::size_t dep_task = task_for_type(deps->deps[i]);
+      // Dependencies that were not constructed (e.g. used through a Provider that was never called) are skipped.
+      if (dep_task != none && dep_task != task) {
+        task_graph.addOrdering(task, dep_task);
+      }
+    }
+  });
+
+  for (const std::unique_ptr<LazySubcomponentState>& state : lazy_subcomponents) {
+    if (state->injector == nullptr) {
+      continue;
+    }
+    std::size_t injector_task = task_by_object[state->injector];
+    const ComponentStorageEntry::LazySubcomponent::Types& types = *state->entry.lazy_subcomponent.types;
+    for (std::size_t i = 0; i < types.provided_types->num_deps; ++i) {
+      std::size_t provided_task = task_for_type(types.provided_types->deps[i]);
+      if (provided_task != none) {
+        task_graph.addOrdering(provided_task, injector_task);
+      }
+    }
+    for (std::size_t i = 0; i < types.required_types->num_deps; ++i) {
+      std::size_t required_task = task_for_type(types.required_types->deps[i]);
+      if (required_task != none) {
+        task_graph.addOrdering(injector_task, required_task);
+      }
+    }
+  }
+
+  std::size_t num_threads = teardown_threads != 0 ? teardown_threads : std::thread::hardware_concurrency();
+  // If there are loops in the ordering constraints, the objects involved are not destroyed here; the allocator will
+  // destroy them sequentially instead.
+  task_graph.run(num_threads == 0 ? 1 : num_threads, [this, num_objects](std::size_t task) {
+    if (task < num_objects) {
+      allocator.destroyObjectAt(task);
+    }
+  });
+}
+
+InjectorStorage::const_object_ptr_t InjectorStorage::createInjectedObjectForObjectArena(InjectorStorage& injector,
+                                                                                       Graph::node_iterator node_itr) {
+  node_itr.setTerminal();
+  return &injector.factory_arena;
+}
+
+InjectorStorage::const_object_ptr_t InjectorStorage::createInjectedObjectFromParent(InjectorStorage& injector,
+                                                                                    Graph::node_iterator node_itr) {
+  InjectorStorage& parent_injector = *injector.parent;
+  const_object_ptr_t object;
+  {
+    // The parent never locks its children, so this can't deadlock.
+    std::lock_guard<std::recursive_mutex> lock(parent_injector.mutex);
+    object = parent_injector.getPtrInternal(injector.parent_nodes[injector.bindings.indexOf(node_itr)]);
+  }
+  node_itr.setTerminal();
+  return object;
+}
+
+void InjectorStorage::findAsyncProviders() {
+  auto itr = multibindings.find(getTypeId<AsyncProviderInfo>());
+  if (itr == multibindings.end()) {
+    return;
+  }
+  for (const NormalizedMultibinding& multibinding : itr->second.elems) {
+    FruitAssert(multibinding.is_constructed);
+    const AsyncProviderInfo& info = *reinterpret_cast<const AsyncProviderInfo*>(multibinding.object);
+    Graph::node_iterator node_itr = bindings.at(info.type);
+    if (!node_itr.isTerminal()) {
+      async_providers_to_start[bindings.indexOf(node_itr)] = info.start;
+    }
+  }
+}
+
+const void* InjectorStorage::getPtrInternalStartingAsyncProviders(Graph::node_iterator node_itr) {
+  std::unordered_map<std::size_t, std::size_t> depth_by_node_index;
+  std::vector<std::pair<std::size_t, Graph::node_iterator>> to_start;
+  findAsyncProvidersToStart(node_itr, depth_by_node_index, to_start);
+
+  // The providers that don't depend on other async providers are called first, so that they all run concurrently.
+  // Calling the others requires waiting for (some of) these.
+  std::stable_sort(to_start.begin(), to_start.end(),
+                   [](const std::pair<std::size_t, Graph::node_iterator>& x,
+                      const std::pair<std::size_t, Graph::node_iterator>& y) { return x.first < y.first; });
+
+  // The flag must be reset even if a provider (or a future) throws, otherwise later calls to get() would never start
+  // async providers in advance.
+  async_providers_started = true;
+  const void* result;
+  try {
+    for (const std::pair<std::size_t, Graph::node_iterator>& p : to_start) {
+      std::size_t node_index = bindings.indexOf(p.second);
+      auto itr = async_providers_to_start.find(node_index);
+      if (itr != async_providers_to_start.end() && started_async_providers.count(node_index) == 0) {
+        // If the provider throws, nothing is recorded, so that it's called again on the next attempt.
+        std::shared_ptr<void> future_ptr = itr->second(*this);
+        started_async_providers[node_index] = std::move(future_ptr);
+      }
+    }
+    result = getPtrInternal(node_itr);
+  } catch (...) {
+    async_providers_started = false;
+    throw;
+  }
+  async_providers_started = false;
+  return result;
+}
+
+std::size_t InjectorStorage::findAsyncProvidersToStart(
+    Graph::node_iterator node_itr, std::unordered_map<std::size_t, std::size_t>& depth_by_node_index,
+    std::vector<std::pair<std::size_t, Graph::node_iterator>>& to_start) {
+  if (node_itr.isTerminal()) {
+    return 0;
+  }
+  std::size_t node_index = bindings.indexOf(node_itr);
+  auto depth_itr = depth_by_node_index.find(node_index);
+  if (depth_itr != depth_by_node_index.end()) {
+    return depth_itr->second;
+  }
+  // This also prevents infinite recursion in case of dependency loops in the graph (these are reported when
+  // constructing the object).
+  depth_by_node_index[node_index] = 0;
+
+  std::size_t depth = 0;
+  const BindingDeps* deps = node_infos[node_index].deps;
+  if (deps != nullptr) {
+    for (std::size_t i = 0; i < deps->num_deps; ++i) {
+      Graph::node_iterator dep_itr = bindings.find(deps->deps[i]);
+      if (!(dep_itr == bindings.end())) {
+        depth = std::max(depth, findAsyncProvidersToStart(dep_itr, depth_by_node_index, to_start));
+      }
+    }
+  }
+  if (async_providers_to_start.count(node_index) != 0 && started_async_providers.count(node_index) == 0) {
+    ++depth;
+    to_start.emplace_back(depth, node_itr);
+  }
+  depth_by_node_index[node_index] = depth;
+  return depth;
+}
+
+std::shared_ptr<void> InjectorStorage::takeAsyncProviderFuture(Graph::node_iterator node_itr) {
+  std::size_t node_index = bindings.indexOf(node_itr);
+  auto itr = started_async_providers.find(node_index);
+  if (itr != started_async_providers.end()) {
+    std::shared_ptr<void> result = std::move(itr->second);
+    started_async_providers.erase(itr);
+    return result;
+  }
+  // The provider wasn't called in advance (e.g. because this object is constructed by a provider that calls
+  // Provider::get()), or its previous future threw. The entry in async_providers_to_start is only removed once the
+  // object is constructed (see createInjectedObjectForAsyncProvider()), so this is always found.
+  auto start_itr = async_providers_to_start.find(node_index);
+  FruitAssert(start_itr != async_providers_to_start.end());
+  return start_itr->second(*this);
+}
+
+void InjectorStorage::addLazySubcomponent(ComponentStorageEntry entry) {
+  FruitAssert(entry.kind == ComponentStorageEntry::Kind::LAZY_SUBCOMPONENT);
+  for (const std::unique_ptr<LazySubcomponentState>& state : lazy_subcomponents) {
+    if (*state->entry.lazy_subcomponent.component.component == *entry.lazy_subcomponent.component.component) {
+      // The same component was installed lazily multiple times, we only need to keep one.
+      entry.destroy();
+      return;
+    }
+  }
+
+  std::unique_ptr<LazySubcomponentState> state(new LazySubcomponentState(entry));
+  const BindingDeps* provided_types = entry.lazy_subcomponent.types->provided_types;
+  for (std::size_t i = 0; i < provided_types->num_deps; ++i) {
+    TypeId type = provided_types->deps[i];
+    if (!lazy_subcomponent_by_provided_type.insert(std::make_pair(type, state.get())).second) {
+      fatal("the type " + std::string(type) +
+            " is provided by multiple components installed with installLazily(). Each type can only be provided by "
+            "one lazily-installed component.");
+    }
+  }
+  lazy_subcomponents.push_back(std::move(state));
+}
+
+const void* InjectorStorage::getLazySubcomponentPtr(TypeId type, Graph::node_iterator node_itr) {
+  // Here we don't need to lock `mutex', it's already locked by the caller.
+  auto itr = lazy_subcomponent_by_provided_type.find(type);
+  FruitAssert(itr != lazy_subcomponent_by_provided_type.end());
+  LazySubcomponentState& state = *itr->second;
+
+  if (state.injector == nullptr) {
+    if (state.expansion_in_progress) {
+      fatal("the type " + std::string(type) +
+            " is provided by a component installed with installLazily(), but injecting the types required by that "
+            "component requires it to be expanded already (there's a dependency loop through the enclosing "
+            "injector).");
+    }
+    // The flag must be reset if the expansion fails (e.g. because the constructor of a required type throws), so
+    // that the expansion can be retried.
+    state.expansion_in_progress = true;
+    try {
+      expandLazySubcomponent(state, node_itr);
+    } catch (...) {
+      state.expansion_in_progress = false;
+      throw;
+    }
+    state.expansion_in_progress = false;
+  }
+
+  InjectorStorage& subcomponent_injector = *state.injector;
+  return subcomponent_injector.getPtrInternal(subcomponent_injector.lazyGetPtr(type));
+}
+
+void InjectorStorage::expandLazySubcomponent(LazySubcomponentState& state, Graph::node_iterator node_itr) {
+  const ComponentStorageEntry::LazySubcomponent::Types& types = *state.entry.lazy_subcomponent.types;
+
+  // The subcomponent is expanded in a separate injector, where the required types are bound to the objects in this
+  // injector. All placeholder bindings depend on all the required types (in the same order), so the edges of
+  // node_itr can be used for this.
+  Graph::node_iterator bindings_begin = bindings.begin();
+  ComponentStorageEntryVector entries(types.required_types->num_deps + 1);
+  for (std::size_t i = 0; i < types.required_types->num_deps; ++i) {
+    ComponentStorageEntry entry;
+    entry.kind = ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT;
+    entry.type_id = types.required_types->deps[i];
+    Graph::node_iterator required_node_itr = node_itr.neighborsBegin().getNodeIterator(i, bindings_begin);
+    entry.binding_for_constructed_object.object_ptr = getPtrInternal(required_node_itr);
+#if FRUIT_EXTRA_DEBUG
+    entry.binding_for_constructed_object.is_nonconst = true;
+#endif
+    entries.push_back(entry);
+  }
+  ComponentStorageEntry component_entry;
+  component_entry.kind = ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_ARGS;
+  component_entry.type_id = state.entry.type_id;
+  component_entry.lazy_component_with_args = state.entry.lazy_subcomponent.component.copy();
+  entries.push_back(component_entry);
+
+  MemoryPool memory_pool;
+  using exposed_types_t = std::vector<TypeId, ArenaAllocator<TypeId>>;
+  exposed_types_t exposed_types =
+      exposed_types_t(types.provided_types->deps, types.provided_types->deps + types.provided_types->num_deps,
+                      ArenaAllocator<TypeId>(memory_pool));
+  std::unique_ptr<InjectorStorage> injector(
+      new InjectorStorage(ComponentStorage(std::move(entries)), exposed_types, memory_pool));
+  allocator.registerExternallyAllocatedObject(injector.get());
+  state.injector = injector.release();
+  if (construction_tracer != nullptr) {
+    state.injector->setConstructionTracer(construction_tracer);
+  }
+  if (allocator.getTeardownPolicy() != fruit::TeardownPolicy::DESTROY_ALL) {
+    state.injector->setTeardownPolicy(allocator.getTeardownPolicy());
+  }
+  if (teardown_threads != 1) {
+    state.injector->setTeardownThreads(teardown_threads);
+  }
+}
+
+const void* InjectorStorage::getPtrInternalWithTracing(Graph::node_iterator node_itr) {
+  // The tracer might be changed by the create() function, e.g. if it injects an Injector and calls
+  // setConstructionTracer() on it; the same tracer must be used for the end of this construction.
+  fruit::ConstructionTracer* tracer = construction_tracer;
+  TypeId type = type_id_by_node_index[bindings.indexOf(node_itr)];
+  NormalizedBinding& normalized_binding = node_itr.getNode();
+  fruit::ConstructionTracer::ConstructionScope scope(tracer);
+  normalized_binding.object = normalized_binding.create(*this, node_itr);
+  FruitAssert(node_itr.isTerminal());
+  construction_ns_by_node_index[bindings.indexOf(node_itr)] = scope.end(type, false /* is_multibinding */);
+  return normalized_binding.object;
+}
+
+void InjectorStorage::ensureConstructedMultibinding(TypeId type, NormalizedMultibindingSet& multibinding_set) {
   for (NormalizedMultibinding& multibinding : multibinding_set.elems) {
     if (!multibinding.is_constructed) {
-      multibinding.object = multibinding.create(*this);
-      multibinding.is_constructed = true;
+      constructMultibinding(type, multibinding);
     }
   }
 }
 
+void InjectorStorage::constructMultibinding(TypeId type, NormalizedMultibinding& multibinding) {
+  fruit::ConstructionTracer* tracer = construction_tracer;
+  if (tracer != nullptr) {
+    fruit::ConstructionTracer::ConstructionScope scope(tracer);
+    multibinding.object = multibinding.create(*this);
+    scope.end(type, true /* is_multibinding */);
+  } else {
+    multibinding.object = multibinding.create(*this);
+  }
+  multibinding.is_constructed = true;
+}
+
+void* InjectorStorage::getMultibindingObject(TypeId type, NormalizedMultibinding& multibinding) {
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  if (!multibinding.is_constructed) {
+    constructMultibinding(type, multibinding);
+  }
+  return multibinding.object;
+}
+
 void* InjectorStorage::getMultibindings(TypeId typeInfo) {
   NormalizedMultibindingSet* multibinding_set = getNormalizedMultibindingSet(typeInfo);
   if (multibinding_set == nullptr) {
+    if (parent != nullptr) {
+      // A child injector has no multibindings of its own.
+      std::lock_guard<std::recursive_mutex> lock(parent->mutex);
+      return parent->getMultibindings(typeInfo);
+    }
     // Not registered.
     return nullptr;
   }
   return multibinding_set->get_multibindings_vector(*this).get();
 }
 
+void InjectorStorage::setConstructionTracer(fruit::ConstructionTracer* tracer) {
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  if (tracer != nullptr && type_id_by_node_index.empty()) {
+    type_id_by_node_index.resize(bindings.size());
+    bindings.forEachNode([this](TypeId type, Graph::node_iterator node_itr) {
+      type_id_by_node_index[bindings.indexOf(node_itr)] = type;
+    });
+  }
+  if (tracer != nullptr && construction_ns_by_node_index.empty()) {
+    // This is kept after the tracer is removed, so that getGraph() can still report these times.
+    construction_ns_by_node_index.resize(bindings.size(), NOT_TRACED);
+  }
+  if (tracer == nullptr) {
+    std::vector<TypeId>().swap(type_id_by_node_index);
+  }
+  construction_tracer = tracer;
+  for (const std::unique_ptr<LazySubcomponentState>& state : lazy_subcomponents) {
+    if (state->injector != nullptr) {
+      state->injector->setConstructionTracer(tracer);
+    }
+  }
+}
+
+void InjectorStorage::setTeardownPolicy(fruit::TeardownPolicy policy) {
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  allocator.setTeardownPolicy(policy);
+  for (const std::unique_ptr<LazySubcomponentState>& state : lazy_subcomponents) {
+    if (state->injector != nullptr) {
+      state->injector->setTeardownPolicy(policy);
+    }
+  }
+}
+
+void InjectorStorage::setTeardownThreads(std::size_t num_threads) {
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  teardown_threads = num_threads;
+  for (const std::unique_ptr<LazySubcomponentState>& state : lazy_subcomponents) {
+    if (state->injector != nullptr) {
+      state->injector->setTeardownThreads(num_threads);
+    }
+  }
+}
+
+std::unique_lock<std::recursive_mutex> InjectorStorage::lockAndCountLookup(TypeId type, LookupKind kind) {
+  std::unique_lock<std::recursive_mutex> lock(mutex, std::try_to_lock);
+  std::uint64_t wait_ns = 0;
+  if (!lock.owns_lock()) {
+    Stopwatch stopwatch;
+    lock.lock();
+    wait_ns = stopwatch.elapsedNs();
+  }
+  // Lookup counting might have been disabled while we were waiting, in that case we don't count this lookup.
+  if (lookup_counting.load(std::memory_order_relaxed)) {
+    if (wait_ns != 0) {
+      ++num_contended_lookups;
+      mutex_wait_ns += wait_ns;
+      max_mutex_wait_ns = std::max(max_mutex_wait_ns, wait_ns);
+    }
+    LookupCounters& counters = lookup_counters_by_type[type];
+    switch (kind) {
+    case LookupKind::GET:
+      ++counters.num_gets;
+      break;
+    case LookupKind::UNSAFE_GET:
+      ++counters.num_unsafe_gets;
+      break;
+    case LookupKind::MULTIBINDINGS:
+      ++counters.num_multibinding_gets;
+      break;
+    }
+  }
+  return lock;
+}
+
+void InjectorStorage::setLookupCounting(bool enabled) {
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  lookup_counting.store(enabled, std::memory_order_relaxed);
+}
+
+fruit::LookupStats InjectorStorage::getLookupStats() {
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  fruit::LookupStats lookup_stats;
+  lookup_stats.types.reserve(lookup_counters_by_type.size());
+  for (const auto& p : lookup_counters_by_type) {
+    fruit::LookupStats::TypeLookups type_lookups;
+    type_lookups.type_name = std::string(p.first);
+    type_lookups.num_gets = p.second.num_gets;
+    type_lookups.num_unsafe_gets = p.second.num_unsafe_gets;
+    type_lookups.num_multibinding_gets = p.second.num_multibinding_gets;
+    lookup_stats.num_lookups += p.second.num_gets + p.second.num_unsafe_gets + p.second.num_multibinding_gets;
+    lookup_stats.types.push_back(std::move(type_lookups));
+  }
+  std::sort(lookup_stats.types.begin(), lookup_stats.types.end(),
+            [](const fruit::LookupStats::TypeLookups& x, const fruit::LookupStats::TypeLookups& y) {
+              std::size_t x_total = x.num_gets + x.num_unsafe_gets + x.num_multibinding_gets;
+              std::size_t y_total = y.num_gets + y.num_unsafe_gets + y.num_multibinding_gets;
+              // Ties are broken by name so that the order is deterministic.
+              return x_total > y_total || (x_total == y_total && x.type_name < y.type_name);
+            });
+  lookup_stats.num_contended_lookups = num_contended_lookups;
+  lookup_stats.mutex_wait_ns = mutex_wait_ns;
+  lookup_stats.max_mutex_wait_ns = max_mutex_wait_ns;
+  return lookup_stats;
+}
+
+void InjectorStorage::clearLookupStats() {
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  lookup_counters_by_type.clear();
+  num_contended_lookups = 0;
+  mutex_wait_ns = 0;
+  max_mutex_wait_ns = 0;
+}
+
+fruit::MemoryUsage InjectorStorage::getMemoryUsage() {
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  fruit::MemoryUsage memory_usage;
+  addMemoryUsage(memory_usage);
+  return memory_usage;
+}
+
+void InjectorStorage::addMemoryUsage(fruit::MemoryUsage& memory_usage) {
+  memory_usage.graph_nodes_bytes += bindings.getNodesBytes();
+  memory_usage.graph_edges_bytes += bindings.getEdgesBytes();
+  memory_usage.graph_lookup_table_bytes += bindings.getNodeIndexLookupTableBytes();
+  memory_usage.graph_values_bytes += bindings.getNodeIndexValuesBytes();
+  memory_usage.multibindings_bytes += NormalizedComponentStorage::getMultibindingsBytes(multibindings);
+  memory_usage.allocator_reserved_bytes += allocator.getReservedBytes();
+  memory_usage.allocator_used_bytes += allocator.getUsedBytes();
+  memory_usage.allocator_destruction_list_bytes += allocator.getDestructionListBytes();
+  memory_usage.factory_arena_bytes += factory_arena.getAllocatedBytes();
+
+  if (normalized_component_storage_ptr != nullptr) {
+    // Only the graph is still used after construction, but the whole object is retained.
+    normalized_component_storage_ptr->addMemoryUsage(memory_usage);
+  }
+
+  bindings.forEachNode([this, &memory_usage](TypeId type, Graph::node_iterator node_itr) {
+    if (!node_itr.isTerminal() && node_infos[bindings.indexOf(node_itr)].needs_allocation) {
+      memory_usage.unconstructed_types.push_back(std::string(type));
+    }
+  });
+  for (const auto& p : multibindings) {
+    for (const NormalizedMultibinding& multibinding : p.second.elems) {
+      if (!multibinding.is_constructed && multibinding.needs_allocation) {
+        memory_usage.unconstructed_types.push_back(std::string(p.first));
+      }
+    }
+  }
+
+  // The injectors of lazy subcomponents are only accessed while holding the lock on `mutex', so we don't need to lock
+  // them here.
+  for (const std::unique_ptr<LazySubcomponentState>& state : lazy_subcomponents) {
+    if (state->injector != nullptr) {
+      state->injector->addMemoryUsage(memory_usage);
+    }
+  }
+}
+
+fruit::InjectorGraph InjectorStorage::getGraph() {
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  const std::size_t none = static_cast<std::size_t>(-1);
+  fruit::InjectorGraph graph;
+
+  // Maps bindings.indexOf(node_itr) to the index of the node in graph.nodes.
+  std::vector<std::size_t> graph_index_by_node_index(bindings.size(), none);
+
+  bindings.forEachNode([&](TypeId type, Graph::node_iterator node_itr) {
+    std::size_t node_index = bindings.indexOf(node_itr);
+    const NormalizedBindingInfo& info = node_infos[node_index];
+    graph_index_by_node_index[node_index] = graph.nodes.size();
+
+    fruit::InjectorGraph::Node node;
+    node.type_name = std::string(type);
+    if (lazy_subcomponent_by_provided_type.count(type) != 0) {
+      node.kind = fruit::InjectorGraph::BindingKind::LAZY_SUBCOMPONENT;
+    } else if (info.deps == nullptr) {
+      node.kind = fruit::InjectorGraph::BindingKind::INSTANCE;
+    } else if (info.needs_allocation) {
+      node.kind = fruit::InjectorGraph::BindingKind::CONSTRUCTED_IN_INJECTOR;
+    } else {
+      node.kind = fruit::InjectorGraph::BindingKind::CONSTRUCTED_OUTSIDE_INJECTOR;
+    }
+    node.is_compressed = info.is_compressed;
+    node.is_constructed = node_itr.isTerminal();
+    node.has_construction_time = !construction_ns_by_node_index.empty() &&
+                                 construction_ns_by_node_index[node_index] != NOT_TRACED;
+    node.construction_ns = node.has_construction_time ? construction_ns_by_node_index[node_index] : 0;
+    graph.nodes.push_back(std::move(node));
+  });
+
+  // The edges in `bindings' are lost once the objects are constructed, so we use the deps in node_infos instead.
+  bindings.forEachNode([&](TypeId, Graph::node_iterator node_itr) {
+    std::size_t node_index = bindings.indexOf(node_itr);
+    const BindingDeps* deps = node_infos[node_index].deps;
+    if (deps == nullptr) {
+      return;
+    }
+    fruit::InjectorGraph::Node& node = graph.nodes[graph_index_by_node_index[node_index]];
+    for (std::size_t i = 0; i < deps->num_deps; ++i) {
+      Graph::node_iterator dep_itr = bindings.find(deps->deps[i]);
+      if (!(dep_itr == bindings.end()) && graph_index_by_node_index[bindings.indexOf(dep_itr)] != none) {
+        node.dependencies.push_back(graph_index_by_node_index[bindings.indexOf(dep_itr)]);
+      }
+    }
+  });
+
+  return graph;
+}
+
+std::shared_future<void> InjectorStorage::prefetch(std::vector<TypeId> types, bool include_multibindings) {
+  std::shared_future<void> result = std::async(std::launch::async, &InjectorStorage::prefetchInCurrentThread, this,
+                                               std::move(types), include_multibindings)
+                                        .share();
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  // We only keep the prefetches that might still be in progress.
+  prefetches.erase(std::remove_if(prefetches.begin(), prefetches.end(),
+                                  [](const std::shared_future<void>& prefetch) {
+                                    return prefetch.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                                  }),
+                   prefetches.end());
+  prefetches.push_back(result);
+  return result;
+}
+
+void InjectorStorage::prefetchInCurrentThread(const std::vector<TypeId>& types, bool include_multibindings) {
+  for (TypeId type : types) {
+    std::vector<Graph::node_iterator> nodes;
+    {
+      std::lock_guard<std::recursive_mutex> lock(mutex);
+      std::vector<bool> visited(bindings.size());
+      findUnconstructedDependencies(lazyGetPtr(type), visited, nodes);
+    }
+    // The lock is released after constructing each object, so that other threads can use the injector in the
+    // meantime. Since the dependencies of each node come before it, constructing a node only constructs that object
+    // (unless another thread is constructing objects too).
+    for (Graph::node_iterator node_itr : nodes) {
+      std::lock_guard<std::recursive_mutex> lock(mutex);
+      getPtrInternal(node_itr);
+    }
+  }
+
+  if (include_multibindings) {
+    std::vector<TypeId> multibinding_types;
+    {
+      std::lock_guard<std::recursive_mutex> lock(mutex);
+      for (const auto& p : multibindings) {
+        multibinding_types.push_back(p.first);
+      }
+    }
+    for (TypeId type : multibinding_types) {
+      std::lock_guard<std::recursive_mutex> lock(mutex);
+      getMultibindings(type);
+    }
+  }
+}
+
+void InjectorStorage::findUnconstructedDependencies(Graph::node_iterator node_itr, std::vector<bool>& visited,
+                                                    std::vector<Graph::node_iterator>& nodes) {
+  std::size_t node_index = bindings.indexOf(node_itr);
+  if (node_itr.isTerminal() || visited[node_index]) {
+    return;
+  }
+  visited[node_index] = true;
+  const BindingDeps* deps = node_infos[node_index].deps;
+  if (deps != nullptr) {
+    for (std::size_t i = 0; i < deps->num_deps; ++i) {
+      Graph::node_iterator dep_itr = bindings.find(deps->deps[i]);
+      if (!(dep_itr == bindings.end())) {
+        findUnconstructedDependencies(dep_itr, visited, nodes);
+      }
+    }
+  }
+  nodes.push_back(node_itr);
+}
+
 void InjectorStorage::eagerlyInjectMultibindings() {
   std::lock_guard<std::recursive_mutex> lock(mutex);
   for (auto& typeInfoInfoPair : multibindings) {
@@ -30,6 +30,7 @@
 #include <fruit/impl/data_structures/semistatic_map.templates.h>
 #include <fruit/impl/injector/injector_storage.h>
 #include <fruit/impl/normalized_component_storage/binding_normalization.h>
+#include <fruit/impl/util/stopwatch.h>
 
 using std::cout;
 using std::endl;
@@ -55,15 +56,17 @@ NormalizedComponentStorage::NormalizedComponentStorage(ComponentStorage&& compon
       component_with_args_replacements(
           createLazyComponentWithArgsReplacementMap(0 /* capacity */, normalized_component_memory_pool)) {
 
+  Stopwatch stopwatch;
   using bindings_vector_t = std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>;
   bindings_vector_t bindings_vector = bindings_vector_t(ArenaAllocator<ComponentStorageEntry>(memory_pool));
-  BindingNormalization::normalizeBindingsWithPermanentBindingCompression(std::move(component).release(),
-                                                                         fixed_size_allocator_data, memory_pool,
-                                                                         exposed_types, bindings_vector, multibindings);
-
-  bindings = SemistaticGraph<TypeId, NormalizedBinding>(InjectorStorage::BindingDataNodeIter{bindings_vector.begin()},
-                                                        InjectorStorage::BindingDataNodeIter{bindings_vector.end()},
-                                                        memory_pool);
+  std::vector<TypeId, ArenaAllocator<TypeId>> compressed_type_ids =
+      std::vector<TypeId, ArenaAllocator<TypeId>>(ArenaAllocator<TypeId>(memory_pool));
+  BindingNormalization::normalizeBindingsWithPermanentBindingCompression(
+      std::move(component).release(), fixed_size_allocator_data, memory_pool, exposed_types, bindings_vector,
+      compressed_type_ids, multibindings, lazy_subcomponents, normalization_stats);
+
+  createGraph(bindings_vector, compressed_type_ids, memory_pool);
+  normalization_stats.total_ns = stopwatch.elapsedNs();
 }
 
 NormalizedComponentStorage::NormalizedComponentStorage(ComponentStorage&& component,
@@ -81,17 +84,50 @@ NormalizedComponentStorage::NormalizedComponentStorage(ComponentStorage&& compon
       component_with_args_replacements(
           createLazyComponentWithArgsReplacementMap(20 /* capacity */, normalized_component_memory_pool)) {
 
+  Stopwatch stopwatch;
   using bindings_vector_t = std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>;
   bindings_vector_t bindings_vector = bindings_vector_t(ArenaAllocator<ComponentStorageEntry>(memory_pool));
   BindingNormalization::normalizeBindingsWithUndoableBindingCompression(
       std::move(component).release(), fixed_size_allocator_data, memory_pool, normalized_component_memory_pool,
       normalized_component_memory_pool, exposed_types, bindings_vector, multibindings, binding_compression_info_map,
       fully_expanded_components_with_no_args, fully_expanded_components_with_args, component_with_no_args_replacements,
-      component_with_args_replacements);
+      component_with_args_replacements, lazy_subcomponents, normalization_stats);
 
+  std::vector<TypeId, ArenaAllocator<TypeId>> compressed_type_ids =
+      std::vector<TypeId, ArenaAllocator<TypeId>>(ArenaAllocator<TypeId>(memory_pool));
+  compressed_type_ids.reserve(binding_compression_info_map.size());
+  for (const auto& p : binding_compression_info_map) {
+    compressed_type_ids.push_back(p.second.i_type_id);
+  }
+
+  createGraph(bindings_vector, compressed_type_ids, memory_pool);
+  normalization_stats.total_ns = stopwatch.elapsedNs();
+}
+
+void NormalizedComponentStorage::createGraph(
+    std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& bindings_vector,
+    const std::vector<TypeId, ArenaAllocator<TypeId>>& compressed_type_ids, MemoryPool& memory_pool) {
+  Stopwatch stopwatch;
   bindings = SemistaticGraph<TypeId, NormalizedBinding>(InjectorStorage::BindingDataNodeIter{bindings_vector.begin()},
                                                         InjectorStorage::BindingDataNodeIter{bindings_vector.end()},
                                                         memory_pool);
+  node_infos.resize(bindings.size());
+  for (const ComponentStorageEntry& entry : bindings_vector) {
+    NormalizedBindingInfo& info = node_infos[bindings.indexOf(bindings.at(entry.type_id))];
+    if (entry.kind != ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT) {
+      info.deps = entry.binding_for_object_to_construct.deps;
+      info.needs_allocation =
+          entry.kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION;
+    }
+  }
+  for (TypeId type_id : compressed_type_ids) {
+    node_infos[bindings.indexOf(bindings.at(type_id))].is_compressed = true;
+  }
+  normalization_stats.graph_construction_ns += stopwatch.elapsedNs();
+  normalization_stats.num_graph_nodes = bindings.size();
+  normalization_stats.num_hash_function_retries = bindings.getNumHashFunctionRetries();
+  normalization_stats.allocator_reserved_bytes = fixed_size_allocator_data.getTotalSize();
+  normalization_stats.allocator_num_types_to_destroy = fixed_size_allocator_data.getNumTypesToDestroy();
 }
 
 NormalizedComponentStorage::~NormalizedComponentStorage() {
@@ -111,6 +147,10 @@ NormalizedComponentStorage::~NormalizedComponentStorage() {
     replacement_component.destroy();
   }
 
+  for (const ComponentStorageEntry& entry : lazy_subcomponents) {
+    entry.destroy();
+  }
+
   // We must free all the memory in these before the normalized_component_memory_pool is destroyed.
   binding_compression_info_map = createHashMapWithArenaAllocator<TypeId, CompressedBindingUndoInfo>(
       0 /* capacity */, normalized_component_memory_pool);
@@ -124,6 +164,25 @@ NormalizedComponentStorage::~NormalizedComponentStorage() {
       createLazyComponentWithArgsReplacementMap(0 /* capacity */, normalized_component_memory_pool);
 }
 
+void NormalizedComponentStorage::addMemoryUsage(fruit::MemoryUsage& memory_usage) const {
+  memory_usage.graph_nodes_bytes += bindings.getNodesBytes();
+  memory_usage.graph_edges_bytes += bindings.getEdgesBytes();
+  memory_usage.graph_lookup_table_bytes += bindings.getNodeIndexLookupTableBytes();
+  memory_usage.graph_values_bytes += bindings.getNodeIndexValuesBytes();
+  memory_usage.multibindings_bytes += getMultibindingsBytes(multibindings);
+  memory_usage.memory_pool_bytes += normalized_component_memory_pool.getAllocatedBytes();
+}
+
+std::size_t NormalizedComponentStorage::getMultibindingsBytes(
+    const std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings) {
+  std::size_t bytes = multibindings.bucket_count() * sizeof(void*);
+  for (const auto& p : multibindings) {
+    // Each element is stored in a separate node, together with (at least) a pointer to the next node.
+    bytes += sizeof(p) + sizeof(void*) + p.second.elems.capacity() * sizeof(NormalizedMultibinding);
+  }
+  return bytes;
+}
+
 } // namespace impl
 // We need a LCOV_EXCL_BR_LINE below because for some reason gcov/lcov think there's a branch there.
 } // namespace fruit LCOV_EXCL_BR_LINE
@@ -33,5 +33,15 @@ NormalizedComponentStorageHolder::NormalizedComponentStorageHolder(
 
 NormalizedComponentStorageHolder::~NormalizedComponentStorageHolder() {}
 
+const fruit::NormalizationStats& NormalizedComponentStorageHolder::getNormalizationStats() const {
+  return storage->normalization_stats;
+}
+
+fruit::MemoryUsage NormalizedComponentStorageHolder::getMemoryUsage() const {
+  fruit::MemoryUsage memory_usage;
+  storage->addMemoryUsage(memory_usage);
+  return memory_usage;
+}
+
 } // namespace impl
 } // namespace fruit
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define IN_FRUIT_CPP_FILE 1
+
+#include <fruit/impl/data_structures/object_arena.h>
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace fruit::impl;
+
+constexpr const std::size_t ObjectArena::INITIAL_CHUNK_SIZE;
+constexpr const std::size_t ObjectArena::MAX_CHUNK_SIZE;
+
+ObjectArena::~ObjectArena() {
+  clear();
+}
+
+void ObjectArena::clear() {
+  std::vector<std::pair<destroy_t, void*>> objects;
+  std::vector<void*> chunks;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    objects.swap(on_destruction);
+    chunks.swap(allocated_chunks);
+    first_free = nullptr;
+    capacity = 0;
+    next_chunk_size = INITIAL_CHUNK_SIZE;
+    allocated_bytes = 0;
+  }
+  // The objects are destroyed without holding the lock, in reverse order of construction.
+  for (auto i = objects.rbegin(), i_end = objects.rend(); i != i_end; ++i) {
+    destroy_t destroy = i->first;
+    void* p = i->second;
+    destroy(p);
+  }
+  for (void* chunk : chunks) {
+    operator delete(chunk);
+  }
+}
+
+std::size_t ObjectArena::getAllocatedBytes() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return allocated_bytes;
+}
+
+void* ObjectArena::allocate(std::size_t size, std::size_t alignment) {
+  if (size == 0) {
+    size = 1;
+  }
+  std::size_t padding = (alignment - std::uintptr_t(first_free) % alignment) % alignment;
+  if (first_free == nullptr || padding + size > capacity) {
+    std::size_t chunk_size = next_chunk_size;
+    next_chunk_size = std::min(2 * next_chunk_size + 64, MAX_CHUNK_SIZE);
+    if (size + alignment > chunk_size) {
+      chunk_size = size + alignment;
+    }
+    // This is to make sure that the push_back below won't throw.
+    allocated_chunks.reserve(allocated_chunks.size() + 1);
+    char* chunk = static_cast<char*>(operator new(chunk_size));
+    allocated_chunks.push_back(chunk);
+    allocated_bytes += chunk_size;
+    first_free = chunk;
+    capacity = chunk_size;
+    padding = (alignment - std::uintptr_t(first_free) % alignment) % alignment;
+  }
+  void* p = first_free + padding;
+  first_free += padding + size;
+  capacity -= padding + size;
+  return p;
+}
+
+void ObjectArena::registerObjectToDestroy(destroy_t destroy, void* p) {
+  std::lock_guard<std::mutex> lock(mutex);
+  on_destruction.emplace_back(destroy, p);
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define IN_FRUIT_CPP_FILE 1
+
+#include <fruit/impl/util/parallel_task_graph.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace fruit {
+namespace impl {
+
+ParallelTaskGraph::ParallelTaskGraph(std::size_t num_tasks) : successors(num_tasks), num_predecessors(num_tasks, 0) {}
+
+void ParallelTaskGraph::addOrdering(std::size_t before, std::size_t after) {
+  successors[before].push_back(after);
+  ++num_predecessors[after];
+}
+
+std::vector<std::size_t> ParallelTaskGraph::run(std::size_t num_threads,
+                                                const std::function<void(std::size_t)>& run_task) {
+  std::mutex mutex;
+  std::condition_variable cond;
+  // The tasks whose predecessors have all completed, that haven't been started yet.
+  std::vector<std::size_t> ready_tasks;
+  std::size_t num_running_tasks = 0;
+  std::vector<std::size_t> num_remaining_predecessors = num_predecessors;
+  std::vector<bool> done(successors.size(), false);
+
+  for (std::size_t i = 0; i < successors.size(); ++i) {
+    if (num_remaining_predecessors[i] == 0) {
+      ready_tasks.push_back(i);
+    }
+  }
+
+  auto worker = [&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      cond.wait(lock, [&]() { return !ready_tasks.empty() || num_running_tasks == 0; });
+      if (ready_tasks.empty()) {
+        // Nothing is ready and no running task can make anything ready, so we're done.
+        return;
+      }
+      std::size_t task = ready_tasks.back();
+      ready_tasks.pop_back();
+      ++num_running_tasks;
+      lock.unlock();
+      run_task(task);
+      lock.lock();
+      --num_running_tasks;
+      done[task] = true;
+      for (std::size_t successor : successors[task]) {
+        if (--num_remaining_predecessors[successor] == 0) {
+          ready_tasks.push_back(successor);
+        }
+      }
+      cond.notify_all();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < num_threads && i < successors.size(); ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  std::vector<std::size_t> tasks_not_run;
+  for (std::size_t i = 0; i < done.size(); ++i) {
+    if (!done[i]) {
+      tasks_not_run.push_back(i);
+    }
+  }
+  return tasks_not_run;
+}
+
+} // namespace impl
+} // namespace fruit
@@ -0,0 +1,251 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+
+    #define IN_FRUIT_CPP_FILE 1
+    #include <fruit/impl/data_structures/flat_hash_table.h>
+
+    #include <set>
+    #include <stdexcept>
+
+    using namespace std;
+    using namespace fruit::impl;
+
+    using IntSet = FlatHashSet<int, std::hash<int>, std::equal_to<int>>;
+    using IntToStringMap = FlatHashMap<int, std::string, std::hash<int>, std::equal_to<int>>;
+
+    // A hasher that makes all elements collide, to exercise the probing.
+    struct ConstantHash {
+      std::size_t operator()(int) const {
+        return 42;
+      }
+    };
+    '''
+
+def test_empty():
+    source = '''
+        int main() {
+          MemoryPool memory_pool;
+          IntSet set(0, std::hash<int>(), std::equal_to<int>(), memory_pool);
+          Assert(set.empty());
+          Assert(set.size() == 0);
+          Assert(set.begin() == set.end());
+          Assert(set.find(5) == set.end());
+          Assert(set.count(5) == 0);
+          Assert(set.erase(5) == 0);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_insert_and_find():
+    source = '''
+        int main() {
+          MemoryPool memory_pool;
+          IntSet set(10, std::hash<int>(), std::equal_to<int>(), memory_pool);
+          Assert(set.insert(2).second);
+          Assert(set.insert(7).second);
+          Assert(!set.insert(2).second);
+          Assert(*set.insert(7).first == 7);
+          Assert(set.size() == 2);
+          Assert(set.count(2) == 1);
+          Assert(set.count(7) == 1);
+          Assert(set.count(3) == 0);
+          Assert(*set.find(7) == 7);
+          Assert(set.find(3) == set.end());
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+@pytest.mark.parametrize('HasherType', [
+    'std::hash<int>',
+    'ConstantHash',
+])
+def test_grow(HasherType):
+    source = '''
+        int main() {
+          MemoryPool memory_pool;
+          FlatHashSet<int, HasherType, std::equal_to<int>> set(1, HasherType(), std::equal_to<int>(), memory_pool);
+          for (int i = 0; i < 1000; ++i) {
+            Assert(set.insert(i * 8).second);
+          }
+          Assert(set.size() == 1000);
+          for (int i = 0; i < 1000; ++i) {
+            Assert(set.count(i * 8) == 1);
+            Assert(set.count(i * 8 + 1) == 0);
+          }
+          std::set<int> elems;
+          for (int x : set) {
+            elems.insert(x);
+          }
+          Assert(elems.size() == 1000);
+          Assert(*elems.begin() == 0);
+          Assert(*elems.rbegin() == 999 * 8);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+@pytest.mark.parametrize('HasherType', [
+    'std::hash<int>',
+    'ConstantHash',
+])
+def test_erase_and_reinsert(HasherType):
+    source = '''
+        int main() {
+          MemoryPool memory_pool;
+          FlatHashSet<int, HasherType, std::equal_to<int>> set(10, HasherType(), std::equal_to<int>(), memory_pool);
+          // Many more insertions and erasures than the capacity, so that the DELETED slots have to be cleaned up.
+          for (int i = 0; i < 500; ++i) {
+            Assert(set.insert(i).second);
+            Assert(set.insert(i + 1000).second);
+            Assert(set.erase(i) == 1);
+            Assert(set.erase(i) == 0);
+          }
+          Assert(set.size() == 500);
+          for (int i = 0; i < 500; ++i) {
+            Assert(set.count(i) == 0);
+            Assert(set.count(i + 1000) == 1);
+          }
+          set.erase(set.find(1000));
+          Assert(set.count(1000) == 0);
+          Assert(set.size() == 499);
+          set.clear();
+          Assert(set.empty());
+          Assert(set.begin() == set.end());
+          Assert(set.insert(1001).second);
+          Assert(set.size() == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_map():
+    source = '''
+        int main() {
+          MemoryPool memory_pool;
+          IntToStringMap map(2, std::hash<int>(), std::equal_to<int>(), memory_pool);
+          map[1] = "foo";
+          Assert(map.insert(std::make_pair(2, "bar")).second);
+          Assert(!map.insert(std::make_pair(2, "baz")).second);
+          Assert(map[3] == "");
+          for (int i = 4; i < 100; ++i) {
+            map[i] = std::to_string(i);
+          }
+          Assert(map.size() == 99);
+          Assert(map.at(1) == "foo");
+          Assert(map.at(2) == "bar");
+          Assert(map.find(3)->second == "");
+          Assert(map.at(42) == "42");
+          Assert(map.find(100) == map.end());
+
+          const IntToStringMap& const_map = map;
+          Assert(const_map.at(1) == "foo");
+          Assert(const_map.find(2)->second == "bar");
+          std::size_t num_elems = 0;
+          for (const auto& p : const_map) {
+            Assert(p.first != 2 || p.second == "bar");
+            ++num_elems;
+          }
+          Assert(num_elems == 99);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_insert_with_throwing_constructor():
+    source = '''
+        static bool should_throw = true;
+
+        struct ThrowingValue {
+          ThrowingValue() {
+            if (should_throw) {
+              throw std::runtime_error("construction failed");
+            }
+          }
+        };
+
+        using IntToThrowingValueMap = FlatHashMap<int, ThrowingValue, std::hash<int>, std::equal_to<int>>;
+
+        int main() {
+          MemoryPool memory_pool;
+          IntToThrowingValueMap map(0, std::hash<int>(), std::equal_to<int>(), memory_pool);
+          for (int i = 0; i < 100; ++i) {
+            try {
+              map[i];
+              Assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            Assert(map.empty());
+            Assert(map.count(i) == 0);
+            Assert(map.begin() == map.end());
+          }
+          should_throw = false;
+          for (int i = 0; i < 100; ++i) {
+            map[i];
+          }
+          Assert(map.size() == 100);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_move():
+    source = '''
+        int main() {
+          MemoryPool memory_pool;
+          IntToStringMap map1(10, std::hash<int>(), std::equal_to<int>(), memory_pool);
+          map1[1] = "foo";
+          IntToStringMap map2(std::move(map1));
+          Assert(map2.size() == 1);
+          Assert(map2.at(1) == "foo");
+
+          IntToStringMap map3(10, std::hash<int>(), std::equal_to<int>(), memory_pool);
+          map3[2] = "bar";
+          map3 = std::move(map2);
+          Assert(map3.size() == 1);
+          Assert(map3.at(1) == "foo");
+          Assert(map3.count(2) == 0);
+
+          // A moved-from map can still be used.
+          map2[5] = "baz";
+          Assert(map2.size() == 1);
+          Assert(map2.at(5) == "baz");
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+if __name__ == '__main__':
+    main(__file__)
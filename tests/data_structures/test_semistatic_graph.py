@@ -347,6 +347,64 @@ def test_move_assignment():
         source,
         locals())
 
+def test_nodes_with_same_edges_range():
+    source = '''
+        struct PointerNode {
+          int id;
+          const char* value;
+          const int* neighbors_begin;
+          const int* neighbors_end;
+
+          int getId() { return id; }
+          const char* getValue() { return value; }
+          bool isTerminal() { return false; }
+          const int* getEdgesBegin() { return neighbors_begin; }
+          const int* getEdgesEnd() { return neighbors_end; }
+        };
+
+        int main() {
+          MemoryPool memory_pool;
+          int neighbors[] = {4, 5};
+          int other_neighbors[] = {5, 4};
+          vector<PointerNode> values{
+            {1, "foo", neighbors, neighbors + 2},
+            {2, "bar", neighbors, neighbors + 2},
+            {3, "baz", other_neighbors, other_neighbors + 2},
+            {4, "qux", neighbors, neighbors},
+            {5, "quux", neighbors, neighbors + 1},
+          };
+
+          Graph graph(values.begin(), values.end(), memory_pool);
+          for (int id : {1, 2}) {
+            edge_iterator itr = graph.at(id).neighborsBegin();
+            Assert(itr.getNodeIterator(graph.begin()).getNode() == string("qux"));
+            ++itr;
+            Assert(itr.getNodeIterator(graph.begin()).getNode() == string("quux"));
+          }
+          edge_iterator itr = graph.at(3).neighborsBegin();
+          Assert(itr.getNodeIterator(graph.begin()).getNode() == string("quux"));
+          ++itr;
+          Assert(itr.getNodeIterator(graph.begin()).getNode() == string("qux"));
+          Assert(graph.at(5).neighborsBegin().getNodeIterator(graph.begin()).getNode() == string("qux"));
+
+          vector<PointerNode> new_values{
+            {6, "corge", other_neighbors, other_neighbors + 2},
+            {7, "grault", other_neighbors, other_neighbors + 2},
+          };
+          Graph extended_graph(graph, new_values.begin(), new_values.end(), memory_pool);
+          for (int id : {3, 6, 7}) {
+            edge_iterator itr = extended_graph.at(id).neighborsBegin();
+            Assert(itr.getNodeIterator(extended_graph.begin()).getNode() == string("quux"));
+            ++itr;
+            Assert(itr.getNodeIterator(extended_graph.begin()).getNode() == string("qux"));
+          }
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
 def test_incomplete_graph():
     source = '''
         int main() {
@@ -210,5 +210,43 @@ def test_move_assignment():
         source,
         locals())
 
+def test_diagnostics():
+    source = '''
+        int main() {
+          MemoryPool memory_pool;
+          vector<pair<int, std::string>> values{{1, "1"}, {3, "3"}, {5, "5"}};
+          SemistaticMap<int, std::string> old_map(values.begin(), values.end(), values.size(), memory_pool);
+          SemistaticMapDiagnostics old_diagnostics = old_map.getDiagnostics();
+          Assert(old_diagnostics.num_values == 3);
+          Assert(old_diagnostics.num_buckets == 8);
+          Assert(old_diagnostics.getLoadFactor() == 3.0 / 8);
+          Assert(old_diagnostics.num_wasted_values == 0);
+          std::size_t num_buckets = 0;
+          std::size_t num_values = 0;
+          for (std::size_t i = 0; i < old_diagnostics.bucket_size_histogram.size(); ++i) {
+            num_buckets += old_diagnostics.bucket_size_histogram[i];
+            num_values += i * old_diagnostics.bucket_size_histogram[i];
+          }
+          Assert(num_buckets == 8);
+          Assert(num_values == 3);
+
+          vector<pair<int, std::string>, ArenaAllocator<pair<int, std::string>>> new_values(
+              {{2, "2"}, {4, "4"}, {16, "16"}},
+              ArenaAllocator<pair<int, std::string>>(memory_pool));
+          SemistaticMap<int, std::string> map(old_map, std::move(new_values));
+          SemistaticMapDiagnostics diagnostics = map.getDiagnostics();
+          Assert(diagnostics.num_hash_function_retries == 0);
+          Assert(diagnostics.num_values == 6);
+          Assert(diagnostics.num_buckets == 8);
+          // The old elements in the buckets of the new ones are copied, so at most 3 slots are wasted.
+          Assert(diagnostics.num_wasted_values <= 3);
+          Assert(map.getValuesBytes() == (3 + diagnostics.num_wasted_values) * sizeof(pair<int, std::string>));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
 if __name__ == '__main__':
     main(__file__)
@@ -0,0 +1,248 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+import pytest
+
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+
+    #include <thread>
+
+    struct Annotation1 {};
+
+    struct Request {
+      int id;
+    };
+
+    struct X : public ConstructionTracker<X> {
+      INJECT(X()) = default;
+    };
+
+    struct Y : public ConstructionTracker<Y> {
+      INJECT(Y(X*)) {}
+    };
+
+    fruit::Component<X, Y> getParentComponent() {
+      return fruit::createComponent();
+    }
+    '''
+
+def test_child_injector_shares_parent_singletons():
+    source = '''
+        int main() {
+          fruit::Injector<X, Y> parent(getParentComponent);
+          X* x = parent.get<X*>();
+          Assert(X::num_objects_constructed == 1);
+
+          for (int i = 0; i < 3; ++i) {
+            Request request{i};
+            fruit::Injector<X, Y, Request> child(parent, request);
+            Assert(child.get<X*>() == x);
+            Assert(child.get<Request*>() == &request);
+            Assert(child.get<Request&>().id == i);
+
+            // Y is constructed by the parent (once), the first time that it's requested by any child.
+            Assert(child.get<Y*>() == parent.get<Y*>());
+          }
+          Assert(X::num_objects_constructed == 1);
+          Assert(Y::num_objects_constructed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_child_injector_constructs_lazily_in_parent():
+    source = '''
+        int main() {
+          fruit::Injector<X, Y> parent(getParentComponent);
+          Request request{1};
+          fruit::Injector<Y, Request> child(parent, request);
+          Assert(X::num_objects_constructed == 0);
+          Assert(Y::num_objects_constructed == 0);
+
+          Y* y = child.get<Y*>();
+          Assert(X::num_objects_constructed == 1);
+          Assert(Y::num_objects_constructed == 1);
+          Assert(parent.get<Y*>() == y);
+
+          fruit::Provider<Y> provider = child.get<fruit::Provider<Y>>();
+          Assert(provider.get() == y);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+@pytest.mark.parametrize('XAnnot,XPtrAnnot', [
+    ('X', 'X*'),
+    ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation1, X*>'),
+])
+def test_child_injector_annotated(XAnnot, XPtrAnnot):
+    source = '''
+        fruit::Component<XAnnot> getAnnotatedParentComponent() {
+          return fruit::createComponent()
+            .registerConstructor<XAnnot()>();
+        }
+
+        int main() {
+          fruit::Injector<XAnnot> parent(getAnnotatedParentComponent);
+          Request request{1};
+          fruit::Injector<XAnnot, Request> child(parent, request);
+          Assert(child.get<XPtrAnnot>() == parent.get<XPtrAnnot>());
+          Assert(X::num_objects_constructed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_child_injector_const_instance():
+    source = '''
+        int main() {
+          fruit::Injector<X, Y> parent(getParentComponent);
+          const Request request{5};
+          fruit::Injector<X, const Request> child(parent, request);
+          Assert(child.get<const Request*>() == &request);
+          Assert(child.get<const Request&>().id == 5);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_child_injector_multiple_instances():
+    source = '''
+        struct Session {};
+
+        int main() {
+          fruit::Injector<X, Y> parent(getParentComponent);
+          Request request{1};
+          Session session;
+          fruit::Injector<Request, Session> child(parent, request, session);
+          Assert(child.get<Request*>() == &request);
+          Assert(child.get<Session*>() == &session);
+          Assert(X::num_objects_constructed == 0);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_child_injector_multibindings_from_parent():
+    source = '''
+        struct Listener {
+          virtual ~Listener() = default;
+        };
+
+        struct ListenerImpl : public Listener {
+          INJECT(ListenerImpl()) = default;
+        };
+
+        fruit::Component<X> getParentComponentWithMultibindings() {
+          return fruit::createComponent()
+            .addMultibinding<Listener, ListenerImpl>();
+        }
+
+        int main() {
+          fruit::Injector<X> parent(getParentComponentWithMultibindings);
+          Request request{1};
+          fruit::Injector<Request> child(parent, request);
+          const std::vector<Listener*>& listeners = child.getMultibindings<Listener>();
+          Assert(listeners.size() == 1);
+          Assert(&listeners == &parent.getMultibindings<Listener>());
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_child_injector_concurrent_children():
+    source = '''
+        int main() {
+          fruit::Injector<X, Y> parent(getParentComponent);
+          std::vector<Y*> ys(8);
+          std::vector<std::thread> threads;
+          for (int i = 0; i < 8; ++i) {
+            threads.emplace_back([&parent, &ys, i]() {
+              Request request{i};
+              fruit::Injector<Y, Request> child(parent, request);
+              ys[i] = child.get<Y*>();
+              Assert(child.get<Request&>().id == i);
+            });
+          }
+          for (std::thread& thread : threads) {
+            thread.join();
+          }
+          for (Y* y : ys) {
+            Assert(y == parent.get<Y*>());
+          }
+          Assert(X::num_objects_constructed == 1);
+          Assert(Y::num_objects_constructed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_child_injector_error_type_not_provided():
+    source = '''
+        struct Z {};
+
+        int main() {
+          fruit::Injector<X, Y> parent(getParentComponent);
+          Request request{1};
+          fruit::Injector<Request, Z> child(parent, request);
+        }
+        '''
+    expect_compile_error(
+        r'TypesInChildInjectorNotProvidedError<Z>',
+        r'The types in TypesNotProvided are declared as provided by the child injector, but they are neither '
+        r'provided by the parent injector nor bound to an instance passed to the Injector constructor.',
+        COMMON_DEFINITIONS,
+        source)
+
+def test_child_injector_error_instance_type_provided_by_parent():
+    source = '''
+        int main() {
+          fruit::Injector<X, Y> parent(getParentComponent);
+          X x;
+          fruit::Injector<X> child(parent, x);
+        }
+        '''
+    expect_compile_error(
+        r'TypesProvidedByParentAndChildInjectorError<X>',
+        r'The types in TypesProvidedTwice are provided by the parent injector, so they can.t also be bound to an '
+        r'instance in the child injector.',
+        COMMON_DEFINITIONS,
+        source)
+
+def test_child_injector_error_declared_nonconst_types_provided_as_const():
+    source = '''
+        void f(fruit::Injector<const X>& parent) {
+          Request request{1};
+          fruit::Injector<X, Request> child(parent, request);
+        }
+        '''
+    expect_compile_error(
+        r'TypesInInjectorProvidedAsConstOnlyError<X>',
+        r'The types in TypesProvidedAsConstOnly are declared as non-const provided types by the injector',
+        COMMON_DEFINITIONS,
+        source)
+
+if __name__ == '__main__':
+    main(__file__)
@@ -168,5 +168,48 @@ def test_error_no_factory_binding_found_with_annotation(MaybeConst):
         source,
         locals())
 
+def test_component_storage_memory_pool_scope():
+    source = '''
+        using fruit::impl::ComponentStorageAllocator;
+        using fruit::impl::ComponentStorageMemoryPoolScope;
+        using fruit::impl::FixedSizeVector;
+        using fruit::impl::MemoryPool;
+
+        int main() {
+          Assert(ComponentStorageMemoryPoolScope::getEntriesMemoryPool() == nullptr);
+          Assert(ComponentStorageMemoryPoolScope::getLazyComponentsMemoryPool() == nullptr);
+          FixedSizeVector<int, ComponentStorageAllocator<int>> heap_vector(2);
+          heap_vector.push_back(1);
+          {
+            MemoryPool entries_memory_pool;
+            MemoryPool lazy_components_memory_pool;
+            ComponentStorageMemoryPoolScope scope(entries_memory_pool, lazy_components_memory_pool);
+            Assert(ComponentStorageMemoryPoolScope::getEntriesMemoryPool() == &entries_memory_pool);
+            Assert(ComponentStorageMemoryPoolScope::getLazyComponentsMemoryPool() == &lazy_components_memory_pool);
+            {
+              MemoryPool nested_memory_pool;
+              ComponentStorageMemoryPoolScope nested_scope(nested_memory_pool, nested_memory_pool);
+              Assert(ComponentStorageMemoryPoolScope::getEntriesMemoryPool() == &nested_memory_pool);
+            }
+            Assert(ComponentStorageMemoryPoolScope::getEntriesMemoryPool() == &entries_memory_pool);
+
+            FixedSizeVector<int, ComponentStorageAllocator<int>> pool_vector(2);
+            pool_vector.push_back(2);
+            // The vectors keep their allocators when they're swapped.
+            pool_vector.swap(heap_vector);
+            Assert(pool_vector[0] == 1);
+            Assert(heap_vector[0] == 2);
+            pool_vector.swap(heap_vector);
+          }
+          Assert(ComponentStorageMemoryPoolScope::getEntriesMemoryPool() == nullptr);
+          Assert(ComponentStorageMemoryPoolScope::getLazyComponentsMemoryPool() == nullptr);
+          Assert(heap_vector[0] == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
 if __name__ == '__main__':
     main(__file__)
@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+
+    #include <sstream>
+    #include <stdexcept>
+
+    struct X {
+      INJECT(X()) = default;
+    };
+
+    struct Y {
+      INJECT(Y(X&)) {}
+    };
+
+    struct Annotation1 {};
+    using XAnnot1 = fruit::Annotated<Annotation1, X>;
+    '''
+
+def test_nested_constructions():
+    source = '''
+        fruit::Component<Y> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::ConstructionTracer tracer;
+          fruit::Injector<Y> injector(getComponent);
+          injector.setConstructionTracer(&tracer);
+          injector.get<Y&>();
+          injector.get<Y&>();
+
+          std::vector<fruit::ConstructionTracer::Event> events = tracer.getEvents();
+          Assert(events.size() == 2);
+          // The dependency is completed first.
+          Assert(events[0].type_name == "X");
+          Assert(events[0].depth == 1);
+          Assert(!events[0].is_multibinding);
+          Assert(events[1].type_name == "Y");
+          Assert(events[1].depth == 0);
+          Assert(events[1].start_ns <= events[0].start_ns);
+          Assert(events[0].start_ns <= events[0].end_ns);
+          Assert(events[0].end_ns <= events[1].end_ns);
+          Assert(events[0].thread_index == 0);
+          Assert(events[1].thread_index == 0);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_depth_after_exception():
+    source = '''
+        struct Throwing {
+          INJECT(Throwing(X&)) {
+            throw std::runtime_error("Throwing failed");
+          }
+        };
+
+        fruit::Component<Throwing, Y> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::ConstructionTracer tracer;
+          fruit::Injector<Throwing, Y> injector(getComponent);
+          injector.setConstructionTracer(&tracer);
+          bool thrown = false;
+          try {
+            injector.get<Throwing&>();
+          } catch (const std::runtime_error&) {
+            thrown = true;
+          }
+          Assert(thrown);
+          injector.get<Y&>();
+
+          // The failed construction isn't recorded, and it doesn't affect the depth of later constructions.
+          std::vector<fruit::ConstructionTracer::Event> events = tracer.getEvents();
+          Assert(events.size() == 2);
+          Assert(events[0].type_name == "X");
+          Assert(events[0].depth == 1);
+          Assert(events[1].type_name == "Y");
+          Assert(events[1].depth == 0);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_not_traced_without_tracer():
+    source = '''
+        fruit::Component<X, Y> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::ConstructionTracer tracer;
+          fruit::Injector<X, Y> injector(getComponent);
+          injector.get<X&>();
+          injector.setConstructionTracer(&tracer);
+          injector.get<Y&>();
+          injector.setConstructionTracer(nullptr);
+          injector.get<Y&>();
+
+          std::vector<fruit::ConstructionTracer::Event> events = tracer.getEvents();
+          Assert(events.size() == 1);
+          Assert(events[0].type_name == "Y");
+          Assert(events[0].depth == 0);
+
+          tracer.clear();
+          Assert(tracer.getEvents().empty());
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_multibindings():
+    source = '''
+        fruit::Component<> getComponent() {
+          return fruit::createComponent()
+            .addMultibinding<XAnnot1, X>()
+            .addMultibindingProvider<fruit::Annotated<Annotation1, X*>()>([]() { return new X(); });
+        }
+
+        int main() {
+          fruit::ConstructionTracer tracer;
+          fruit::Injector<> injector(getComponent);
+          injector.setConstructionTracer(&tracer);
+          Assert(injector.getMultibindings<XAnnot1>().size() == 2);
+
+          std::vector<fruit::ConstructionTracer::Event> events = tracer.getEvents();
+          std::size_t num_multibinding_events = 0;
+          for (const fruit::ConstructionTracer::Event& event : events) {
+            if (event.is_multibinding) {
+              Assert(event.type_name == "fruit::Annotated<Annotation1, X>");
+              ++num_multibinding_events;
+            }
+          }
+          Assert(num_multibinding_events == 2);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_install_lazily():
+    source = '''
+        fruit::Component<fruit::Required<X>, Y> getChildComponent() {
+          return fruit::createComponent();
+        }
+
+        fruit::Component<Y> getComponent() {
+          return fruit::createComponent()
+            .installLazily(getChildComponent);
+        }
+
+        int main() {
+          fruit::ConstructionTracer tracer;
+          fruit::Injector<Y> injector(getComponent);
+          injector.setConstructionTracer(&tracer);
+          injector.get<Y&>();
+
+          // The object is constructed in the injector of the child component, that is also traced.
+          bool found_nested_y = false;
+          for (const fruit::ConstructionTracer::Event& event : tracer.getEvents()) {
+            if (event.type_name == "Y" && event.depth > 0) {
+              found_nested_y = true;
+            }
+          }
+          Assert(found_nested_y);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_chrome_trace_json():
+    source = '''
+        fruit::Component<Y> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::ConstructionTracer tracer;
+          fruit::Injector<Y> injector(getComponent);
+          injector.setConstructionTracer(&tracer);
+          injector.get<Y&>();
+
+          std::ostringstream os;
+          tracer.writeChromeTraceJson(os);
+          std::string json = os.str();
+          Assert(json.find("{\\"traceEvents\\":[") == 0);
+          std::size_t x_pos = json.find("{\\"name\\":\\"X\\",\\"cat\\":\\"binding\\",\\"ph\\":\\"X\\",\\"ts\\":");
+          std::size_t y_pos = json.find("{\\"name\\":\\"Y\\",\\"cat\\":\\"binding\\",\\"ph\\":\\"X\\",\\"ts\\":");
+          Assert(x_pos != std::string::npos);
+          Assert(y_pos != std::string::npos);
+          Assert(x_pos < y_pos);
+          Assert(json.find("\\"pid\\":1,\\"tid\\":0,\\"args\\":{\\"depth\\":1}}", x_pos) != std::string::npos);
+          Assert(json.find("\\"pid\\":1,\\"tid\\":0,\\"args\\":{\\"depth\\":0}}", y_pos) != std::string::npos);
+          Assert(json.find("],\\"displayTimeUnit\\":\\"ns\\"}") != std::string::npos);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+if __name__ == '__main__':
+    main(__file__)
@@ -20,12 +20,21 @@ COMMON_DEFINITIONS = '''
 
 FRUIT_PUBLIC_HEADERS = [
     "component.h",
+    "construction_tracer.h",
+    "factory.h",
     "fruit.h",
     "fruit_forward_decls.h",
     "injector.h",
+    "injector_graph.h",
+    "injector_stats.h",
+    "keyed_multibindings.h",
     "macro.h",
+    "memory_usage.h",
+    "multibinding_provider.h",
     "normalized_component.h",
+    "object_pool.h",
     "provider.h",
+    "teardown_policy.h",
 ]
 
 @pytest.mark.parametrize('HeaderFile', FRUIT_PUBLIC_HEADERS)
@@ -0,0 +1,276 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from fruit_test_common import *
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+
+    #include <chrono>
+    #include <sstream>
+    #include <thread>
+
+    struct X {
+      INJECT(X()) = default;
+    };
+
+    struct Y {
+      INJECT(Y(X&)) {}
+    };
+
+    std::size_t findNode(const fruit::InjectorGraph& graph, const std::string& type_name) {
+      for (std::size_t i = 0; i < graph.nodes.size(); ++i) {
+        if (graph.nodes[i].type_name == type_name) {
+          return i;
+        }
+      }
+      Assert(false);
+      return 0;
+    }
+    '''
+
+def test_nodes_and_edges():
+    source = '''
+        struct Z {};
+
+        struct I {
+          virtual ~I() = default;
+        };
+
+        struct C : public I {
+          INJECT(C(Y&)) {}
+        };
+
+        struct W {
+          INJECT(W(X&, Z&)) {}
+        };
+
+        Z z;
+
+        fruit::Component<I, W> getComponent() {
+          return fruit::createComponent()
+            .bind<I, C>()
+            .bindInstance(z)
+            .registerProvider([](X& x) { return new W(x, z); });
+        }
+
+        int main() {
+          fruit::Injector<I, W> injector(getComponent);
+          injector.get<W*>();
+
+          fruit::InjectorGraph graph = injector.getGraph();
+          // C is not in the graph, since its binding was compressed.
+          Assert(graph.nodes.size() == 5);
+          std::size_t x = findNode(graph, "X");
+          std::size_t y = findNode(graph, "Y");
+          std::size_t z = findNode(graph, "Z");
+          std::size_t i = findNode(graph, "I");
+          std::size_t w = findNode(graph, "W");
+
+          Assert(graph.nodes[x].kind == fruit::InjectorGraph::BindingKind::CONSTRUCTED_IN_INJECTOR);
+          Assert(graph.nodes[x].is_constructed);
+          Assert(!graph.nodes[x].is_compressed);
+          Assert(graph.nodes[x].dependencies.empty());
+          Assert(!graph.nodes[x].has_construction_time);
+
+          Assert(graph.nodes[y].kind == fruit::InjectorGraph::BindingKind::CONSTRUCTED_IN_INJECTOR);
+          Assert(!graph.nodes[y].is_constructed);
+          Assert(graph.nodes[y].dependencies == std::vector<std::size_t>{x});
+
+          Assert(graph.nodes[z].kind == fruit::InjectorGraph::BindingKind::INSTANCE);
+          Assert(graph.nodes[z].is_constructed);
+
+          Assert(graph.nodes[i].kind == fruit::InjectorGraph::BindingKind::CONSTRUCTED_IN_INJECTOR);
+          Assert(graph.nodes[i].is_compressed);
+          Assert(!graph.nodes[i].is_constructed);
+          Assert(graph.nodes[i].dependencies == std::vector<std::size_t>{y});
+
+          Assert(graph.nodes[w].kind == fruit::InjectorGraph::BindingKind::CONSTRUCTED_OUTSIDE_INJECTOR);
+          Assert(graph.nodes[w].is_constructed);
+          Assert(graph.nodes[w].dependencies == std::vector<std::size_t>{x});
+
+          Assert(graph.getCriticalPath().empty());
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_undone_binding_compression():
+    source = '''
+        struct I {
+          virtual ~I() = default;
+        };
+
+        struct C : public I {
+          INJECT(C()) = default;
+        };
+
+        struct W {
+          INJECT(W(C&)) {}
+        };
+
+        fruit::Component<I> getComponent() {
+          return fruit::createComponent()
+            .bind<I, C>();
+        }
+
+        fruit::Component<W> getWComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::NormalizedComponent<I> normalized_component(getComponent);
+          fruit::Injector<I, W> injector(normalized_component, getWComponent);
+
+          fruit::InjectorGraph graph = injector.getGraph();
+          std::size_t c = findNode(graph, "C");
+          std::size_t i = findNode(graph, "I");
+          std::size_t w = findNode(graph, "W");
+          Assert(!graph.nodes[i].is_compressed);
+          Assert(graph.nodes[i].kind == fruit::InjectorGraph::BindingKind::CONSTRUCTED_OUTSIDE_INJECTOR);
+          Assert(graph.nodes[i].dependencies == std::vector<std::size_t>{c});
+          Assert(graph.nodes[c].kind == fruit::InjectorGraph::BindingKind::CONSTRUCTED_IN_INJECTOR);
+          Assert(graph.nodes[w].dependencies == std::vector<std::size_t>{c});
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_critical_path():
+    source = '''
+        struct Slow {
+          INJECT(Slow(X&)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+          }
+        };
+
+        struct Top {
+          INJECT(Top(Slow&, Y&)) {}
+        };
+
+        fruit::Component<Top> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::ConstructionTracer tracer;
+          fruit::Injector<Top> injector(getComponent);
+          injector.setConstructionTracer(&tracer);
+          injector.get<Top&>();
+          injector.setConstructionTracer(nullptr);
+
+          fruit::InjectorGraph graph = injector.getGraph();
+          std::size_t x = findNode(graph, "X");
+          std::size_t slow = findNode(graph, "Slow");
+          std::size_t top = findNode(graph, "Top");
+          for (const fruit::InjectorGraph::Node& node : graph.nodes) {
+            Assert(node.has_construction_time);
+          }
+          // The construction times don't include the dependencies.
+          Assert(graph.nodes[slow].construction_ns >= 20 * 1000 * 1000);
+          Assert(graph.nodes[top].construction_ns < graph.nodes[slow].construction_ns);
+
+          std::vector<std::size_t> critical_path = graph.getCriticalPath();
+          Assert(critical_path.size() >= 2);
+          Assert(critical_path[0] == top);
+          Assert(critical_path[1] == slow);
+          if (critical_path.size() == 3) {
+            Assert(critical_path[2] == x);
+          }
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_lazy_subcomponent():
+    source = '''
+        fruit::Component<fruit::Required<X>, Y> getChildComponent() {
+          return fruit::createComponent();
+        }
+
+        fruit::Component<X, Y> getComponent() {
+          return fruit::createComponent()
+            .installLazily(getChildComponent);
+        }
+
+        int main() {
+          fruit::Injector<X, Y> injector(getComponent);
+          fruit::InjectorGraph graph = injector.getGraph();
+          std::size_t x = findNode(graph, "X");
+          std::size_t y = findNode(graph, "Y");
+          Assert(graph.nodes[y].kind == fruit::InjectorGraph::BindingKind::LAZY_SUBCOMPONENT);
+          Assert(!graph.nodes[y].is_constructed);
+          Assert(graph.nodes[y].dependencies == std::vector<std::size_t>{x});
+
+          injector.get<Y&>();
+          Assert(injector.getGraph().nodes[y].is_constructed);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_dot_and_json():
+    source = r"""
+        int main() {
+          fruit::InjectorGraph graph;
+          graph.nodes.resize(3);
+          graph.nodes[0] = {"Y", fruit::InjectorGraph::BindingKind::CONSTRUCTED_IN_INJECTOR, false, true, true, 100, {1}};
+          graph.nodes[1] = {"X\"", fruit::InjectorGraph::BindingKind::CONSTRUCTED_OUTSIDE_INJECTOR, true, true, true, 200,
+                            {}};
+          graph.nodes[2] = {"Z", fruit::InjectorGraph::BindingKind::INSTANCE, false, false, false, 0, {1}};
+
+          Assert(graph.getCriticalPath() == (std::vector<std::size_t>{0, 1}));
+
+          std::ostringstream dot_stream;
+          graph.writeDot(dot_stream);
+          std::string dot = dot_stream.str();
+          Assert(dot.find("digraph injector {") == 0);
+          Assert(dot.find(R"(  n0 [label="Y\nconstructed_in_injector\n100 ns", style="filled", color=red];)")
+                 != std::string::npos);
+          Assert(dot.find(R"(  n1 [label="X\"\nconstructed_outside_injector\n200 ns", style="filled,dashed", color=red];)")
+                 != std::string::npos);
+          Assert(dot.find(R"(  n2 [label="Z\ninstance"];)") != std::string::npos);
+          Assert(dot.find("  n0 -> n1 [color=red];") != std::string::npos);
+          Assert(dot.find("  n2 -> n1;") != std::string::npos);
+
+          std::ostringstream json_stream;
+          graph.writeJson(json_stream);
+          std::string json = json_stream.str();
+          Assert(json.find(R"({"nodes":[)") == 0);
+          Assert(json.find(R"({"id":0,"type":"Y","kind":"constructed_in_injector","compressed":false,"constructed":true,)"
+                           R"("construction_ns":100,"dependencies":[1]})") != std::string::npos);
+          Assert(json.find(R"({"id":1,"type":"X\"","kind":"constructed_outside_injector","compressed":true,)")
+                 != std::string::npos);
+          Assert(json.find(R"({"id":2,"type":"Z","kind":"instance","compressed":false,"constructed":false,)"
+                           R"("construction_ns":null,"dependencies":[1]})") != std::string::npos);
+          Assert(json.find(R"(],"critical_path":[0,1],"critical_path_ns":300})") != std::string::npos);
+        }
+        """
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+if __name__ == '__main__':
+    main(__file__)
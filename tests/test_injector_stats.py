@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+
+    struct X {
+      INJECT(X()) = default;
+    };
+
+    struct A {
+      INJECT(A(X&)) {}
+    };
+
+    struct B {
+      INJECT(B(X&)) {}
+    };
+
+    struct I {
+      virtual ~I() = default;
+    };
+
+    struct C : public I {
+      INJECT(C()) = default;
+    };
+
+    fruit::Component<X> getXComponent() {
+      return fruit::createComponent();
+    }
+
+    fruit::Component<A> getAComponent() {
+      return fruit::createComponent()
+        .install(getXComponent);
+    }
+
+    fruit::Component<B> getBComponent() {
+      return fruit::createComponent()
+        .install(getXComponent);
+    }
+
+    fruit::Component<I> getIComponent() {
+      return fruit::createComponent()
+        .bind<I, C>();
+    }
+
+    fruit::Component<A, B, I> getRootComponent() {
+      return fruit::createComponent()
+        .install(getAComponent)
+        .install(getBComponent)
+        .install(getIComponent);
+    }
+    '''
+
+def test_injector_stats():
+    source = '''
+        int main() {
+          fruit::Injector<A, B, I> injector(getRootComponent);
+          const fruit::InjectorStats& stats = injector.getStats();
+          const fruit::NormalizationStats& normalization = stats.normalization;
+
+          // getRootComponent, getAComponent, getBComponent, getIComponent and getXComponent.
+          Assert(normalization.num_components_expanded == 5);
+          // getXComponent is installed twice.
+          Assert(normalization.num_duplicate_components == 1);
+          Assert(normalization.num_entries_processed > normalization.num_components_expanded);
+          // The binding for C is compressed into the one for I.
+          Assert(normalization.num_compressed_bindings == 1);
+          Assert(normalization.num_undone_binding_compressions == 0);
+          // A, B, X and I.
+          Assert(normalization.num_bindings == 4);
+          Assert(normalization.num_multibindings == 0);
+          Assert(normalization.num_graph_nodes >= normalization.num_bindings);
+          Assert(normalization.allocator_reserved_bytes >= sizeof(A) + sizeof(B) + sizeof(X) + sizeof(C));
+          Assert(normalization.allocator_num_types_to_destroy >= 1);
+
+          Assert(normalization.component_expansion_ns + normalization.binding_compression_ns
+                 + normalization.graph_construction_ns <= normalization.total_ns);
+          Assert(normalization.total_ns <= stats.total_ns);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_normalized_component_stats():
+    source = '''
+        int main() {
+          fruit::NormalizedComponent<A> normalized_component(getAComponent);
+          const fruit::NormalizationStats& normalization = normalized_component.getNormalizationStats();
+          // getAComponent and getXComponent.
+          Assert(normalization.num_components_expanded == 2);
+          Assert(normalization.num_bindings == 2);
+          Assert(normalization.component_expansion_ns <= normalization.total_ns);
+
+          fruit::Injector<A, B> injector(normalized_component, getBComponent);
+          const fruit::InjectorStats& stats = injector.getStats();
+          // Only the additional component is normalized here, and getXComponent was already expanded in the
+          // NormalizedComponent.
+          Assert(stats.normalization.num_components_expanded == 1);
+          Assert(stats.normalization.num_duplicate_components == 1);
+          Assert(stats.normalization.num_bindings == 1);
+          Assert(stats.normalization.num_hash_function_retries == 0);
+          Assert(stats.normalization.num_graph_nodes == 3);
+          Assert(stats.normalization.total_ns <= stats.total_ns);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+if __name__ == '__main__':
+    main(__file__)
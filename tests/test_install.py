@@ -925,6 +925,67 @@ def test_install_component_functions_with_args_deduped(XAnnot):
         source,
         locals())
 
+@pytest.mark.parametrize('XAnnot', [
+    'X',
+    'fruit::Annotated<Annotation1, X>',
+])
+def test_install_component_functions_with_args_deduped_using_component_arg_key(XAnnot):
+    source = '''
+        struct X {};
+
+        X x;
+
+        // This is neither hashable nor equality-comparable, Fruit uses the key instead.
+        struct Config {
+          int id;
+          std::vector<std::string> values;
+        };
+
+        namespace fruit {
+        template <>
+        struct ComponentArgKey<Config> {
+          int operator()(const Config& config) const {
+            return config.id;
+          }
+        };
+        }
+
+        fruit::Component<> getComponent(Config) {
+          return fruit::createComponent()
+            .addInstanceMultibinding<XAnnot, X>(x);
+        }
+
+        fruit::Component<> getComponent2() {
+          return fruit::createComponent()
+            .install(getComponent, Config{1, {"foo"}})
+            .install(getComponent, Config{2, {"foo"}});
+        }
+
+        fruit::Component<> getComponent3() {
+          return fruit::createComponent()
+            .install(getComponent, Config{1, {"foo"}});
+        }
+
+        fruit::Component<> getComponent4() {
+          return fruit::createComponent()
+            .install(getComponent2)
+            .install(getComponent3);
+        }
+
+        int main() {
+          fruit::Injector<> injector(getComponent4);
+
+          std::vector<X*> multibindings = injector.getMultibindings<XAnnot>();
+          Assert(multibindings.size() == 2);
+          Assert(multibindings[0] == &x);
+          Assert(multibindings[1] == &x);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
 @pytest.mark.parametrize('XAnnot', [
     'X',
     'fruit::Annotated<Annotation1, X>',
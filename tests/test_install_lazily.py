@@ -0,0 +1,330 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+    #include <stdexcept>
+
+    struct X;
+    struct Y;
+
+    struct Annotation1 {};
+    using XAnnot1 = fruit::Annotated<Annotation1, X>;
+    '''
+
+@pytest.mark.parametrize('XAnnot,XPtrAnnot', [
+    ('X', 'X*'),
+    ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation1, X*>'),
+])
+def test_success(XAnnot, XPtrAnnot):
+    source = '''
+        struct X {
+          int n;
+          X(int n) : n(n) {}
+        };
+
+        static int num_component_calls = 0;
+
+        fruit::Component<XAnnot> getChildComponent() {
+          ++num_component_calls;
+          return fruit::createComponent()
+            .registerProvider<XAnnot()>([]() { return X(5); });
+        }
+
+        fruit::Component<XAnnot> getRootComponent() {
+          return fruit::createComponent()
+            .installLazily(getChildComponent);
+        }
+
+        int main() {
+          fruit::Injector<XAnnot> injector(getRootComponent);
+          Assert(num_component_calls == 0);
+          X x = injector.get<XAnnot>();
+          Assert(x.n == 5);
+          Assert(num_component_calls == 1);
+          X* x_ptr1 = injector.get<XPtrAnnot>();
+          X* x_ptr2 = injector.get<XPtrAnnot>();
+          Assert(x_ptr1 == x_ptr2);
+          Assert(num_component_calls == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_not_expanded_if_not_injected():
+    source = '''
+        struct X {
+          INJECT(X()) = default;
+        };
+
+        struct Y {
+          INJECT(Y()) = default;
+        };
+
+        static int num_component_calls = 0;
+
+        fruit::Component<Y> getChildComponent() {
+          ++num_component_calls;
+          return fruit::createComponent();
+        }
+
+        fruit::Component<X, Y> getRootComponent() {
+          return fruit::createComponent()
+            .installLazily(getChildComponent);
+        }
+
+        int main() {
+          {
+            fruit::Injector<X, Y> injector(getRootComponent);
+            injector.get<X*>();
+          }
+          Assert(num_component_calls == 0);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_required_types_injected_from_enclosing_injector():
+    source = '''
+        struct X {
+          INJECT(X()) = default;
+        };
+
+        struct Y {
+          X& x;
+          INJECT(Y(X& x)) : x(x) {}
+        };
+
+        fruit::Component<fruit::Required<X>, Y> getChildComponent() {
+          return fruit::createComponent();
+        }
+
+        fruit::Component<X, Y> getRootComponent() {
+          return fruit::createComponent()
+            .installLazily(getChildComponent);
+        }
+
+        int main() {
+          fruit::Injector<X, Y> injector(getRootComponent);
+          X& x = injector.get<X&>();
+          Y& y = injector.get<Y&>();
+          Assert(&(y.x) == &x);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_expansion_retried_after_required_type_throws():
+    source = '''
+        static int num_x_constructions = 0;
+
+        struct X {
+          INJECT(X()) {
+            ++num_x_constructions;
+            if (num_x_constructions == 1) {
+              throw std::runtime_error("X construction failed");
+            }
+          }
+        };
+
+        struct Y {
+          X& x;
+          INJECT(Y(X& x)) : x(x) {}
+        };
+
+        fruit::Component<fruit::Required<X>, Y> getChildComponent() {
+          return fruit::createComponent();
+        }
+
+        fruit::Component<X, Y> getRootComponent() {
+          return fruit::createComponent()
+            .installLazily(getChildComponent);
+        }
+
+        int main() {
+          fruit::Injector<X, Y> injector(getRootComponent);
+          try {
+            injector.get<Y&>();
+            Assert(false);
+          } catch (const std::runtime_error&) {
+          }
+          Y& y = injector.get<Y&>();
+          Assert(&(y.x) == &injector.get<X&>());
+          Assert(num_x_constructions == 2);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_with_args_and_provider():
+    source = '''
+        struct X {
+          INJECT(X()) = default;
+        };
+
+        struct Y {
+          INJECT(Y()) = default;
+        };
+
+        struct Z1 {
+          INJECT(Z1(X&, Y&)) {}
+        };
+
+        struct Z2 {
+          INJECT(Z2(X&, Y&)) {}
+        };
+
+        static int num_component_calls = 0;
+
+        fruit::Component<X, Y> getChildComponent(int) {
+          ++num_component_calls;
+          return fruit::createComponent();
+        }
+
+        // Both these components install getChildComponent lazily (with the same args), so it's expanded only once.
+        fruit::Component<Z1> getZ1Component() {
+          return fruit::createComponent()
+            .installLazily(getChildComponent, 7);
+        }
+
+        fruit::Component<Z2> getZ2Component() {
+          return fruit::createComponent()
+            .installLazily(getChildComponent, 7);
+        }
+
+        fruit::Component<Z1, Z2> getRootComponent() {
+          return fruit::createComponent()
+            .install(getZ1Component)
+            .install(getZ2Component);
+        }
+
+        int main() {
+          fruit::Injector<Z1, Z2> injector(getRootComponent);
+          fruit::Provider<Z1> provider = injector.get<fruit::Provider<Z1>>();
+          Assert(num_component_calls == 0);
+          provider.get<Z1*>();
+          Assert(num_component_calls == 1);
+          injector.get<Z2*>();
+          Assert(num_component_calls == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_with_normalized_component():
+    source = '''
+        struct X {
+          INJECT(X()) = default;
+        };
+
+        struct Y {
+          X& x;
+          INJECT(Y(X& x)) : x(x) {}
+        };
+
+        static int num_component_calls = 0;
+
+        fruit::Component<fruit::Required<X>, Y> getChildComponent() {
+          ++num_component_calls;
+          return fruit::createComponent();
+        }
+
+        fruit::Component<fruit::Required<X>, Y> getRootComponent() {
+          return fruit::createComponent()
+            .installLazily(getChildComponent);
+        }
+
+        fruit::Component<X> getXComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::NormalizedComponent<fruit::Required<X>, Y> normalized_component(getRootComponent);
+          Assert(num_component_calls == 0);
+          fruit::Injector<X, Y> injector1(normalized_component, getXComponent);
+          fruit::Injector<X, Y> injector2(normalized_component, getXComponent);
+          Assert(num_component_calls == 0);
+          Y& y1 = injector1.get<Y&>();
+          Assert(&(y1.x) == &(injector1.get<X&>()));
+          Assert(num_component_calls == 1);
+          Y& y2 = injector2.get<Y&>();
+          Assert(&(y2.x) == &(injector2.get<X&>()));
+          Assert(&y1 != &y2);
+          Assert(num_component_calls == 2);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_same_type_provided_by_multiple_lazy_components_error():
+    source = '''
+        struct X {
+          INJECT(X()) = default;
+        };
+
+        struct Z1 {
+          INJECT(Z1(X&)) {}
+        };
+
+        struct Z2 {
+          INJECT(Z2(X&)) {}
+        };
+
+        fruit::Component<X> getChildComponent(int) {
+          return fruit::createComponent();
+        }
+
+        fruit::Component<Z1> getZ1Component() {
+          return fruit::createComponent()
+            .installLazily(getChildComponent, 1);
+        }
+
+        fruit::Component<Z2> getZ2Component() {
+          return fruit::createComponent()
+            .installLazily(getChildComponent, 2);
+        }
+
+        fruit::Component<Z1, Z2> getRootComponent() {
+          return fruit::createComponent()
+            .install(getZ1Component)
+            .install(getZ2Component);
+        }
+
+        int main() {
+          fruit::Injector<Z1, Z2> injector(getRootComponent);
+        }
+        '''
+    expect_runtime_error(
+        r'Fatal injection error: the type X is provided by multiple components installed with installLazily\(\).',
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+if __name__ == '__main__':
+    main(__file__)
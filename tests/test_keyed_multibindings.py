@@ -0,0 +1,286 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+import pytest
+
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+
+    #include <algorithm>
+    #include <atomic>
+    #include <string>
+    #include <thread>
+
+    struct Annotation1 {};
+
+    struct Handler {
+      virtual int id() = 0;
+      virtual ~Handler() = default;
+    };
+
+    struct Dep : public ConstructionTracker<Dep> {
+      INJECT(Dep()) = default;
+    };
+
+    template <int n>
+    struct HandlerImpl : public Handler, public ConstructionTracker<HandlerImpl<n>> {
+      INJECT(HandlerImpl(Dep*)) {}
+      int id() override {
+        return n;
+      }
+    };
+    '''
+
+@pytest.mark.parametrize('HandlerAnnot', [
+    'Handler',
+    'fruit::Annotated<Annotation1, Handler>',
+])
+def test_keyed_multibindings_construct_lazily(HandlerAnnot):
+    source = '''
+        fruit::Component<> getComponent() {
+          return fruit::createComponent()
+            .addKeyedMultibinding<std::string, HandlerAnnot, HandlerImpl<1>>("/foo")
+            .addKeyedMultibinding<std::string, HandlerAnnot, HandlerImpl<2>>("/bar")
+            .addKeyedMultibinding<std::string, HandlerAnnot, HandlerImpl<3>>("/baz");
+        }
+
+        int main() {
+          fruit::Injector<> injector(getComponent);
+          const fruit::KeyedMultibindings<std::string, Handler>& handlers =
+              injector.getKeyedMultibindings<std::string, HandlerAnnot>();
+          Assert(handlers.size() == 3);
+          Assert(handlers.contains("/bar"));
+          Assert(!handlers.contains("/qux"));
+          Assert(handlers.get("/qux") == nullptr);
+          Assert(HandlerImpl<1>::num_objects_constructed == 0);
+          Assert(HandlerImpl<2>::num_objects_constructed == 0);
+          Assert(HandlerImpl<3>::num_objects_constructed == 0);
+          Assert(Dep::num_objects_constructed == 0);
+
+          Handler* handler = handlers.get("/bar");
+          Assert(handler->id() == 2);
+          Assert(handlers.get("/bar") == handler);
+          Assert(HandlerImpl<1>::num_objects_constructed == 0);
+          Assert(HandlerImpl<2>::num_objects_constructed == 1);
+          Assert(HandlerImpl<3>::num_objects_constructed == 0);
+          Assert(Dep::num_objects_constructed == 1);
+
+          std::vector<std::string> keys = handlers.getKeys();
+          std::sort(keys.begin(), keys.end());
+          Assert(keys == std::vector<std::string>({"/bar", "/baz", "/foo"}));
+
+          // The map is built once per injector.
+          Assert(&injector.getKeyedMultibindings<std::string, HandlerAnnot>() == &handlers);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_keyed_multibindings_none():
+    source = '''
+        fruit::Component<> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<> injector(getComponent);
+          const fruit::KeyedMultibindings<std::string, Handler>& handlers =
+              injector.getKeyedMultibindings<std::string, Handler>();
+          Assert(handlers.size() == 0);
+          Assert(handlers.get("/foo") == nullptr);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_keyed_multibindings_separate_from_multibindings_and_other_key_types():
+    source = '''
+        fruit::Component<> getComponent() {
+          return fruit::createComponent()
+            .addMultibinding<Handler, HandlerImpl<1>>()
+            .addKeyedMultibinding<std::string, Handler, HandlerImpl<2>>("2")
+            .addKeyedMultibinding<int, Handler, HandlerImpl<3>>(3);
+        }
+
+        int main() {
+          fruit::Injector<> injector(getComponent);
+          Assert(injector.getMultibindings<Handler>().size() == 1);
+          Assert(injector.getMultibindings<Handler>()[0]->id() == 1);
+          Assert(injector.getKeyedMultibindings<std::string, Handler>().size() == 1);
+          Assert(injector.getKeyedMultibindings<std::string, Handler>().get("2")->id() == 2);
+          Assert(injector.getKeyedMultibindings<int, Handler>().size() == 1);
+          Assert(injector.getKeyedMultibindings<int, Handler>().get(3)->id() == 3);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_keyed_multibindings_with_binding_to_same_class():
+    source = '''
+        fruit::Component<Handler> getComponent() {
+          return fruit::createComponent()
+            .bind<Handler, HandlerImpl<1>>()
+            .addKeyedMultibinding<std::string, Handler, HandlerImpl<1>>("1");
+        }
+
+        int main() {
+          fruit::Injector<Handler> injector(getComponent);
+          Handler* handler = injector.getKeyedMultibindings<std::string, Handler>().get("1");
+          Assert(handler->id() == 1);
+          Assert(injector.get<Handler*>() == handler);
+          Assert(HandlerImpl<1>::num_objects_constructed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_keyed_multibindings_same_binding_from_multiple_components():
+    source = '''
+        fruit::Component<> getComponent1() {
+          return fruit::createComponent()
+            .addKeyedMultibinding<std::string, Handler, HandlerImpl<1>>("1");
+        }
+
+        fruit::Component<> getComponent2() {
+          return fruit::createComponent()
+            .addKeyedMultibinding<std::string, Handler, HandlerImpl<1>>("1")
+            .addKeyedMultibinding<std::string, Handler, HandlerImpl<2>>("2");
+        }
+
+        fruit::Component<> getComponent() {
+          return fruit::createComponent()
+            .install(getComponent1)
+            .install(getComponent2);
+        }
+
+        int main() {
+          fruit::Injector<> injector(getComponent);
+          const fruit::KeyedMultibindings<std::string, Handler>& handlers =
+              injector.getKeyedMultibindings<std::string, Handler>();
+          Assert(handlers.size() == 2);
+          Assert(handlers.get("1")->id() == 1);
+          Assert(handlers.get("2")->id() == 2);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+@pytest.mark.parametrize('EagerlyInjectAll', [
+    'injector.eagerlyInjectAll()',
+    'injector.prefetchAll().wait()',
+])
+def test_keyed_multibindings_not_constructed_by_eager_injection(EagerlyInjectAll):
+    source = '''
+        fruit::Component<> getComponent() {
+          return fruit::createComponent()
+            .addKeyedMultibinding<std::string, Handler, HandlerImpl<1>>("/foo")
+            .addKeyedMultibinding<std::string, Handler, HandlerImpl<2>>("/bar")
+            .addMultibinding<Handler, HandlerImpl<3>>();
+        }
+
+        int main() {
+          fruit::Injector<> injector(getComponent);
+          EagerlyInjectAll;
+          // The (non-keyed) multibinding is constructed, but the keyed ones are still constructed lazily.
+          Assert(HandlerImpl<1>::num_objects_constructed == 0);
+          Assert(HandlerImpl<2>::num_objects_constructed == 0);
+          Assert(HandlerImpl<3>::num_objects_constructed == 1);
+
+          const fruit::KeyedMultibindings<std::string, Handler>& handlers =
+              injector.getKeyedMultibindings<std::string, Handler>();
+          Assert(handlers.get("/foo")->id() == 1);
+          Assert(HandlerImpl<1>::num_objects_constructed == 1);
+          Assert(HandlerImpl<2>::num_objects_constructed == 0);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals(),
+        ignore_deprecation_warnings=True)
+
+def test_keyed_multibindings_concurrent_get():
+    source = '''
+        fruit::Component<> getComponent() {
+          return fruit::createComponent()
+            .addKeyedMultibinding<int, Handler, HandlerImpl<1>>(1)
+            .addKeyedMultibinding<int, Handler, HandlerImpl<2>>(2);
+        }
+
+        int main() {
+          fruit::Injector<> injector(getComponent);
+          const fruit::KeyedMultibindings<int, Handler>& handlers = injector.getKeyedMultibindings<int, Handler>();
+          std::atomic<int> sum(0);
+          std::vector<std::thread> threads;
+          for (int i = 0; i < 8; ++i) {
+            threads.emplace_back([&handlers, &sum, i]() {
+              sum += handlers.get(i % 2 + 1)->id();
+            });
+          }
+          for (std::thread& thread : threads) {
+            thread.join();
+          }
+          Assert(sum == 12);
+          Assert(HandlerImpl<1>::num_objects_constructed == 1);
+          Assert(HandlerImpl<2>::num_objects_constructed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_keyed_multibindings_error_same_key():
+    source = '''
+        fruit::Component<> getComponent() {
+          return fruit::createComponent()
+            .addKeyedMultibinding<std::string, Handler, HandlerImpl<1>>("/foo")
+            .addKeyedMultibinding<std::string, Handler, HandlerImpl<2>>("/foo");
+        }
+
+        int main() {
+          fruit::Injector<> injector(getComponent);
+          injector.getKeyedMultibindings<std::string, Handler>();
+        }
+        '''
+    expect_runtime_error(
+        r'Fatal injection error: the keyed multibindings for the type (struct )?Handler with keys of type .* '
+        r'contain two different multibindings with the same key.',
+        COMMON_DEFINITIONS,
+        source)
+
+def test_keyed_multibindings_error_not_base():
+    source = '''
+        struct X {};
+
+        fruit::Component<> getComponent() {
+          return fruit::createComponent()
+            .addKeyedMultibinding<int, X, HandlerImpl<1>>(1);
+        }
+        '''
+    expect_compile_error(
+        r'NotABaseClassOfError<X,HandlerImpl<1>>',
+        'I is not a base class of C.',
+        COMMON_DEFINITIONS,
+        source)
+
+if __name__ == '__main__':
+    main(__file__)
@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+
+    struct X {
+      INJECT(X()) = default;
+    };
+
+    struct Y {
+      INJECT(Y(X&)) {}
+    };
+
+    struct Annotation1 {};
+    using XAnnot1 = fruit::Annotated<Annotation1, X>;
+    '''
+
+def test_not_counted_by_default():
+    source = '''
+        fruit::Component<X, Y> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<X, Y> injector(getComponent);
+          injector.get<Y&>();
+          injector.get<X*>();
+
+          fruit::LookupStats lookup_stats = injector.getLookupStats();
+          Assert(lookup_stats.types.empty());
+          Assert(lookup_stats.num_lookups == 0);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_counts_by_type():
+    source = '''
+        fruit::Component<X, Y> getComponent() {
+          return fruit::createComponent()
+            .addMultibinding<XAnnot1, X>();
+        }
+
+        int main() {
+          fruit::Injector<X, Y> injector(getComponent);
+          injector.setLookupCounting(true);
+          injector.get<Y&>();
+          // All these are lookups of X.
+          injector.get<X&>();
+          injector.get<X*>();
+          injector.get<fruit::Provider<X>>();
+          Assert(fruit::impl::InjectorAccessorForTests::unsafeGet<X>(injector) != nullptr);
+          injector.getMultibindings<XAnnot1>();
+          injector.setLookupCounting(false);
+          injector.get<Y&>();
+
+          fruit::LookupStats lookup_stats = injector.getLookupStats();
+          Assert(lookup_stats.num_lookups == 6);
+          Assert(lookup_stats.types.size() == 3);
+          // The most looked up type comes first.
+          Assert(lookup_stats.types[0].type_name == "X");
+          Assert(lookup_stats.types[0].num_gets == 3);
+          Assert(lookup_stats.types[0].num_unsafe_gets == 1);
+          Assert(lookup_stats.types[0].num_multibinding_gets == 0);
+          Assert(lookup_stats.types[0].getNumRepeatedLookups() == 3);
+          Assert(lookup_stats.types[1].type_name == "Y");
+          Assert(lookup_stats.types[1].num_gets == 1);
+          Assert(lookup_stats.types[1].getNumRepeatedLookups() == 0);
+          Assert(lookup_stats.types[2].type_name == "fruit::Annotated<Annotation1, X>");
+          Assert(lookup_stats.types[2].num_multibinding_gets == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_counts_keyed_multibindings():
+    source = '''
+        fruit::Component<> getComponent() {
+          return fruit::createComponent()
+            .addKeyedMultibinding<int, X, X>(1);
+        }
+
+        int main() {
+          fruit::Injector<> injector(getComponent);
+          injector.setLookupCounting(true);
+          injector.getKeyedMultibindings<int, X>();
+          injector.getKeyedMultibindings<int, X>();
+
+          fruit::LookupStats lookup_stats = injector.getLookupStats();
+          Assert(lookup_stats.num_lookups == 2);
+          Assert(lookup_stats.types.size() == 1);
+          Assert(lookup_stats.types[0].num_multibinding_gets == 2);
+          Assert(lookup_stats.types[0].getNumRepeatedLookups() == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_clear():
+    source = '''
+        fruit::Component<X> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<X> injector(getComponent);
+          injector.setLookupCounting(true);
+          injector.get<X&>();
+          injector.clearLookupStats();
+          Assert(injector.getLookupStats().num_lookups == 0);
+          injector.get<X&>();
+          Assert(injector.getLookupStats().num_lookups == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_mutex_wait_time():
+    source = '''
+        #include <atomic>
+        #include <chrono>
+        #include <thread>
+
+        static std::atomic<bool> constructing(false);
+
+        struct Slow {
+          INJECT(Slow()) {
+            constructing = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+          }
+        };
+
+        fruit::Component<X, Slow> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<X, Slow> injector(getComponent);
+          injector.setLookupCounting(true);
+          std::thread thread([&injector]() { injector.get<Slow&>(); });
+          while (!constructing) {
+            std::this_thread::yield();
+          }
+          // This waits for the construction of Slow to finish, since that's done while holding the injector's lock.
+          injector.get<X&>();
+          thread.join();
+
+          fruit::LookupStats lookup_stats = injector.getLookupStats();
+          Assert(lookup_stats.num_lookups == 2);
+          Assert(lookup_stats.num_contended_lookups == 1);
+          Assert(lookup_stats.mutex_wait_ns > 0);
+          Assert(lookup_stats.max_mutex_wait_ns == lookup_stats.mutex_wait_ns);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+if __name__ == '__main__':
+    main(__file__)
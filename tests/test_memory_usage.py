@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from fruit_test_common import *
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+
+    #include <algorithm>
+
+    struct X {
+      INJECT(X()) = default;
+    };
+
+    struct Y {
+      INJECT(Y(X&)) {}
+    };
+
+    struct Z {
+      INJECT(Z()) = default;
+    };
+
+    struct Annotation1 {};
+    using XAnnot1 = fruit::Annotated<Annotation1, X>;
+
+    bool contains(const std::vector<std::string>& v, const std::string& s) {
+      return std::find(v.begin(), v.end(), s) != v.end();
+    }
+    '''
+
+def test_injector():
+    source = '''
+        fruit::Component<Y, Z> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<Y, Z> injector(getComponent);
+
+          fruit::MemoryUsage memory_usage = injector.getMemoryUsage();
+          Assert(memory_usage.graph_nodes_bytes > 0);
+          Assert(memory_usage.graph_lookup_table_bytes > 0);
+          Assert(memory_usage.graph_values_bytes > 0);
+          Assert(memory_usage.allocator_reserved_bytes >= sizeof(X) + sizeof(Y) + sizeof(Z));
+          Assert(memory_usage.allocator_used_bytes <= 1);
+          Assert(memory_usage.getTotalBytes() >= memory_usage.graph_nodes_bytes + memory_usage.allocator_reserved_bytes);
+          Assert(memory_usage.unconstructed_types.size() == 3);
+          Assert(contains(memory_usage.unconstructed_types, "X"));
+          Assert(contains(memory_usage.unconstructed_types, "Y"));
+          Assert(contains(memory_usage.unconstructed_types, "Z"));
+
+          injector.get<Y&>();
+
+          fruit::MemoryUsage memory_usage2 = injector.getMemoryUsage();
+          Assert(memory_usage2.allocator_reserved_bytes == memory_usage.allocator_reserved_bytes);
+          Assert(memory_usage2.allocator_used_bytes >= sizeof(X) + sizeof(Y));
+          Assert(memory_usage2.allocator_used_bytes <= memory_usage2.allocator_reserved_bytes);
+          Assert(memory_usage2.unconstructed_types == std::vector<std::string>{"Z"});
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_instances_and_providers_dont_reserve_space():
+    source = '''
+        X x;
+
+        fruit::Component<X, Y> getComponent() {
+          return fruit::createComponent()
+            .bindInstance(x)
+            .registerProvider([]() { return new Y(x); });
+        }
+
+        int main() {
+          fruit::Injector<X, Y> injector(getComponent);
+          fruit::MemoryUsage memory_usage = injector.getMemoryUsage();
+          Assert(memory_usage.unconstructed_types.empty());
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_multibindings():
+    source = '''
+        fruit::Component<> getComponent() {
+          return fruit::createComponent()
+            .addMultibindingProvider<XAnnot1()>([]() { return X(); })
+            .addMultibindingProvider<XAnnot1(X*)>([](X*) { return X(); })
+            .addMultibindingProvider<fruit::Annotated<Annotation1, X*>()>([]() { return new X(); });
+        }
+
+        int main() {
+          fruit::Injector<> injector(getComponent);
+
+          fruit::MemoryUsage memory_usage = injector.getMemoryUsage();
+          Assert(memory_usage.multibindings_bytes > 0);
+          // The multibinding that returns a pointer doesn't reserve space in the injector, X does.
+          Assert(memory_usage.unconstructed_types.size() == 3);
+          Assert(std::count(memory_usage.unconstructed_types.begin(), memory_usage.unconstructed_types.end(),
+                            "fruit::Annotated<Annotation1, X>") == 2);
+          Assert(contains(memory_usage.unconstructed_types, "X"));
+
+          Assert(injector.getMultibindings<XAnnot1>().size() == 3);
+          Assert(injector.getMemoryUsage().unconstructed_types.empty());
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_normalized_component():
+    source = '''
+        struct I {
+          virtual ~I() = default;
+        };
+
+        struct C : public I {
+          INJECT(C()) = default;
+        };
+
+        fruit::Component<fruit::Required<X>, I, Y> getComponent() {
+          return fruit::createComponent()
+            .bind<I, C>();
+        }
+
+        fruit::Component<X> getXComponent() {
+          return fruit::createComponent();
+        }
+
+        struct W {
+          INJECT(W(C&)) {}
+        };
+
+        // W depends on C, so the binding compression of I->C must be undone.
+        fruit::Component<X, W> getXWComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::NormalizedComponent<fruit::Required<X>, I, Y> normalized_component(getComponent);
+
+          fruit::MemoryUsage memory_usage = normalized_component.getMemoryUsage();
+          Assert(memory_usage.graph_nodes_bytes > 0);
+          Assert(memory_usage.memory_pool_bytes > 0);
+          Assert(memory_usage.allocator_reserved_bytes == 0);
+          Assert(memory_usage.allocator_destruction_list_bytes == 0);
+          Assert(memory_usage.unconstructed_types.empty());
+
+          fruit::Injector<I, Y> injector(normalized_component, getXComponent);
+          fruit::MemoryUsage injector_memory_usage = injector.getMemoryUsage();
+          Assert(injector_memory_usage.memory_pool_bytes == 0);
+          Assert(injector_memory_usage.allocator_reserved_bytes > 0);
+          // The space for C is reserved through the compressed binding for I.
+          Assert(injector_memory_usage.unconstructed_types.size() == 3);
+          Assert(contains(injector_memory_usage.unconstructed_types, "I"));
+          Assert(contains(injector_memory_usage.unconstructed_types, "X"));
+          Assert(contains(injector_memory_usage.unconstructed_types, "Y"));
+
+          fruit::Injector<I, W> injector2(normalized_component, getXWComponent);
+          fruit::MemoryUsage injector2_memory_usage = injector2.getMemoryUsage();
+          Assert(injector2_memory_usage.unconstructed_types.size() == 4);
+          Assert(contains(injector2_memory_usage.unconstructed_types, "C"));
+          Assert(!contains(injector2_memory_usage.unconstructed_types, "I"));
+          Assert(contains(injector2_memory_usage.unconstructed_types, "W"));
+          injector2.get<I&>();
+          Assert(!contains(injector2.getMemoryUsage().unconstructed_types, "C"));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_install_lazily():
+    source = '''
+        fruit::Component<Z> getChildComponent() {
+          return fruit::createComponent();
+        }
+
+        fruit::Component<X, Z> getComponent() {
+          return fruit::createComponent()
+            .installLazily(getChildComponent);
+        }
+
+        int main() {
+          fruit::Injector<X, Z> injector(getComponent);
+          fruit::MemoryUsage memory_usage = injector.getMemoryUsage();
+          Assert(memory_usage.unconstructed_types == std::vector<std::string>{"X"});
+
+          injector.get<Z&>();
+
+          // The injector of the lazy subcomponent is also included.
+          fruit::MemoryUsage memory_usage2 = injector.getMemoryUsage();
+          Assert(memory_usage2.graph_nodes_bytes > memory_usage.graph_nodes_bytes);
+          Assert(memory_usage2.unconstructed_types == std::vector<std::string>{"X"});
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+if __name__ == '__main__':
+    main(__file__)
@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+import pytest
+
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+
+    #include <atomic>
+    #include <thread>
+
+    struct Annotation1 {};
+
+    struct Plugin {
+      virtual int id() = 0;
+      virtual ~Plugin() = default;
+    };
+
+    struct Dep : public ConstructionTracker<Dep> {
+      INJECT(Dep()) = default;
+    };
+
+    template <int n>
+    struct PluginImpl : public Plugin, public ConstructionTracker<PluginImpl<n>> {
+      INJECT(PluginImpl(Dep*)) {}
+      int id() override {
+        return n;
+      }
+    };
+    '''
+
+@pytest.mark.parametrize('PluginAnnot', [
+    'Plugin',
+    'fruit::Annotated<Annotation1, Plugin>',
+])
+def test_multibinding_providers_construct_lazily(PluginAnnot):
+    source = '''
+        fruit::Component<> getComponent() {
+          return fruit::createComponent()
+            .addMultibinding<PluginAnnot, PluginImpl<1>>()
+            .addMultibinding<PluginAnnot, PluginImpl<2>>()
+            .addMultibinding<PluginAnnot, PluginImpl<3>>();
+        }
+
+        int main() {
+          fruit::Injector<> injector(getComponent);
+          const std::vector<fruit::MultibindingProvider<Plugin>>& providers =
+              injector.getMultibindingProviders<PluginAnnot>();
+          Assert(providers.size() == 3);
+          Assert(PluginImpl<1>::num_objects_constructed == 0);
+          Assert(PluginImpl<2>::num_objects_constructed == 0);
+          Assert(PluginImpl<3>::num_objects_constructed == 0);
+          Assert(Dep::num_objects_constructed == 0);
+          Assert(!providers[1].isConstructed());
+
+          // The order is the same as in getMultibindings().
+          int id = providers[1]->id();
+          Assert(providers[1].isConstructed());
+          Assert(PluginImpl<1>::num_objects_constructed + PluginImpl<2>::num_objects_constructed
+                 + PluginImpl<3>::num_objects_constructed == 1);
+          Assert(Dep::num_objects_constructed == 1);
+
+          Plugin* plugin = providers[1].get();
+          Assert(&*providers[1] == plugin);
+
+          const std::vector<Plugin*>& plugins = injector.getMultibindings<PluginAnnot>();
+          Assert(plugins.size() == 3);
+          Assert(plugins[1] == plugin);
+          Assert(plugins[1]->id() == id);
+          Assert(PluginImpl<1>::num_objects_constructed == 1);
+          Assert(PluginImpl<2>::num_objects_constructed == 1);
+          Assert(PluginImpl<3>::num_objects_constructed == 1);
+          Assert(Dep::num_objects_constructed == 1);
+
+          // The providers are created once per injector.
+          Assert(&injector.getMultibindingProviders<PluginAnnot>() == &providers);
+          for (std::size_t i = 0; i < 3; ++i) {
+            Assert(providers[i].get() == plugins[i]);
+          }
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_multibinding_providers_after_get_multibindings():
+    source = '''
+        fruit::Component<> getComponent() {
+          return fruit::createComponent()
+            .addMultibinding<Plugin, PluginImpl<1>>()
+            .addMultibindingProvider([](Dep*) { return static_cast<Plugin*>(new PluginImpl<2>(nullptr)); });
+        }
+
+        int main() {
+          fruit::Injector<> injector(getComponent);
+          const std::vector<Plugin*>& plugins = injector.getMultibindings<Plugin>();
+          const std::vector<fruit::MultibindingProvider<Plugin>>& providers =
+              injector.getMultibindingProviders<Plugin>();
+          Assert(providers.size() == 2);
+          for (std::size_t i = 0; i < 2; ++i) {
+            // These were already constructed, so they can be returned without locking.
+            Assert(providers[i].isConstructed());
+            Assert(providers[i].get() == plugins[i]);
+          }
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_multibinding_providers_none():
+    source = '''
+        fruit::Component<> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<> injector(getComponent);
+          Assert(injector.getMultibindingProviders<Plugin>().empty());
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_multibinding_providers_copy():
+    source = '''
+        fruit::Component<> getComponent() {
+          return fruit::createComponent()
+            .addMultibinding<Plugin, PluginImpl<1>>();
+        }
+
+        int main() {
+          fruit::Injector<> injector(getComponent);
+          fruit::MultibindingProvider<Plugin> provider = injector.getMultibindingProviders<Plugin>()[0];
+          Assert(!provider.isConstructed());
+          Plugin* plugin = provider.get();
+          Assert(provider.isConstructed());
+          Assert(plugin->id() == 1);
+
+          fruit::MultibindingProvider<Plugin> provider2 = provider;
+          Assert(provider2.isConstructed());
+          Assert(provider2.get() == plugin);
+
+          // The original provider didn't see the construction, but it still returns the same object.
+          Assert(!injector.getMultibindingProviders<Plugin>()[0].isConstructed());
+          Assert(injector.getMultibindingProviders<Plugin>()[0].get() == plugin);
+          Assert(PluginImpl<1>::num_objects_constructed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_multibinding_providers_concurrent_get():
+    source = '''
+        fruit::Component<> getComponent() {
+          return fruit::createComponent()
+            .addMultibinding<Plugin, PluginImpl<1>>()
+            .addMultibinding<Plugin, PluginImpl<2>>();
+        }
+
+        int main() {
+          fruit::Injector<> injector(getComponent);
+          const std::vector<fruit::MultibindingProvider<Plugin>>& providers =
+              injector.getMultibindingProviders<Plugin>();
+          std::atomic<int> sum(0);
+          std::vector<std::thread> threads;
+          for (int i = 0; i < 8; ++i) {
+            threads.emplace_back([&providers, &sum, i]() {
+              sum += providers[i % 2]->id();
+            });
+          }
+          for (std::thread& thread : threads) {
+            thread.join();
+          }
+          Assert(sum == 12);
+          Assert(PluginImpl<1>::num_objects_constructed == 1);
+          Assert(PluginImpl<2>::num_objects_constructed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_multibinding_providers_error_not_normalized():
+    source = '''
+        void f(fruit::Injector<>& injector) {
+          injector.getMultibindingProviders<Plugin*>();
+        }
+        '''
+    expect_compile_error(
+        r'NonClassTypeError<Plugin\*,Plugin>',
+        'A non-class type T was specified. Use C instead.',
+        COMMON_DEFINITIONS,
+        source)
+
+if __name__ == '__main__':
+    main(__file__)
@@ -0,0 +1,247 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+import pytest
+
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+    #include <chrono>
+    #include <thread>
+
+    struct Annotation1 {};
+
+    struct Y : public ConstructionTracker<Y> {
+      std::thread::id constructor_thread;
+
+      INJECT(Y())
+        : constructor_thread(std::this_thread::get_id()) {
+      }
+    };
+
+    struct X : public ConstructionTracker<X> {
+      Y* y;
+      std::thread::id constructor_thread;
+
+      INJECT(X(Y* y))
+        : y(y), constructor_thread(std::this_thread::get_id()) {
+      }
+    };
+    '''
+
+@pytest.mark.parametrize('XAnnot,XPtrAnnot,XBindings', [
+    ('X', 'X*', ''),
+    ('fruit::Annotated<Annotation1, X>',
+     'fruit::Annotated<Annotation1, X*>',
+     '.registerConstructor<fruit::Annotated<Annotation1, X>(Y*)>()'),
+])
+def test_prefetch_success(XAnnot, XPtrAnnot, XBindings):
+    source = '''
+        struct Z : public ConstructionTracker<Z> {
+          INJECT(Z()) = default;
+        };
+
+        fruit::Component<XAnnot, Z> getComponent() {
+          return fruit::createComponent()
+            XBindings;
+        }
+
+        int main() {
+          fruit::Injector<XAnnot, Z> injector(getComponent);
+          Assert(X::num_objects_constructed == 0);
+
+          std::shared_future<void> prefetch = injector.prefetch<XPtrAnnot>();
+          prefetch.get();
+          Assert(X::num_objects_constructed == 1);
+          Assert(Y::num_objects_constructed == 1);
+          Assert(Z::num_objects_constructed == 0);
+
+          X* x = injector.get<XPtrAnnot>();
+          Assert(x->constructor_thread != std::this_thread::get_id());
+          Assert(x->y->constructor_thread != std::this_thread::get_id());
+          Assert(X::num_objects_constructed == 1);
+          Assert(Y::num_objects_constructed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_prefetch_multiple_types_success():
+    source = '''
+        struct Z : public ConstructionTracker<Z> {
+          INJECT(Z()) = default;
+        };
+
+        fruit::Component<X, Z> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<X, Z> injector(getComponent);
+
+          injector.prefetch<fruit::Provider<X>, const Z&>().get();
+          Assert(X::num_objects_constructed == 1);
+          Assert(Y::num_objects_constructed == 1);
+          Assert(Z::num_objects_constructed == 1);
+
+          // Prefetching objects that are already constructed does nothing.
+          injector.prefetch<X>().get();
+          Assert(X::num_objects_constructed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_prefetch_concurrent_with_get():
+    source = '''
+        fruit::Component<X> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          for (int i = 0; i < 20; ++i) {
+            fruit::Injector<X> injector(getComponent);
+            std::shared_future<void> prefetch = injector.prefetch<X>();
+            X* x = injector.get<X*>();
+            prefetch.get();
+            Assert(x == injector.get<X*>());
+          }
+          Assert(X::num_objects_constructed == 20);
+          Assert(Y::num_objects_constructed == 20);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_prefetch_injector_destroyed_during_prefetch():
+    source = '''
+        struct Z : public ConstructionTracker<Z> {
+          static std::size_t num_objects_destroyed;
+
+          INJECT(Z()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+          }
+
+          ~Z() {
+            ++num_objects_destroyed;
+          }
+        };
+
+        std::size_t Z::num_objects_destroyed = 0;
+
+        fruit::Component<Z> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          {
+            fruit::Injector<Z> injector(getComponent);
+            injector.prefetch<Z>();
+            // The destructor waits for the prefetch to complete.
+          }
+          Assert(Z::num_objects_constructed == 1);
+          Assert(Z::num_objects_destroyed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_prefetch_exception():
+    source = '''
+        struct Z {
+          INJECT(Z()) {
+            throw std::runtime_error("Z failed");
+          }
+        };
+
+        fruit::Component<Z> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<Z> injector(getComponent);
+          std::shared_future<void> prefetch = injector.prefetch<Z>();
+          try {
+            prefetch.get();
+            Assert(false);
+          } catch (const std::runtime_error& e) {
+            Assert(std::string(e.what()) == "Z failed");
+          }
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_prefetch_all_success():
+    source = '''
+        struct Z : public ConstructionTracker<Z> {
+          Z() = default;
+        };
+
+        struct W : public ConstructionTracker<W> {
+          W() = default;
+        };
+
+        fruit::Component<X> getComponent() {
+          return fruit::createComponent()
+            .addMultibindingProvider([](){ return new Z(); })
+            .registerConstructor<W()>();
+        }
+
+        int main() {
+          fruit::Injector<X> injector(getComponent);
+          injector.prefetchAll().get();
+          Assert(X::num_objects_constructed == 1);
+          Assert(Y::num_objects_constructed == 1);
+          Assert(Z::num_objects_constructed == 1);
+          // W is not reachable from Injector<X>.
+          Assert(W::num_objects_constructed == 0);
+
+          Assert(injector.getMultibindings<Z>().size() == 1);
+          Assert(Z::num_objects_constructed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_prefetch_error_type_not_provided():
+    source = '''
+        struct Z {
+          INJECT(Z()) = default;
+        };
+
+        fruit::Component<X> getComponent() {
+          return fruit::createComponent();
+        }
+
+        void f(fruit::Injector<X>& injector) {
+          injector.prefetch<X, Z>();
+        }
+        '''
+    expect_compile_error(
+        'TypeNotProvidedError<Z>',
+        'Trying to get an instance of T, but it is not provided by this Provider/Injector.',
+        COMMON_DEFINITIONS,
+        source)
+
+if __name__ == '__main__':
+    main(__file__)
@@ -0,0 +1,201 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+import pytest
+
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+
+    struct Y {
+      INJECT(Y()) = default;
+    };
+
+    struct X {
+      Y* y;
+      int n;
+
+      X(Y* y, int n)
+        : y(y), n(n) {
+      }
+    };
+
+    struct Annotation1 {};
+    '''
+
+@pytest.mark.parametrize('XAnnot,XFactoryAnnot', [
+    ('X', 'fruit::Factory<X*(int)>'),
+    ('X', 'std::function<X*(int)>'),
+    ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation1, fruit::Factory<X*(int)>>'),
+    ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation1, std::function<X*(int)>>'),
+])
+def test_register_arena_factory_success(XAnnot, XFactoryAnnot):
+    source = '''
+        fruit::Component<XFactoryAnnot> getComponent() {
+          return fruit::createComponent()
+            .registerArenaFactory<XAnnot(Y*, fruit::Assisted<int>)>();
+        }
+
+        int main() {
+          fruit::Injector<XFactoryAnnot> injector(getComponent);
+          Assert(injector.getMemoryUsage().factory_arena_bytes == 0);
+          auto factory = injector.get<XFactoryAnnot>();
+          X* x1 = factory(1);
+          X* x2 = factory(2);
+          Assert(x1 != x2);
+          Assert(x1->n == 1);
+          Assert(x2->n == 2);
+          Assert(x1->y == x2->y);
+          for (int i = 0; i < 10000; ++i) {
+            Assert(factory(i)->n == i);
+          }
+          Assert(injector.getMemoryUsage().factory_arena_bytes >= 10002 * sizeof(X));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_register_arena_factory_objects_destroyed_before_other_objects():
+    source = '''
+        std::vector<std::string> events;
+
+        struct Z {
+          INJECT(Z()) = default;
+
+          ~Z() {
+            events.push_back("~Z");
+          }
+        };
+
+        struct W {
+          Z* z;
+          int n;
+
+          W(Z* z, int n)
+            : z(z), n(n) {
+          }
+
+          ~W() {
+            events.push_back("~W" + std::to_string(n));
+          }
+        };
+
+        using WFactory = fruit::Factory<W*(int)>;
+
+        fruit::Component<WFactory> getComponent() {
+          return fruit::createComponent()
+            .registerArenaFactory<W(Z*, fruit::Assisted<int>)>();
+        }
+
+        int main() {
+          {
+            fruit::Injector<WFactory> injector(getComponent);
+            WFactory factory(injector);
+            factory(1);
+            factory(2);
+            Assert(events.empty());
+          }
+          Assert(events == std::vector<std::string>{"~W2", "~W1", "~Z"});
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_register_arena_factory_in_multiple_components():
+    source = '''
+        struct Z {
+          int n;
+
+          Z(int n)
+            : n(n) {
+          }
+        };
+
+        using XFactory = fruit::Factory<X*(int)>;
+        using ZFactory = fruit::Factory<Z*(int)>;
+
+        fruit::Component<XFactory> getXComponent() {
+          return fruit::createComponent()
+            .registerArenaFactory<X(Y*, fruit::Assisted<int>)>();
+        }
+
+        fruit::Component<ZFactory> getZComponent() {
+          return fruit::createComponent()
+            .registerArenaFactory<Z(fruit::Assisted<int>)>();
+        }
+
+        fruit::Component<XFactory, ZFactory> getComponent() {
+          return fruit::createComponent()
+            .install(getXComponent)
+            .install(getZComponent);
+        }
+
+        fruit::Component<ZFactory> getEmptyComponent() {
+          return fruit::createComponent()
+            .install(getZComponent);
+        }
+
+        int main() {
+          fruit::Injector<XFactory, ZFactory> injector(getComponent);
+          Assert(injector.get<XFactory>()(1)->n == 1);
+          Assert(injector.get<ZFactory>()(2)->n == 2);
+
+          fruit::NormalizedComponent<XFactory> normalized_component(getXComponent);
+          fruit::Injector<XFactory, ZFactory> injector2(normalized_component, getEmptyComponent);
+          Assert(injector2.get<XFactory>()(3)->n == 3);
+          Assert(injector2.get<ZFactory>()(4)->n == 4);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_register_arena_factory_error_pointer():
+    source = '''
+        fruit::Component<fruit::Factory<X**(int)>> getComponent() {
+          return fruit::createComponent()
+            .registerArenaFactory<X*(Y*, fruit::Assisted<int>)>();
+        }
+        '''
+    expect_compile_error(
+        r'FactoryReturningPointerError<X\*\(Y\*,fruit::Assisted<int>\)>',
+        'The specified factory returns a pointer. This is not supported',
+        COMMON_DEFINITIONS,
+        source)
+
+def test_register_arena_factory_error_abstract_class():
+    source = '''
+        struct Z {
+          virtual void f() = 0;
+        };
+
+        fruit::Component<fruit::Factory<Z*()>> getComponent() {
+          return fruit::createComponent()
+            .registerArenaFactory<Z()>();
+        }
+        '''
+    expect_compile_error(
+        'CannotConstructAbstractClassError<Z>',
+        'The specified class can.t be constructed because it.s an abstract class.',
+        COMMON_DEFINITIONS,
+        source)
+
+if __name__ == '__main__':
+    main(__file__)
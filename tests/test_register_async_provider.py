@@ -0,0 +1,460 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+import pytest
+
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+    #include <chrono>
+    #include <future>
+    #include <stdexcept>
+
+    struct Annotation1 {};
+
+    template <typename T>
+    using WithNoAnnot = T;
+
+    template <typename T>
+    using WithAnnot1 = fruit::Annotated<Annotation1, T>;
+    '''
+
+@pytest.mark.parametrize('WithAnnot', [
+    'WithNoAnnot',
+    'WithAnnot1',
+])
+@pytest.mark.parametrize('ConstructX,XPtr', [
+    ('X()', 'X'),
+    ('new X()', 'X*'),
+])
+def test_register_async_provider_success(WithAnnot, ConstructX, XPtr):
+    source = '''
+        struct X : public ConstructionTracker<X> {
+          int value = 5;
+        };
+
+        fruit::Component<WithAnnot<X>> getComponent() {
+          return fruit::createComponent()
+            .registerAsyncProvider<WithAnnot<std::future<XPtr>>()>([](){
+              return std::async(std::launch::async, [](){ return ConstructX; });
+            });
+        }
+
+        int main() {
+          fruit::Injector<WithAnnot<X>> injector(getComponent);
+          Assert(X::num_objects_constructed == 0);
+
+          Assert((injector.get<WithAnnot<X                 >>(). value == 5));
+          Assert((injector.get<WithAnnot<X*                >>()->value == 5));
+          Assert((injector.get<WithAnnot<X&                >>(). value == 5));
+          Assert((injector.get<WithAnnot<const X*          >>()->value == 5));
+          Assert((injector.get<WithAnnot<std::shared_ptr<X>>>()->value == 5));
+
+          Assert(X::num_objects_constructed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_register_async_provider_with_injected_args_success():
+    source = '''
+        struct Y {
+          INJECT(Y()) = default;
+          int value = 5;
+        };
+
+        struct X {
+          int value;
+        };
+
+        fruit::Component<X> getComponent() {
+          return fruit::createComponent()
+            .registerAsyncProvider([](Y* y) {
+              return std::async(std::launch::async, [y](){ return X{y->value + 1}; });
+            });
+        }
+
+        int main() {
+          fruit::Injector<X> injector(getComponent);
+          Assert(injector.get<X&>().value == 6);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+@pytest.mark.parametrize('UseNormalizedComponent', [
+    'false',
+    'true',
+])
+def test_register_async_provider_independent_providers_run_concurrently(UseNormalizedComponent):
+    source = '''
+        std::promise<void> y_provider_called;
+        std::promise<void> z_provider_called;
+
+        struct Y {
+          int value;
+        };
+
+        struct Z {
+          int value;
+        };
+
+        struct X {
+          Y* y;
+          Z* z;
+
+          INJECT(X(Y* y, Z* z))
+            : y(y), z(z) {
+          }
+        };
+
+        // The futures for Y and Z only complete once both providers have been called, so this would fail if the
+        // injector waited for Y before calling the provider of Z (or vice versa).
+        fruit::Component<X> getComponent() {
+          return fruit::createComponent()
+            .registerAsyncProvider([]() {
+              y_provider_called.set_value();
+              return std::async(std::launch::async, [](){
+                Assert(z_provider_called.get_future().wait_for(std::chrono::seconds(30)) == std::future_status::ready);
+                return Y{1};
+              });
+            })
+            .registerAsyncProvider([]() {
+              z_provider_called.set_value();
+              return std::async(std::launch::async, [](){
+                Assert(y_provider_called.get_future().wait_for(std::chrono::seconds(30)) == std::future_status::ready);
+                return Z{2};
+              });
+            });
+        }
+
+        fruit::Component<> getEmptyComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          if (UseNormalizedComponent) {
+            fruit::NormalizedComponent<X> normalized_component(getComponent);
+            fruit::Injector<X> injector(normalized_component, getEmptyComponent);
+            X* x = injector.get<X*>();
+            Assert(x->y->value == 1);
+            Assert(x->z->value == 2);
+          } else {
+            fruit::Injector<X> injector(getComponent);
+            X* x = injector.get<X*>();
+            Assert(x->y->value == 1);
+            Assert(x->z->value == 2);
+          }
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_register_async_provider_providers_still_run_concurrently_after_exception():
+    source = '''
+        std::promise<void> y_provider_called;
+        std::promise<void> z_provider_called;
+        int num_w_provider_calls = 0;
+
+        struct W {
+          int value;
+        };
+
+        struct V {
+          W* w;
+
+          INJECT(V(W* w))
+            : w(w) {
+          }
+        };
+
+        struct Y {
+          int value;
+        };
+
+        struct Z {
+          int value;
+        };
+
+        struct X {
+          Y* y;
+          Z* z;
+
+          INJECT(X(Y* y, Z* z))
+            : y(y), z(z) {
+          }
+        };
+
+        // As in test_register_async_provider_independent_providers_run_concurrently, this fails if the providers of Y
+        // and Z are not both called before waiting for their futures, here after an exception in another future.
+        fruit::Component<V, X> getComponent() {
+          return fruit::createComponent()
+            .registerAsyncProvider([]() {
+              bool first_call = num_w_provider_calls++ == 0;
+              return std::async(std::launch::async, [first_call]() -> W {
+                if (first_call) {
+                  throw std::runtime_error("W failed");
+                }
+                return W{3};
+              });
+            })
+            .registerAsyncProvider([]() {
+              y_provider_called.set_value();
+              return std::async(std::launch::async, [](){
+                Assert(z_provider_called.get_future().wait_for(std::chrono::seconds(30)) == std::future_status::ready);
+                return Y{1};
+              });
+            })
+            .registerAsyncProvider([]() {
+              z_provider_called.set_value();
+              return std::async(std::launch::async, [](){
+                Assert(y_provider_called.get_future().wait_for(std::chrono::seconds(30)) == std::future_status::ready);
+                return Z{2};
+              });
+            });
+        }
+
+        int main() {
+          fruit::Injector<V, X> injector(getComponent);
+          bool thrown = false;
+          try {
+            injector.get<V*>();
+          } catch (const std::runtime_error& e) {
+            thrown = true;
+            Assert(std::string(e.what()) == "W failed");
+          }
+          Assert(thrown);
+          X* x = injector.get<X*>();
+          Assert(x->y->value == 1);
+          Assert(x->z->value == 2);
+
+          // A retry calls the provider of W again.
+          V* v = injector.get<V*>();
+          Assert(v->w->value == 3);
+          Assert(num_w_provider_calls == 2);
+          Assert(injector.get<V*>() == v);
+          Assert(num_w_provider_calls == 2);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_register_async_provider_retry_after_injected_arg_throws():
+    source = '''
+        int num_y_constructions = 0;
+        int num_x_provider_calls = 0;
+
+        struct Y {
+          INJECT(Y()) {
+            if (num_y_constructions++ == 0) {
+              throw std::runtime_error("Y failed");
+            }
+          }
+        };
+
+        struct X {
+          Y* y;
+        };
+
+        fruit::Component<X> getComponent() {
+          return fruit::createComponent()
+            .registerAsyncProvider([](Y* y) {
+              ++num_x_provider_calls;
+              return std::async(std::launch::async, [y](){
+                return X{y};
+              });
+            });
+        }
+
+        int main() {
+          fruit::Injector<X> injector(getComponent);
+          bool thrown = false;
+          try {
+            injector.get<X*>();
+          } catch (const std::runtime_error& e) {
+            thrown = true;
+            Assert(std::string(e.what()) == "Y failed");
+          }
+          Assert(thrown);
+          Assert(num_x_provider_calls == 0);
+
+          X* x = injector.get<X*>();
+          Assert(x->y != nullptr);
+          Assert(num_y_constructions == 2);
+          Assert(num_x_provider_calls == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_register_async_provider_depending_on_async_provider():
+    source = '''
+        std::vector<std::string> events;
+
+        struct Y {
+          int value;
+        };
+
+        struct X {
+          Y* y;
+        };
+
+        fruit::Component<X, Y> getComponent() {
+          return fruit::createComponent()
+            .registerAsyncProvider([]() {
+              events.push_back("Y provider");
+              std::promise<Y> promise;
+              promise.set_value(Y{5});
+              return promise.get_future();
+            })
+            .registerAsyncProvider([](Y* y) {
+              events.push_back("X provider");
+              std::promise<X> promise;
+              promise.set_value(X{y});
+              return promise.get_future();
+            });
+        }
+
+        int main() {
+          fruit::Injector<X, Y> injector(getComponent);
+          Assert(injector.get<X*>()->y->value == 5);
+          Assert(injector.get<Y*>()->value == 5);
+          Assert((events == std::vector<std::string>{"Y provider", "X provider"}));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_register_async_provider_with_provider_dependency():
+    source = '''
+        int num_y_provider_calls = 0;
+
+        struct Y {
+          int value;
+        };
+
+        struct X {
+          fruit::Provider<Y> y_provider;
+
+          INJECT(X(fruit::Provider<Y> y_provider))
+            : y_provider(y_provider) {
+          }
+        };
+
+        fruit::Component<X, Y> getComponent() {
+          return fruit::createComponent()
+            .registerAsyncProvider([]() {
+              ++num_y_provider_calls;
+              return std::async(std::launch::async, [](){ return Y{5}; });
+            });
+        }
+
+        int main() {
+          {
+            fruit::Injector<X, Y> injector(getComponent);
+            injector.get<X*>();
+            // The future was not used, it's destroyed with the injector.
+          }
+          {
+            fruit::Injector<X, Y> injector(getComponent);
+            X* x = injector.get<X*>();
+            Assert(x->y_provider.get<Y*>()->value == 5);
+            Assert(injector.get<Y*>()->value == 5);
+          }
+          Assert(num_y_provider_calls == 2);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+@pytest.mark.parametrize('XAnnot,XFuturePtrAnnot,XAnnotRegex', [
+    ('X', 'std::future<X*>', '(struct )?X'),
+    ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation1, std::future<X*>>', '(struct )?fruit::Annotated<(struct )?Annotation1, ?(struct )?X>'),
+])
+def test_register_async_provider_error_returned_nullptr(XAnnot, XFuturePtrAnnot, XAnnotRegex):
+    source = '''
+        struct X {};
+
+        fruit::Component<XAnnot> getComponent() {
+          return fruit::createComponent()
+              .registerAsyncProvider<XFuturePtrAnnot()>([](){
+                std::promise<X*> promise;
+                promise.set_value(nullptr);
+                return promise.get_future();
+              });
+        }
+
+        int main() {
+          fruit::Injector<XAnnot> injector(getComponent);
+          injector.get<XAnnot>();
+        }
+        '''
+    expect_runtime_error(
+        'Fatal injection error: attempting to get an instance for the type XAnnotRegex but the future returned by the async provider returned nullptr',
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_register_async_provider_error_not_returning_future():
+    source = '''
+        struct X {};
+
+        fruit::Component<X> getComponent() {
+          return fruit::createComponent()
+              .registerAsyncProvider([](){ return X(); });
+        }
+        '''
+    expect_compile_error(
+        'AsyncProviderNotReturningFutureError<X>',
+        r'registerAsyncProvider\(\) was called with a lambda that returns T, but the lambda must return a std::future<C> or a std::future<C\*>.',
+        COMMON_DEFINITIONS,
+        source)
+
+def test_register_async_provider_error_abstract_class_with_no_virtual_destructor():
+    source = '''
+        struct I {
+          virtual int foo() = 0;
+        };
+
+        struct X : public I {
+          int foo() override {
+            return 5;
+          }
+        };
+
+        fruit::Component<I> getComponent() {
+          return fruit::createComponent()
+              .registerAsyncProvider([](){
+                return std::async(std::launch::async, [](){ return static_cast<I*>(new X()); });
+              });
+        }
+        '''
+    expect_compile_error(
+        'ProviderReturningPointerToAbstractClassWithNoVirtualDestructorError<I>',
+        r'registerProvider\(\) was called with a lambda that returns a pointer to T, but T is an abstract class',
+        COMMON_DEFINITIONS,
+        source)
+
+if __name__ == '__main__':
+    main(__file__)
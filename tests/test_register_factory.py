@@ -62,6 +62,142 @@ def test_register_factory_success_no_params_autoinject(XFactoryAnnot):
         source,
         locals())
 
+@pytest.mark.parametrize('XFactoryAnnot,ConstructX', [
+    ('fruit::Factory<X(int)>', 'x'),
+    ('fruit::Factory<std::unique_ptr<X>(int)>', '*x'),
+    ('fruit::Annotated<Annotation1, fruit::Factory<X(int)>>', 'x'),
+    ('fruit::Annotated<Annotation1, fruit::Factory<std::unique_ptr<X>(int)>>', '*x'),
+])
+def test_register_factory_success_fruit_factory_autoinject(XFactoryAnnot, ConstructX):
+    source = '''
+        struct Y {
+          INJECT(Y()) = default;
+        };
+
+        struct X {
+          Y* y;
+          int n;
+
+          INJECT(X(Y* y, ASSISTED(int) n))
+            : y(y), n(n) {
+          }
+        };
+
+        fruit::Component<XFactoryAnnot> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<XFactoryAnnot> injector(getComponent);
+          auto x = injector.get<XFactoryAnnot>()(42);
+          Assert((ConstructX).n == 42);
+          Assert((ConstructX).y != nullptr);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_register_factory_success_fruit_factory_and_std_function():
+    source = '''
+        struct Y {
+          INJECT(Y()) = default;
+        };
+
+        struct X {
+          Y& y;
+          int n;
+
+          X(Y& y, int n)
+            : y(y), n(n) {
+          }
+        };
+
+        struct Z {
+          fruit::Factory<X(int)> xFactory;
+
+          INJECT(Z(fruit::Factory<X(int)> xFactory))
+            : xFactory(xFactory) {
+          }
+        };
+
+        fruit::Component<Y, Z, std::function<X(int)>> getComponent() {
+          return fruit::createComponent()
+            .registerFactory<X(Y&, fruit::Assisted<int>)>([](Y& y, int n) { return X(y, n); });
+        }
+
+        int main() {
+          fruit::Injector<Y, Z, std::function<X(int)>> injector(getComponent);
+          fruit::Factory<X(int)> xFactory = injector.get<Z&>().xFactory;
+          X x1 = xFactory(5);
+          X x2 = injector.get<std::function<X(int)>>()(7);
+          Assert(x1.n == 5);
+          Assert(x2.n == 7);
+          // The injected Y& must refer to the Y in the injector, not to a copy.
+          Assert(&x1.y == &injector.get<Y&>());
+          Assert(&x2.y == &injector.get<Y&>());
+          Assert(sizeof(fruit::Factory<X(int)>) <= 2 * sizeof(void*));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_register_factory_std_function_usable_after_injector_destroyed():
+    source = '''
+        struct Y {
+          int value = 5;
+          INJECT(Y()) = default;
+        };
+
+        struct X {
+          int n;
+
+          X(int n)
+            : n(n) {
+          }
+        };
+
+        fruit::Component<std::function<X(int)>, fruit::Factory<X(int)>> getComponent() {
+          return fruit::createComponent()
+            .registerFactory<X(Y, fruit::Assisted<int>)>([](Y y, int n) { return X(y.value + n); });
+        }
+
+        int main() {
+          std::function<X(int)> xFunction;
+          {
+            fruit::Injector<std::function<X(int)>, fruit::Factory<X(int)>> injector(getComponent);
+            Assert(injector.get<fruit::Factory<X(int)>>()(1).n == 6);
+            xFunction = injector.get<std::function<X(int)>>();
+          }
+          // The std::function doesn't refer to the (destroyed) injector, unlike a Factory.
+          Assert(xFunction(2).n == 7);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_register_factory_fruit_factory_no_binding_found_error():
+    source = '''
+        struct X {
+          X(int) {}
+        };
+
+        fruit::Component<fruit::Factory<X(int)>> getComponent() {
+          return fruit::createComponent();
+        }
+        '''
+    expect_compile_error(
+        r'NoBindingFoundError<fruit::Factory<X\(int\)>>',
+        'No explicit binding nor C::Inject definition was found for T',
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
 @pytest.mark.parametrize('ConstructX,XPtrAnnot,XPtrFactoryAnnot', [
     ('X()', 'X', 'std::function<X()>'),
     ('X()', 'fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation1, std::function<X()>>'),
@@ -0,0 +1,233 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+import pytest
+
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+
+    struct Y {
+      INJECT(Y()) = default;
+    };
+
+    struct X {
+      Y* y;
+      int n;
+
+      X(Y* y, int n)
+        : y(y), n(n) {
+      }
+    };
+
+    struct Annotation1 {};
+    '''
+
+@pytest.mark.parametrize('XAnnot,XFactoryAnnot', [
+    ('X', 'fruit::Factory<fruit::Pooled<X>(int)>'),
+    ('X', 'std::function<fruit::Pooled<X>(int)>'),
+    ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation1, fruit::Factory<fruit::Pooled<X>(int)>>'),
+    ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation1, std::function<fruit::Pooled<X>(int)>>'),
+])
+def test_register_pooled_factory_success(XAnnot, XFactoryAnnot):
+    source = '''
+        fruit::Component<XFactoryAnnot, fruit::ObjectPool<X>> getComponent() {
+          return fruit::createComponent()
+            .registerPooledFactory<XAnnot(Y*, fruit::Assisted<int>)>();
+        }
+
+        int main() {
+          fruit::Injector<XFactoryAnnot, fruit::ObjectPool<X>> injector(getComponent);
+          auto factory = injector.get<XFactoryAnnot>();
+          {
+            fruit::Pooled<X> x1 = factory(1);
+            fruit::Pooled<X> x2 = factory(2);
+            Assert(x1->n == 1);
+            Assert(x2->n == 2);
+            Assert(x1->y == x2->y);
+          }
+          for (int i = 0; i < 10; ++i) {
+            fruit::Pooled<X> x = factory(i);
+            Assert(x->n == i);
+          }
+
+          fruit::ObjectPoolStats stats = injector.get<fruit::ObjectPool<X>&>().getStats();
+          Assert(stats.num_allocations == 2);
+          Assert(stats.num_reuses == 10);
+          Assert(stats.num_returned_to_pool == 12);
+          Assert(stats.num_deallocations == 0);
+          Assert(stats.num_live_objects == 0);
+          Assert(stats.pool_size == 2);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_register_pooled_factory_empty_pooled():
+    source = '''
+        struct Z {
+          fruit::Pooled<X> x;
+        };
+
+        fruit::Component<fruit::Factory<fruit::Pooled<X>(int)>> getComponent() {
+          return fruit::createComponent()
+            .registerPooledFactory<X(Y*, fruit::Assisted<int>)>();
+        }
+
+        int main() {
+          fruit::Injector<fruit::Factory<fruit::Pooled<X>(int)>> injector(getComponent);
+          auto factory = injector.get<fruit::Factory<fruit::Pooled<X>(int)>>();
+          Z z;
+          Assert(z.x == nullptr);
+          z.x = factory(5);
+          Assert(z.x->n == 5);
+          z.x = nullptr;
+          Assert(z.x == nullptr);
+          fruit::Pooled<X> x = nullptr;
+          x = factory(6);
+          Assert(x->n == 6);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_register_pooled_factory_with_explicit_pool_binding():
+    source = '''
+        using XFactory = fruit::Factory<fruit::Pooled<X>(int)>;
+
+        fruit::Component<XFactory, fruit::ObjectPool<X>> getComponent() {
+          return fruit::createComponent()
+            .registerProvider([]() { return new fruit::ObjectPool<X>(1); })
+            .registerPooledFactory<X(Y*, fruit::Assisted<int>)>();
+        }
+
+        int main() {
+          fruit::Injector<XFactory, fruit::ObjectPool<X>> injector(getComponent);
+          XFactory factory(injector);
+          {
+            fruit::Pooled<X> x1 = factory(1);
+            fruit::Pooled<X> x2 = factory(2);
+            fruit::Pooled<X> x3 = factory(3);
+            Assert(injector.get<fruit::ObjectPool<X>&>().getStats().num_live_objects == 3);
+          }
+
+          fruit::ObjectPoolStats stats = injector.get<fruit::ObjectPool<X>&>().getStats();
+          Assert(stats.num_allocations == 3);
+          Assert(stats.num_returned_to_pool == 1);
+          Assert(stats.num_deallocations == 2);
+          Assert(stats.num_live_objects == 0);
+          Assert(stats.pool_size == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_register_pooled_factory_destroys_objects():
+    source = '''
+        struct Z {
+          static int num_live_objects;
+
+          Z() {
+            ++num_live_objects;
+          }
+
+          ~Z() {
+            --num_live_objects;
+          }
+        };
+
+        int Z::num_live_objects = 0;
+
+        using ZFactory = fruit::Factory<fruit::Pooled<Z>()>;
+
+        fruit::Component<ZFactory> getComponent() {
+          return fruit::createComponent()
+            .registerPooledFactory<Z()>();
+        }
+
+        int main() {
+          fruit::Injector<ZFactory> injector(getComponent);
+          ZFactory factory(injector);
+          {
+            fruit::Pooled<Z> z = factory();
+            Assert(Z::num_live_objects == 1);
+          }
+          Assert(Z::num_live_objects == 0);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_register_pooled_factory_error_abstract_class():
+    source = '''
+        struct Z {
+          virtual void f() = 0;
+        };
+
+        fruit::Component<fruit::Factory<fruit::Pooled<Z>()>> getComponent() {
+          return fruit::createComponent()
+            .registerPooledFactory<Z()>();
+        }
+        '''
+    expect_compile_error(
+        'CannotConstructAbstractClassError<Z>',
+        'The specified class can.t be constructed because it.s an abstract class.',
+        COMMON_DEFINITIONS,
+        source)
+
+def test_register_pooled_factory_error_not_signature():
+    source = '''
+        fruit::Component<> getComponent() {
+          return fruit::createComponent()
+            .registerPooledFactory<X>();
+        }
+        '''
+    expect_compile_error(
+        'NotASignatureError<X>',
+        'CandidateSignature was specified as parameter, but it.s not a signature.',
+        COMMON_DEFINITIONS,
+        source)
+
+def test_register_pooled_factory_error_over_aligned_class():
+    source = '''
+        struct alignas(2 * alignof(std::max_align_t)) Z {
+          INJECT(Z()) = default;
+        };
+
+        fruit::Component<fruit::Factory<fruit::Pooled<Z>()>> getComponent() {
+          return fruit::createComponent()
+            .registerPooledFactory<Z()>();
+        }
+
+        int main() {
+          fruit::Injector<fruit::Factory<fruit::Pooled<Z>()>> injector(getComponent);
+          injector.get<fruit::Factory<fruit::Pooled<Z>()>>()();
+        }
+        '''
+    expect_generic_compile_error(
+        'fruit::ObjectPool doesn.t support over-aligned types.',
+        COMMON_DEFINITIONS,
+        source)
+
+if __name__ == '__main__':
+    main(__file__)
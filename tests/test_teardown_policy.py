@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+import pytest
+
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+
+    #include <string>
+    #include <vector>
+
+    struct Annotation1 {};
+
+    std::vector<std::string> destroyed;
+
+    struct Memory {
+      INJECT(Memory()) = default;
+      ~Memory() {
+        destroyed.push_back("Memory");
+      }
+    };
+
+    struct File {
+      INJECT(File(Memory*)) {}
+      ~File() {
+        destroyed.push_back("File");
+      }
+    };
+
+    struct Socket {
+      INJECT(Socket(File*)) {}
+      ~Socket() {
+        destroyed.push_back("Socket");
+      }
+    };
+
+    struct Unmarked {
+      INJECT(Unmarked(Socket*)) {}
+      ~Unmarked() {
+        destroyed.push_back("Unmarked");
+      }
+    };
+
+    namespace fruit {
+    template <>
+    struct LeakOnExit<Memory> : std::true_type {};
+
+    template <>
+    struct HoldsExternalResources<File> : std::true_type {};
+
+    // Marked with both, HoldsExternalResources takes precedence.
+    template <>
+    struct LeakOnExit<Socket> : std::true_type {};
+    template <>
+    struct HoldsExternalResources<Socket> : std::true_type {};
+    }
+
+    fruit::Component<Unmarked> getComponent() {
+      return fruit::createComponent();
+    }
+    '''
+
+@pytest.mark.parametrize('TeardownPolicy,ExpectedDestroyed', [
+    ('fruit::TeardownPolicy::DESTROY_ALL', '"Unmarked", "Socket", "File", "Memory"'),
+    ('fruit::TeardownPolicy::LEAK_MARKED_TYPES', '"Unmarked", "Socket", "File"'),
+    ('fruit::TeardownPolicy::LEAK_ALL', '"Socket", "File"'),
+])
+def test_teardown_policy(TeardownPolicy, ExpectedDestroyed):
+    source = '''
+        int main() {
+          {
+            fruit::Injector<Unmarked> injector(getComponent);
+            injector.get<Unmarked*>();
+            injector.setTeardownPolicy(TeardownPolicy);
+          }
+          Assert((destroyed == std::vector<std::string>{ExpectedDestroyed}));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_teardown_policy_default_destroys_all():
+    source = '''
+        int main() {
+          {
+            fruit::Injector<Unmarked> injector(getComponent);
+            injector.get<Unmarked*>();
+          }
+          Assert((destroyed == std::vector<std::string>{"Unmarked", "Socket", "File", "Memory"}));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+@pytest.mark.parametrize('TeardownPolicy', [
+    'fruit::TeardownPolicy::LEAK_MARKED_TYPES',
+    'fruit::TeardownPolicy::LEAK_ALL',
+])
+def test_teardown_policy_annotated_and_externally_allocated_objects(TeardownPolicy):
+    source = '''
+        using MemoryAnnot = fruit::Annotated<Annotation1, Memory>;
+
+        fruit::Component<MemoryAnnot> getMemoryComponent() {
+          return fruit::createComponent()
+            .registerProvider<fruit::Annotated<Annotation1, Memory*>()>([]() { return new Memory(); });
+        }
+
+        int main() {
+          Memory* memory;
+          {
+            fruit::Injector<MemoryAnnot> injector(getMemoryComponent);
+            memory = injector.get<fruit::Annotated<Annotation1, Memory*>>();
+            injector.setTeardownPolicy(TeardownPolicy);
+          }
+          Assert(destroyed.empty());
+          // The object was leaked by the injector, so it can still be deleted here.
+          delete memory;
+          Assert((destroyed == std::vector<std::string>{"Memory"}));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_teardown_policy_lazy_subcomponents():
+    source = '''
+        fruit::Component<Unmarked> getRootComponent() {
+          return fruit::createComponent()
+            .installLazily(getComponent);
+        }
+
+        int main() {
+          {
+            fruit::Injector<Unmarked> injector(getRootComponent);
+            injector.setTeardownPolicy(fruit::TeardownPolicy::LEAK_ALL);
+            // The lazy subcomponent is only expanded here, after the policy is set.
+            injector.get<Unmarked*>();
+          }
+          Assert((destroyed == std::vector<std::string>{"Socket", "File"}));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_teardown_policy_lazy_subcomponents_expanded_before_setting_policy():
+    source = '''
+        fruit::Component<Unmarked> getRootComponent() {
+          return fruit::createComponent()
+            .installLazily(getComponent);
+        }
+
+        int main() {
+          {
+            fruit::Injector<Unmarked> injector(getRootComponent);
+            injector.get<Unmarked*>();
+            injector.setTeardownPolicy(fruit::TeardownPolicy::LEAK_MARKED_TYPES);
+          }
+          Assert((destroyed == std::vector<std::string>{"Unmarked", "Socket", "File"}));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+if __name__ == '__main__':
+    main(__file__)
@@ -0,0 +1,265 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+import pytest
+
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+
+    #include <algorithm>
+    #include <chrono>
+    #include <mutex>
+    #include <string>
+    #include <thread>
+    #include <vector>
+
+    struct Annotation1 {};
+
+    std::mutex destroyed_mutex;
+    std::vector<std::string> destroyed;
+
+    void recordDestruction(const std::string& name) {
+      std::lock_guard<std::mutex> lock(destroyed_mutex);
+      destroyed.push_back(name);
+    }
+
+    // Returns true if `x' was destroyed before `y'.
+    bool destroyedBefore(const std::string& x, const std::string& y) {
+      auto x_itr = std::find(destroyed.begin(), destroyed.end(), x);
+      auto y_itr = std::find(destroyed.begin(), destroyed.end(), y);
+      return x_itr != destroyed.end() && y_itr != destroyed.end() && x_itr < y_itr;
+    }
+
+    template <int n>
+    struct Object {
+      ~Object() {
+        recordDestruction("Object" + std::to_string(n));
+      }
+    };
+    '''
+
+@pytest.mark.parametrize('NumThreads', [
+    '0',
+    '2',
+    '8',
+])
+def test_teardown_threads_respects_dependencies(NumThreads):
+    source = '''
+        // A diamond: D <- B, C <- A.
+        struct D : Object<4> {
+          INJECT(D()) = default;
+        };
+        struct C : Object<3> {
+          INJECT(C(D*)) {}
+        };
+        struct B : Object<2> {
+          INJECT(B(D*)) {}
+        };
+        struct A : Object<1> {
+          INJECT(A(B*, C*)) {}
+        };
+
+        fruit::Component<A> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          {
+            fruit::Injector<A> injector(getComponent);
+            injector.get<A*>();
+            injector.setTeardownThreads(NumThreads);
+          }
+          Assert(destroyed.size() == 4);
+          Assert(destroyedBefore("Object1", "Object2"));
+          Assert(destroyedBefore("Object1", "Object3"));
+          Assert(destroyedBefore("Object2", "Object4"));
+          Assert(destroyedBefore("Object3", "Object4"));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_teardown_threads_independent_objects_destroyed_in_parallel():
+    source = '''
+        template <int n>
+        struct Slow {
+          INJECT(Slow()) = default;
+          ~Slow() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+          }
+        };
+
+        fruit::Component<Slow<1>, Slow<2>, Slow<3>, Slow<4>> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          std::chrono::steady_clock::time_point start;
+          {
+            fruit::Injector<Slow<1>, Slow<2>, Slow<3>, Slow<4>> injector(getComponent);
+            injector.get<Slow<1>*>();
+            injector.get<Slow<2>*>();
+            injector.get<Slow<3>*>();
+            injector.get<Slow<4>*>();
+            injector.setTeardownThreads(4);
+            start = std::chrono::steady_clock::now();
+          }
+          auto elapsed = std::chrono::steady_clock::now() - start;
+          // Destroying them sequentially would take 1200ms.
+          Assert(elapsed < std::chrono::milliseconds(900));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+@pytest.mark.parametrize('IAnnot,IPtrAnnot', [
+    ('I', 'I*'),
+    ('fruit::Annotated<Annotation1, I>', 'fruit::Annotated<Annotation1, I*>'),
+])
+def test_teardown_threads_interfaces_and_providers(IAnnot, IPtrAnnot):
+    source = '''
+        struct I {
+          virtual ~I() = default;
+        };
+        struct Impl : public I, Object<3> {
+          INJECT(Impl()) = default;
+        };
+        struct Y : Object<2> {};
+        struct X : Object<1> {
+          X(I*, Y*) {}
+        };
+
+        fruit::Component<X> getComponent() {
+          return fruit::createComponent()
+            .registerConstructor<X(IPtrAnnot, Y*)>()
+            .bind<IAnnot, Impl>()
+            .registerProvider([]() { return new Y(); });
+        }
+
+        int main() {
+          {
+            fruit::Injector<X> injector(getComponent);
+            injector.get<X*>();
+            injector.setTeardownThreads(4);
+          }
+          Assert(destroyed.size() == 3);
+          Assert(destroyedBefore("Object1", "Object2"));
+          Assert(destroyedBefore("Object1", "Object3"));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_teardown_threads_multibindings_destroyed_first():
+    source = '''
+        struct Y : Object<2> {
+          INJECT(Y()) = default;
+        };
+        struct Listener : Object<1> {
+          Listener(Y*) {}
+        };
+
+        fruit::Component<> getComponent() {
+          return fruit::createComponent()
+            .addMultibindingProvider([](Y* y) { return new Listener(y); });
+        }
+
+        int main() {
+          {
+            fruit::Injector<> injector(getComponent);
+            Assert(injector.getMultibindings<Listener>().size() == 1);
+            injector.setTeardownThreads(4);
+          }
+          Assert((destroyed == std::vector<std::string>{"Object1", "Object2"}));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_teardown_threads_lazy_subcomponents():
+    source = '''
+        struct Z : Object<3> {
+          INJECT(Z()) = default;
+        };
+        struct Y : Object<2> {
+          INJECT(Y(Z*)) {}
+        };
+        struct X : Object<1> {
+          INJECT(X(Y*)) {}
+        };
+
+        fruit::Component<fruit::Required<Z>, Y> getYComponent() {
+          return fruit::createComponent();
+        }
+
+        fruit::Component<X> getComponent() {
+          return fruit::createComponent()
+            .installLazily(getYComponent);
+        }
+
+        int main() {
+          {
+            fruit::Injector<X> injector(getComponent);
+            injector.setTeardownThreads(4);
+            injector.get<X*>();
+          }
+          Assert((destroyed == std::vector<std::string>{"Object1", "Object2", "Object3"}));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_teardown_threads_with_teardown_policy():
+    source = '''
+        struct Y : Object<2> {
+          INJECT(Y()) = default;
+        };
+        struct X : Object<1> {
+          INJECT(X(Y*)) {}
+        };
+
+        namespace fruit {
+        template <>
+        struct LeakOnExit<X> : std::true_type {};
+        }
+
+        fruit::Component<X> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          {
+            fruit::Injector<X> injector(getComponent);
+            injector.get<X*>();
+            injector.setTeardownPolicy(fruit::TeardownPolicy::LEAK_MARKED_TYPES);
+            injector.setTeardownThreads(4);
+          }
+          Assert((destroyed == std::vector<std::string>{"Object2"}));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+if __name__ == '__main__':
+    main(__file__)